@@ -423,6 +423,7 @@ ____CORE_SRC_FILENAMES_OBJECTS =  &
 	$(OBJS)\monodll_imagall.obj &
 	$(OBJS)\monodll_imagbmp.obj &
 	$(OBJS)\monodll_image.obj &
+	$(OBJS)\monodll_imagecache.obj &
 	$(OBJS)\monodll_imagfill.obj &
 	$(OBJS)\monodll_imaggif.obj &
 	$(OBJS)\monodll_imagiff.obj &
@@ -691,6 +692,7 @@ ____CORE_SRC_FILENAMES_OBJECTS =  &
 	$(OBJS)\monodll_imagall.obj &
 	$(OBJS)\monodll_imagbmp.obj &
 	$(OBJS)\monodll_image.obj &
+	$(OBJS)\monodll_imagecache.obj &
 	$(OBJS)\monodll_imagfill.obj &
 	$(OBJS)\monodll_imaggif.obj &
 	$(OBJS)\monodll_imagiff.obj &
@@ -1217,6 +1219,7 @@ ____CORE_SRC_FILENAMES_1_OBJECTS =  &
 	$(OBJS)\monolib_imagall.obj &
 	$(OBJS)\monolib_imagbmp.obj &
 	$(OBJS)\monolib_image.obj &
+	$(OBJS)\monolib_imagecache.obj &
 	$(OBJS)\monolib_imagfill.obj &
 	$(OBJS)\monolib_imaggif.obj &
 	$(OBJS)\monolib_imagiff.obj &
@@ -1485,6 +1488,7 @@ ____CORE_SRC_FILENAMES_1_OBJECTS =  &
 	$(OBJS)\monolib_imagall.obj &
 	$(OBJS)\monolib_imagbmp.obj &
 	$(OBJS)\monolib_image.obj &
+	$(OBJS)\monolib_imagecache.obj &
 	$(OBJS)\monolib_imagfill.obj &
 	$(OBJS)\monolib_imaggif.obj &
 	$(OBJS)\monolib_imagiff.obj &
@@ -1910,6 +1914,7 @@ ____CORE_SRC_FILENAMES_2_OBJECTS =  &
 	$(OBJS)\coredll_imagall.obj &
 	$(OBJS)\coredll_imagbmp.obj &
 	$(OBJS)\coredll_image.obj &
+	$(OBJS)\coredll_imagecache.obj &
 	$(OBJS)\coredll_imagfill.obj &
 	$(OBJS)\coredll_imaggif.obj &
 	$(OBJS)\coredll_imagiff.obj &
@@ -2178,6 +2183,7 @@ ____CORE_SRC_FILENAMES_2_OBJECTS =  &
 	$(OBJS)\coredll_imagall.obj &
 	$(OBJS)\coredll_imagbmp.obj &
 	$(OBJS)\coredll_image.obj &
+	$(OBJS)\coredll_imagecache.obj &
 	$(OBJS)\coredll_imagfill.obj &
 	$(OBJS)\coredll_imaggif.obj &
 	$(OBJS)\coredll_imagiff.obj &
@@ -2462,6 +2468,7 @@ ____CORE_SRC_FILENAMES_3_OBJECTS =  &
 	$(OBJS)\corelib_imagall.obj &
 	$(OBJS)\corelib_imagbmp.obj &
 	$(OBJS)\corelib_image.obj &
+	$(OBJS)\corelib_imagecache.obj &
 	$(OBJS)\corelib_imagfill.obj &
 	$(OBJS)\corelib_imaggif.obj &
 	$(OBJS)\corelib_imagiff.obj &
@@ -2730,6 +2737,7 @@ ____CORE_SRC_FILENAMES_3_OBJECTS =  &
 	$(OBJS)\corelib_imagall.obj &
 	$(OBJS)\corelib_imagbmp.obj &
 	$(OBJS)\corelib_image.obj &
+	$(OBJS)\corelib_imagecache.obj &
 	$(OBJS)\corelib_imagfill.obj &
 	$(OBJS)\corelib_imaggif.obj &
 	$(OBJS)\corelib_imagiff.obj &
@@ -3911,6 +3919,7 @@ MONODLL_OBJECTS =  &
 	$(OBJS)\monodll_tarstrm.obj &
 	$(OBJS)\monodll_textbuf.obj &
 	$(OBJS)\monodll_textfile.obj &
+	$(OBJS)\monodll_threadpool.obj &
 	$(OBJS)\monodll_time.obj &
 	$(OBJS)\monodll_timercmn.obj &
 	$(OBJS)\monodll_timerimpl.obj &
@@ -4059,6 +4068,7 @@ MONOLIB_OBJECTS =  &
 	$(OBJS)\monolib_tarstrm.obj &
 	$(OBJS)\monolib_textbuf.obj &
 	$(OBJS)\monolib_textfile.obj &
+	$(OBJS)\monolib_threadpool.obj &
 	$(OBJS)\monolib_time.obj &
 	$(OBJS)\monolib_timercmn.obj &
 	$(OBJS)\monolib_timerimpl.obj &
@@ -4205,6 +4215,7 @@ BASEDLL_OBJECTS =  &
 	$(OBJS)\basedll_tarstrm.obj &
 	$(OBJS)\basedll_textbuf.obj &
 	$(OBJS)\basedll_textfile.obj &
+	$(OBJS)\basedll_threadpool.obj &
 	$(OBJS)\basedll_time.obj &
 	$(OBJS)\basedll_timercmn.obj &
 	$(OBJS)\basedll_timerimpl.obj &
@@ -4336,6 +4347,7 @@ BASELIB_OBJECTS =  &
 	$(OBJS)\baselib_tarstrm.obj &
 	$(OBJS)\baselib_textbuf.obj &
 	$(OBJS)\baselib_textfile.obj &
+	$(OBJS)\baselib_threadpool.obj &
 	$(OBJS)\baselib_time.obj &
 	$(OBJS)\baselib_timercmn.obj &
 	$(OBJS)\baselib_timerimpl.obj &
@@ -6689,6 +6701,9 @@ $(OBJS)\monodll_textbuf.obj :  .AUTODEPEND ..\..\src\common\textbuf.cpp
 $(OBJS)\monodll_textfile.obj :  .AUTODEPEND ..\..\src\common\textfile.cpp
 	$(CXX) -bt=nt -zq -fo=$^@ $(MONODLL_CXXFLAGS) $<
 
+$(OBJS)\monodll_threadpool.obj :  .AUTODEPEND ..\..\src\common\threadpool.cpp
+	$(CXX) -bt=nt -zq -fo=$^@ $(MONODLL_CXXFLAGS) $<
+
 $(OBJS)\monodll_time.obj :  .AUTODEPEND ..\..\src\common\time.cpp
 	$(CXX) -bt=nt -zq -fo=$^@ $(MONODLL_CXXFLAGS) $<
 
@@ -8220,6 +8235,11 @@ $(OBJS)\monodll_image.obj :  .AUTODEPEND ..\..\src\common\image.cpp
 	$(CXX) -bt=nt -zq -fo=$^@ $(MONODLL_CXXFLAGS) $<
 !endif
 
+!ifeq USE_GUI 1
+$(OBJS)\monodll_imagecache.obj :  .AUTODEPEND ..\..\src\common\imagecache.cpp
+	$(CXX) -bt=nt -zq -fo=$^@ $(MONODLL_CXXFLAGS) $<
+!endif
+
 !ifeq USE_GUI 1
 $(OBJS)\monodll_imagfill.obj :  .AUTODEPEND ..\..\src\common\imagfill.cpp
 	$(CXX) -bt=nt -zq -fo=$^@ $(MONODLL_CXXFLAGS) $<
@@ -9094,6 +9114,9 @@ $(OBJS)\monolib_textbuf.obj :  .AUTODEPEND ..\..\src\common\textbuf.cpp
 $(OBJS)\monolib_textfile.obj :  .AUTODEPEND ..\..\src\common\textfile.cpp
 	$(CXX) -bt=nt -zq -fo=$^@ $(MONOLIB_CXXFLAGS) $<
 
+$(OBJS)\monolib_threadpool.obj :  .AUTODEPEND ..\..\src\common\threadpool.cpp
+	$(CXX) -bt=nt -zq -fo=$^@ $(MONOLIB_CXXFLAGS) $<
+
 $(OBJS)\monolib_time.obj :  .AUTODEPEND ..\..\src\common\time.cpp
 	$(CXX) -bt=nt -zq -fo=$^@ $(MONOLIB_CXXFLAGS) $<
 
@@ -10625,6 +10648,11 @@ $(OBJS)\monolib_image.obj :  .AUTODEPEND ..\..\src\common\image.cpp
 	$(CXX) -bt=nt -zq -fo=$^@ $(MONOLIB_CXXFLAGS) $<
 !endif
 
+!ifeq USE_GUI 1
+$(OBJS)\monolib_imagecache.obj :  .AUTODEPEND ..\..\src\common\imagecache.cpp
+	$(CXX) -bt=nt -zq -fo=$^@ $(MONOLIB_CXXFLAGS) $<
+!endif
+
 !ifeq USE_GUI 1
 $(OBJS)\monolib_imagfill.obj :  .AUTODEPEND ..\..\src\common\imagfill.cpp
 	$(CXX) -bt=nt -zq -fo=$^@ $(MONOLIB_CXXFLAGS) $<
@@ -11499,6 +11527,9 @@ $(OBJS)\basedll_textbuf.obj :  .AUTODEPEND ..\..\src\common\textbuf.cpp
 $(OBJS)\basedll_textfile.obj :  .AUTODEPEND ..\..\src\common\textfile.cpp
 	$(CXX) -bt=nt -zq -fo=$^@ $(BASEDLL_CXXFLAGS) $<
 
+$(OBJS)\basedll_threadpool.obj :  .AUTODEPEND ..\..\src\common\threadpool.cpp
+	$(CXX) -bt=nt -zq -fo=$^@ $(BASEDLL_CXXFLAGS) $<
+
 $(OBJS)\basedll_time.obj :  .AUTODEPEND ..\..\src\common\time.cpp
 	$(CXX) -bt=nt -zq -fo=$^@ $(BASEDLL_CXXFLAGS) $<
 
@@ -11838,6 +11869,9 @@ $(OBJS)\baselib_textbuf.obj :  .AUTODEPEND ..\..\src\common\textbuf.cpp
 $(OBJS)\baselib_textfile.obj :  .AUTODEPEND ..\..\src\common\textfile.cpp
 	$(CXX) -bt=nt -zq -fo=$^@ $(BASELIB_CXXFLAGS) $<
 
+$(OBJS)\baselib_threadpool.obj :  .AUTODEPEND ..\..\src\common\threadpool.cpp
+	$(CXX) -bt=nt -zq -fo=$^@ $(BASELIB_CXXFLAGS) $<
+
 $(OBJS)\baselib_time.obj :  .AUTODEPEND ..\..\src\common\time.cpp
 	$(CXX) -bt=nt -zq -fo=$^@ $(BASELIB_CXXFLAGS) $<
 
@@ -13003,6 +13037,11 @@ $(OBJS)\coredll_image.obj :  .AUTODEPEND ..\..\src\common\image.cpp
 	$(CXX) -bt=nt -zq -fo=$^@ $(COREDLL_CXXFLAGS) $<
 !endif
 
+!ifeq USE_GUI 1
+$(OBJS)\coredll_imagecache.obj :  .AUTODEPEND ..\..\src\common\imagecache.cpp
+	$(CXX) -bt=nt -zq -fo=$^@ $(COREDLL_CXXFLAGS) $<
+!endif
+
 !ifeq USE_GUI 1
 $(OBJS)\coredll_imagfill.obj :  .AUTODEPEND ..\..\src\common\imagfill.cpp
 	$(CXX) -bt=nt -zq -fo=$^@ $(COREDLL_CXXFLAGS) $<
@@ -14411,6 +14450,11 @@ $(OBJS)\corelib_image.obj :  .AUTODEPEND ..\..\src\common\image.cpp
 	$(CXX) -bt=nt -zq -fo=$^@ $(CORELIB_CXXFLAGS) $<
 !endif
 
+!ifeq USE_GUI 1
+$(OBJS)\corelib_imagecache.obj :  .AUTODEPEND ..\..\src\common\imagecache.cpp
+	$(CXX) -bt=nt -zq -fo=$^@ $(CORELIB_CXXFLAGS) $<
+!endif
+
 !ifeq USE_GUI 1
 $(OBJS)\corelib_imagfill.obj :  .AUTODEPEND ..\..\src\common\imagfill.cpp
 	$(CXX) -bt=nt -zq -fo=$^@ $(CORELIB_CXXFLAGS) $<
@@ -531,6 +531,10 @@ SOURCE=..\..\src\common\textfile.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\src\common\threadpool.cpp
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\src\common\time.cpp
 # End Source File
 # Begin Source File
@@ -1567,6 +1571,10 @@ SOURCE=..\..\include\wx\thread.h
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\include\wx\threadpool.h
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\include\wx\time.h
 # End Source File
 # Begin Source File
@@ -518,6 +518,10 @@ SOURCE=..\..\src\common\image.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\src\common\imagecache.cpp
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\src\common\imagfill.cpp
 # End Source File
 # Begin Source File
@@ -6452,6 +6456,10 @@ SOURCE=..\..\include\wx\image.h
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\include\wx\imagecache.h
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\include\wx\imaggif.h
 # End Source File
 # Begin Source File
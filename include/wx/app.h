@@ -308,11 +308,18 @@ public:
     // call to SuspendProcessingOfPendingEvents()
     void ResumeProcessingOfPendingEvents();
 
+    // set the maximal number (0 for unlimited) of pending events of a single
+    // handler processed in a row by ProcessPendingEvents() and, optionally,
+    // the maximal time in microseconds to spend on them
+    void SetPendingEventsBatch(size_t maxEvents, unsigned long maxTime = 0);
+
     // called by ~wxEvtHandler to (eventually) remove the handler from the list of
     // the handlers with pending events
     void RemovePendingEventHandler(wxEvtHandler* toRemove);
 
-    // adds an event handler to the list of the handlers with pending events
+    // adds an event handler to the list of the handlers with pending events,
+    // this is lock-free and may be called from any thread but only once for
+    // each handler becoming scheduled, see wxEvtHandler::QueueEvent()
     void AppendPendingEventHandler(wxEvtHandler* toAppend);
 
     // moves the event handler from the list of the handlers with pending events
@@ -479,16 +486,35 @@ protected:
     // pending events)
     wxEvtHandlerArray m_handlersWithPendingDelayedEvents;
 
+    // the handlers which were scheduled by AppendPendingEventHandler() but not
+    // yet moved to m_handlersWithPendingEvents: this is a lock-free LIFO list
+    // linked using wxEvtHandler::m_nextScheduledHandler
+    wxEvtHandler * volatile m_scheduledHandlers;
+
 #if wxUSE_THREADS
-    // this critical section protects both the lists above
+    // this critical section protects both the arrays above, but not the
+    // m_scheduledHandlers list which is only modified atomically
     wxCriticalSection m_handlersWithPendingEventsLocker;
 #endif
 
     // flag modified by Suspend/ResumeProcessingOfPendingEvents()
     bool m_bDoPendingEventProcessing;
 
+    // limits set by SetPendingEventsBatch()
+    size_t m_pendingEventsBatchSize;
+    unsigned long m_pendingEventsBatchTime;
+
     friend class WXDLLIMPEXP_FWD_BASE wxEvtHandler;
 
+private:
+    // move the handlers from m_scheduledHandlers to m_handlersWithPendingEvents,
+    // must be called with m_handlersWithPendingEventsLocker held
+    void MergeScheduledHandlers();
+
+    // process the pending events of the given handler, as many of them as
+    // allowed by SetPendingEventsBatch()
+    void ProcessPendingEventsBatch(wxEvtHandler *handler);
+
     // the application object is a singleton anyhow, there is no sense in
     // copying it
     wxDECLARE_NO_COPY_CLASS(wxAppConsoleBase);
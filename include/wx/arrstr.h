@@ -150,6 +150,23 @@ public:
   wxArrayString(const wxArrayString& array);
     // assignment operator
   wxArrayString& operator=(const wxArrayString& src);
+#ifdef wxHAS_RVALUE_REF
+    // move ctor and assignment operator take the other array contents and,
+    // as the copying versions, its sort flag, leaving it empty
+  wxArrayString(wxArrayString&& array) { Init(array.m_autoSort); Take(array); }
+  wxArrayString& operator=(wxArrayString&& src)
+  {
+      if ( &src != this )
+      {
+          Clear();
+          Take(src);
+
+          m_autoSort = src.m_autoSort;
+      }
+
+      return *this;
+  }
+#endif // wxHAS_RVALUE_REF
     // not virtual, this class should not be derived from
  ~wxArrayString();
 
@@ -206,6 +223,12 @@ public:
   size_t Add(const wxString& str, size_t nInsert = 1);
     // add new element at given position
   void Insert(const wxString& str, size_t uiIndex, size_t nInsert = 1);
+#ifdef wxHAS_RVALUE_REF
+    // versions of the above taking a temporary string which is moved, and
+    // not copied, into the array
+  size_t Add(wxString&& str);
+  void Insert(wxString&& str, size_t uiIndex);
+#endif // wxHAS_RVALUE_REF
     // expand the array to have count elements
   void SetCount(size_t count);
     // remove first item matching this value
@@ -343,6 +366,9 @@ public:
   size_type max_size() const { return INT_MAX; }
   void pop_back() { RemoveAt(GetCount() - 1); }
   void push_back(const_reference v) { Add(v); }
+#ifdef wxHAS_RVALUE_REF
+  void push_back(value_type&& v) { Add(std::move(v)); }
+#endif // wxHAS_RVALUE_REF
   reverse_iterator rbegin() { return reverse_iterator(end() - 1); }
   const_reverse_iterator rbegin() const
     { return const_reverse_iterator(end() - 1); }
@@ -363,9 +389,25 @@ public:
 protected:
   void Init(bool autoSort);             // common part of all ctors
   void Copy(const wxArrayString& src);  // copies the contents of another array
+#ifdef wxHAS_RVALUE_REF
+    // takes the contents of another array, which must be empty, leaving the
+    // other array empty but preserving its sort flag
+  void Take(wxArrayString& src)
+  {
+      m_nSize = src.m_nSize;
+      m_nCount = src.m_nCount;
+      m_pItems = src.m_pItems;
+
+      src.Init(src.m_autoSort);
+  }
+#endif // wxHAS_RVALUE_REF
 
 private:
   void Grow(size_t nIncrement = 0);     // makes array bigger if needed
+    // returns the position at which str should be inserted in sorted array
+  size_t GetSortedPos(const wxString& str) const;
+    // moves the items after nIndex to make room for nInsert new ones
+  void MakeRoom(size_t nIndex, size_t nInsert);
 
   size_t  m_nSize,    // current size of the array
           m_nCount;   // current number of elements
@@ -22,6 +22,9 @@
 //  - wxAtomicDec must return a zero value if the value is zero once
 //  decremented else it must return any non-zero value (the true value is OK
 //  but not necessary).
+//  - wxAtomicCompareAndSwap[Ptr] must return true if and only if the value
+//  was equal to the expected one and so was replaced with the desired one,
+//  and must act as a full memory barrier.
 
 #if wxUSE_THREADS
 
@@ -42,6 +45,16 @@ inline wxUint32 wxAtomicDec (wxUint32 &value)
     return __sync_sub_and_fetch(&value, 1);
 }
 
+inline bool wxAtomicCompareAndSwap (wxUint32 &value, wxUint32 expected, wxUint32 desired)
+{
+    return __sync_bool_compare_and_swap(&value, expected, desired);
+}
+
+inline bool wxAtomicCompareAndSwapPtr (void * volatile &ptr, void *expected, void *desired)
+{
+    return __sync_bool_compare_and_swap(&ptr, expected, desired);
+}
+
 
 #elif defined(__WXMSW__)
 
@@ -58,6 +71,16 @@ inline wxUint32 wxAtomicDec (wxUint32 &value)
     return InterlockedDecrement ((LONG*)&value);
 }
 
+inline bool wxAtomicCompareAndSwap (wxUint32 &value, wxUint32 expected, wxUint32 desired)
+{
+    return InterlockedCompareExchange ((LONG*)&value, desired, expected) == (LONG)expected;
+}
+
+inline bool wxAtomicCompareAndSwapPtr (void * volatile &ptr, void *expected, void *desired)
+{
+    return InterlockedCompareExchangePointer ((PVOID volatile*)&ptr, desired, expected) == expected;
+}
+
 #elif defined(__WXMAC__) || defined(__DARWIN__)
 
 #include "libkern/OSAtomic.h"
@@ -71,6 +94,16 @@ inline wxUint32 wxAtomicDec (wxUint32 &value)
     return OSAtomicDecrement32 ((int32_t*)&value);
 }
 
+inline bool wxAtomicCompareAndSwap (wxUint32 &value, wxUint32 expected, wxUint32 desired)
+{
+    return OSAtomicCompareAndSwap32Barrier ((int32_t)expected, (int32_t)desired, (int32_t*)&value);
+}
+
+inline bool wxAtomicCompareAndSwapPtr (void * volatile &ptr, void *expected, void *desired)
+{
+    return OSAtomicCompareAndSwapPtrBarrier (expected, desired, &ptr);
+}
+
 #elif defined (__SOLARIS__)
 
 #include <atomic.h>
@@ -85,6 +118,16 @@ inline wxUint32 wxAtomicDec (wxUint32 &value)
     return atomic_add_32_nv ((uint32_t*)&value, (uint32_t)-1);
 }
 
+inline bool wxAtomicCompareAndSwap (wxUint32 &value, wxUint32 expected, wxUint32 desired)
+{
+    return atomic_cas_32 ((uint32_t*)&value, expected, desired) == expected;
+}
+
+inline bool wxAtomicCompareAndSwapPtr (void * volatile &ptr, void *expected, void *desired)
+{
+    return atomic_cas_ptr (&ptr, expected, desired) == expected;
+}
+
 #else // unknown platform
 
 // it will result in inclusion if the generic implementation code a bit later in this page
@@ -98,6 +141,24 @@ inline wxUint32 wxAtomicDec (wxUint32 &value)
 inline void wxAtomicInc (wxUint32 &value) { ++value; }
 inline wxUint32 wxAtomicDec (wxUint32 &value) { return --value; }
 
+inline bool wxAtomicCompareAndSwap (wxUint32 &value, wxUint32 expected, wxUint32 desired)
+{
+    if ( value != expected )
+        return false;
+
+    value = desired;
+    return true;
+}
+
+inline bool wxAtomicCompareAndSwapPtr (void * volatile &ptr, void *expected, void *desired)
+{
+    if ( ptr != expected )
+        return false;
+
+    ptr = desired;
+    return true;
+}
+
 #endif // !wxUSE_THREADS
 
 // ----------------------------------------------------------------------------
@@ -141,6 +202,35 @@ private:
 inline void wxAtomicInc(wxAtomicInt32 &value) { value.Inc(); }
 inline wxInt32 wxAtomicDec(wxAtomicInt32 &value) { return value.Dec(); }
 
+// there are no native compare-and-swap operations neither, so emulate them
+// using a single critical section shared by all of them (notice that this
+// means that the first call to them must be done from the main thread)
+inline wxCriticalSection& wxGetAtomicCompareAndSwapLock()
+{
+    static wxCriticalSection s_locker;
+    return s_locker;
+}
+
+inline bool wxAtomicCompareAndSwap(wxUint32 &value, wxUint32 expected, wxUint32 desired)
+{
+    wxCriticalSectionLocker lock(wxGetAtomicCompareAndSwapLock());
+    if ( value != expected )
+        return false;
+
+    value = desired;
+    return true;
+}
+
+inline bool wxAtomicCompareAndSwapPtr(void * volatile &ptr, void *expected, void *desired)
+{
+    wxCriticalSectionLocker lock(wxGetAtomicCompareAndSwapLock());
+    if ( ptr != expected )
+        return false;
+
+    ptr = desired;
+    return true;
+}
+
 #else // !wxNEEDS_GENERIC_ATOMIC_OPS
 
 #define wxHAS_ATOMIC_OPS
@@ -157,4 +247,29 @@ typedef wxInt32 wxAtomicInt32;
 // default type
 typedef wxAtomicInt32 wxAtomicInt;
 
+// ----------------------------------------------------------------------------
+// helpers for working with typed pointers built on top of the functions above
+// ----------------------------------------------------------------------------
+
+template <typename T>
+inline bool wxAtomicCompareAndSwapPtr(T * volatile &ptr, T *expected, T *desired)
+{
+    return wxAtomicCompareAndSwapPtr(reinterpret_cast<void * volatile &>(ptr),
+                                     static_cast<void *>(expected),
+                                     static_cast<void *>(desired));
+}
+
+// atomically replace the pointer with the new value and return the old one
+template <typename T>
+inline T *wxAtomicExchangePtr(T * volatile &ptr, T *value)
+{
+    T *old;
+    do
+    {
+        old = ptr;
+    } while ( !wxAtomicCompareAndSwapPtr(ptr, old, value) );
+
+    return old;
+}
+
 #endif // _WX_ATOMIC_H_
@@ -272,6 +272,18 @@ typedef short int WXTYPE;
     #define wxEXPLICIT
 #endif /*  HAVE_EXPLICIT/!HAVE_EXPLICIT */
 
+/*  check for rvalue references (C++11 move semantics) support */
+#ifndef wxHAS_RVALUE_REF
+    #if defined(__cplusplus) && __cplusplus >= 201103L
+        #define wxHAS_RVALUE_REF
+    #elif defined(__GXX_EXPERIMENTAL_CXX0X__) && wxCHECK_GCC_VERSION(4, 3)
+        /*  g++ supports them in -std=c++0x mode since 4.3 */
+        #define wxHAS_RVALUE_REF
+    #elif wxCHECK_VISUALC_VERSION(10)
+        #define wxHAS_RVALUE_REF
+    #endif
+#endif /*  !wxHAS_RVALUE_REF */
+
 /* these macros are obsolete, use the standard C++ casts directly now */
 #define wx_static_cast(t, x) static_cast<t>(x)
 #define wx_const_cast(t, x) const_cast<t>(x)
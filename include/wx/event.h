@@ -29,6 +29,8 @@
 #include "wx/typeinfo.h"
 #include "wx/any.h"
 
+#include <new>          // for std::nothrow_t
+
 #ifdef wxHAS_EVENT_BIND
     #include "wx/meta/convertible.h"
 #endif
@@ -66,6 +68,9 @@ class WXDLLIMPEXP_FWD_BASE wxEventFilter;
 
 class WXDLLIMPEXP_FWD_BASE wxMSVC_FWD_MULTIPLE_BASES wxEvtHandler;
 class wxEventConnectionRef;
+class wxPendingEventNode;
+class wxCoalescedEvents;
+class wxDynamicEventIndex;
 
 // ----------------------------------------------------------------------------
 // Event types
@@ -898,6 +903,75 @@ enum wxEventCategory
         wxEVT_CATEGORY_CLIPBOARD
 };
 
+// ----------------------------------------------------------------------------
+// wxEventAllocator: allocator for the events which are often created in one
+// thread and destroyed in another one, e.g. queued using QueueEvent()
+// ----------------------------------------------------------------------------
+
+// statistics returned by wxEventAllocator::GetStats()
+struct wxEventAllocatorStats
+{
+    // total number of allocations and the number of them which had to use the
+    // heap because there were no cached blocks
+    unsigned long numAllocs,
+                  numHeapAllocs;
+
+    // total number of deallocations and the number of blocks returned to the
+    // heap because there were too many of them cached already
+    unsigned long numFrees,
+                  numHeapFrees;
+};
+
+class WXDLLIMPEXP_BASE wxEventAllocator
+{
+public:
+    // allocate a block of memory of at least the given size, the first
+    // version throws std::bad_alloc if there is not enough memory while the
+    // second one returns NULL
+    static void *Alloc(size_t size);
+    static void *Alloc(size_t size, const std::nothrow_t&);
+
+    // free a block allocated by Alloc() with the same size, this can be done
+    // from any thread and not only the one which allocated it
+    static void Free(void *p, size_t size);
+
+    // return all the blocks cached by the current thread to the common pool,
+    // this is done automatically when a wxThread terminates (and the threads
+    // not created by wxThread don't cache any blocks)
+    static void ReleaseThreadCache();
+
+    // get the statistics for all threads, notice that they're only updated
+    // periodically and so can be slightly out of date for the other threads
+    static wxEventAllocatorStats GetStats();
+};
+
+// use wxEventAllocator for allocating the objects of the given class and all
+// classes deriving from it, this must be used in the public section of the
+// class declaration and can't be used together with memory tracing which
+// uses its own operator new
+//
+// notice that the nothrow and placement forms of operator new must be
+// declared too as they would be hidden by the class operator new otherwise
+// and that the nothrow operator delete is only called if the ctor throws, so
+// it can just return the block to the heap as all the blocks come from it
+#if wxUSE_MEMORY_TRACING
+    #define wxDECLARE_EVENT_ALLOCATOR()
+#else // !wxUSE_MEMORY_TRACING
+    #define wxDECLARE_EVENT_ALLOCATOR() \
+        static void *operator new(size_t size) \
+            { return wxEventAllocator::Alloc(size); } \
+        static void operator delete(void *p, size_t size) \
+            { wxEventAllocator::Free(p, size); } \
+        static void *operator new(size_t size, const std::nothrow_t& nt) throw() \
+            { return wxEventAllocator::Alloc(size, nt); } \
+        static void operator delete(void *p, const std::nothrow_t& nt) throw() \
+            { ::operator delete(p, nt); } \
+        static void *operator new(size_t WXUNUSED(size), void *p) \
+            { return p; } \
+        static void operator delete(void *WXUNUSED(p), void *WXUNUSED(q)) \
+            { }
+#endif // wxUSE_MEMORY_TRACING/!wxUSE_MEMORY_TRACING
+
 /*
  * wxWidgets events, covering all interesting things that might happen
  * (button clicking, resizing, setting text in widgets, etc.).
@@ -1254,6 +1328,8 @@ public:
     virtual wxEventCategory GetEventCategory() const
         { return wxEVT_CATEGORY_THREAD; }
 
+    wxDECLARE_EVENT_ALLOCATOR()
+
 private:
     DECLARE_DYNAMIC_CLASS_NO_ASSIGN(wxThreadEvent)
 };
@@ -1318,6 +1394,8 @@ public:
     virtual wxEvent *Clone() const { return new wxCommandEvent(*this); }
     virtual wxEventCategory GetEventCategory() const { return wxEVT_CATEGORY_USER_INPUT; }
 
+    wxDECLARE_EVENT_ALLOCATOR()
+
 protected:
     void*             m_clientData;    // Arbitrary client data
     wxClientData*     m_clientObject;  // Arbitrary client object
@@ -3118,6 +3196,11 @@ public:
 
     void DeletePendingEvents();
 
+    // Enable or disable coalescing of the events of the given type queued by
+    // QueueEvent(): if enabled, an event replaces the pending event with the
+    // same type and id instead of being appended to the queue.
+    void EnableEventCoalescing(wxEventType eventType, bool enable = true);
+
 #if wxUSE_THREADS
     bool ProcessThreadEvent(const wxEvent& event);
         // NOTE: uses AddPendingEvent(); call only from secondary threads
@@ -3368,10 +3451,37 @@ protected:
     wxEvtHandler*       m_nextHandler;
     wxEvtHandler*       m_previousHandler;
     wxList*             m_dynamicEvents;
-    wxList*             m_pendingEvents;
+
+    // Index of m_dynamicEvents entries by event type and id used to speed up
+    // SearchDynamicEventTable(), allocated together with m_dynamicEvents.
+    wxDynamicEventIndex* m_dynamicEventsIndex;
+
+    // Events queued by QueueEvent() are pushed on m_incomingEvents, which is a
+    // lock-free LIFO list that can be modified from any thread. They are moved
+    // from it, in FIFO order, to the list starting at m_pendingEventsHead by
+    // ProcessPendingEvents() which is the only code touching the latter list.
+    wxPendingEventNode * volatile m_incomingEvents;
+    wxPendingEventNode *m_pendingEventsHead,
+                       *m_pendingEventsTail;
+
+    // Non-zero if this handler is registered with wxTheApp as having pending
+    // events, it is only modified using atomic operations.
+    wxUint32            m_pendingEventsScheduled;
+
+    // The next handler in the lock-free list of wxAppConsoleBase handlers
+    // which were scheduled since its last ProcessPendingEvents() call.
+    wxEvtHandler*       m_nextScheduledHandler;
+
+    // The event types for which EnableEventCoalescing() was called and their
+    // pending events, NULL if it never was. Once allocated, it is only
+    // deleted by the dtor. The pointer itself is set atomically and can be
+    // tested without locking but the object is only accessed while holding
+    // m_pendingEventsLock.
+    wxCoalescedEvents * volatile m_coalescedEvents;
 
 #if wxUSE_THREADS
-    // critical section protecting m_pendingEvents
+    // critical section serializing the processing of the pending events, it
+    // is only taken by QueueEvent() for the events of coalesced types
     wxCriticalSection m_pendingEventsLock;
 #endif // wxUSE_THREADS
 
@@ -3410,9 +3520,35 @@ private:
     // try to process events in all handlers chained to this one
     bool DoTryChain(wxEvent& event);
 
+    // queue the event if its type is coalesced, replacing the pending event
+    // with the same type and id if there is one, and return true or just
+    // return false if events of this type are not coalesced
+    bool QueueCoalescedEvent(wxEvent *event, bool *replaced);
+
+    // move the events from m_incomingEvents to the end of the pending list
+    void TakeIncomingEvents();
+
+    // stop being registered as having pending events with wxTheApp, called
+    // when there are no more pending events left
+    void UnschedulePendingEvents();
+
+    // reset m_pendingEventsScheduled after this handler was removed from the
+    // list of the handlers with pending events, scheduling it again if an
+    // event was queued for it in the meanwhile
+    void ResetPendingEventsScheduled();
+
+    // process the first pending event which can be processed now and return
+    // true if there are more pending events left, notice that this object
+    // may be already destroyed when this function returns
+    bool DoProcessPendingEvent();
+
     // Head of the event filter linked list.
     static wxEventFilter* ms_filterList;
 
+    // it manipulates m_nextScheduledHandler and uses DoProcessPendingEvent()
+    // and ResetPendingEventsScheduled()
+    friend class WXDLLIMPEXP_FWD_BASE wxAppConsoleBase;
+
     DECLARE_DYNAMIC_CLASS_NO_COPY(wxEvtHandler)
 };
 
@@ -54,6 +54,10 @@ public:
 #if wxUSE_STREAMS
     virtual bool SaveFile( wxImage *image, wxOutputStream& stream, bool verbose=true );
     virtual bool LoadFile( wxImage *image, wxInputStream& stream, bool verbose=true, int index=-1 );
+    virtual bool LoadRows( wxImage *image, wxImageRowSink& sink,
+                           wxInputStream& stream,
+                           bool verbose=true, int index=-1 );
+    virtual bool CanLoadRows() const { return true; }
 
 protected:
     virtual bool DoCanRead( wxInputStream& stream );
@@ -90,6 +94,16 @@ public:
     virtual bool LoadFile( wxImage *image, wxInputStream& stream, bool verbose=true, int index=-1 );
     virtual bool DoLoadFile( wxImage *image, wxInputStream& stream, bool verbose, int index );
 
+    // the icons can't be loaded row by row, so don't inherit wxBMPHandler
+    // implementation of these functions
+    virtual bool LoadRows( wxImage *image, wxImageRowSink& sink,
+                           wxInputStream& stream,
+                           bool verbose=true, int index=-1 )
+    {
+        return wxImageHandler::LoadRows(image, sink, stream, verbose, index);
+    }
+    virtual bool CanLoadRows() const { return false; }
+
 protected:
     virtual int DoGetImageCount( wxInputStream& stream );
     virtual bool DoCanRead( wxInputStream& stream );
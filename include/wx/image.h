@@ -71,7 +71,20 @@ enum wxImageResizeQuality
     wxIMAGE_QUALITY_NORMAL = wxIMAGE_QUALITY_NEAREST,
 
     // highest (but best) quality
-    wxIMAGE_QUALITY_HIGH
+    wxIMAGE_QUALITY_HIGH = 4,
+
+    // sharpest results, especially suitable for creating thumbnails
+    wxIMAGE_QUALITY_LANCZOS3 = 5
+};
+
+// Constants for wxImage::Paste() for determining alpha channel treatment
+enum wxImageAlphaBlendMode
+{
+    // replace the pixels of the image with the pasted ones, including alpha
+    wxIMAGE_ALPHA_BLEND_OVER = 0,
+
+    // compose the pasted pixels with alpha over the existing ones
+    wxIMAGE_ALPHA_BLEND_COMPOSE = 1
 };
 
 // alpha channel values: fully transparent, default threshold separating
@@ -98,6 +111,103 @@ class WXDLLIMPEXP_FWD_CORE wxPalette;
 DECLARE_VARIANT_OBJECT_EXPORTED(wxImage,WXDLLIMPEXP_CORE)
 #endif
 
+//-----------------------------------------------------------------------------
+// wxImageRowSink: receives the rows of the image decoded by wxImageHandler
+//-----------------------------------------------------------------------------
+
+class WXDLLIMPEXP_CORE wxImageRowSink
+{
+public:
+    wxImageRowSink() { }
+    virtual ~wxImageRowSink() { }
+
+    // called once before any rows with the size of the image and whether it
+    // has an alpha channel, may return false to abort loading
+    virtual bool Start(int width, int height, bool hasAlpha) = 0;
+
+    // called exactly once for each row of the image, but not necessarily in
+    // top to bottom order: data contains width RGB triplets and alpha, which
+    // is NULL if the image doesn't have alpha, width alpha values; both are
+    // only valid during this call, which may return false to abort loading
+    virtual bool ProcessRow(int y,
+                            const unsigned char *data,
+                            const unsigned char *alpha) = 0;
+
+    wxDECLARE_NO_COPY_CLASS(wxImageRowSink);
+};
+
+//-----------------------------------------------------------------------------
+// wxImageLoadCallback: receives the images loaded by wxImage::LoadFiles()
+//-----------------------------------------------------------------------------
+
+class WXDLLIMPEXP_CORE wxImageLoadCallback
+{
+public:
+    wxImageLoadCallback() { }
+    virtual ~wxImageLoadCallback() { }
+
+    // called in the thread which called LoadFiles() for each of the files, in
+    // the same order as they were given: image is invalid if the file failed
+    // to load and may be modified by this function, which may also return
+    // false to stop loading the remaining files
+    virtual bool OnImageLoaded(size_t n,
+                               const wxString& filename,
+                               wxImage& image) = 0;
+
+    wxDECLARE_NO_COPY_CLASS(wxImageLoadCallback);
+};
+
+//-----------------------------------------------------------------------------
+// wxImageDecodeCallback: notified by wxImageIncrementalDecoder about progress
+//-----------------------------------------------------------------------------
+
+class WXDLLIMPEXP_CORE wxImageDecodeCallback
+{
+public:
+    wxImageDecodeCallback() { }
+    virtual ~wxImageDecodeCallback() { }
+
+    // called when the rows from yStart up to, but excluding, yEnd of the
+    // given frame were decoded or, for interlaced images, refined: the image
+    // contains everything decoded so far and is only valid during this call,
+    // so it must be copied with wxImage::Copy() if it needs to be kept; may
+    // return false to abort decoding
+    virtual bool OnRowsDecoded(unsigned frame,
+                               const wxImage& image,
+                               int yStart,
+                               int yEnd) = 0;
+
+    // called when the frame was completely decoded, this image won't be
+    // modified by the decoder any more and may be kept; may return false to
+    // abort decoding
+    virtual bool OnFrameDecoded(unsigned frame, const wxImage& image) = 0;
+
+    wxDECLARE_NO_COPY_CLASS(wxImageDecodeCallback);
+};
+
+//-----------------------------------------------------------------------------
+// wxImageIncrementalDecoder: decodes the image data pushed into it in chunks
+//-----------------------------------------------------------------------------
+
+class WXDLLIMPEXP_CORE wxImageIncrementalDecoder
+{
+public:
+    wxImageIncrementalDecoder() { }
+    virtual ~wxImageIncrementalDecoder() { }
+
+    // pass the next chunk of image data to the decoder which decodes as much
+    // of it as possible and notifies the callback about the results, returns
+    // false if the data is invalid or the callback aborted decoding, after
+    // which the decoder can't be used any more
+    virtual bool Feed(const void *data, size_t len) = 0;
+
+    // return true once the end of the image data was reached, any data fed
+    // to the decoder after this is ignored
+    virtual bool IsDone() const = 0;
+
+    wxDECLARE_NO_COPY_CLASS(wxImageIncrementalDecoder);
+};
+
 //-----------------------------------------------------------------------------
 // wxImageHandler
 //-----------------------------------------------------------------------------
@@ -119,6 +229,28 @@ public:
                            bool WXUNUSED(verbose)=true )
         { return false; }
 
+    // load the image passing its rows to the given sink instead of storing
+    // them in the image: the image is only used for the options affecting
+    // loading and for the options set by the handler, e.g. the resolution
+    //
+    // the default implementation loads the entire image using LoadFile(), so
+    // the handlers which can decode the image without keeping all of it in
+    // memory override both this function and CanLoadRows()
+    virtual bool LoadRows( wxImage *image, wxImageRowSink& sink,
+                           wxInputStream& stream,
+                           bool verbose=true, int index=-1 );
+    virtual bool CanLoadRows() const { return false; }
+
+    // create a decoder which can be fed with the image data as it becomes
+    // available, e.g. when it's received from network, and which notifies
+    // the callback about the progress: returns NULL if this handler doesn't
+    // support incremental decoding (which is the default), otherwise the
+    // caller must delete the decoder
+    virtual wxImageIncrementalDecoder *
+    CreateIncrementalDecoder(wxImageDecodeCallback& WXUNUSED(callback),
+                             bool WXUNUSED(verbose) = true)
+        { return NULL; }
+
     int GetImageCount( wxInputStream& stream );
         // save the stream position, call DoGetImageCount() and restore the position
 
@@ -317,7 +449,8 @@ public:
 
     // pastes image into this instance and takes care of
     // the mask colour and out of bounds problems
-    void Paste( const wxImage &image, int x, int y );
+    void Paste( const wxImage &image, int x, int y,
+                wxImageAlphaBlendMode alphaBlend = wxIMAGE_ALPHA_BLEND_OVER );
 
     // return the new image with size width*height
     wxImage Scale( int width, int height,
@@ -328,6 +461,7 @@ public:
     wxImage ResampleBox(int width, int height) const;
     wxImage ResampleBilinear(int width, int height) const;
     wxImage ResampleBicubic(int width, int height) const;
+    wxImage ResampleLanczos3(int width, int height) const;
 
     // blur the image according to the specified pixel radius
     wxImage Blur(int radius) const;
@@ -414,6 +548,14 @@ public:
     virtual bool LoadFile( const wxString& name, wxBitmapType type = wxBITMAP_TYPE_ANY, int index = -1 );
     virtual bool LoadFile( const wxString& name, const wxString& mimetype, int index = -1 );
 
+    // load all the given files using all the available CPUs and pass them to
+    // the callback, return the number of successfully loaded images; the
+    // options, if specified, are applied to all the loaded images
+    static size_t LoadFiles( const wxArrayString& names,
+                             wxImageLoadCallback& callback,
+                             wxBitmapType type = wxBITMAP_TYPE_ANY,
+                             const wxImage *options = NULL );
+
 #if wxUSE_STREAMS
     static bool CanRead( wxInputStream& stream );
     static int GetImageCount( wxInputStream& stream, wxBitmapType type = wxBITMAP_TYPE_ANY );
@@ -502,6 +644,8 @@ public:
     // -1.0..1.0 where -1.0 is -360 degrees and 1.0 is 360 degrees
     void RotateHue(double angle);
 
+    // all the functions below except GetHandlers() may be called from any
+    // thread, but the handlers must not be removed while they are being used
     static wxList& GetHandlers() { return sm_handlers; }
     static void AddHandler( wxImageHandler *handler );
     static void InsertHandler( wxImageHandler *handler );
@@ -520,6 +664,13 @@ public:
     static HSVValue RGBtoHSV(const RGBValue& rgb);
     static RGBValue HSVtoRGB(const HSVValue& hsv);
 
+    // set the maximal number of threads used by the functions processing the
+    // whole image, such as Scale(), Blur() or Rotate90(), 0 means to use as
+    // many threads as there are CPUs while 1, which is the default, means to
+    // only use the current thread
+    static void SetMaxThreads(unsigned numThreads);
+    static unsigned GetMaxThreads();
+
 #if WXWIN_COMPATIBILITY_2_8
     wxDEPRECATED_CONSTRUCTOR(
         wxImage(const wxString& name, long type, int index = -1)
@@ -582,6 +733,7 @@ public:
 
 protected:
     static wxList   sm_handlers;
+    static unsigned sm_maxThreads;
 
     // return the index of the point with the given coordinates or -1 if the
     // image is invalid of the coordinates are out of range
@@ -0,0 +1,74 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        wx/imagecache.h
+// Purpose:     wxImageCache class caching decoded images
+// Author:      agent
+// Created:     2026-10-17
+// RCS-ID:      $Id$
+// Copyright:   (c) 2026 agent <agent@local>
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _WX_IMAGECACHE_H_
+#define _WX_IMAGECACHE_H_
+
+#include "wx/defs.h"
+
+#if wxUSE_IMAGE
+
+class WXDLLIMPEXP_FWD_CORE wxImage;
+class WXDLLIMPEXP_FWD_BASE wxString;
+
+class wxImageCacheImpl;
+
+// ----------------------------------------------------------------------------
+// wxImageCache: LRU cache of decoded images limited by the memory they use
+// ----------------------------------------------------------------------------
+
+class WXDLLIMPEXP_CORE wxImageCache
+{
+public:
+    // create a cache using at most the given number of bytes for the images,
+    // a cache with 0 budget is disabled and never stores anything
+    wxEXPLICIT wxImageCache(size_t maxMemory = 0);
+    ~wxImageCache();
+
+    // return the global cache used by wxImage::LoadFile(), it is disabled by
+    // default and must be enabled by calling SetMaxMemory() on it
+    static wxImageCache& Get();
+
+    // change the memory budget, evicting the least recently used images if
+    // the cache now uses more than it
+    void SetMaxMemory(size_t maxMemory);
+    size_t GetMaxMemory() const;
+    bool IsEnabled() const { return GetMaxMemory() != 0; }
+
+    // return the memory currently used by the cached images and their number
+    size_t GetMemoryUsed() const;
+    size_t GetCount() const;
+
+    // find the image with the given key and return true and its copy, which
+    // can be freely modified, in image or return false if it's not cached
+    bool Lookup(const wxString& key, wxImage *image);
+
+    // store a copy of the image under the given key replacing the previously
+    // stored image, if any; returns false if the image doesn't fit the budget
+    bool Store(const wxString& key, const wxImage& image);
+
+    // remove the image with the given key or all of them
+    bool Remove(const wxString& key);
+    void Clear();
+
+    // statistics: the number of successful and failed Lookup() calls
+    unsigned long GetHits() const;
+    unsigned long GetMisses() const;
+    void ResetStatistics();
+
+private:
+    wxImageCacheImpl *m_impl;
+
+    wxDECLARE_NO_COPY_CLASS(wxImageCache);
+};
+
+#endif // wxUSE_IMAGE
+
+#endif // _WX_IMAGECACHE_H_
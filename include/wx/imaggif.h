@@ -11,6 +11,7 @@
 #define _WX_IMAGGIF_H_
 
 #include "wx/image.h"
+#include "wx/thread.h"
 
 
 //-----------------------------------------------------------------------------
@@ -42,6 +43,9 @@ public:
                           bool verbose = true, int index = -1);
     virtual bool SaveFile(wxImage *image, wxOutputStream& stream,
                           bool verbose=true);
+    virtual wxImageIncrementalDecoder *
+    CreateIncrementalDecoder(wxImageDecodeCallback& callback,
+                             bool verbose = true);
 
     // Save animated gif
     bool SaveAnimation(const wxImageArray& images, wxOutputStream *stream,
@@ -73,6 +77,10 @@ protected:
       m_crntShiftState;    /* Number of bits in CrntShiftDWord. */
     wxUint8 m_LZBuf[256];   /* Compressed input is buffered here. */
 
+    // the members above are only used while saving, so saving is serialized
+    // while loading doesn't use any state and can be done concurrently
+    wxCRIT_SECT_DECLARE_MEMBER(m_csSave);
+
     bool InitHashTable();
     void ClearHashTable();
     void InsertHashTable(unsigned long key, int code);
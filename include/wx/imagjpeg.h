@@ -21,6 +21,10 @@
 #include "wx/image.h"
 #include "wx/versioninfo.h"
 
+// if this option is set to non-zero value, the image is decoded using faster
+// but less precise algorithms
+#define wxIMAGE_OPTION_JPEG_FAST_DECODE  wxT("JpegFastDecode")
+
 class WXDLLIMPEXP_CORE wxJPEGHandler: public wxImageHandler
 {
 public:
@@ -39,6 +43,10 @@ public:
 #if wxUSE_STREAMS
     virtual bool LoadFile( wxImage *image, wxInputStream& stream, bool verbose=true, int index=-1 );
     virtual bool SaveFile( wxImage *image, wxOutputStream& stream, bool verbose=true );
+    virtual bool LoadRows( wxImage *image, wxImageRowSink& sink,
+                           wxInputStream& stream,
+                           bool verbose=true, int index=-1 );
+    virtual bool CanLoadRows() const { return true; }
 protected:
     virtual bool DoCanRead( wxInputStream& stream );
 #endif
@@ -53,6 +53,13 @@ public:
 #if wxUSE_STREAMS
     virtual bool LoadFile( wxImage *image, wxInputStream& stream, bool verbose=true, int index=-1 );
     virtual bool SaveFile( wxImage *image, wxOutputStream& stream, bool verbose=true );
+    virtual bool LoadRows( wxImage *image, wxImageRowSink& sink,
+                           wxInputStream& stream,
+                           bool verbose=true, int index=-1 );
+    virtual bool CanLoadRows() const { return true; }
+    virtual wxImageIncrementalDecoder *
+    CreateIncrementalDecoder(wxImageDecodeCallback& callback,
+                             bool verbose = true);
 protected:
     virtual bool DoCanRead( wxInputStream& stream );
 #endif
@@ -44,6 +44,10 @@ public:
 #if wxUSE_STREAMS
     virtual bool LoadFile( wxImage *image, wxInputStream& stream, bool verbose=true, int index=-1 );
     virtual bool SaveFile( wxImage *image, wxOutputStream& stream, bool verbose=true );
+    virtual bool LoadRows( wxImage *image, wxImageRowSink& sink,
+                           wxInputStream& stream,
+                           bool verbose=true, int index=-1 );
+    virtual bool CanLoadRows() const { return true; }
 
 protected:
     virtual int DoGetImageCount( wxInputStream& stream );
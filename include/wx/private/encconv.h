@@ -0,0 +1,23 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        wx/private/encconv.h
+// Purpose:     Private access to the single byte encoding tables
+// Author:      agent
+// Created:     2026-10-17
+// RCS-ID:      $Id$
+// Copyright:   (c) 2026 agent <agent@local>
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef _WX_PRIVATE_ENCCONV_H_
+#define _WX_PRIVATE_ENCCONV_H_
+
+#include "wx/fontenc.h"
+
+// returns the table giving the Unicode values of the characters 128..255 of
+// the given single byte encoding or NULL if it's not supported
+//
+// this is defined in encconv.cpp and used by the table-driven converter in
+// strconv.cpp
+extern const wxUint16 *wxGetEncodingTable(wxFontEncoding enc);
+
+#endif // _WX_PRIVATE_ENCCONV_H_
@@ -20,7 +20,17 @@ enum wxFDIODispatcherEntryFlags
     wxFDIO_INPUT = 1,
     wxFDIO_OUTPUT = 2,
     wxFDIO_EXCEPTION = 4,
-    wxFDIO_ALL = wxFDIO_INPUT | wxFDIO_OUTPUT | wxFDIO_EXCEPTION
+    wxFDIO_ALL = wxFDIO_INPUT | wxFDIO_OUTPUT | wxFDIO_EXCEPTION,
+
+    // this flag can be combined with the ones above to request notifications
+    // only when the descriptor state changes, i.e. the handler must consume
+    // all the available input or fill the output buffer until EAGAIN before
+    // it is notified again, and all of its OnXXXWaiting() methods for which
+    // the descriptor is ready are called in a row, so it must not be deleted
+    // from any of them; only wxEpollDispatcher supports this flag and the
+    // other dispatchers simply ignore it, which is safe as such a handler
+    // works with level-triggered notifications as well
+    wxFDIO_EDGE_TRIGGERED = 8
 };
 
 // base class for wxSelectDispatcher and wxEpollDispatcher
@@ -0,0 +1,38 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        wx/private/imageband.h
+// Purpose:     wxImageBandProcessor for processing images using several threads
+// Author:      agent
+// Created:     2026-10-16
+// RCS-ID:      $Id$
+// Copyright:   (c) 2026 agent <agent@local>
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef _WX_PRIVATE_IMAGEBAND_H_
+#define _WX_PRIVATE_IMAGEBAND_H_
+
+#include "wx/defs.h"
+
+// Base class for the operations which can be applied independently to the
+// different parts, or bands, of the image, e.g. to its rows.
+class wxImageBandProcessor
+{
+public:
+    // process all the numItems items, possibly using several threads if
+    // allowed by wxImage::SetMaxThreads() and if the amount of work, given by
+    // the number of pixels processed for each item, is big enough
+    void Process(int numItems, int pixelsPerItem);
+
+protected:
+    virtual ~wxImageBandProcessor() { }
+
+    // process the items [from, to): this is called from several threads at
+    // once for non-overlapping ranges, so it can write only the data related
+    // to the items in this range and must always produce the same result as
+    // if all the items were processed at once
+    virtual void ProcessBand(int from, int to) = 0;
+
+    friend class wxImageBandTask;
+};
+
+#endif // _WX_PRIVATE_IMAGEBAND_H_
@@ -0,0 +1,765 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        wx/private/pixelops.h
+// Purpose:     Kernels processing rows of pixels, vectorized when possible
+// Author:      agent
+// Created:     2026-10-16
+// RCS-ID:      $Id$
+// Copyright:   (c) 2026 agent <agent@local>
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef _WX_PRIVATE_PIXELOPS_H_
+#define _WX_PRIVATE_PIXELOPS_H_
+
+#include "wx/private/simd.h"
+
+// Each of the kernels below has a scalar version, which is always available
+// and defines the result, and may have a vectorized one which must produce
+// exactly the same output and is used instead of it if the CPU supports it.
+
+namespace wxPixelOps
+{
+
+// ----------------------------------------------------------------------------
+// helpers
+// ----------------------------------------------------------------------------
+
+// return x/255 rounded to the nearest integer for x in 0..255*255 range
+inline unsigned Div255(unsigned x)
+{
+    x += 128;
+    return (x + (x >> 8)) >> 8;
+}
+
+// return data*alpha/255 rounded down, which is exactly what this expression
+// computes for all 8 bit values, without using the much slower division
+inline unsigned Premultiply(unsigned alpha, unsigned data)
+{
+    const unsigned n = data * alpha;
+    return (n + 1 + (n >> 8)) >> 8;
+}
+
+// return a pixel in CAIRO_FORMAT_ARGB32 format, i.e. a 32-bit quantity with
+// alpha in the upper 8 bits, then red, then green, then blue, from the
+// non-premultiplied components
+inline wxUint32
+PremultipliedARGB(wxUint32 alpha, wxUint32 r, wxUint32 g, wxUint32 b)
+{
+    // handle the most common cases of fully opaque and transparent pixels
+    // specially
+    if ( alpha == 255 )
+        return 0xff000000 | r << 16 | g << 8 | b;
+
+    if ( alpha == 0 )
+        return 0;
+
+    return alpha                  << 24 |
+           Premultiply(alpha, r)  << 16 |
+           Premultiply(alpha, g)  <<  8 |
+           Premultiply(alpha, b);
+}
+
+// Undoes the pre-multiplication of the components of the pixels with the
+// given alpha: this computes data*255/alpha rounded down using a
+// multiplication by the factor which only needs to be recomputed when alpha
+// changes, which is rare in practice, instead of dividing each component.
+class Unpremultiplier
+{
+public:
+    Unpremultiplier() : m_alpha(255), m_factor(0) { }
+
+    void SetAlpha(wxUint32 alpha)
+    {
+        if ( alpha != m_alpha )
+        {
+            m_alpha = alpha;
+            if ( alpha != 255 && alpha != 0 )
+                m_factor = (255*65536 + alpha - 1) / alpha;
+        }
+    }
+
+    unsigned char operator()(wxUint32 data) const
+    {
+        // the transparent pixels are left unchanged for compatibility
+        if ( m_alpha == 255 || m_alpha == 0 )
+            return data;
+
+        return (data * m_factor) >> 16;
+    }
+
+private:
+    wxUint32 m_alpha,
+             m_factor;
+};
+
+#ifdef wxHAS_SSE2
+
+// Div255() for 8 16-bit values
+inline __m128i Div255(__m128i x)
+{
+    x = _mm_add_epi16(x, _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+}
+
+// Premultiply() for 8 16-bit values
+inline __m128i Premultiply(__m128i alpha, __m128i data)
+{
+    const __m128i n = _mm_mullo_epi16(data, alpha);
+    return _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(n, _mm_set1_epi16(1)),
+                                        _mm_srli_epi16(n, 8)),
+                          8);
+}
+
+// replicate the 16-bit value in the lane 3 of each half of the vector, which
+// is the alpha of the pixel in ARGB32 format, to all the lanes of this half
+inline __m128i BroadcastAlpha(__m128i pixels)
+{
+    return _mm_shufflehi_epi16(_mm_shufflelo_epi16(pixels, 0xff), 0xff);
+}
+
+// return true if all bytes of the vector are either 0 or 255
+inline bool AreAllOpaqueOrTransparent(__m128i v)
+{
+    const __m128i extreme = _mm_or_si128(
+                                _mm_cmpeq_epi8(v, _mm_setzero_si128()),
+                                _mm_cmpeq_epi8(v, _mm_set1_epi8(-1)));
+    return _mm_movemask_epi8(extreme) == 0xffff;
+}
+
+#endif // wxHAS_SSE2
+
+#ifdef wxHAS_SSSE3_DISPATCH
+
+// load 16 pixels in RGB format into 4 vectors containing 4 pixels each in
+// the low 3 bytes of their 32-bit lanes in ARGB32 format with 0 alpha
+wxSSSE3_TARGET inline void LoadRGBAsARGB(const unsigned char *rgb,
+                                         __m128i pixels[4])
+{
+    const __m128i shuffle = _mm_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1,
+                                          8, 7, 6, -1, 11, 10, 9, -1);
+
+    const __m128i v0 = _mm_loadu_si128((const __m128i *)rgb),
+                  v1 = _mm_loadu_si128((const __m128i *)(rgb + 16)),
+                  v2 = _mm_loadu_si128((const __m128i *)(rgb + 32));
+
+    pixels[0] = _mm_shuffle_epi8(v0, shuffle);
+    pixels[1] = _mm_shuffle_epi8(_mm_alignr_epi8(v1, v0, 12), shuffle);
+    pixels[2] = _mm_shuffle_epi8(_mm_alignr_epi8(v2, v1, 8), shuffle);
+    pixels[3] = _mm_shuffle_epi8(_mm_srli_si128(v2, 4), shuffle);
+}
+
+// return the vector with each of the alpha values repeated 3 times, as needed
+// for processing RGB data, for the n-th third of 16 RGB pixels
+wxSSSE3_TARGET inline __m128i ExpandAlphaToRGB(__m128i alpha, int n)
+{
+    switch ( n )
+    {
+        case 0:
+            return _mm_shuffle_epi8(alpha,
+                        _mm_setr_epi8(0, 0, 0, 1, 1, 1, 2, 2,
+                                      2, 3, 3, 3, 4, 4, 4, 5));
+        case 1:
+            return _mm_shuffle_epi8(alpha,
+                        _mm_setr_epi8(5, 5, 6, 6, 6, 7, 7, 7,
+                                      8, 8, 8, 9, 9, 9, 10, 10));
+    }
+
+    return _mm_shuffle_epi8(alpha,
+                _mm_setr_epi8(10, 11, 11, 11, 12, 12, 12, 13,
+                              13, 13, 14, 14, 14, 15, 15, 15));
+}
+
+#endif // wxHAS_SSSE3_DISPATCH
+
+// ----------------------------------------------------------------------------
+// RGBToARGB: convert wxImage data to CAIRO_FORMAT_ARGB32, pre-multiplying it,
+//            if alpha is not NULL, or to CAIRO_FORMAT_RGB24 otherwise
+// ----------------------------------------------------------------------------
+
+inline void RGBToARGBScalar(wxUint32 *dst,
+                            const unsigned char *rgb,
+                            const unsigned char *alpha,
+                            int count)
+{
+    if ( alpha )
+    {
+        for ( int x = 0; x < count; x++, rgb += 3 )
+            *dst++ = PremultipliedARGB(*alpha++, rgb[0], rgb[1], rgb[2]);
+    }
+    else
+    {
+        for ( int x = 0; x < count; x++, rgb += 3 )
+            *dst++ = rgb[0] << 16 | rgb[1] << 8 | rgb[2];
+    }
+}
+
+#ifdef wxHAS_SSSE3_DISPATCH
+
+wxSSSE3_TARGET inline void RGBToARGBSSSE3(wxUint32 *dst,
+                                          const unsigned char *rgb,
+                                          const unsigned char *alpha,
+                                          int count)
+{
+    const __m128i zero = _mm_setzero_si128();
+
+    // put the alpha values of 4 pixels in the upper bytes of 32-bit lanes
+    const __m128i placeAlpha[4] =
+    {
+        _mm_setr_epi8(-1, -1, -1, 0, -1, -1, -1, 1,
+                      -1, -1, -1, 2, -1, -1, -1, 3),
+        _mm_setr_epi8(-1, -1, -1, 4, -1, -1, -1, 5,
+                      -1, -1, -1, 6, -1, -1, -1, 7),
+        _mm_setr_epi8(-1, -1, -1, 8, -1, -1, -1, 9,
+                      -1, -1, -1, 10, -1, -1, -1, 11),
+        _mm_setr_epi8(-1, -1, -1, 12, -1, -1, -1, 13,
+                      -1, -1, -1, 14, -1, -1, -1, 15)
+    };
+
+    int x = 0;
+    for ( ; x + 16 <= count; x += 16, rgb += 48 )
+    {
+        __m128i pixels[4];
+        LoadRGBAsARGB(rgb, pixels);
+
+        if ( alpha )
+        {
+            const __m128i a = _mm_loadu_si128((const __m128i *)(alpha + x));
+            for ( int n = 0; n < 4; n++ )
+            {
+                const __m128i placed = _mm_shuffle_epi8(a, placeAlpha[n]);
+
+                const __m128i
+                    lo = Premultiply(
+                            BroadcastAlpha(_mm_unpacklo_epi8(placed, zero)),
+                            _mm_unpacklo_epi8(pixels[n], zero)),
+                    hi = Premultiply(
+                            BroadcastAlpha(_mm_unpackhi_epi8(placed, zero)),
+                            _mm_unpackhi_epi8(pixels[n], zero));
+
+                pixels[n] = _mm_or_si128(_mm_packus_epi16(lo, hi), placed);
+            }
+        }
+
+        for ( int n = 0; n < 4; n++ )
+            _mm_storeu_si128((__m128i *)(dst + x + 4*n), pixels[n]);
+    }
+
+    RGBToARGBScalar(dst + x, rgb, alpha ? alpha + x : NULL, count - x);
+}
+
+#endif // wxHAS_SSSE3_DISPATCH
+
+inline void RGBToARGB(wxUint32 *dst,
+                      const unsigned char *rgb,
+                      const unsigned char *alpha,
+                      int count)
+{
+#ifdef wxHAS_SSSE3_DISPATCH
+    if ( wxCPUHasSSSE3() )
+    {
+        RGBToARGBSSSE3(dst, rgb, alpha, count);
+        return;
+    }
+#endif // wxHAS_SSSE3_DISPATCH
+
+    RGBToARGBScalar(dst, rgb, alpha, count);
+}
+
+// ----------------------------------------------------------------------------
+// PixelsToARGB: convert non-premultiplied 32bpp pixels with the channels in
+//               the given order to pre-multiplied CAIRO_FORMAT_ARGB32
+// ----------------------------------------------------------------------------
+
+template <int R, int G, int B, int A>
+inline void PixelsToARGBScalar(wxUint32 *dst,
+                               const unsigned char *src,
+                               int count)
+{
+    for ( int x = 0; x < count; x++, src += 4 )
+        *dst++ = PremultipliedARGB(src[A], src[R], src[G], src[B]);
+}
+
+#ifdef wxHAS_SSE2
+
+template <int R, int G, int B, int A>
+inline void PixelsToARGBSSE2(wxUint32 *dst,
+                             const unsigned char *src,
+                             int count)
+{
+    const __m128i zero = _mm_setzero_si128();
+
+    // alpha itself is multiplied by 255 which leaves it unchanged
+    const __m128i keepColour = _mm_setr_epi16(-1, -1, -1, 0, -1, -1, -1, 0),
+                  opaque = _mm_setr_epi16(0, 0, 0, 255, 0, 0, 0, 255);
+
+    int x = 0;
+    for ( ; x + 4 <= count; x += 4, src += 16 )
+    {
+        const __m128i v = _mm_loadu_si128((const __m128i *)src);
+
+        __m128i lo = _mm_unpacklo_epi8(v, zero),
+                hi = _mm_unpackhi_epi8(v, zero);
+
+        // put the channels in ARGB32 order
+        lo = _mm_shufflehi_epi16(_mm_shufflelo_epi16(lo, _MM_SHUFFLE(A, R, G, B)),
+                                 _MM_SHUFFLE(A, R, G, B));
+        hi = _mm_shufflehi_epi16(_mm_shufflelo_epi16(hi, _MM_SHUFFLE(A, R, G, B)),
+                                 _MM_SHUFFLE(A, R, G, B));
+
+        lo = Premultiply(_mm_or_si128(_mm_and_si128(BroadcastAlpha(lo),
+                                                    keepColour),
+                                      opaque),
+                         lo);
+        hi = Premultiply(_mm_or_si128(_mm_and_si128(BroadcastAlpha(hi),
+                                                    keepColour),
+                                      opaque),
+                         hi);
+
+        _mm_storeu_si128((__m128i *)(dst + x), _mm_packus_epi16(lo, hi));
+    }
+
+    PixelsToARGBScalar<R, G, B, A>(dst + x, src, count - x);
+}
+
+#endif // wxHAS_SSE2
+
+template <int R, int G, int B, int A>
+inline void PixelsToARGB(wxUint32 *dst, const unsigned char *src, int count)
+{
+#ifdef wxHAS_SSE2
+    PixelsToARGBSSE2<R, G, B, A>(dst, src, count);
+#else
+    PixelsToARGBScalar<R, G, B, A>(dst, src, count);
+#endif
+}
+
+// ----------------------------------------------------------------------------
+// ARGBToRGB: convert CAIRO_FORMAT_ARGB32 data to wxImage undoing the
+//            pre-multiplication if alpha is not NULL or CAIRO_FORMAT_RGB24
+//            data otherwise
+// ----------------------------------------------------------------------------
+
+inline void ARGBToRGBScalar(unsigned char *rgb,
+                            unsigned char *alpha,
+                            const wxUint32 *src,
+                            int count)
+{
+    if ( alpha )
+    {
+        Unpremultiplier unpremultiply;
+        for ( int x = 0; x < count; x++ )
+        {
+            const wxUint32 argb = *src++;
+
+            *alpha++ = (argb & 0xff000000) >> 24;
+
+            unpremultiply.SetAlpha(argb >> 24);
+            *rgb++ = unpremultiply((argb & 0x00ff0000) >> 16);
+            *rgb++ = unpremultiply((argb & 0x0000ff00) >>  8);
+            *rgb++ = unpremultiply((argb & 0x000000ff));
+        }
+    }
+    else
+    {
+        for ( int x = 0; x < count; x++ )
+        {
+            const wxUint32 argb = *src++;
+
+            *rgb++ = (argb & 0x00ff0000) >> 16;
+            *rgb++ = (argb & 0x0000ff00) >>  8;
+            *rgb++ = (argb & 0x000000ff);
+        }
+    }
+}
+
+#ifdef wxHAS_SSSE3_DISPATCH
+
+wxSSSE3_TARGET inline void ARGBToRGBSSSE3(unsigned char *rgb,
+                                          unsigned char *alpha,
+                                          const wxUint32 *src,
+                                          int count)
+{
+    const __m128i shuffleRGB = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9,
+                                             8, 14, 13, 12, -1, -1, -1, -1),
+                  shuffleAlpha = _mm_setr_epi8(3, 7, 11, 15, -1, -1, -1, -1,
+                                               -1, -1, -1, -1, -1, -1, -1, -1);
+
+    int x = 0;
+    for ( ; x + 16 <= count; x += 16, src += 16, rgb += 48 )
+    {
+        __m128i pixels[4];
+        for ( int n = 0; n < 4; n++ )
+            pixels[n] = _mm_loadu_si128((const __m128i *)(src + 4*n));
+
+        if ( alpha )
+        {
+            const __m128i
+                a = _mm_or_si128(
+                        _mm_or_si128(
+                            _mm_shuffle_epi8(pixels[0], shuffleAlpha),
+                            _mm_slli_si128(_mm_shuffle_epi8(pixels[1],
+                                                            shuffleAlpha), 4)),
+                        _mm_or_si128(
+                            _mm_slli_si128(_mm_shuffle_epi8(pixels[2],
+                                                            shuffleAlpha), 8),
+                            _mm_slli_si128(_mm_shuffle_epi8(pixels[3],
+                                                            shuffleAlpha), 12)));
+
+            // only the fully opaque and transparent pixels, which are by far
+            // the most common ones, can be copied without changing them
+            if ( !AreAllOpaqueOrTransparent(a) )
+            {
+                ARGBToRGBScalar(rgb, alpha + x, src, 16);
+                continue;
+            }
+
+            _mm_storeu_si128((__m128i *)(alpha + x), a);
+        }
+
+        for ( int n = 0; n < 4; n++ )
+            pixels[n] = _mm_shuffle_epi8(pixels[n], shuffleRGB);
+
+        _mm_storeu_si128((__m128i *)rgb,
+                         _mm_or_si128(pixels[0],
+                                      _mm_slli_si128(pixels[1], 12)));
+        _mm_storeu_si128((__m128i *)(rgb + 16),
+                         _mm_or_si128(_mm_srli_si128(pixels[1], 4),
+                                      _mm_slli_si128(pixels[2], 8)));
+        _mm_storeu_si128((__m128i *)(rgb + 32),
+                         _mm_or_si128(_mm_srli_si128(pixels[2], 8),
+                                      _mm_slli_si128(pixels[3], 4)));
+    }
+
+    ARGBToRGBScalar(rgb, alpha ? alpha + x : NULL, src, count - x);
+}
+
+#endif // wxHAS_SSSE3_DISPATCH
+
+inline void ARGBToRGB(unsigned char *rgb,
+                      unsigned char *alpha,
+                      const wxUint32 *src,
+                      int count)
+{
+#ifdef wxHAS_SSSE3_DISPATCH
+    if ( wxCPUHasSSSE3() )
+    {
+        ARGBToRGBSSSE3(rgb, alpha, src, count);
+        return;
+    }
+#endif // wxHAS_SSSE3_DISPATCH
+
+    ARGBToRGBScalar(rgb, alpha, src, count);
+}
+
+// ----------------------------------------------------------------------------
+// BlendOver: compose the source RGB pixels with alpha over the destination
+//            ones, which are opaque if dstAlpha is NULL
+// ----------------------------------------------------------------------------
+
+inline void BlendOverScalar(unsigned char *dst,
+                            unsigned char *dstAlpha,
+                            const unsigned char *src,
+                            const unsigned char *srcAlpha,
+                            int count)
+{
+    for ( int x = 0; x < count; x++, dst += 3, src += 3 )
+    {
+        const unsigned a = srcAlpha[x];
+
+        // fully transparent source pixels don't change anything
+        if ( !a )
+            continue;
+
+        const unsigned b = dstAlpha ? dstAlpha[x] : 255;
+        if ( b == 255 )
+        {
+            // the result remains opaque in the most common case of opaque
+            // destination, this also works for opaque source pixels
+            for ( int n = 0; n < 3; n++ )
+                dst[n] = Div255(src[n]*a + dst[n]*(255 - a));
+
+            continue;
+        }
+
+        const unsigned bWeight = b*(255 - a),
+                       resultAlpha = a + Div255(bWeight),
+                       denominator = 255*resultAlpha;
+        for ( int n = 0; n < 3; n++ )
+        {
+            const unsigned value = (255*a*src[n] + bWeight*dst[n] +
+                                        denominator/2) / denominator;
+            dst[n] = value > 255 ? 255 : value;
+        }
+
+        dstAlpha[x] = resultAlpha;
+    }
+}
+
+#ifdef wxHAS_SSSE3_DISPATCH
+
+wxSSSE3_TARGET inline void BlendOverSSSE3(unsigned char *dst,
+                                          unsigned char *dstAlpha,
+                                          const unsigned char *src,
+                                          const unsigned char *srcAlpha,
+                                          int count)
+{
+    const __m128i zero = _mm_setzero_si128(),
+                  all255 = _mm_set1_epi16(255);
+
+    int x = 0;
+    for ( ; x + 16 <= count; x += 16, dst += 48, src += 48 )
+    {
+        const __m128i a = _mm_loadu_si128((const __m128i *)(srcAlpha + x));
+
+        // the vectorized version only handles opaque destination pixels
+        if ( dstAlpha )
+        {
+            const __m128i b = _mm_loadu_si128((const __m128i *)(dstAlpha + x));
+            if ( _mm_movemask_epi8(_mm_cmpeq_epi8(b, _mm_set1_epi8(-1)))
+                    != 0xffff )
+            {
+                BlendOverScalar(dst, dstAlpha + x, src, srcAlpha + x, 16);
+                continue;
+            }
+        }
+
+        // nothing to do if the source pixels are all transparent
+        if ( _mm_movemask_epi8(_mm_cmpeq_epi8(a, zero)) == 0xffff )
+            continue;
+
+        for ( int n = 0; n < 3; n++ )
+        {
+            const __m128i s = _mm_loadu_si128((const __m128i *)(src + 16*n)),
+                          d = _mm_loadu_si128((const __m128i *)(dst + 16*n)),
+                          e = ExpandAlphaToRGB(a, n);
+
+            const __m128i aLo = _mm_unpacklo_epi8(e, zero),
+                          aHi = _mm_unpackhi_epi8(e, zero);
+
+            const __m128i
+                lo = Div255(_mm_add_epi16(
+                        _mm_mullo_epi16(_mm_unpacklo_epi8(s, zero), aLo),
+                        _mm_mullo_epi16(_mm_unpacklo_epi8(d, zero),
+                                        _mm_sub_epi16(all255, aLo)))),
+                hi = Div255(_mm_add_epi16(
+                        _mm_mullo_epi16(_mm_unpackhi_epi8(s, zero), aHi),
+                        _mm_mullo_epi16(_mm_unpackhi_epi8(d, zero),
+                                        _mm_sub_epi16(all255, aHi))));
+
+            _mm_storeu_si128((__m128i *)(dst + 16*n),
+                             _mm_packus_epi16(lo, hi));
+        }
+    }
+
+    BlendOverScalar(dst, dstAlpha ? dstAlpha + x : NULL,
+                    src, srcAlpha + x, count - x);
+}
+
+#endif // wxHAS_SSSE3_DISPATCH
+
+inline void BlendOver(unsigned char *dst,
+                      unsigned char *dstAlpha,
+                      const unsigned char *src,
+                      const unsigned char *srcAlpha,
+                      int count)
+{
+#ifdef wxHAS_SSSE3_DISPATCH
+    if ( wxCPUHasSSSE3() )
+    {
+        BlendOverSSSE3(dst, dstAlpha, src, srcAlpha, count);
+        return;
+    }
+#endif // wxHAS_SSSE3_DISPATCH
+
+    BlendOverScalar(dst, dstAlpha, src, srcAlpha, count);
+}
+
+// ----------------------------------------------------------------------------
+// AlphaToMask: replace the pixels with alpha less than threshold with the
+//              given mask colour
+// ----------------------------------------------------------------------------
+
+inline void AlphaToMaskScalar(unsigned char *rgb,
+                              const unsigned char *alpha,
+                              int count,
+                              unsigned char threshold,
+                              unsigned char r,
+                              unsigned char g,
+                              unsigned char b)
+{
+    for ( int x = 0; x < count; x++, rgb += 3 )
+    {
+        if ( alpha[x] < threshold )
+        {
+            rgb[0] = r;
+            rgb[1] = g;
+            rgb[2] = b;
+        }
+    }
+}
+
+#ifdef wxHAS_SSE2
+
+inline void AlphaToMaskSSE2(unsigned char *rgb,
+                            const unsigned char *alpha,
+                            int count,
+                            unsigned char threshold,
+                            unsigned char r,
+                            unsigned char g,
+                            unsigned char b)
+{
+    const __m128i t = _mm_set1_epi8((char)threshold);
+
+    // most pixels are usually above the threshold, so just skip over them
+    int x = 0;
+    for ( ; x + 16 <= count; x += 16, rgb += 48 )
+    {
+        const __m128i a = _mm_loadu_si128((const __m128i *)(alpha + x));
+        if ( _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(a, t), a))
+                != 0xffff )
+        {
+            AlphaToMaskScalar(rgb, alpha + x, 16, threshold, r, g, b);
+        }
+    }
+
+    AlphaToMaskScalar(rgb, alpha + x, count - x, threshold, r, g, b);
+}
+
+#endif // wxHAS_SSE2
+
+inline void AlphaToMask(unsigned char *rgb,
+                        const unsigned char *alpha,
+                        int count,
+                        unsigned char threshold,
+                        unsigned char r,
+                        unsigned char g,
+                        unsigned char b)
+{
+#ifdef wxHAS_SSE2
+    AlphaToMaskSSE2(rgb, alpha, count, threshold, r, g, b);
+#else
+    AlphaToMaskScalar(rgb, alpha, count, threshold, r, g, b);
+#endif
+}
+
+// ----------------------------------------------------------------------------
+// MaskToAlpha: make the pixels of the given mask colour transparent and all
+//              the other ones opaque
+// ----------------------------------------------------------------------------
+
+inline void MaskToAlphaScalar(unsigned char *alpha,
+                              const unsigned char *rgb,
+                              int count,
+                              unsigned char r,
+                              unsigned char g,
+                              unsigned char b)
+{
+    for ( int x = 0; x < count; x++, rgb += 3 )
+        alpha[x] = rgb[0] == r && rgb[1] == g && rgb[2] == b ? 0 : 255;
+}
+
+#ifdef wxHAS_SSSE3_DISPATCH
+
+wxSSSE3_TARGET inline void MaskToAlphaSSSE3(unsigned char *alpha,
+                                            const unsigned char *rgb,
+                                            int count,
+                                            unsigned char r,
+                                            unsigned char g,
+                                            unsigned char b)
+{
+    const char cr = (char)r,
+               cg = (char)g,
+               cb = (char)b;
+
+    // the mask colour repeated with the phase of each of the 3 vectors
+    // containing 16 pixels
+    const __m128i
+        mask0 = _mm_setr_epi8(cr, cg, cb, cr, cg, cb, cr, cg,
+                              cb, cr, cg, cb, cr, cg, cb, cr),
+        mask1 = _mm_setr_epi8(cg, cb, cr, cg, cb, cr, cg, cb,
+                              cr, cg, cb, cr, cg, cb, cr, cg),
+        mask2 = _mm_setr_epi8(cb, cr, cg, cb, cr, cg, cb, cr,
+                              cg, cb, cr, cg, cb, cr, cg, cb);
+
+    // gather the comparison results for the given component of all pixels
+    // from the 3 vectors
+    const __m128i
+        gather0[3] =
+        {
+            _mm_setr_epi8(0, 3, 6, 9, 12, 15, -1, -1,
+                          -1, -1, -1, -1, -1, -1, -1, -1),
+            _mm_setr_epi8(1, 4, 7, 10, 13, -1, -1, -1,
+                          -1, -1, -1, -1, -1, -1, -1, -1),
+            _mm_setr_epi8(2, 5, 8, 11, 14, -1, -1, -1,
+                          -1, -1, -1, -1, -1, -1, -1, -1)
+        },
+        gather1[3] =
+        {
+            _mm_setr_epi8(-1, -1, -1, -1, -1, -1, 2, 5,
+                          8, 11, 14, -1, -1, -1, -1, -1),
+            _mm_setr_epi8(-1, -1, -1, -1, -1, 0, 3, 6,
+                          9, 12, 15, -1, -1, -1, -1, -1),
+            _mm_setr_epi8(-1, -1, -1, -1, -1, 1, 4, 7,
+                          10, 13, -1, -1, -1, -1, -1, -1)
+        },
+        gather2[3] =
+        {
+            _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1,
+                          -1, -1, -1, 1, 4, 7, 10, 13),
+            _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1,
+                          -1, -1, -1, 2, 5, 8, 11, 14),
+            _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1,
+                          -1, -1, 0, 3, 6, 9, 12, 15)
+        };
+
+    int x = 0;
+    for ( ; x + 16 <= count; x += 16, rgb += 48 )
+    {
+        const __m128i
+            eq0 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)rgb),
+                                 mask0),
+            eq1 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(rgb + 16)),
+                                 mask1),
+            eq2 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(rgb + 32)),
+                                 mask2);
+
+        __m128i eq = _mm_set1_epi8(-1);
+        for ( int n = 0; n < 3; n++ )
+        {
+            eq = _mm_and_si128(eq,
+                    _mm_or_si128(_mm_or_si128(
+                                    _mm_shuffle_epi8(eq0, gather0[n]),
+                                    _mm_shuffle_epi8(eq1, gather1[n])),
+                                 _mm_shuffle_epi8(eq2, gather2[n])));
+        }
+
+        _mm_storeu_si128((__m128i *)(alpha + x),
+                         _mm_andnot_si128(eq, _mm_set1_epi8(-1)));
+    }
+
+    MaskToAlphaScalar(alpha + x, rgb, count - x, r, g, b);
+}
+
+#endif // wxHAS_SSSE3_DISPATCH
+
+inline void MaskToAlpha(unsigned char *alpha,
+                        const unsigned char *rgb,
+                        int count,
+                        unsigned char r,
+                        unsigned char g,
+                        unsigned char b)
+{
+#ifdef wxHAS_SSSE3_DISPATCH
+    if ( wxCPUHasSSSE3() )
+    {
+        MaskToAlphaSSSE3(alpha, rgb, count, r, g, b);
+        return;
+    }
+#endif // wxHAS_SSSE3_DISPATCH
+
+    MaskToAlphaScalar(alpha, rgb, count, r, g, b);
+}
+
+} // namespace wxPixelOps
+
+#endif // _WX_PRIVATE_PIXELOPS_H_
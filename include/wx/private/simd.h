@@ -0,0 +1,72 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        wx/private/simd.h
+// Purpose:     Detection of the SIMD instruction sets usable by wx code
+// Author:      agent
+// Created:     2026-10-16
+// RCS-ID:      $Id$
+// Copyright:   (c) 2026 agent <agent@local>
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef _WX_PRIVATE_SIMD_H_
+#define _WX_PRIVATE_SIMD_H_
+
+#include "wx/defs.h"
+
+// The code using SIMD instructions must always have a scalar version too,
+// which is used when the instructions are not available and which defines
+// the expected result: the vectorized version must produce exactly the same
+// output.
+
+// SSE2 is always available when targeting x86-64 and can be enabled for x86
+#if defined(__SSE2__) || defined(_M_X64) || \
+        (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define wxHAS_SSE2
+    #include <emmintrin.h>
+#endif
+
+// SSSE3 is not part of the baseline, but these compilers allow using it in
+// the functions compiled specially for it, which are only called after
+// checking that the CPU supports it at run-time using wxCPUHasSSSE3()
+#ifdef wxHAS_SSE2
+    #if defined(__VISUALC__)
+        #define wxHAS_SSSE3_DISPATCH
+        #define wxSSSE3_TARGET
+        #include <intrin.h>
+        #include <tmmintrin.h>
+    #elif wxCHECK_GCC_VERSION(4, 9) || \
+            (defined(__clang__) && __clang_major__ >= 4)
+        #define wxHAS_SSSE3_DISPATCH
+        #define wxSSSE3_TARGET __attribute__((target("ssse3")))
+        #include <cpuid.h>
+        #include <tmmintrin.h>
+    #endif
+#endif // wxHAS_SSE2
+
+#ifdef wxHAS_SSSE3_DISPATCH
+
+// return true if the CPU supports SSSE3, this is only checked once
+inline bool wxCPUHasSSSE3()
+{
+    static int s_hasSSSE3 = -1;
+    if ( s_hasSSSE3 == -1 )
+    {
+#ifdef __VISUALC__
+        int info[4];
+        __cpuid(info, 1);
+        const unsigned ecx = info[2];
+#else
+        unsigned eax, ebx, ecx, edx;
+        if ( !__get_cpuid(1, &eax, &ebx, &ecx, &edx) )
+            ecx = 0;
+#endif
+
+        s_hasSSSE3 = (ecx & (1 << 9)) != 0;
+    }
+
+    return s_hasSSSE3 == 1;
+}
+
+#endif // wxHAS_SSSE3_DISPATCH
+
+#endif // _WX_PRIVATE_SIMD_H_
@@ -0,0 +1,791 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        wx/private/utf8ops.h
+// Purpose:     Kernels for UTF-8 validation and conversion, vectorized when
+//              possible
+// Author:      agent
+// Created:     2026-10-16
+// RCS-ID:      $Id$
+// Copyright:   (c) 2026 agent <agent@local>
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef _WX_PRIVATE_UTF8OPS_H_
+#define _WX_PRIVATE_UTF8OPS_H_
+
+#include "wx/private/simd.h"
+
+#include <string.h>
+
+namespace wxUtf8Ops
+{
+
+// ----------------------------------------------------------------------------
+// ASCII runs
+// ----------------------------------------------------------------------------
+
+// Most of the text processed in practice is either entirely ASCII or contains
+// long runs of ASCII characters, so the functions below, which handle such
+// runs, are used by the UTF-8 converters before falling back to the general
+// (and much slower) code processing the characters one by one.
+
+// copy at most count ASCII characters from src to dst, which may be NULL to
+// only count them, stopping at the first non-ASCII one and return the number
+// of characters processed
+inline size_t AsciiToWCharScalar(wchar_t *dst, const char *src, size_t count)
+{
+    size_t n;
+    for ( n = 0; n < count && !(src[n] & 0x80); n++ )
+    {
+        if ( dst )
+            dst[n] = (unsigned char)src[n];
+    }
+
+    return n;
+}
+
+// the reverse of AsciiToWCharScalar()
+inline size_t WCharToAsciiScalar(char *dst, const wchar_t *src, size_t count)
+{
+    size_t n;
+    for ( n = 0; n < count && (wxUint32)src[n] < 0x80; n++ )
+    {
+        if ( dst )
+            dst[n] = (char)src[n];
+    }
+
+    return n;
+}
+
+#ifdef wxHAS_SSE2
+
+inline size_t AsciiToWCharSSE2(wchar_t *dst, const char *src, size_t count)
+{
+    const __m128i zero = _mm_setzero_si128();
+
+    size_t n = 0;
+    for ( ; n + 16 <= count; n += 16 )
+    {
+        const __m128i v = _mm_loadu_si128((const __m128i *)(src + n));
+        if ( _mm_movemask_epi8(v) )
+            break;
+
+        if ( dst )
+        {
+            __m128i *out = (__m128i *)(dst + n);
+            const __m128i lo = _mm_unpacklo_epi8(v, zero),
+                          hi = _mm_unpackhi_epi8(v, zero);
+#if SIZEOF_WCHAR_T == 2
+            _mm_storeu_si128(out, lo);
+            _mm_storeu_si128(out + 1, hi);
+#else // 32 bit wchar_t
+            _mm_storeu_si128(out, _mm_unpacklo_epi16(lo, zero));
+            _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(lo, zero));
+            _mm_storeu_si128(out + 2, _mm_unpacklo_epi16(hi, zero));
+            _mm_storeu_si128(out + 3, _mm_unpackhi_epi16(hi, zero));
+#endif // 16/32 bit wchar_t
+        }
+    }
+
+    // handle the last few characters and the rest of the block containing
+    // the first non-ASCII one, if any
+    return n + AsciiToWCharScalar(dst ? dst + n : NULL, src + n, count - n);
+}
+
+inline size_t WCharToAsciiSSE2(char *dst, const wchar_t *src, size_t count)
+{
+    const __m128i zero = _mm_setzero_si128();
+
+    size_t n = 0;
+    for ( ; n + 16 <= count; n += 16 )
+    {
+        const __m128i *in = (const __m128i *)(src + n);
+#if SIZEOF_WCHAR_T == 2
+        const __m128i v0 = _mm_loadu_si128(in),
+                      v1 = _mm_loadu_si128(in + 1);
+        const __m128i nonAscii = _mm_and_si128(_mm_or_si128(v0, v1),
+                                               _mm_set1_epi16(-0x80));
+        if ( _mm_movemask_epi8(_mm_cmpeq_epi16(nonAscii, zero)) != 0xffff )
+            break;
+
+        if ( dst )
+            _mm_storeu_si128((__m128i *)(dst + n), _mm_packus_epi16(v0, v1));
+#else // 32 bit wchar_t
+        const __m128i v0 = _mm_loadu_si128(in),
+                      v1 = _mm_loadu_si128(in + 1),
+                      v2 = _mm_loadu_si128(in + 2),
+                      v3 = _mm_loadu_si128(in + 3);
+        const __m128i nonAscii = _mm_and_si128
+                                 (
+                                    _mm_or_si128(_mm_or_si128(v0, v1),
+                                                 _mm_or_si128(v2, v3)),
+                                    _mm_set1_epi32(-0x80)
+                                 );
+        if ( _mm_movemask_epi8(_mm_cmpeq_epi32(nonAscii, zero)) != 0xffff )
+            break;
+
+        if ( dst )
+        {
+            _mm_storeu_si128((__m128i *)(dst + n),
+                             _mm_packus_epi16(_mm_packs_epi32(v0, v1),
+                                              _mm_packs_epi32(v2, v3)));
+        }
+#endif // 16/32 bit wchar_t
+    }
+
+    return n + WCharToAsciiScalar(dst ? dst + n : NULL, src + n, count - n);
+}
+
+#endif // wxHAS_SSE2
+
+inline size_t AsciiToWChar(wchar_t *dst, const char *src, size_t count)
+{
+#ifdef wxHAS_SSE2
+    return AsciiToWCharSSE2(dst, src, count);
+#else
+    return AsciiToWCharScalar(dst, src, count);
+#endif
+}
+
+inline size_t WCharToAscii(char *dst, const wchar_t *src, size_t count)
+{
+#ifdef wxHAS_SSE2
+    return WCharToAsciiSSE2(dst, src, count);
+#else
+    return WCharToAsciiScalar(dst, src, count);
+#endif
+}
+
+// ----------------------------------------------------------------------------
+// validation
+// ----------------------------------------------------------------------------
+
+//
+// Table 3.1B from Unicode spec: Legal UTF-8 Byte Sequences
+//
+//     Code Points    | 1st Byte | 2nd Byte | 3rd Byte | 4th Byte |
+// -------------------+----------+----------+----------+----------+
+//   U+0000..U+007F   |  00..7F  |          |          |          |
+//   U+0080..U+07FF   |  C2..DF  |  80..BF  |          |          |
+//   U+0800..U+0FFF   |  E0      |  A0..BF  |  80..BF  |          |
+//   U+1000..U+FFFF   |  E1..EF  |  80..BF  |  80..BF  |          |
+//  U+10000..U+3FFFF  |  F0      |  90..BF  |  80..BF  |  80..BF  |
+//  U+40000..U+FFFFF  |  F1..F3  |  80..BF  |  80..BF  |  80..BF  |
+// U+100000..U+10FFFF |  F4      |  80..8F  |  80..BF  |  80..BF  |
+// -------------------+----------+----------+----------+----------+
+
+// return true if the len bytes at str are valid UTF-8 as defined by RFC 3629,
+// i.e. don't contain any overlong sequences, surrogates or code points
+// greater than U+10FFFF (NUL characters are not treated specially)
+inline bool IsValidScalar(const char *str, size_t len)
+{
+    const unsigned char *c = (const unsigned char *)str;
+    const unsigned char * const end = c + len;
+
+    while ( c != end )
+    {
+        const unsigned char b = *c++;
+        if ( b <= 0x7F )
+            continue;
+
+        // number of the continuation bytes and the range of the valid values
+        // for the first of them, the other ones are always in 80..BF range
+        size_t n;
+        unsigned char lo = 0x80,
+                      hi = 0xBF;
+        if ( b < 0xC2 ) // invalid lead bytes: 80..C1
+            return false;
+        else if ( b <= 0xDF )
+            n = 1;
+        else if ( b <= 0xEF )
+        {
+            n = 2;
+            if ( b == 0xE0 )
+                lo = 0xA0;
+            else if ( b == 0xED )
+                hi = 0x9F;
+        }
+        else if ( b <= 0xF4 )
+        {
+            n = 3;
+            if ( b == 0xF0 )
+                lo = 0x90;
+            else if ( b == 0xF4 )
+                hi = 0x8F;
+        }
+        else // invalid lead bytes: F5..FF
+            return false;
+
+        if ( (size_t)(end - c) < n )
+            return false;
+
+        if ( *c < lo || *c > hi )
+            return false;
+
+        for ( c++; --n; c++ )
+        {
+            if ( (*c & 0xC0) != 0x80 )
+                return false;
+        }
+    }
+
+    return true;
+}
+
+#ifdef wxHAS_SSSE3_DISPATCH
+
+// This uses the algorithm from "Validating UTF-8 In Less Than One Instruction
+// Per Byte" by J. Keiser and D. Lemire: the errors in the 2 byte sequences are
+// found by looking up the bit masks of the errors possible for the high and
+// low nibbles of the first byte and the high nibble of the second one and
+// combining them, while the errors in the longer sequences are found by
+// checking that continuation bytes appear exactly where they must.
+namespace Private
+{
+
+enum
+{
+    TooShort    = 1 << 0,   // 11______ 0_______ or 11______ 11______
+    TooLong     = 1 << 1,   // 0_______ 10______
+    Overlong3   = 1 << 2,   // 11100000 100_____
+    TooLarge    = 1 << 3,   // 11110100 1001____ or 11110100 101_____ ...
+    Surrogate   = 1 << 4,   // 11101101 101_____
+    Overlong2   = 1 << 5,   // 1100000_ 10______
+    TooLarge1000= 1 << 6,   // 11110101 1000____ or 1111011_ 1000____ ...
+    Overlong4   = 1 << 6,   // 11110000 1000____
+    TwoConts    = 1 << 7,   // 10______ 10______
+    Carry       = TooShort | TooLong | TwoConts
+};
+
+struct ValidationState
+{
+    __m128i prev,               // the previous block
+            prevIncomplete,     // non-zero if it ended with incomplete char
+            error;              // non-zero if an error was found
+};
+
+wxSSSE3_TARGET inline void CheckBlock(ValidationState& state, __m128i input)
+{
+    if ( !_mm_movemask_epi8(input) )
+    {
+        // the block is entirely ASCII, so the only possible error is a
+        // sequence truncated at the end of the previous block
+        state.error = _mm_or_si128(state.error, state.prevIncomplete);
+        state.prevIncomplete = _mm_setzero_si128();
+        state.prev = input;
+        return;
+    }
+
+    const __m128i byte1HighTable = _mm_setr_epi8
+    (
+        // 0_______ ________
+        TooLong, TooLong, TooLong, TooLong,
+        TooLong, TooLong, TooLong, TooLong,
+        // 10______ ________
+        (char)TwoConts, (char)TwoConts, (char)TwoConts, (char)TwoConts,
+        // 1100____ ________
+        TooShort | Overlong2,
+        // 1101____ ________
+        TooShort,
+        // 1110____ ________
+        TooShort | Overlong3 | Surrogate,
+        // 1111____ ________
+        TooShort | TooLarge | TooLarge1000 | Overlong4
+    );
+
+    const __m128i byte1LowTable = _mm_setr_epi8
+    (
+        // ____0000 ________
+        (char)(Carry | Overlong3 | Overlong2 | Overlong4),
+        // ____0001 ________
+        (char)(Carry | Overlong2),
+        // ____001_ ________
+        (char)Carry,
+        (char)Carry,
+        // ____0100 ________
+        (char)(Carry | TooLarge),
+        // ____0101 ________ and ____011_ ________
+        (char)(Carry | TooLarge | TooLarge1000),
+        (char)(Carry | TooLarge | TooLarge1000),
+        (char)(Carry | TooLarge | TooLarge1000),
+        // ____1___ ________
+        (char)(Carry | TooLarge | TooLarge1000),
+        (char)(Carry | TooLarge | TooLarge1000),
+        (char)(Carry | TooLarge | TooLarge1000),
+        (char)(Carry | TooLarge | TooLarge1000),
+        (char)(Carry | TooLarge | TooLarge1000),
+        // ____1101 ________
+        (char)(Carry | TooLarge | TooLarge1000 | Surrogate),
+        (char)(Carry | TooLarge | TooLarge1000),
+        (char)(Carry | TooLarge | TooLarge1000)
+    );
+
+    const __m128i byte2HighTable = _mm_setr_epi8
+    (
+        // ________ 0_______
+        TooShort, TooShort, TooShort, TooShort,
+        TooShort, TooShort, TooShort, TooShort,
+        // ________ 1000____
+        (char)(TooLong | Overlong2 | TwoConts | Overlong3 | TooLarge1000 |
+               Overlong4),
+        // ________ 1001____
+        (char)(TooLong | Overlong2 | TwoConts | Overlong3 | TooLarge),
+        // ________ 101_____
+        (char)(TooLong | Overlong2 | TwoConts | Surrogate | TooLarge),
+        (char)(TooLong | Overlong2 | TwoConts | Surrogate | TooLarge),
+        // ________ 11______
+        TooShort, TooShort, TooShort, TooShort
+    );
+
+    const __m128i nibbleMask = _mm_set1_epi8(0x0f);
+
+    const __m128i prev1 = _mm_alignr_epi8(input, state.prev, 15);
+
+    const __m128i byte1High = _mm_shuffle_epi8(byte1HighTable,
+        _mm_and_si128(_mm_srli_epi16(prev1, 4), nibbleMask));
+    const __m128i byte1Low = _mm_shuffle_epi8(byte1LowTable,
+        _mm_and_si128(prev1, nibbleMask));
+    const __m128i byte2High = _mm_shuffle_epi8(byte2HighTable,
+        _mm_and_si128(_mm_srli_epi16(input, 4), nibbleMask));
+
+    const __m128i special = _mm_and_si128(_mm_and_si128(byte1High, byte1Low),
+                                          byte2High);
+
+    // the bytes which must be the 3rd byte of 3 or 4 byte sequence or the 4th
+    // byte of a 4 byte one: they must have been marked as TwoConts above
+    const __m128i prev2 = _mm_alignr_epi8(input, state.prev, 14),
+                  prev3 = _mm_alignr_epi8(input, state.prev, 13);
+    const __m128i must23 = _mm_or_si128
+                           (
+                                _mm_subs_epu8(prev2, _mm_set1_epi8((char)0xDF)),
+                                _mm_subs_epu8(prev3, _mm_set1_epi8((char)0xEF))
+                           );
+    const __m128i must23As80 = _mm_and_si128
+                               (
+                                    _mm_cmpgt_epi8(must23, _mm_setzero_si128()),
+                                    _mm_set1_epi8((char)TwoConts)
+                               );
+
+    state.error = _mm_or_si128(state.error,
+                               _mm_xor_si128(must23As80, special));
+
+    // the last 3 bytes of the block must not start a sequence longer than
+    // the number of the bytes remaining in it, remember if they do
+    const __m128i maxComplete = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1,
+                                              -1, -1, -1, -1, -1,
+                                              (char)0xEF,
+                                              (char)0xDF,
+                                              (char)0xBF);
+    state.prevIncomplete = _mm_subs_epu8(input, maxComplete);
+    state.prev = input;
+}
+
+} // namespace Private
+
+wxSSSE3_TARGET inline bool IsValidSSSE3(const char *str, size_t len)
+{
+    Private::ValidationState state;
+    state.prev =
+    state.prevIncomplete =
+    state.error = _mm_setzero_si128();
+
+    size_t n = 0;
+    for ( ; n + 16 <= len; n += 16 )
+    {
+        Private::CheckBlock(state,
+                            _mm_loadu_si128((const __m128i *)(str + n)));
+    }
+
+    // check the remaining bytes padded with NULs, which also detects any
+    // sequence truncated at the end of the string, even if there are none
+    char last[16] = { 0 };
+    memcpy(last, str + n, len - n);
+    Private::CheckBlock(state, _mm_loadu_si128((const __m128i *)last));
+
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(state.error,
+                                            _mm_setzero_si128())) == 0xffff;
+}
+
+#endif // wxHAS_SSSE3_DISPATCH
+
+inline bool IsValid(const char *str, size_t len)
+{
+#ifdef wxHAS_SSSE3_DISPATCH
+    if ( wxCPUHasSSSE3() )
+        return IsValidSSSE3(str, len);
+#endif
+
+    return IsValidScalar(str, len);
+}
+
+// ----------------------------------------------------------------------------
+// conversion of non-ASCII text
+// ----------------------------------------------------------------------------
+
+// The functions below convert the text in blocks of 16 bytes or 8 wchar_ts
+// for as long as they can and stop at the first block they can't handle,
+// leaving the rest of the string, including any errors in it, to the scalar
+// code of the caller. They always stop at a character boundary, return the
+// number of the input units consumed (0 if they couldn't do anything) and
+// the number of output units produced in the written parameter. If dst is
+// NULL, they only count the output units.
+
+#ifdef wxHAS_SSE2
+
+namespace Private
+{
+
+// decode 8 characters of at most 3 bytes each, given as 16 bit values of the
+// bytes starting at their positions in the block, and return their code
+// points: the values corresponding to the continuation bytes are meaningless
+inline __m128i DecodeUpTo3(__m128i c0, __m128i c1, __m128i c2)
+{
+    const __m128i mask3F = _mm_set1_epi16(0x3f);
+    const __m128i t1 = _mm_and_si128(c1, mask3F),
+                  t2 = _mm_and_si128(c2, mask3F);
+
+    // 110xxxxx 10yyyyyy
+    const __m128i v2 = _mm_or_si128
+                       (
+                            _mm_slli_epi16(_mm_and_si128(c0, _mm_set1_epi16(0x1f)), 6),
+                            t1
+                       );
+
+    // 1110xxxx 10yyyyyy 10zzzzzz: notice that shifting the lead byte left by
+    // 12 bits already discards its marker bits
+    const __m128i v3 = _mm_or_si128
+                       (
+                            _mm_or_si128(_mm_slli_epi16(c0, 12),
+                                         _mm_slli_epi16(t1, 6)),
+                            t2
+                       );
+
+    const __m128i isAscii = _mm_cmplt_epi16(c0, _mm_set1_epi16(0x80)),
+                  is3 = _mm_cmpgt_epi16(c0, _mm_set1_epi16(0xdf));
+
+    const __m128i multi = _mm_or_si128(_mm_and_si128(is3, v3),
+                                       _mm_andnot_si128(is3, v2));
+
+    return _mm_or_si128(_mm_and_si128(isAscii, c0),
+                        _mm_andnot_si128(isAscii, multi));
+}
+
+// append the given code point to dst, if it's not NULL, using a surrogate
+// pair for it if necessary
+inline void PutCodePoint(wchar_t *dst, size_t& written, wxUint32 code)
+{
+#if SIZEOF_WCHAR_T == 2
+    if ( code >= 0x10000 )
+    {
+        code -= 0x10000;
+        if ( dst )
+        {
+            dst[written] = (wchar_t)(0xd800 | (code >> 10));
+            dst[written + 1] = (wchar_t)(0xdc00 | (code & 0x3ff));
+        }
+
+        written += 2;
+        return;
+    }
+#endif // SIZEOF_WCHAR_T == 2
+
+    if ( dst )
+        dst[written] = (wchar_t)code;
+
+    written++;
+}
+
+} // namespace Private
+
+#ifdef wxHAS_SSSE3_DISPATCH
+
+// convert UTF-8 to wchar_t, src must point to the start of a character
+//
+// each block is only converted after checking that it and the next one, in
+// which the characters started in it may end, are valid, so this doesn't
+// handle the last 16 to 31 bytes of the string
+wxSSSE3_TARGET inline size_t
+ToWCharSSSE3(wchar_t *dst, size_t dstLen,
+             const char *src, size_t srcLen,
+             size_t& written)
+{
+    written = 0;
+    if ( srcLen < 32 )
+        return 0;
+
+    const __m128i zero = _mm_setzero_si128();
+
+    Private::ValidationState state;
+    state.prev =
+    state.prevIncomplete =
+    state.error = zero;
+    Private::CheckBlock(state, _mm_loadu_si128((const __m128i *)src));
+
+    // the start of the first character not converted yet
+    const char *next = src;
+    for ( size_t pos = 0; pos + 32 <= srcLen; pos += 16 )
+    {
+        const char * const block = src + pos;
+
+        Private::CheckBlock(state, _mm_loadu_si128((const __m128i *)(block + 16)));
+        if ( _mm_movemask_epi8(_mm_cmpeq_epi8(state.error, zero)) != 0xffff )
+            break;
+
+        // at most 16 characters start in a block and, for UTF-16, only the
+        // last of them may need 2 units if all the previous ones are ASCII
+        if ( dst && dstLen - written < 17 )
+            break;
+
+        const __m128i b0 = _mm_loadu_si128((const __m128i *)block);
+        const int nonAscii = _mm_movemask_epi8(b0);
+        if ( !nonAscii )
+        {
+            // as the previous block didn't end in the middle of a character,
+            // all of this one can be converted
+            if ( dst )
+            {
+                __m128i *out = (__m128i *)(dst + written);
+                const __m128i lo = _mm_unpacklo_epi8(b0, zero),
+                              hi = _mm_unpackhi_epi8(b0, zero);
+#if SIZEOF_WCHAR_T == 2
+                _mm_storeu_si128(out, lo);
+                _mm_storeu_si128(out + 1, hi);
+#else // 32 bit wchar_t
+                _mm_storeu_si128(out, _mm_unpacklo_epi16(lo, zero));
+                _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(lo, zero));
+                _mm_storeu_si128(out + 2, _mm_unpacklo_epi16(hi, zero));
+                _mm_storeu_si128(out + 3, _mm_unpackhi_epi16(hi, zero));
+#endif // 16/32 bit wchar_t
+            }
+
+            written += 16;
+            next = block + 16;
+            continue;
+        }
+
+        const bool has4 = _mm_movemask_epi8(_mm_cmpeq_epi8(
+                            _mm_subs_epu8(b0, _mm_set1_epi8((char)0xef)),
+                            zero)) != 0xffff;
+        if ( has4 )
+        {
+            // 4 byte sequences are rare enough for not bothering with them,
+            // just decode the characters starting in this block one by one,
+            // which is still faster than the caller's code as we know that
+            // they're valid
+            const char * const end = block + 16;
+            while ( next < end )
+            {
+                const unsigned char * const c = (const unsigned char *)next;
+                wxUint32 code;
+                if ( c[0] < 0x80 )
+                {
+                    code = c[0];
+                    next += 1;
+                }
+                else if ( c[0] < 0xe0 )
+                {
+                    code = ((c[0] & 0x1f) << 6) | (c[1] & 0x3f);
+                    next += 2;
+                }
+                else if ( c[0] < 0xf0 )
+                {
+                    code = ((c[0] & 0x0f) << 12) | ((c[1] & 0x3f) << 6) |
+                           (c[2] & 0x3f);
+                    next += 3;
+                }
+                else
+                {
+                    code = ((c[0] & 0x07) << 18) | ((c[1] & 0x3f) << 12) |
+                           ((c[2] & 0x3f) << 6) | (c[3] & 0x3f);
+                    next += 4;
+                }
+
+                Private::PutCodePoint(dst, written, code);
+            }
+
+            continue;
+        }
+
+        // decode the characters which could start at every position of the
+        // block and then keep only those which really start there, i.e.
+        // don't correspond to continuation bytes (80..BF)
+        const __m128i b1 = _mm_loadu_si128((const __m128i *)(block + 1)),
+                      b2 = _mm_loadu_si128((const __m128i *)(block + 2));
+
+        wxUint16 codes[16];
+        _mm_storeu_si128((__m128i *)codes,
+                         Private::DecodeUpTo3(_mm_unpacklo_epi8(b0, zero),
+                                              _mm_unpacklo_epi8(b1, zero),
+                                              _mm_unpacklo_epi8(b2, zero)));
+        _mm_storeu_si128((__m128i *)(codes + 8),
+                         Private::DecodeUpTo3(_mm_unpackhi_epi8(b0, zero),
+                                              _mm_unpackhi_epi8(b1, zero),
+                                              _mm_unpackhi_epi8(b2, zero)));
+
+        int starts = _mm_movemask_epi8(_mm_cmpgt_epi8(b0,
+                                                      _mm_set1_epi8(-0x41)));
+        int last = 0;
+        for ( int i = 0; starts; i++, starts >>= 1 )
+        {
+            if ( starts & 1 )
+            {
+                if ( dst )
+                    dst[written] = codes[i];
+                written++;
+                last = i;
+            }
+        }
+
+        const unsigned char lead = block[last];
+        next = block + last + (lead < 0x80 ? 1 : lead < 0xe0 ? 2 : 3);
+    }
+
+    return next - src;
+}
+
+#endif // wxHAS_SSSE3_DISPATCH
+
+// convert wchar_t to UTF-8, only the characters below the surrogates range
+// are handled here
+inline size_t
+FromWCharSSE2(char *dst, size_t dstLen,
+              const wchar_t *src, size_t srcLen,
+              size_t& written)
+{
+    const __m128i zero = _mm_setzero_si128();
+
+    written = 0;
+
+    size_t n;
+    for ( n = 0; n + 8 <= srcLen; n += 8 )
+    {
+        // we need 3 bytes per character and 1 more as we write 4 of them
+        if ( dst && dstLen - written < 8*3 + 1 )
+            break;
+
+        const __m128i *in = (const __m128i *)(src + n);
+#if SIZEOF_WCHAR_T == 2
+        const __m128i u = _mm_loadu_si128(in);
+        if ( _mm_movemask_epi8(_mm_cmpeq_epi16(
+                _mm_subs_epu16(u, _mm_set1_epi16((short)0xd7ff)),
+                zero)) != 0xffff )
+            break;
+#else // 32 bit wchar_t
+        const __m128i u0 = _mm_loadu_si128(in),
+                      u1 = _mm_loadu_si128(in + 1);
+
+        // there is no unsigned comparison, so flip the sign bits
+        const __m128i signBit = _mm_set1_epi32((int)0x80000000),
+                      limit = _mm_set1_epi32((int)(0x80000000 | 0xd800));
+        if ( _mm_movemask_epi8(_mm_and_si128(
+                _mm_cmplt_epi32(_mm_xor_si128(u0, signBit), limit),
+                _mm_cmplt_epi32(_mm_xor_si128(u1, signBit), limit))) != 0xffff )
+            break;
+
+        // and there is no unsigned saturating pack neither, so shift the
+        // values into the signed range before packing them and back after it
+        const __m128i bias = _mm_set1_epi32(0x8000);
+        const __m128i u = _mm_add_epi16
+                          (
+                            _mm_packs_epi32(_mm_sub_epi32(u0, bias),
+                                            _mm_sub_epi32(u1, bias)),
+                            _mm_set1_epi16((short)0x8000)
+                          );
+#endif // 16/32 bit wchar_t
+
+        const __m128i is1 = _mm_cmpeq_epi16(
+                                _mm_subs_epu16(u, _mm_set1_epi16(0x7f)), zero),
+                      is12 = _mm_cmpeq_epi16(
+                                _mm_subs_epu16(u, _mm_set1_epi16(0x7ff)), zero);
+
+        // the last byte of 2 and 3 byte sequences and the middle one of the
+        // latter
+        const __m128i mask3F = _mm_set1_epi16(0x3f),
+                      marker = _mm_set1_epi16(0x80);
+        const __m128i cont = _mm_or_si128(_mm_and_si128(u, mask3F), marker),
+                      mid = _mm_or_si128(_mm_and_si128(_mm_srli_epi16(u, 6),
+                                                       mask3F),
+                                         marker);
+
+        const __m128i lead2 = _mm_or_si128(_mm_srli_epi16(u, 6),
+                                           _mm_set1_epi16(0xc0)),
+                      lead3 = _mm_or_si128(_mm_srli_epi16(u, 12),
+                                           _mm_set1_epi16(0xe0));
+        const __m128i lead = _mm_or_si128
+                             (
+                                _mm_and_si128(is1, u),
+                                _mm_andnot_si128
+                                (
+                                    is1,
+                                    _mm_or_si128(_mm_and_si128(is12, lead2),
+                                                 _mm_andnot_si128(is12, lead3))
+                                )
+                             );
+        const __m128i second = _mm_or_si128(_mm_and_si128(is12, cont),
+                                            _mm_andnot_si128(is12, mid));
+
+        // combine the bytes of each character into a 32 bit value, the
+        // unused bytes of the shorter sequences are simply overwritten later
+        const __m128i firstTwo = _mm_or_si128(lead, _mm_slli_epi16(second, 8));
+
+        wxUint32 bytes[8];
+        _mm_storeu_si128((__m128i *)bytes, _mm_unpacklo_epi16(firstTwo, cont));
+        _mm_storeu_si128((__m128i *)(bytes + 4),
+                         _mm_unpackhi_epi16(firstTwo, cont));
+
+        // the masks are -1 for true, so this gives 1, 2 or 3
+        wxUint16 lengths[8];
+        _mm_storeu_si128((__m128i *)lengths,
+                         _mm_add_epi16(_mm_add_epi16(_mm_set1_epi16(3), is1),
+                                       is12));
+
+        for ( int i = 0; i < 8; i++ )
+        {
+            if ( dst )
+                memcpy(dst + written, &bytes[i], 4);
+            written += lengths[i];
+        }
+    }
+
+    return n;
+}
+
+#endif // wxHAS_SSE2
+
+inline size_t ToWChar(wchar_t *dst, size_t dstLen,
+                      const char *src, size_t srcLen,
+                      size_t& written)
+{
+#ifdef wxHAS_SSSE3_DISPATCH
+    if ( wxCPUHasSSSE3() )
+        return ToWCharSSSE3(dst, dstLen, src, srcLen, written);
+#else
+    wxUnusedVar(dst);
+    wxUnusedVar(dstLen);
+    wxUnusedVar(src);
+    wxUnusedVar(srcLen);
+#endif
+
+    written = 0;
+    return 0;
+}
+
+inline size_t FromWChar(char *dst, size_t dstLen,
+                        const wchar_t *src, size_t srcLen,
+                        size_t& written)
+{
+#ifdef wxHAS_SSE2
+    return FromWCharSSE2(dst, dstLen, src, srcLen, written);
+#else
+    wxUnusedVar(dst);
+    wxUnusedVar(dstLen);
+    wxUnusedVar(src);
+    wxUnusedVar(srcLen);
+
+    written = 0;
+    return 0;
+#endif
+}
+
+} // namespace wxUtf8Ops
+
+#endif // _WX_PRIVATE_UTF8OPS_H_
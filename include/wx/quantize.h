@@ -34,6 +34,10 @@ class WXDLLIMPEXP_FWD_CORE wxPalette;
 #define wxQUANTIZE_RETURN_8BIT_DATA             0x02
 #define wxQUANTIZE_FILL_DESTINATION_IMAGE       0x04
 
+// use a faster algorithm, which doesn't dither the image and uses several
+// threads if allowed by wxImage::SetMaxThreads(), instead of the default one
+#define wxQUANTIZE_FAST                         0x08
+
 class WXDLLIMPEXP_CORE wxQuantize: public wxObject
 {
 public:
@@ -68,7 +72,9 @@ DECLARE_DYNAMIC_CLASS(wxQuantize)
     // in_rows and out_rows are arrays [0..h-1] of pointer to rows
     // (in_rows contains w * 3 bytes per row, out_rows w bytes per row)
     // fills out_rows with indexes into palette (which is also stored into palette variable)
-    static void DoQuantize(unsigned w, unsigned h, unsigned char **in_rows, unsigned char **out_rows, unsigned char *palette, int desiredNoColours);
+    // flags may contain wxQUANTIZE_FAST, all the other ones are ignored
+    static void DoQuantize(unsigned w, unsigned h, unsigned char **in_rows, unsigned char **out_rows, unsigned char *palette, int desiredNoColours,
+        int flags = 0);
 
 };
 
@@ -114,6 +114,21 @@ public:
     const wxWCharBuffer cMB2WC(const wxScopedCharBuffer& in) const;
     const wxCharBuffer cWC2MB(const wxScopedWCharBuffer& in) const;
 
+    // Convert the input into the buffer which is (re)allocated by these
+    // functions themselves. The return value has the same meaning as for
+    // To/FromWChar(), but on success the buffer length is set to it and the
+    // buffer is always NUL-terminated, even if the input is not.
+    //
+    // Unlike all the functions above, these functions usually convert the
+    // input only once, instead of doing it once to find the length of the
+    // output and then again to really convert it, by using a buffer big
+    // enough for the output of any input of the given length, so they should
+    // be preferred to them when performance matters.
+    size_t ToWCharBuffer(wxWCharBuffer& dst,
+                         const char *src, size_t srcLen = wxNO_LEN) const;
+    size_t FromWCharBuffer(wxCharBuffer& dst,
+                           const wchar_t *src, size_t srcLen = wxNO_LEN) const;
+
     // convenience functions for converting MB or WC to/from wxWin default
 #if wxUSE_UNICODE
     const wxWCharBuffer cMB2WX(const char *psz) const { return cMB2WC(psz); }
@@ -151,6 +166,13 @@ public:
     virtual bool IsUTF8() const { return false; }
 #endif
 
+    // return true if ToWChar() and FromWChar() can be safely called with an
+    // output buffer which may be too small for the result: this is the case
+    // if they always return wxCONV_FAILED without writing beyond the end of
+    // the buffer nor changing any conversion state then, and allows
+    // ToWCharBuffer() and FromWCharBuffer() to convert the input only once
+    virtual bool CanConvertInOnePass() const { return false; }
+
     // The old conversion functions. The existing classes currently mostly
     // implement these ones but we're in transition to using To/FromWChar()
     // instead and any new classes should implement just the new functions.
@@ -353,6 +375,8 @@ public:
 
     virtual wxMBConv *Clone() const { return new wxMBConvStrictUTF8(); }
 
+    virtual bool CanConvertInOnePass() const { return true; }
+
 #if wxUSE_UNICODE_UTF8
     // NB: other mapping modes are not, strictly speaking, UTF-8, so we can't
     //     take the shortcut in that case
@@ -379,6 +403,11 @@ public:
 
     virtual wxMBConv *Clone() const { return new wxMBConvUTF8(m_options); }
 
+    // the lossy mapping modes don't check for the end of the output buffer
+    // carefully enough
+    virtual bool CanConvertInOnePass() const
+        { return m_options == MAP_INVALID_UTF8_NOT; }
+
 #if wxUSE_UNICODE_UTF8
     // NB: other mapping modes are not, strictly speaking, UTF-8, so we can't
     //     take the shortcut in that case
@@ -399,6 +428,7 @@ public:
     enum { BYTES_PER_CHAR = 2 };
 
     virtual size_t GetMBNulLen() const { return BYTES_PER_CHAR; }
+    virtual bool CanConvertInOnePass() const { return true; }
 
 protected:
     // return the length of the buffer using srcLen if it's not wxNO_LEN and
@@ -446,6 +476,7 @@ public:
     enum { BYTES_PER_CHAR = 4 };
 
     virtual size_t GetMBNulLen() const { return BYTES_PER_CHAR; }
+    virtual bool CanConvertInOnePass() const { return true; }
 
 protected:
     // this is similar to wxMBConvUTF16Base method with the same name except
@@ -511,6 +542,8 @@ public:
     virtual bool IsUTF8() const;
 #endif
 
+    virtual bool CanConvertInOnePass() const;
+
     virtual wxMBConv *Clone() const { return new wxCSConv(*this); }
 
     void Clear();
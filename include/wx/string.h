@@ -89,6 +89,17 @@
     #endif
 #endif // wxUSE_STRING_POS_CACHE
 
+// the cache above only helps when the string is accessed sequentially, so long
+// UTF-8 strings also use an index mapping the positions of every few
+// characters to their byte offsets to make random access to them fast; this
+// index is only built for the strings for which it's needed but it still
+// makes wxString object bigger, predefine this symbol as 0 to disable it
+#ifndef wxUSE_STRING_POS_INDEX
+    #define wxUSE_STRING_POS_INDEX wxUSE_STRING_POS_CACHE
+#elif wxUSE_STRING_POS_INDEX && !wxUSE_STRING_POS_CACHE
+    #error "wxUSE_STRING_POS_INDEX requires wxUSE_STRING_POS_CACHE"
+#endif
+
 class WXDLLIMPEXP_FWD_BASE wxString;
 
 // unless this symbol is predefined to disable the compatibility functions, do
@@ -449,6 +460,106 @@ private:
 };
 #endif // wxUSE_UNICODE_UTF8
 
+#if wxUSE_STRING_POS_INDEX
+// index used by wxString to find the byte offsets of the characters in long
+// UTF-8 strings without scanning them from the beginning: it stores the
+// offsets of every STEP-th character, so finding any other one requires
+// scanning at most STEP characters
+class WXDLLIMPEXP_BASE wxStringPosIndex
+{
+public:
+    enum
+    {
+        // the distance between the positions stored in the index
+        STEP = 64,
+
+        // the minimal length of the string, in bytes, for which the index is
+        // used, the shorter strings are scanned quickly enough anyhow
+        MIN_LENGTH = 1024
+    };
+
+    // build the index for the given string
+    wxStringPosIndex(const wxStringImpl& str);
+    ~wxStringPosIndex() { delete [] m_offsets; }
+
+    // return the length of the indexed string in characters
+    size_t GetLength() const { return m_length; }
+
+    // return the offset of the character at the given position, which must be
+    // less than or equal to the string length, in the indexed string
+    size_t PosToImpl(const wxStringImpl& str, size_t pos) const;
+
+    // return the position of the character at the given offset
+    size_t PosFromImpl(const wxStringImpl& str, size_t impl) const;
+
+private:
+    // the length of the string in characters
+    size_t m_length;
+
+    // the m_count offsets of the characters 0, STEP, 2*STEP, ... or NULL if
+    // the string contains only ASCII characters, as the offsets are the same
+    // as positions then
+    size_t *m_offsets;
+    size_t m_count;
+
+    wxDECLARE_NO_COPY_CLASS(wxStringPosIndex);
+};
+
+// this class manages the index for a wxString object: notice that copying the
+// string doesn't copy the index as the copy may never need it
+class WXDLLIMPEXP_BASE wxStringPosIndexPtr
+{
+public:
+    wxStringPosIndexPtr() : m_ptr(NULL) { }
+    wxStringPosIndexPtr(const wxStringPosIndexPtr& WXUNUSED(other))
+        : m_ptr(NULL) { }
+    wxStringPosIndexPtr& operator=(const wxStringPosIndexPtr& WXUNUSED(other))
+    {
+        Reset();
+        return *this;
+    }
+
+    ~wxStringPosIndexPtr() { delete Get(); }
+
+    // return the existing index or NULL
+    const wxStringPosIndex *Get() const
+        { return static_cast<const wxStringPosIndex *>(m_ptr); }
+
+    // create the index for the given string and return it, this can be called
+    // from several threads simultaneously
+    const wxStringPosIndex *Create(const wxStringImpl& str);
+
+    // discard the index when the string changes
+    void Reset()
+    {
+        if ( m_ptr )
+        {
+            delete Get();
+            m_ptr = NULL;
+        }
+    }
+
+    // this helper discards the index of a string when it goes out of scope:
+    // it's used by wxString methods modifying the string, as they can
+    // recreate the index before actually changing the string when converting
+    // the positions to the byte offsets
+    class ResetOnExit
+    {
+    public:
+        ResetOnExit(wxStringPosIndexPtr& index) : m_index(index) { }
+        ~ResetOnExit() { m_index.Reset(); }
+
+    private:
+        wxStringPosIndexPtr& m_index;
+
+        wxDECLARE_NO_COPY_CLASS(ResetOnExit);
+    };
+
+private:
+    void * volatile m_ptr;
+};
+#endif // wxUSE_STRING_POS_INDEX
+
 class WXDLLIMPEXP_BASE wxString
 #ifdef wxNEEDS_WXSTRING_PRINTF_MIXIN
                                 : public wxStringPrintfMixin
@@ -667,7 +778,8 @@ private:
                sumofs,  // sum of all offsets after using the cache, used to
                         // compute the average after dividing by hits
                lentot,  // number of total calls to length()
-               lenhits; // number of cache hits in length()
+               lenhits, // number of cache hits in length()
+               idxhits; // number of PosToImpl() calls using the index
   } ms_cacheStats;
 
   friend struct wxStrCacheStatsDumper;
@@ -769,6 +881,24 @@ private:
       if ( pos == cache->pos )
           return cache->impl;
 
+#if wxUSE_STRING_POS_INDEX
+      // use the index for long strings unless the cached position is close
+      // enough, as it would be when iterating over the string
+      if ( pos < cache->pos || pos - cache->pos > wxStringPosIndex::STEP )
+      {
+          const wxStringPosIndex * const index = GetPosIndex();
+          if ( index )
+          {
+              wxCACHE_PROFILE_FIELD_INC(idxhits);
+
+              cache->pos = pos;
+              cache->impl = index->PosToImpl(m_impl, pos);
+
+              return cache->impl;
+          }
+      }
+#endif // wxUSE_STRING_POS_INDEX
+
       // this seems to happen only rarely so just reset the cache in this case
       // instead of complicating code even further by seeking backwards in this
       // case
@@ -795,8 +925,34 @@ private:
       return cache->impl;
   }
 
+#if wxUSE_STRING_POS_INDEX
+  // return the index for this string, building it if necessary, or NULL if
+  // the string is too short to use it
+  const wxStringPosIndex *GetPosIndex() const
+  {
+      if ( m_impl.length() < wxStringPosIndex::MIN_LENGTH )
+          return NULL;
+
+      const wxStringPosIndex * const index = m_posIndex.Get();
+      return index ? index : m_posIndex.Create(m_impl);
+  }
+
+  // discard the index when leaving the current scope, this is used by all
+  // the wxSTRING_XXX() macros below which are used whenever the string is
+  // modified, even if it's just appended to
+  #define wxSTRING_INVALIDATE_INDEX() \
+      wxStringPosIndexPtr::ResetOnExit \
+          wxMAKE_UNIQUE_NAME(wxStrIndexReset)(m_posIndex)
+#else // !wxUSE_STRING_POS_INDEX
+  #define wxSTRING_INVALIDATE_INDEX()
+#endif // wxUSE_STRING_POS_INDEX/!wxUSE_STRING_POS_INDEX
+
   void InvalidateCache()
   {
+#if wxUSE_STRING_POS_INDEX
+      m_posIndex.Reset();
+#endif // wxUSE_STRING_POS_INDEX
+
       Cache::Element * const cache = FindCacheElement();
       if ( cache )
           cache->Reset();
@@ -829,10 +985,14 @@ private:
       }
   }
 
-  #define wxSTRING_INVALIDATE_CACHE() InvalidateCache()
-  #define wxSTRING_INVALIDATE_CACHED_LENGTH() InvalidateCachedLength()
-  #define wxSTRING_UPDATE_CACHED_LENGTH(n) UpdateCachedLength(n)
-  #define wxSTRING_SET_CACHED_LENGTH(n) SetCachedLength(n)
+  #define wxSTRING_INVALIDATE_CACHE() \
+      InvalidateCache(); wxSTRING_INVALIDATE_INDEX()
+  #define wxSTRING_INVALIDATE_CACHED_LENGTH() \
+      InvalidateCachedLength(); wxSTRING_INVALIDATE_INDEX()
+  #define wxSTRING_UPDATE_CACHED_LENGTH(n) \
+      UpdateCachedLength(n); wxSTRING_INVALIDATE_INDEX()
+  #define wxSTRING_SET_CACHED_LENGTH(n) \
+      SetCachedLength(n); wxSTRING_INVALIDATE_INDEX()
 #else // !wxUSE_STRING_POS_CACHE
   size_t DoPosToImpl(size_t pos) const
   {
@@ -863,8 +1023,14 @@ private:
   {
       if ( pos == 0 || pos == npos )
           return pos;
-      else
-          return const_iterator(this, m_impl.begin() + pos) - begin();
+
+#if wxUSE_STRING_POS_INDEX
+      const wxStringPosIndex * const index = GetPosIndex();
+      if ( index )
+          return index->PosFromImpl(m_impl, pos);
+#endif // wxUSE_STRING_POS_INDEX
+
+      return const_iterator(this, m_impl.begin() + pos) - begin();
   }
 #endif // !wxUSE_UNICODE_UTF8/wxUSE_UNICODE_UTF8
 
@@ -1259,6 +1425,18 @@ public:
     // copy ctor
   wxString(const wxString& stringSrc) : m_impl(stringSrc.m_impl) { }
 
+#ifdef wxHAS_RVALUE_REF
+    // move ctor, the other string is left empty
+  wxString(wxString&& stringSrc) : m_impl(std::move(stringSrc.m_impl))
+  {
+#if wxUSE_STRING_POS_CACHE
+      // the cache entry and the index of the other string are not valid any
+      // more
+      stringSrc.InvalidateCache();
+#endif // wxUSE_STRING_POS_CACHE
+  }
+#endif // wxHAS_RVALUE_REF
+
     // string containing nRepeat copies of ch
   wxString(wxUniChar ch, size_t nRepeat = 1 )
     { assign(nRepeat, ch); }
@@ -1457,6 +1635,14 @@ public:
 
       if ( cache->len == npos )
       {
+#if wxUSE_STRING_POS_INDEX
+          // the index doesn't need to be created just for this, but if we
+          // already have it, it knows the length
+          const wxStringPosIndex * const index = m_posIndex.Get();
+          if ( index )
+              cache->len = index->GetLength();
+          else
+#endif // wxUSE_STRING_POS_INDEX
           // it's probably not worth trying to be clever and using cache->pos
           // here as it's probably 0 anyhow -- you usually call length() before
           // starting to index the string
@@ -1926,6 +2112,24 @@ public:
     return *this;
   }
 
+#ifdef wxHAS_RVALUE_REF
+    // from a temporary wxString
+  wxString& operator=(wxString&& stringSrc)
+  {
+    if ( this != &stringSrc )
+    {
+        wxSTRING_INVALIDATE_CACHE();
+#if wxUSE_STRING_POS_CACHE
+        stringSrc.InvalidateCache();
+#endif // wxUSE_STRING_POS_CACHE
+
+        m_impl = std::move(stringSrc.m_impl);
+    }
+
+    return *this;
+  }
+#endif // wxHAS_RVALUE_REF
+
   wxString& operator=(const wxCStrData& cstr)
     { return *this = cstr.AsString(); }
     // from a character
@@ -3501,6 +3705,11 @@ private:
 private:
   wxStringImpl m_impl;
 
+#if wxUSE_STRING_POS_INDEX
+  // the index used by PosToImpl() for long strings, created on demand
+  mutable wxStringPosIndexPtr m_posIndex;
+#endif // wxUSE_STRING_POS_INDEX
+
   // buffers for compatibility conversion from (char*)c_str() and
   // (wchar_t*)c_str(): the pointers returned by these functions should remain
   // valid until the string itself is modified for compatibility with the
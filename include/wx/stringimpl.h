@@ -28,6 +28,12 @@
 
 #include <stdlib.h>
 
+#ifdef wxHAS_RVALUE_REF
+    #include "wx/beforestd.h"
+    #include <utility>          // for std::move()
+    #include "wx/afterstd.h"
+#endif // wxHAS_RVALUE_REF
+
 // ---------------------------------------------------------------------------
 // macros
 // ---------------------------------------------------------------------------
@@ -305,6 +311,14 @@ public:
       GetStringData()->Lock();                    // => one more copy
     }
   }
+#ifdef wxHAS_RVALUE_REF
+    // move ctor: steals the data of the other string which becomes empty
+  wxStringImpl(wxStringImpl&& stringSrc)
+  {
+    m_pchData = stringSrc.m_pchData;
+    stringSrc.Init();
+  }
+#endif // wxHAS_RVALUE_REF
     // string containing nRepeat copies of ch
   wxStringImpl(size_type nRepeat, wxStringCharType ch);
     // ctor takes first nLength characters from C string
@@ -356,6 +370,11 @@ public:
   // overloaded assignment
     // from another wxString
   wxStringImpl& operator=(const wxStringImpl& stringSrc);
+#ifdef wxHAS_RVALUE_REF
+    // from a temporary string: just exchange the data with it
+  wxStringImpl& operator=(wxStringImpl&& stringSrc)
+    { swap(stringSrc); return *this; }
+#endif // wxHAS_RVALUE_REF
     // from a character
   wxStringImpl& operator=(wxStringCharType ch);
     // from a C string
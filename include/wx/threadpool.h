@@ -0,0 +1,245 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        wx/threadpool.h
+// Purpose:     wxThreadPool and wxThreadPoolTask classes
+// Author:      agent
+// Created:     2026-10-16
+// RCS-ID:      $Id$
+// Copyright:   (c) 2026 agent <agent@local>
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _WX_THREADPOOL_H_
+#define _WX_THREADPOOL_H_
+
+#include "wx/defs.h"
+
+#if wxUSE_THREADS
+
+#include "wx/atomic.h"
+#include "wx/event.h"
+#include "wx/thread.h"
+#include "wx/vector.h"
+
+class WXDLLIMPEXP_FWD_BASE wxThreadPool;
+class wxThreadPoolQueue;
+class wxThreadPoolWorker;
+
+// the event sent to the completion handler of a task when it finishes
+wxDECLARE_EXPORTED_EVENT(WXDLLIMPEXP_BASE, wxEVT_THREAD_POOL_TASK, wxThreadEvent);
+
+#define EVT_THREAD_POOL_TASK(id, func) \
+    wx__DECLARE_EVT1(wxEVT_THREAD_POOL_TASK, id, wxThreadEventHandler(func))
+
+// the state of a wxThreadPoolTask
+enum wxThreadPoolTaskState
+{
+    wxTHREAD_POOL_TASK_PENDING,     // not submitted or not started yet
+    wxTHREAD_POOL_TASK_RUNNING,     // Run() is being executed
+    wxTHREAD_POOL_TASK_DONE,        // Run() has returned
+    wxTHREAD_POOL_TASK_CANCELLED    // cancelled before or while running
+};
+
+// ----------------------------------------------------------------------------
+// wxThreadPoolTask: a unit of work executed by wxThreadPool
+// ----------------------------------------------------------------------------
+
+class WXDLLIMPEXP_BASE wxThreadPoolTask
+{
+public:
+    // the id is used for the completion event, see SetCompletionHandler()
+    wxThreadPoolTask(int id = wxID_ANY);
+
+    // the tasks are reference counted as they're shared between the code
+    // creating them and the pool executing them, the initial reference belongs
+    // to the creator and must be released with DecRef() when the task is not
+    // needed any more
+    void IncRef() { wxAtomicInc(m_refCount); }
+    void DecRef()
+    {
+        if ( !wxAtomicDec(m_refCount) )
+            delete this;
+    }
+
+    int GetId() const { return m_id; }
+
+    // set the handler to which wxEVT_THREAD_POOL_TASK event is queued when the
+    // task finishes, either normally or because it was cancelled; the event
+    // has the id of the task and GetInt() returns its final state
+    //
+    // the handler must remain alive until the event is processed and this
+    // must be called before submitting the task
+    void SetCompletionHandler(wxEvtHandler *handler) { m_handler = handler; }
+
+    // get the current state of the task
+    wxThreadPoolTaskState GetState() const
+    {
+        return static_cast<wxThreadPoolTaskState>(m_state);
+    }
+
+    // return true if the task finished running or was cancelled
+    bool IsFinished() const
+    {
+        const wxThreadPoolTaskState state = GetState();
+        return state == wxTHREAD_POOL_TASK_DONE ||
+                state == wxTHREAD_POOL_TASK_CANCELLED;
+    }
+
+    // cancel the task: if it hasn't started running yet, it won't be run at
+    // all and true is returned; otherwise IsCancelRequested() will return true
+    // from now on and Run() should check it and return as soon as possible
+    bool Cancel();
+
+    // return true if Cancel() or wxThreadPool::CancelAll() had been called
+    bool IsCancelRequested() const;
+
+    // wait until the task finishes; if called from a thread of the pool, it
+    // executes the other tasks while waiting
+    void Wait();
+
+    // same as Wait() but with a timeout, return false if it expired
+    bool WaitTimeout(unsigned long milliseconds);
+
+protected:
+    // the dtor is protected as the tasks must be deleted using DecRef() only
+    virtual ~wxThreadPoolTask();
+
+    // this method is called in a thread of the pool and must be overridden to
+    // do the work of the task
+    virtual void Run() = 0;
+
+private:
+    // common part of Wait() and WaitTimeout(), timeout of -1 means infinite
+    bool DoWait(long timeout);
+
+    // queue the completion event and wake up the threads waiting for us
+    void NotifyFinished();
+
+    // change the state from "from" to "to" atomically, return false if the
+    // current state is not "from"
+    bool ChangeState(wxThreadPoolTaskState from, wxThreadPoolTaskState to)
+    {
+        return wxAtomicCompareAndSwap(m_state, from, to);
+    }
+
+
+    wxAtomicInt m_refCount;
+    wxUint32 m_state;
+    wxUint32 m_cancelRequested;
+
+    // the pool this task was submitted to or NULL
+    wxThreadPool *m_pool;
+
+    // the value of the cancellation counter of the pool when the task was
+    // submitted to it
+    wxUint32 m_cancelEpoch;
+
+    wxEvtHandler *m_handler;
+    const int m_id;
+
+    friend class wxThreadPool;
+    friend class wxThreadPoolWorker;
+
+    wxDECLARE_NO_COPY_CLASS(wxThreadPoolTask);
+};
+
+// ----------------------------------------------------------------------------
+// wxThreadPool: executes wxThreadPoolTasks using a fixed number of threads
+// ----------------------------------------------------------------------------
+
+// Each thread of the pool has its own queue of tasks: the tasks submitted
+// from a task running in the pool are added to the queue of its thread, which
+// executes the most recently added task first, while the tasks submitted from
+// the outside go to a shared queue. A thread without any tasks of its own
+// takes them from the shared queue or steals the oldest ones from the other
+// threads, so that the work is distributed between all threads without any
+// global lock being taken when the tasks spawn subtasks.
+class WXDLLIMPEXP_BASE wxThreadPool
+{
+public:
+    // create the pool with the given number of threads, by default the number
+    // of CPUs is used
+    wxThreadPool(unsigned numThreads = 0);
+
+    // cancels all the pending tasks and waits for the running ones to finish
+    ~wxThreadPool();
+
+    // return true if the threads of the pool were successfully created
+    bool IsOk() const { return !m_workers.empty(); }
+
+    // return the number of threads in the pool
+    unsigned GetThreadCount() const { return m_workers.size(); }
+
+    // submit a task for execution, the pool takes a reference to it which it
+    // releases when the task finishes; return false if the pool is being
+    // shut down
+    bool Submit(wxThreadPoolTask *task);
+
+    // cancel all the pending tasks and request cancellation of the running
+    // ones
+    void CancelAll();
+
+    // wait until all the submitted tasks finish
+    void WaitAll();
+
+    // return the global pool with the default number of threads, creating it
+    // on first use; this pool is destroyed on library shutdown
+    static wxThreadPool& Get();
+
+private:
+    // add a task to the queue of the given worker or the shared queue if NULL
+    void Enqueue(wxThreadPoolWorker *worker, wxThreadPoolTask *task);
+
+    // get the next task to execute by the given worker or NULL if none
+    wxThreadPoolTask *Dequeue(wxThreadPoolWorker *worker);
+
+    // execute the task (if it wasn't cancelled) and release it
+    void Execute(wxThreadPoolTask *task);
+
+    // wake up the threads waiting for a task to finish
+    void WakeUpWaiters();
+
+    // wait until the task finishes or the timeout expires
+    bool WaitForTask(wxThreadPoolTask *task, long timeout);
+
+    // the main loop of the worker threads
+    void WorkerMain(wxThreadPoolWorker *worker);
+
+    // return the worker of this pool running in the current thread or NULL
+    wxThreadPoolWorker *GetCurrentWorker() const;
+
+
+    wxVector<wxThreadPoolWorker *> m_workers;
+
+    // the queue of the tasks submitted from outside of the pool
+    wxThreadPoolQueue *m_sharedQueue;
+
+    // the number of tasks in all the queues
+    wxAtomicInt m_numQueued;
+
+    // the number of submitted tasks which didn't finish yet
+    wxAtomicInt m_numActive;
+
+    // incremented by CancelAll() to cancel all the tasks submitted before
+    wxUint32 m_cancelEpoch;
+
+    // the mutex and condition used by the workers waiting for tasks
+    wxMutex m_idleMutex;
+    wxCondition m_idleCond;
+    wxAtomicInt m_numIdle;
+    bool m_shutdown;
+
+    // the mutex and condition used by the threads waiting for the tasks to
+    // finish
+    wxMutex m_doneMutex;
+    wxCondition m_doneCond;
+    wxAtomicInt m_numWaiting;
+
+    friend class wxThreadPoolTask;
+    friend class wxThreadPoolWorker;
+
+    wxDECLARE_NO_COPY_CLASS(wxThreadPool);
+};
+
+#endif // wxUSE_THREADS
+
+#endif // _WX_THREADPOOL_H_
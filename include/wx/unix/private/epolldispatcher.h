@@ -41,12 +41,27 @@ private:
     // ctor is private, use Create()
     wxEpollDispatcher(int epollDescriptor);
 
-    // common part of HasPending() and Dispatch(): calls epoll_wait() with the
-    // given timeout
+    // calls epoll_wait() with the given timeout, restarting it if interrupted
     int DoPoll(epoll_event *events, int numEvents, int timeout) const;
 
+    // adjust the size of m_events to the number of registered descriptors
+    void AdjustEventsBuffer();
+
 
     int m_epollDescriptor;
+
+    // the number of descriptors currently registered with us
+    int m_numFDs;
+
+    // the buffer for the events returned by epoll_wait(), it grows and shrinks
+    // with the number of registered descriptors to allow retrieving the events
+    // for all of them with a single system call
+    epoll_event *m_events;
+    int m_numEventsMax;
+
+    // true while the events in m_events are being dispatched, a nested call to
+    // Dispatch() from one of the handlers must not reuse the buffer then
+    bool m_inDispatch;
 };
 
 #endif // wxUSE_EPOLL_DISPATCHER
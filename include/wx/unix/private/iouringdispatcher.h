@@ -0,0 +1,157 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        wx/unix/private/iouringdispatcher.h
+// Purpose:     wxIoUringDispatcher class
+// Author:      agent
+// Created:     2026-10-16
+// RCS-ID:      $Id$
+// Copyright:   (c) 2026 agent <agent@local>
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef _WX_PRIVATE_IOURINGDISPATCHER_H_
+#define _WX_PRIVATE_IOURINGDISPATCHER_H_
+
+#include "wx/defs.h"
+
+// io_uring is only used as an alternative to epoll, so only check for it if
+// the latter is available
+#if wxUSE_EPOLL_DISPATCHER && defined(HAVE_LINUX_IO_URING_H)
+    #include <linux/io_uring.h>
+
+    // we need the possibility to wait for the completions with a timeout
+    // which appeared in Linux 5.11
+    #ifdef IORING_FEAT_EXT_ARG
+        #define wxHAS_IOURING_DISPATCHER
+    #endif
+#endif
+
+#ifdef wxHAS_IOURING_DISPATCHER
+
+#include "wx/private/fdiodispatcher.h"
+
+// ----------------------------------------------------------------------------
+// wxIoUringDispatcher: wxFDIODispatcher using Linux io_uring
+// ----------------------------------------------------------------------------
+
+// This dispatcher submits a poll request for each registered descriptor to the
+// io_uring submission ring and gets the readiness notifications from its
+// completion ring. The requests are only submitted to the kernel when waiting
+// for the completions, so that all the (re)registrations done while handling
+// the events result in a single system call.
+//
+// Level-triggered notifications are implemented by using one-shot poll
+// requests which are resubmitted after calling the handler while the
+// descriptors registered with wxFDIO_EDGE_TRIGGERED use multishot requests.
+class WXDLLIMPEXP_BASE wxIoUringDispatcher : public wxFDIODispatcher
+{
+public:
+    // create a new instance of this class, return NULL if io_uring is not
+    // supported by the running kernel
+    //
+    // the caller should delete the returned pointer
+    static wxIoUringDispatcher *Create();
+
+    virtual ~wxIoUringDispatcher();
+
+    // implement base class pure virtual methods
+    virtual bool RegisterFD(int fd, wxFDIOHandler* handler, int flags = wxFDIO_ALL);
+    virtual bool ModifyFD(int fd, wxFDIOHandler* handler, int flags = wxFDIO_ALL);
+    virtual bool UnregisterFD(int fd);
+    virtual bool HasPending() const;
+    virtual int Dispatch(int timeout = TIMEOUT_INFINITE);
+
+private:
+    // information about a registered descriptor
+    struct Entry
+    {
+        Entry() { handler = NULL; flags = 0; generation = 0; }
+
+        wxFDIOHandler *handler;
+        int flags;
+
+        // the generation of the registration, used to recognize the
+        // completions of the requests made for the previous registrations of
+        // the same descriptor
+        wxUint32 generation;
+    };
+
+    WX_DECLARE_HASH_MAP(int, Entry, wxIntegerHash, wxIntegerEqual, EntriesMap);
+
+    // ctor is private, use Create()
+    wxIoUringDispatcher(int ringFD, const io_uring_params& params);
+
+    // map the rings into our address space, return false on failure
+    bool MapRings(const io_uring_params& params);
+
+    // get the next free submission queue entry, submitting the already queued
+    // ones if necessary to make space for it, can return NULL on failure
+    //
+    // the entry is not visible to the kernel until CommitSQE() is called
+    io_uring_sqe *GetSQE();
+
+    // make the entry returned by GetSQE() available to the kernel after
+    // filling it
+    void CommitSQE();
+
+    // queue a poll request for the given descriptor
+    bool QueuePoll(int fd, const Entry& entry);
+
+    // queue a request cancelling the poll request for the given descriptor
+    bool QueuePollRemove(int fd, const Entry& entry);
+
+    // submit all the queued requests and, if timeout is not 0, wait for at
+    // least one completion for at most this number of milliseconds; return
+    // false on error
+    bool Enter(int timeout);
+
+    // return true if the completion ring is not empty
+    bool HasCompletions() const;
+
+    // call the handlers for the available completions, return the number of
+    // the events processed
+    int ProcessCompletions();
+
+
+    // the io_uring descriptor
+    int m_ringFD;
+
+    // the mapped memory regions containing the submission and completion
+    // rings (which can be the same) and the submission queue entries
+    void *m_sqRing;
+    size_t m_sqRingSize;
+    void *m_cqRing;
+    size_t m_cqRingSize;
+    io_uring_sqe *m_sqes;
+    size_t m_sqesSize;
+
+    // pointers to the fields of the submission ring
+    unsigned *m_sqHead;
+    unsigned *m_sqTail;
+    unsigned *m_sqMask;
+    unsigned *m_sqArray;
+    unsigned m_sqEntries;
+
+    // pointers to the fields of the completion ring
+    unsigned *m_cqHead;
+    unsigned *m_cqTail;
+    unsigned *m_cqMask;
+    io_uring_cqe *m_cqes;
+
+    // the number of queued but not yet submitted requests
+    unsigned m_numToSubmit;
+
+    // all the registered descriptors
+    EntriesMap m_entries;
+
+    // the generation to use for the next registration, never 0
+    wxUint32 m_nextGeneration;
+
+    // false if the kernel turned out not to support multishot poll requests
+    bool m_hasMultishotPoll;
+
+    wxDECLARE_NO_COPY_CLASS(wxIoUringDispatcher);
+};
+
+#endif // wxHAS_IOURING_DISPATCHER
+
+#endif // _WX_PRIVATE_IOURINGDISPATCHER_H_
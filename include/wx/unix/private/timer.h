@@ -14,11 +14,24 @@
 #if wxUSE_TIMER
 
 #include "wx/private/timer.h"
+#include "wx/vector.h"
 
 // the type used for milliseconds is large enough for microseconds too but
 // introduce a synonym for it to avoid confusion
 typedef wxMilliClock_t wxUsecClock_t;
 
+// under Linux we can use a timerfd monitored by wxFDIODispatcher to be
+// notified about the timers expiration instead of polling for it
+#if wxUSE_CONSOLE_EVENTLOOP && defined(HAVE_SYS_TIMERFD_H)
+    #define wxHAS_TIMERFD
+#endif
+
+struct wxTimerSchedule;
+
+#ifdef wxHAS_TIMERFD
+class wxTimerFDHandler;
+#endif // wxHAS_TIMERFD
+
 // ----------------------------------------------------------------------------
 // wxTimer implementation class for Unix platforms
 // ----------------------------------------------------------------------------
@@ -46,6 +59,12 @@ public:
 
 private:
     bool m_isRunning;
+
+    // the schedule of this timer in wxTimerScheduler if it's running, this is
+    // managed by wxTimerScheduler only
+    wxTimerSchedule *m_schedule;
+
+    friend class wxTimerScheduler;
 };
 
 // ----------------------------------------------------------------------------
@@ -58,6 +77,8 @@ struct wxTimerSchedule
         : m_timer(timer),
           m_expiration(expiration)
     {
+        m_seq = 0;
+        m_index = 0;
     }
 
     // the timer itself (we don't own this pointer)
@@ -65,16 +86,24 @@ struct wxTimerSchedule
 
     // the time of its next expiration, in usec
     wxUsecClock_t m_expiration;
+
+    // the sequence number of this schedule, used to expire the timers with
+    // the same expiration time in the order in which they were added
+    unsigned long m_seq;
+
+    // the position of this schedule in wxTimerScheduler heap
+    size_t m_index;
 };
 
-// the linked list of all active timers, we keep it sorted by expiration time
-WX_DECLARE_LIST(wxTimerSchedule, wxTimerList);
+// the binary heap of all active timers ordered by expiration time
+typedef wxVector<wxTimerSchedule *> wxTimerHeap;
 
 // ----------------------------------------------------------------------------
 // wxTimerScheduler: class responsible for updating all timers
 // ----------------------------------------------------------------------------
 
-class wxTimerScheduler
+// NB: this class is exported to allow testing it
+class WXDLLIMPEXP_BASE wxTimerScheduler
 {
 public:
     // get the unique timer scheduler instance
@@ -114,22 +143,93 @@ public:
 
     // trigger the timer event for all timers which have expired, return true
     // if any did
+    //
+    // this must be called after each wxFDIODispatcher::Dispatch() call even
+    // if IsMonitoredByDispatcher() returns true
     bool NotifyExpired();
 
+    // return true if the timers expiration is signalled by a file descriptor
+    // monitored by wxFDIODispatcher, in which case the event loop doesn't need
+    // to use GetNext() to limit its timeout
+    bool IsMonitoredByDispatcher() const
+    {
+#ifdef wxHAS_TIMERFD
+        return m_timerFD != NULL;
+#else
+        return false;
+#endif
+    }
+
+#ifdef wxHAS_TIMERFD
+    // called by the timer fd handler from inside wxFDIODispatcher::Dispatch()
+    // when the timer fd expires: we don't notify the timers from there as
+    // their event handlers could modify the dispatcher while it iterates over
+    // its fds, but just remember to do it in the next NotifyExpired() call
+    void OnTimerFDExpired() { m_timerFDExpired = true; }
+#endif // wxHAS_TIMERFD
+
 private:
     // ctor and dtor are private, this is a singleton class only created by
     // Get() and destroyed by Shutdown()
-    wxTimerScheduler() { }
+    wxTimerScheduler()
+    {
+        m_nextSeq = 0;
+
+#ifdef wxHAS_TIMERFD
+        m_timerFD = NULL;
+        m_triedTimerFD = false;
+        m_timerFDExpired = false;
+#endif // wxHAS_TIMERFD
+    }
+
     ~wxTimerScheduler();
 
-    // add the given timer schedule to the list in the right place
+    // update the expiration time of the timer fd, if we use it, to correspond
+    // to the timer currently at the top of the heap
+    void UpdateTimerFD();
+
+    // add the given timer schedule to the heap
     //
     // we take ownership of the pointer "s" which must be heap-allocated
     void DoAddTimer(wxTimerSchedule *s);
 
+    // remove the timer schedule at the given position from the heap, without
+    // deleting it
+    void DoRemoveTimer(size_t index);
+
+    // heap helpers: put the schedule at the given position and move it up or
+    // down the heap until the heap property is restored
+    void SetAt(size_t index, wxTimerSchedule *s);
+    void SiftUp(size_t index, wxTimerSchedule *s);
+    void SiftDown(size_t index, wxTimerSchedule *s);
+
+    // return true if the schedule "s1" must expire before "s2"
+    static bool ExpiresBefore(const wxTimerSchedule *s1,
+                              const wxTimerSchedule *s2)
+    {
+        return s1->m_expiration < s2->m_expiration ||
+                (s1->m_expiration == s2->m_expiration && s1->m_seq < s2->m_seq);
+    }
+
+
+    // the heap of all currently active timers, the one expiring first is
+    // always at its top, i.e. the first element
+    wxTimerHeap m_timers;
+
+    // the sequence number to use for the next added timer
+    unsigned long m_nextSeq;
+
+#ifdef wxHAS_TIMERFD
+    // the handler of the timer fd, NULL if we don't use it (yet)
+    wxTimerFDHandler *m_timerFD;
+
+    // true if we had already tried to create m_timerFD, so that we don't try
+    // again if it failed
+    bool m_triedTimerFD;
 
-    // the list of all currently active timers sorted by expiration
-    wxTimerList m_timers;
+    // true if the timer fd has expired since the last NotifyExpired() call
+    bool m_timerFDExpired;
+#endif // wxHAS_TIMERFD
 
     static wxTimerScheduler *ms_instance;
 };
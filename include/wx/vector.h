@@ -35,6 +35,9 @@ inline void wxVectorSort(wxVector<T>& v)
 
 #include "wx/beforestd.h"
 #include <new> // for placement new
+#ifdef wxHAS_RVALUE_REF
+    #include <utility> // for std::move()
+#endif
 #include "wx/afterstd.h"
 
 namespace wxPrivate
@@ -44,6 +47,18 @@ namespace wxPrivate
 // two implementations, both in generic way for any C++ types and as an
 // optimized version for "movable" types that uses realloc() and memmove().
 
+// relocate the object, moving rather than copying it if possible
+template<typename T>
+inline void wxVectorRelocate(T* dest, T& source)
+{
+#ifdef wxHAS_RVALUE_REF
+    ::new(dest) T(std::move(source));
+#else
+    ::new(dest) T(source);
+#endif
+    source.~T();
+}
+
 // version for movable types:
 template<typename T>
 struct wxVectorMemOpsMovable
@@ -72,10 +87,7 @@ struct wxVectorMemOpsGeneric
     {
         T *mem = (T*)::operator new(newCapacity * sizeof(T));
         for ( size_t i = 0; i < occupiedSize; i++ )
-        {
-            ::new(mem + i) T(old[i]);
-            old[i].~T();
-        }
+            wxVectorRelocate(mem + i, old[i]);
         ::operator delete(old);
         return mem;
     }
@@ -86,10 +98,7 @@ struct wxVectorMemOpsGeneric
         T* destptr = dest;
         T* sourceptr = source;
         for ( size_t i = count; i > 0; --i, ++destptr, ++sourceptr )
-        {
-            ::new(destptr) T(*sourceptr);
-            sourceptr->~T();
-        }
+            wxVectorRelocate(destptr, *sourceptr);
     }
 
     static void MemmoveForward(T* dest, T* source, size_t count)
@@ -98,10 +107,7 @@ struct wxVectorMemOpsGeneric
         T* destptr = dest + count - 1;
         T* sourceptr = source + count - 1;
         for ( size_t i = count; i > 0; --i, --destptr, --sourceptr )
-        {
-            ::new(destptr) T(*sourceptr);
-            sourceptr->~T();
-        }
+            wxVectorRelocate(destptr, *sourceptr);
     }
 };
 
@@ -200,6 +206,13 @@ public:
         Copy(c);
     }
 
+#ifdef wxHAS_RVALUE_REF
+    wxVector(wxVector&& c) : m_size(0), m_capacity(0), m_values(NULL)
+    {
+        swap(c);
+    }
+#endif // wxHAS_RVALUE_REF
+
     ~wxVector()
     {
         clear();
@@ -242,7 +255,7 @@ public:
         if ( m_capacity + increment > n )
             n = m_capacity + increment;
 
-        m_values = Ops::Realloc(m_values, n * sizeof(value_type), m_size);
+        m_values = Ops::Realloc(m_values, n, m_size);
         m_capacity = n;
     }
 
@@ -287,6 +300,14 @@ public:
         return *this;
     }
 
+#ifdef wxHAS_RVALUE_REF
+    wxVector& operator=(wxVector&& vb)
+    {
+        swap(vb);
+        return *this;
+    }
+#endif // wxHAS_RVALUE_REF
+
     void push_back(const value_type& v)
     {
         reserve(size() + 1);
@@ -303,6 +324,18 @@ public:
         m_size++;
     }
 
+#ifdef wxHAS_RVALUE_REF
+    void push_back(value_type&& v)
+    {
+        reserve(size() + 1);
+
+        void* const place = m_values + m_size;
+        ::new(place) value_type(std::move(v));
+
+        m_size++;
+    }
+#endif // wxHAS_RVALUE_REF
+
     void pop_back()
     {
         erase(end() - 1);
@@ -186,6 +186,25 @@ public:
     */
     void ResumeProcessingOfPendingEvents();
 
+    /**
+        Sets the limits on the number of pending events of a single handler
+        processed in one go.
+
+        By default ProcessPendingEvents() processes a single pending event of
+        each handler before passing to the next one, which is fair but results
+        in a lot of overhead when many events are queued for the same handler,
+        e.g. by a worker thread. Calling this function allows to process up to
+        @a maxEvents events of the same handler in a row, or all of its events
+        if @a maxEvents is 0, while stopping earlier if more than @a maxTime
+        microseconds have elapsed, unless it is 0.
+
+        Destroying the handler from inside one of its event handlers is safe,
+        the remaining events are simply not processed in this case.
+
+        @since 2.9.4
+    */
+    void SetPendingEventsBatch(size_t maxEvents, unsigned long maxTime = 0);
+
     //@}
 
     /**
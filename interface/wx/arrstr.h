@@ -96,6 +96,18 @@ public:
     */
     size_t Add(const wxString& str, size_t copies = 1);
 
+    /**
+        Appends the temporary string @a str to the array, moving it into the
+        array instead of copying it, and returns its index.
+
+        This overload is only available if the compiler supports C++11 rvalue
+        references (@c wxHAS_RVALUE_REF is defined) and when not using
+        standard containers, as @c std::vector<> already provides it then.
+
+        @since 2.9.4
+    */
+    size_t Add(wxString&& str);
+
     /**
         Preallocates enough memory to store @a nCount items.
 
@@ -39,5 +39,44 @@ void wxAtomicInc(wxAtomicInt& value);
 */
 wxInt32 wxAtomicDec(wxAtomicInt& value);
 
+/**
+    This function atomically replaces @a value with @a desired if, and only
+    if, it is currently equal to @a expected.
+
+    Returns @true if the value was replaced or @false if it was different from
+    @a expected and so was left unchanged. The function also acts as a full
+    memory barrier.
+
+    As with wxAtomicInc(), a generic and much less efficient implementation
+    is used if wxHAS_ATOMIC_OPS is not defined.
+
+    @since 2.9.4
+
+    @header{wx/atomic.h}
+*/
+bool wxAtomicCompareAndSwap(wxUint32& value, wxUint32 expected, wxUint32 desired);
+
+/**
+    Pointer version of wxAtomicCompareAndSwap().
+
+    This function also exists as a template for pointers of any type @c T.
+
+    @since 2.9.4
+
+    @header{wx/atomic.h}
+*/
+bool wxAtomicCompareAndSwapPtr(void * volatile& ptr, void *expected, void *desired);
+
+/**
+    Atomically replaces the pointer @a ptr with @a value and returns its
+    previous value.
+
+    @since 2.9.4
+
+    @header{wx/atomic.h}
+*/
+template <typename T>
+T *wxAtomicExchangePtr(T * volatile& ptr, T *value);
+
 //@}
 
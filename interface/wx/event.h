@@ -67,6 +67,102 @@ enum wxEventCategory
         wxEVT_CATEGORY_TIMER|wxEVT_CATEGORY_THREAD
 };
 
+/**
+    Statistics about wxEventAllocator use returned by wxEventAllocator::GetStats().
+
+    @since 2.9.4
+*/
+struct wxEventAllocatorStats
+{
+    /// Total number of allocated blocks.
+    unsigned long numAllocs;
+
+    /// Number of blocks which couldn't be reused and were allocated on heap.
+    unsigned long numHeapAllocs;
+
+    /// Total number of freed blocks.
+    unsigned long numFrees;
+
+    /// Number of freed blocks returned to the heap instead of being cached.
+    unsigned long numHeapFrees;
+};
+
+/**
+    @class wxEventAllocator
+
+    Allocator used for the objects of wxThreadEvent and wxCommandEvent classes
+    (and the classes deriving from them) and for the internal nodes of the
+    pending events queue.
+
+    These objects are often allocated in one thread, e.g. a worker thread
+    calling wxQueueEvent(), and freed in another one, e.g. the main thread
+    processing the event. Instead of returning their memory to the heap, it is
+    cached and reused for the next allocations, avoiding the heap overhead.
+    The memory blocks freed by one thread become available to the other
+    threads once enough of them accumulate.
+
+    The memory is only cached if the compiler supports thread-specific
+    variables, otherwise this class simply uses the global operator new and
+    delete. It is also not used if @c wxUSE_MEMORY_TRACING is on.
+
+    You don't normally need to use this class directly except for getting
+    statistics about its use with GetStats().
+
+    @library{wxbase}
+    @category{events}
+
+    @since 2.9.4
+*/
+class wxEventAllocator
+{
+public:
+    /**
+        Allocates a block of memory of at least the given size.
+
+        The block can be freed by any thread.
+    */
+    static void *Alloc(size_t size);
+
+    /**
+        Allocates a block of memory of at least the given size without
+        throwing.
+
+        This is the same as the other overload but returns @NULL instead of
+        throwing @c std::bad_alloc if there is not enough memory.
+    */
+    static void *Alloc(size_t size, const std::nothrow_t&);
+
+    /**
+        Frees a block previously allocated by Alloc().
+
+        @param p
+            The block to free, may be @NULL.
+        @param size
+            The size which was passed to Alloc() when allocating this block.
+    */
+    static void Free(void *p, size_t size);
+
+    /**
+        Releases all the blocks cached by the current thread.
+
+        This is done automatically when a wxThread terminates and so normally
+        doesn't need to be called. Notice that only the main thread and the
+        threads created by wxThread cache the blocks, the other threads always
+        allocate them from the heap and return them to it directly, as their
+        caches couldn't be released when they terminate.
+    */
+    static void ReleaseThreadCache();
+
+    /**
+        Returns the statistics of the allocator use.
+
+        The statistics include all the operations performed by the current
+        thread, but the operations done by the other threads are accounted for
+        only periodically, so the values may be slightly out of date.
+    */
+    static wxEventAllocatorStats GetStats();
+};
+
 /**
     @class wxEvent
 
@@ -591,6 +687,36 @@ public:
     */
     void DeletePendingEvents();
 
+    /**
+        Enables or disables coalescing of the queued events of the given type.
+
+        By default, all the events queued using QueueEvent() or
+        AddPendingEvent() are processed, in the order in which they were
+        queued. This may be undesirable for the events sent very frequently,
+        e.g. progress notifications sent by a worker thread, as only the last
+        one of them is really useful but the event loop can spend a lot of
+        time processing all the outdated ones.
+
+        When coalescing is enabled for @a eventType, queuing an event of this
+        type when another event with the same type and the same id is already
+        pending for this handler replaces the pending event with the new one,
+        which is then processed at the position in the queue of the event it
+        replaced. The replaced event is deleted immediately, i.e. possibly in
+        the thread calling QueueEvent().
+
+        Notice that queuing the events of the coalesced types needs to lock
+        an internal critical section and so is slower than queuing the other
+        events.
+
+        @param eventType
+            The type of the events to coalesce.
+        @param enable
+            @true to enable coalescing or @false to disable it again.
+
+        @since 2.9.4
+    */
+    void EnableEventCoalescing(wxEventType eventType, bool enable = true);
+
     /**
         Searches the event table, executing an event handler function if an appropriate
         one is found.
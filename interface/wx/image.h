@@ -23,6 +23,29 @@ enum wxImageResolution
     wxIMAGE_RESOLUTION_CM = 2
 };
 
+/**
+    Constants for wxImage::Paste() determining how the alpha channel of the
+    pasted image is used.
+
+    @since 2.9.4
+*/
+enum wxImageAlphaBlendMode
+{
+    /**
+        Replace the pixels of the image, including their alpha values, with
+        the pasted ones. This is the default.
+    */
+    wxIMAGE_ALPHA_BLEND_OVER = 0,
+
+    /**
+        Compose the pasted pixels over the existing ones using the alpha
+        channel of the pasted image, as when drawing it. The image gets an
+        alpha channel, if it didn't have it yet, and its pixels become more
+        opaque where the pasted pixels are drawn.
+    */
+    wxIMAGE_ALPHA_BLEND_COMPOSE = 1
+};
+
 /**
     Image resize algorithm.
 
@@ -58,7 +81,17 @@ enum wxImageResizeQuality
     image (meaning that both the new width and height will be smaller than
     the original size). Otherwise wxIMAGE_QUALITY_BICUBIC is used.
     */
-    wxIMAGE_QUALITY_HIGH
+    wxIMAGE_QUALITY_HIGH,
+
+    /**
+    Lanczos filter with the window of 3 pixels. This produces sharper results
+    than wxIMAGE_QUALITY_BICUBIC and, unlike it, also takes all the pixels of
+    the original image into account when reducing its size, which makes it
+    the best choice for creating the thumbnails.
+
+    @since 2.9.4
+    */
+    wxIMAGE_QUALITY_LANCZOS3
 };
 
 /**
@@ -95,6 +128,8 @@ enum wxImagePNGType
 
 #define wxIMAGE_OPTION_GIF_COMMENT                      wxString("GifComment")
 
+#define wxIMAGE_OPTION_JPEG_FAST_DECODE                 wxString("JpegFastDecode")
+
 #define wxIMAGE_OPTION_PNG_FORMAT                       wxString("PngFormat")
 #define wxIMAGE_OPTION_PNG_BITDEPTH                     wxString("PngBitDepth")
 #define wxIMAGE_OPTION_PNG_FILTER                       wxString("PngF")
@@ -125,6 +160,249 @@ enum
 };
 
 
+/**
+    @class wxImageRowSink
+
+    The interface used by wxImageHandler::LoadRows() to pass the decoded image
+    to the caller one row at a time.
+
+    This allows processing the images without keeping all of their data in
+    memory, e.g. wxImage uses it to create thumbnails of big images when the
+    @c wxIMAGE_OPTION_MAX_WIDTH or @c wxIMAGE_OPTION_MAX_HEIGHT options are
+    specified.
+
+    @since 2.9.4
+
+    @library{wxcore}
+    @category{gdi}
+
+    @see wxImageHandler::LoadRows()
+*/
+class wxImageRowSink
+{
+public:
+    /**
+        Called once before any rows are passed to ProcessRow().
+
+        @param width
+            The width of the image.
+        @param height
+            The height of the image.
+        @param hasAlpha
+            @true if the image has an alpha channel.
+
+        @return @true to continue loading or @false to abort it.
+    */
+    virtual bool Start(int width, int height, bool hasAlpha) = 0;
+
+    /**
+        Called exactly once for each row of the image.
+
+        Notice that the rows are not necessarily passed in top to bottom
+        order, e.g. the bottom-up BMP files pass them in the reverse order.
+
+        @param y
+            The index of the row, from 0 for the topmost row.
+        @param data
+            The RGB data of the row, i.e. 3 times the image width bytes. The
+            pointer is only valid during this call.
+        @param alpha
+            The alpha values of the row or @NULL if the image doesn't have
+            alpha channel. The pointer is only valid during this call.
+
+        @return @true to continue loading or @false to abort it.
+    */
+    virtual bool ProcessRow(int y,
+                            const unsigned char *data,
+                            const unsigned char *alpha) = 0;
+};
+
+
+/**
+    @class wxImageLoadCallback
+
+    The interface used by wxImage::LoadFiles() to pass the loaded images to
+    the caller.
+
+    @since 2.9.4
+
+    @library{wxcore}
+    @category{gdi}
+
+    @see wxImage::LoadFiles()
+*/
+class wxImageLoadCallback
+{
+public:
+    /**
+        Called for each of the files passed to wxImage::LoadFiles().
+
+        This function is called in the thread which called LoadFiles() and
+        in the order of the files.
+
+        @param n
+            The index of the file in the array passed to LoadFiles().
+        @param filename
+            The name of the file.
+        @param image
+            The loaded image or an invalid image if loading it failed. It can
+            be modified or copied by this function.
+
+        @return @true to continue loading the remaining files or @false to
+            stop and return from LoadFiles() as soon as possible.
+    */
+    virtual bool OnImageLoaded(size_t n,
+                               const wxString& filename,
+                               wxImage& image) = 0;
+};
+
+
+/**
+    @class wxImageDecodeCallback
+
+    The interface used by wxImageIncrementalDecoder to notify the application
+    about the progress of decoding.
+
+    @since 2.9.4
+
+    @library{wxcore}
+    @category{gdi}
+
+    @see wxImageHandler::CreateIncrementalDecoder()
+*/
+class wxImageDecodeCallback
+{
+public:
+    /**
+        Called when some rows of the image have been decoded.
+
+        For interlaced images the same rows can be passed to this function
+        several times, as their quality is progressively improved. The GIF
+        decoder only calls this function for all the rows of each frame at
+        once.
+
+        @param frame
+            The index of the frame being decoded, starting from 0.
+        @param image
+            The image containing everything decoded so far, the pixels which
+            haven't been decoded yet are black and, if the image has alpha,
+            transparent. The image data can be modified by the decoder after
+            this function returns, so it must be copied using wxImage::Copy()
+            if it needs to be kept.
+        @param yStart
+            The first updated row.
+        @param yEnd
+            One past the last updated row.
+
+        @return @true to continue decoding or @false to abort it.
+    */
+    virtual bool OnRowsDecoded(unsigned frame,
+                               const wxImage& image,
+                               int yStart,
+                               int yEnd) = 0;
+
+    /**
+        Called when a frame was completely decoded.
+
+        Unlike the image passed to OnRowsDecoded(), this one is not modified
+        by the decoder any more and can be simply kept.
+
+        @param frame
+            The index of the frame, starting from 0.
+        @param image
+            The decoded frame.
+
+        @return @true to continue decoding or @false to abort it.
+    */
+    virtual bool OnFrameDecoded(unsigned frame, const wxImage& image) = 0;
+};
+
+
+/**
+    @class wxImageIncrementalDecoder
+
+    Decoder to which the image data is passed in chunks as it becomes
+    available.
+
+    Unlike wxImage::LoadFile(), which blocks until all the image data was read
+    from the stream, this decoder can be fed with the data received from a
+    socket or a slow wxFileSystem handler chunk by chunk, so that the part of
+    the image which was already received can be shown to the user without
+    waiting for the rest of it.
+
+    Decoders are created by wxImageHandler::CreateIncrementalDecoder() and
+    are currently available for PNG and GIF images. Example:
+    @code
+        class ProgressiveView : public wxImageDecodeCallback
+        {
+        public:
+            virtual bool OnRowsDecoded(unsigned frame, const wxImage& image,
+                                       int yStart, int yEnd)
+            {
+                ... update the display of the given rows ...
+                return true;
+            }
+
+            virtual bool OnFrameDecoded(unsigned frame, const wxImage& image)
+            {
+                m_image = image;
+                return true;
+            }
+
+            wxImage m_image;
+        };
+
+        ProgressiveView view;
+        wxImageIncrementalDecoder* decoder = wxImage::FindHandler(wxBITMAP_TYPE_PNG)->
+            CreateIncrementalDecoder(view);
+
+        // in the socket event handler:
+        char buf[4096];
+        socket->Read(buf, sizeof(buf));
+        if ( !decoder->Feed(buf, socket->LastCount()) )
+            ... handle the error ...
+    @endcode
+
+    @since 2.9.4
+
+    @library{wxcore}
+    @category{gdi}
+*/
+class wxImageIncrementalDecoder
+{
+public:
+    /**
+        Destroys the decoder.
+    */
+    virtual ~wxImageIncrementalDecoder();
+
+    /**
+        Passes the next chunk of the image data to the decoder.
+
+        The decoder decodes as much of the data it has received so far as
+        possible and calls wxImageDecodeCallback functions to notify the
+        application about the results before returning.
+
+        @param data
+            Pointer to the data, which is copied by the decoder if necessary
+            and doesn't need to remain valid after this function returns.
+        @param len
+            The length of the data, which may be arbitrarily small.
+
+        @return @false if the data is invalid or the callback aborted
+            decoding, in which case the decoder can't be used any more.
+    */
+    virtual bool Feed(const void* data, size_t len) = 0;
+
+    /**
+        Returns @true once the end of the image data has been reached.
+
+        Any data passed to Feed() after this is ignored.
+    */
+    virtual bool IsDone() const = 0;
+};
+
+
 /**
     @class wxImageHandler
 
@@ -266,6 +544,77 @@ public:
     virtual bool LoadFile(wxImage* image, wxInputStream& stream,
                           bool verbose = true, int index = -1);
 
+    /**
+        Loads an image from a stream, passing its rows to the given sink.
+
+        Unlike LoadFile(), this function doesn't store the image data in
+        @a image, which is only used to retrieve the options affecting loading
+        and to store the options set by the handler, such as the image
+        resolution.
+
+        The default implementation loads the entire image using LoadFile()
+        and then passes its rows to the sink. The handlers returning @true
+        from CanLoadRows() override it to decode the image without keeping
+        all of it in memory.
+
+        @param image
+            The image object used for the options.
+        @param sink
+            The object receiving the image data.
+        @param stream
+            Opened input stream for reading image data.
+        @param verbose
+            If set to @true, errors reported by the image handler will produce
+            wxLogMessages.
+        @param index
+            The index of the image in the file (starting from zero).
+
+        @return @true if the operation succeeded, @false otherwise.
+
+        @since 2.9.4
+    */
+    virtual bool LoadRows(wxImage* image, wxImageRowSink& sink,
+                          wxInputStream& stream,
+                          bool verbose = true, int index = -1);
+
+    /**
+        Returns @true if LoadRows() is implemented without loading the entire
+        image in memory.
+
+        This is currently the case for the BMP, JPEG, PNG and TIFF handlers,
+        although some variants of these formats, e.g. compressed BMP or
+        interlaced PNG files, still need to be loaded entirely.
+
+        @since 2.9.4
+    */
+    virtual bool CanLoadRows() const;
+
+    /**
+        Creates a decoder for loading the image data incrementally.
+
+        The returned decoder can be fed with the image data as it becomes
+        available and notifies the given callback about the rows and frames
+        decoded so far.
+
+        The default implementation returns @NULL, currently only the PNG and
+        GIF handlers support incremental decoding.
+
+        @param callback
+            The object notified about the decoding progress, it must remain
+            valid during the lifetime of the decoder.
+        @param verbose
+            If set to @true, errors reported by the decoder will produce
+            wxLogMessages.
+
+        @return The new decoder which must be deleted by the caller or @NULL
+            if this handler doesn't support incremental decoding.
+
+        @since 2.9.4
+    */
+    virtual wxImageIncrementalDecoder*
+    CreateIncrementalDecoder(wxImageDecodeCallback& callback,
+                             bool verbose = true);
+
     /**
         Saves a image in the output stream.
 
@@ -432,6 +781,13 @@ const unsigned char wxIMAGE_ALPHA_OPAQUE = 0xff;
     Saving GIFs requires images of maximum 8 bpp (see wxQuantize), and the alpha channel converted to a mask (see wxImage::ConvertAlphaToMask).
     Saving an animated GIF requires images of the same size (see wxGIFHandler::SaveAnimation)
 
+    All the handlers listed above are reentrant, i.e. the same handler can be
+    used to load different images in several threads at once (GIF images are
+    saved by one thread at a time however). This is notably required by
+    wxImage::LoadFiles(), so the custom handlers should be reentrant too.
+    Notice that wxImage objects themselves are not thread-safe, so each thread
+    must use its own images.
+
     @library{wxcore}
     @category{gdi}
 
@@ -772,8 +1128,17 @@ public:
 
     /**
         Copy the data of the given @a image to the specified position in this image.
+
+        By default, the data of the pasted image, including its alpha channel
+        if it has one, simply replaces the data of this image. If @a alphaBlend
+        is wxIMAGE_ALPHA_BLEND_COMPOSE and the pasted image has alpha, it is
+        composed over this image instead, i.e. the existing pixels remain
+        visible through the transparent parts of the pasted image.
+
+        @since 2.9.4 The @a alphaBlend parameter.
     */
-    void Paste(const wxImage& image, int x, int y);
+    void Paste(const wxImage& image, int x, int y,
+               wxImageAlphaBlendMode alphaBlend = wxIMAGE_ALPHA_BLEND_OVER);
 
     /**
         Replaces the colour specified by @e r1,g1,b1 by the colour @e r2,g2,b2.
@@ -1177,11 +1542,15 @@ public:
             max width given if it is not 0 @em and its height is less than the
             max height given if it is not 0. This is typically used for loading
             thumbnails and the advantage of using these options compared to
-            calling Rescale() after loading is that some handlers (only JPEG
-            one right now) support rescaling the image during loading which is
-            vastly more efficient than loading the entire huge image and
-            rescaling it later (if these options are not supported by the
-            handler, this is still what happens however). These options must be
+            calling Rescale() after loading is that some handlers support
+            rescaling the image during loading which is vastly more efficient
+            than loading the entire huge image and rescaling it later (if these
+            options are not supported by the handler, this is still what
+            happens however). JPEG handler decodes the image at the reduced
+            size directly while the other handlers for which
+            wxImageHandler::CanLoadRows() returns @true reduce the image by
+            averaging the blocks of its pixels as it is being read, without
+            ever keeping the full size image in memory. These options must be
             set before calling LoadFile() to have any effect.
 
         @li @c wxIMAGE_OPTION_ORIGINAL_WIDTH and @c wxIMAGE_OPTION_ORIGINAL_HEIGHT:
@@ -1209,6 +1578,15 @@ public:
             the image provides the resolution information and can be queried
             after loading the image.
 
+        Options specific to wxJPEGHandler:
+        @li @c wxIMAGE_OPTION_JPEG_FAST_DECODE: If this option is set to a
+            non-zero value before loading the image, faster but less precise
+            integer inverse DCT and chroma upsampling algorithms are used.
+            This is typically useful for loading thumbnails or previews,
+            together with @c wxIMAGE_OPTION_MAX_WIDTH and
+            @c wxIMAGE_OPTION_MAX_HEIGHT. This option is available since
+            wxWidgets 2.9.4.
+
         Options specific to wxPNGHandler:
         @li @c wxIMAGE_OPTION_PNG_FORMAT: Format for saving a PNG file, see
             wxImagePNGType for the supported values.
@@ -1408,6 +1786,10 @@ public:
             See the description in the LoadFile(wxInputStream&, wxBitmapType, int) overload.
         @param index
             See the description in the LoadFile(wxInputStream&, wxBitmapType, int) overload.
+
+        If the global wxImageCache is enabled, the image is taken from it if
+        the same file was already loaded with the same parameters and options
+        and stored in it otherwise.
     */
     virtual bool LoadFile(const wxString& name,
                           wxBitmapType type = wxBITMAP_TYPE_ANY,
@@ -1423,10 +1805,75 @@ public:
             MIME type string (for example 'image/jpeg')
         @param index
             See the description in the LoadFile(wxInputStream&, wxBitmapType, int) overload.
+
+        The global wxImageCache is used by this function in the same way as
+        by the overload taking wxBitmapType.
     */
     virtual bool LoadFile(const wxString& name, const wxString& mimetype,
                           int index = -1);
 
+    /**
+        Loads several image files using multiple threads.
+
+        The files are loaded concurrently by the threads of the global
+        wxThreadPool, but @a callback is always called in the thread calling
+        this function and in the same order as the files appear in @a names,
+        so it doesn't need to be thread-safe. Only a limited number of images
+        is loaded in advance, so the images can be processed by the callback
+        without keeping all of them in memory at once.
+
+        This can be used to create thumbnails of all images in a directory:
+        @code
+            class ThumbnailsLoader : public wxImageLoadCallback
+            {
+            public:
+                virtual bool OnImageLoaded(size_t n, const wxString& filename,
+                                           wxImage& image)
+                {
+                    if ( image.IsOk() )
+                        m_thumbnails.push_back(image);
+
+                    return true;
+                }
+
+                wxVector<wxImage> m_thumbnails;
+            };
+
+            wxArrayString names;
+            wxDir::GetAllFiles(dir, &names, "*.jpg", wxDIR_FILES);
+
+            wxImage options;
+            options.SetOption(wxIMAGE_OPTION_MAX_WIDTH, 128);
+            options.SetOption(wxIMAGE_OPTION_MAX_HEIGHT, 128);
+
+            ThumbnailsLoader loader;
+            wxImage::LoadFiles(names, loader, wxBITMAP_TYPE_JPEG, &options);
+        @endcode
+
+        Notice that the image handlers used for loading the files must be
+        reentrant, which is the case for all the handlers provided by
+        wxWidgets, see @ref image_handlers.
+
+        @param names
+            Names of the files to load.
+        @param callback
+            The object receiving the loaded images.
+        @param type
+            The type of the images, see LoadFile(wxInputStream&, wxBitmapType, int).
+        @param options
+            If not @NULL, the options of this image are used for all the loaded
+            images, e.g. @c wxIMAGE_OPTION_MAX_WIDTH can be set to load reduced
+            images.
+
+        @return The number of successfully loaded images.
+
+        @since 2.9.4
+    */
+    static size_t LoadFiles(const wxArrayString& names,
+                            wxImageLoadCallback& callback,
+                            wxBitmapType type = wxBITMAP_TYPE_ANY,
+                            const wxImage* options = NULL);
+
     /**
         Loads an image from an input stream.
 
@@ -1767,6 +2214,11 @@ public:
     /**
         Returns the static list of image format handlers.
 
+        Notice that, unlike the other handler management functions, which can
+        be called from any thread, the list returned by this function must
+        not be modified nor iterated over while handlers can be added to it
+        by the other threads.
+
         @see wxImageHandler
     */
     static wxList& GetHandlers();
@@ -1892,6 +2344,37 @@ public:
         Converts a color in HSV color space to RGB color space.
     */
     static wxImage::RGBValue HSVtoRGB(const wxImage::HSVValue& hsv);
+
+    /**
+        Sets the maximal number of threads used by the functions processing
+        the entire image.
+
+        The functions such as Scale(), Rescale(), Blur(), Rotate90() or
+        ConvertToGreyscale() can split the image in bands processed in
+        parallel by the threads of the default wxThreadPool. The results are
+        always exactly the same as when a single thread is used, only the
+        processing time changes. Notice that small images are always
+        processed by a single thread as the overhead of using several of them
+        would outweigh the gain.
+
+        @param numThreads
+            The maximal number of threads to use, including the current one.
+            The default value of 1 means that the current thread only is
+            used, i.e. that parallel processing is disabled, while 0 means
+            using as many threads as there are CPUs in the system.
+
+        @see GetMaxThreads(), wxThreadPool
+
+        @since 2.9.4
+    */
+    static void SetMaxThreads(unsigned numThreads);
+
+    /**
+        Returns the maximal number of threads set by SetMaxThreads().
+
+        @since 2.9.4
+    */
+    static unsigned GetMaxThreads();
 };
 
 
@@ -0,0 +1,159 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        imagecache.h
+// Purpose:     interface of wxImageCache
+// Author:      agent
+// Created:     2026-10-17
+// RCS-ID:      $Id$
+// Copyright:   (c) 2026 agent <agent@local>
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+    @class wxImageCache
+
+    Cache of decoded images limited by the amount of memory they use.
+
+    Applications repeatedly loading the same image files, for example icons or
+    thumbnails shown again after scrolling, may use this class to avoid
+    decoding them every time. The cache keeps the images using at most the
+    given amount of memory and discards the least recently used ones when
+    adding a new image would exceed it.
+
+    The global cache returned by Get() is used by wxImage::LoadFile() taking
+    the file name: if it is enabled, by giving it a non-zero budget with
+    SetMaxMemory(), the images are looked up in it using a key including the
+    full path, size and modification time of the file, the requested image
+    type or MIME type and index and all the options of the image set with
+    wxImage::SetOption() before loading, and stored in it after loading. Any
+    change to the file results in it being loaded again. Images loaded from
+    streams are not cached automatically, but can be cached explicitly using
+    Lookup() and Store() with any key uniquely identifying the stream
+    contents, e.g. its URL:
+    @code
+        wxImage image;
+        if ( !cache.Lookup(url, &image) )
+        {
+            if ( !image.LoadFile(*stream) )
+                ... handle the error ...
+
+            cache.Store(url, image);
+        }
+    @endcode
+
+    All the methods of this class are thread-safe and the images returned by
+    Lookup() don't share any data with the cached images, so they can be
+    freely modified and used in any thread.
+
+    @since 2.9.4
+
+    @library{wxcore}
+    @category{gdi}
+*/
+class wxImageCache
+{
+public:
+    /**
+        Creates a cache using at most the given number of bytes.
+
+        A cache with zero memory budget is disabled and doesn't store
+        anything.
+    */
+    explicit wxImageCache(size_t maxMemory = 0);
+
+    /**
+        Destroys the cache and all the images in it.
+    */
+    ~wxImageCache();
+
+    /**
+        Returns the global cache used by wxImage::LoadFile().
+
+        This cache is disabled by default, call SetMaxMemory() to enable it.
+    */
+    static wxImageCache& Get();
+
+    /**
+        Changes the maximal amount of memory used by the images in the cache.
+
+        If the cache currently uses more memory than @a maxMemory, the least
+        recently used images are removed from it. Setting the budget to 0
+        disables the cache and removes all images from it.
+    */
+    void SetMaxMemory(size_t maxMemory);
+
+    /**
+        Returns the memory budget set by SetMaxMemory() or passed to ctor.
+    */
+    size_t GetMaxMemory() const;
+
+    /**
+        Returns @true if the memory budget is not 0.
+    */
+    bool IsEnabled() const;
+
+    /**
+        Returns the number of bytes used by the data of all the cached images.
+
+        This is the sum of 3 bytes per pixel for the images without alpha
+        channel and 4 bytes per pixel for the images with it.
+    */
+    size_t GetMemoryUsed() const;
+
+    /**
+        Returns the number of cached images.
+    */
+    size_t GetCount() const;
+
+    /**
+        Looks up the image with the given key.
+
+        If the image is found, it becomes the most recently used one.
+
+        @param key
+            The key which was passed to Store().
+        @param image
+            Non-@NULL pointer filled with a copy of the cached image if it was
+            found and left unchanged otherwise.
+        @return @true if the image was found.
+    */
+    bool Lookup(const wxString& key, wxImage* image);
+
+    /**
+        Stores a copy of the image under the given key.
+
+        If another image was already stored with the same key, it is
+        replaced. The least recently used images are removed from the cache
+        if necessary to make place for the new one.
+
+        @return @false if the image is bigger than the memory budget of the
+            cache, in which case it is not stored.
+    */
+    bool Store(const wxString& key, const wxImage& image);
+
+    /**
+        Removes the image with the given key from the cache.
+
+        @return @true if the image was found and removed.
+    */
+    bool Remove(const wxString& key);
+
+    /**
+        Removes all images from the cache.
+    */
+    void Clear();
+
+    /**
+        Returns the number of Lookup() calls which found the image.
+    */
+    unsigned long GetHits() const;
+
+    /**
+        Returns the number of Lookup() calls which didn't find the image.
+    */
+    unsigned long GetMisses() const;
+
+    /**
+        Resets the counters returned by GetHits() and GetMisses() to 0.
+    */
+    void ResetStatistics();
+};
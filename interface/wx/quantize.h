@@ -6,6 +6,36 @@
 // Licence:     wxWindows licence
 /////////////////////////////////////////////////////////////////////////////
 
+/**
+    Flags used by wxQuantize::Quantize().
+*/
+enum
+{
+    /// Reserve the first 20 palette entries for the Windows system colours.
+    wxQUANTIZE_INCLUDE_WINDOWS_COLOURS      = 0x01,
+
+    /// Return the image data as palette indices in @c eightBitData.
+    wxQUANTIZE_RETURN_8BIT_DATA             = 0x02,
+
+    /// Fill the destination image with the quantized colours.
+    wxQUANTIZE_FILL_DESTINATION_IMAGE       = 0x04,
+
+    /**
+        Use a faster algorithm instead of the default one.
+
+        The default algorithm is the median cut with Floyd-Steinberg
+        dithering from the IJG library. The fast one uses Wu's colour
+        quantization algorithm, which usually results in a palette closer to
+        the original colours, and doesn't dither the image, so the result may
+        look more banded for the images with smooth gradients. It also maps
+        the pixels to the palette using several threads if allowed by
+        wxImage::SetMaxThreads().
+
+        @since 2.9.4
+    */
+    wxQUANTIZE_FAST                         = 0x08
+};
+
 /**
     @class wxQuantize
 
@@ -32,10 +62,15 @@ public:
         (@a in_rows contains @a w * 3 bytes per row, @a out_rows @a w bytes per row).
         Fills @a out_rows with indexes into palette (which is also stored into @a palette
         variable).
+
+        The @a flags parameter may contain ::wxQUANTIZE_FAST to use the faster
+        algorithm, all the other flags are ignored by this function. It was
+        added in wxWidgets 2.9.4.
     */
     static void DoQuantize(unsigned int w, unsigned int h,
                            unsigned char** in_rows, unsigned char** out_rows,
-                           unsigned char* palette, int desiredNoColours);
+                           unsigned char* palette, int desiredNoColours,
+                           int flags = 0);
 
     /**
         Reduce the colours in the source image and put the result into the destination image.
@@ -69,6 +69,25 @@ public:
     */
     static size_t GetMaxMBNulLen();
 
+    /**
+        Returns @true if ToWChar() and FromWChar() can be called with the
+        output buffer which may be too small for the result.
+
+        The conversion functions of the classes returning @true from this
+        method must return ::wxCONV_FAILED without writing beyond the end of
+        the output buffer and without changing any internal conversion state
+        if it is too small. This allows ToWCharBuffer() and FromWCharBuffer()
+        to try converting the input into a buffer of the maximal size which
+        could be needed for it instead of computing the exact size first.
+
+        The default implementation returns @false, so this method should be
+        overridden in the derived classes satisfying the above conditions to
+        allow the conversions using them to be faster.
+
+        @since 2.9.4
+    */
+    virtual bool CanConvertInOnePass() const;
+
     /**
         Convert multibyte string to a wide character one.
 
@@ -238,6 +257,52 @@ public:
      */
     const wxCharBuffer cWC2MB(const wxWCharBuffer& buf) const;
 
+    /**
+        Converts from multibyte encoding to Unicode into a buffer allocated by
+        this function itself.
+
+        This function is similar to cMB2WC() but, for the converters which
+        support it (see CanConvertInOnePass()), converts the input only once
+        by converting it into a buffer big enough for the result of any input
+        of the given length and then shrinking it, instead of calling
+        ToWChar() twice: once to find the length of the output and then again
+        to do the conversion. It should be preferred to cMB2WC() in the
+        performance-sensitive code.
+
+        @param dst
+            The buffer which is reallocated to hold the result. On success,
+            its length is set to the return value of this function and it is
+            always @c NUL-terminated, even if the input is not.
+        @param src
+            The input string.
+        @param srcLen
+            The length of the input string or ::wxNO_LEN if it is @c NUL
+            terminated.
+
+        @return
+            The number of characters written to @a dst, with the same meaning
+            as the return value of ToWChar(), i.e. including the trailing @c
+            NUL if @a srcLen is ::wxNO_LEN, or ::wxCONV_FAILED on error, in
+            which case @a dst is left unchanged.
+
+        @since 2.9.4
+     */
+    size_t ToWCharBuffer(wxWCharBuffer& dst,
+                         const char* src, size_t srcLen = wxNO_LEN) const;
+
+    /**
+        Converts from Unicode to multibyte encoding into a buffer allocated by
+        this function itself.
+
+        This is the counterpart of ToWCharBuffer(), see its description for
+        more details. The output buffer is terminated by as many @c NUL bytes
+        as returned by GetMBNulLen().
+
+        @since 2.9.4
+     */
+    size_t FromWCharBuffer(wxCharBuffer& dst,
+                           const wchar_t* src, size_t srcLen = wxNO_LEN) const;
+
     //@{
     /**
         Converts from Unicode to the current wxChar type.
@@ -85,6 +85,20 @@
     @endFlagTable
 
 
+    @section sysopt_unix Unix
+
+    @beginFlagTable
+    @flag{unix.fdio-dispatcher}
+        Selects the mechanism used for monitoring the file descriptors, e.g.
+        sockets, in the console applications. Supported values are "epoll"
+        (the default under Linux), "io_uring" and "select". If the selected
+        mechanism is not available, the default one is used instead. This
+        option must be set before the first wxEventLoop or wxSocketBase is
+        created. io_uring support is available since wxWidgets 2.9.4 and
+        requires Linux 5.11 or later.
+    @endFlagTable
+
+
     @section sysopt_gtk GTK+
 
     @beginFlagTable
@@ -0,0 +1,288 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        wx/threadpool.h
+// Purpose:     interface of wxThreadPool and wxThreadPoolTask
+// Author:      agent
+// Created:     2026-10-16
+// RCS-ID:      $Id$
+// Copyright:   (c) 2026 agent <agent@local>
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+    The state of a wxThreadPoolTask.
+
+    @since 2.9.4
+    @category{threading}
+ */
+enum wxThreadPoolTaskState
+{
+    /// The task was not submitted yet or is waiting in the queue of the pool.
+    wxTHREAD_POOL_TASK_PENDING,
+
+    /// The wxThreadPoolTask::Run() method of the task is being executed.
+    wxTHREAD_POOL_TASK_RUNNING,
+
+    /// The task has finished running.
+    wxTHREAD_POOL_TASK_DONE,
+
+    /**
+        The task was cancelled.
+
+        This happens if wxThreadPoolTask::Cancel() is called for a pending
+        task, which is then never run, or if the task ran after its
+        cancellation had been requested.
+     */
+    wxTHREAD_POOL_TASK_CANCELLED
+};
+
+/**
+    wxThreadPoolTask is the base class for the units of work executed by
+    wxThreadPool.
+
+    Derive from this class and override its Run() method to perform the work
+    of the task. The tasks are reference counted as they are shared between
+    the code creating them and the pool: the task is created with the
+    reference count of 1 and must be released using DecRef() when it is not
+    needed any more, the pool keeps its own reference while the task is
+    queued or running.
+
+    The completion of the task can be waited for using Wait() or, in the GUI
+    code which shouldn't block, notified by the wxEVT_THREAD_POOL_TASK event
+    which is queued, using wxEvtHandler::QueueEvent(), to the handler
+    specified with SetCompletionHandler(). This event is a wxThreadEvent
+    whose id is the id of the task and whose wxCommandEvent::GetInt() value
+    is its final state, i.e. either ::wxTHREAD_POOL_TASK_DONE or
+    ::wxTHREAD_POOL_TASK_CANCELLED.
+
+    Example:
+    @code
+        class SumTask : public wxThreadPoolTask
+        {
+        public:
+            SumTask(const int *data, size_t count)
+                : m_data(data), m_count(count), m_sum(0) { }
+
+            long GetSum() const { return m_sum; }
+
+        protected:
+            virtual void Run()
+            {
+                for ( size_t n = 0; n < m_count && !IsCancelRequested(); n++ )
+                    m_sum += m_data[n];
+            }
+
+        private:
+            const int * const m_data;
+            const size_t m_count;
+            long m_sum;
+        };
+
+        SumTask *task = new SumTask(data, count);
+        wxThreadPool::Get().Submit(task);
+        ... do something else ...
+        task->Wait();
+        wxLogMessage("The sum is %ld", task->GetSum());
+        task->DecRef();
+    @endcode
+
+    @beginEventEmissionTable{wxThreadEvent}
+    @event{EVT_THREAD_POOL_TASK(id, func)}
+        Process a @c wxEVT_THREAD_POOL_TASK event, sent when the task with
+        the given id finishes running or is cancelled.
+    @endEventTable
+
+    @since 2.9.4
+
+    @library{wxbase}
+    @category{threading}
+
+    @see wxThreadPool
+*/
+class wxThreadPoolTask
+{
+public:
+    /**
+        Constructor.
+
+        @param id
+            The id of the task used for its completion event.
+     */
+    wxThreadPoolTask(int id = wxID_ANY);
+
+    /**
+        Increments the reference count of the task.
+     */
+    void IncRef();
+
+    /**
+        Decrements the reference count of the task and deletes it if it
+        reaches 0.
+     */
+    void DecRef();
+
+    /**
+        Returns the id of the task specified in the constructor.
+     */
+    int GetId() const;
+
+    /**
+        Sets the handler to which the completion event is queued.
+
+        The handler must remain alive until the event is processed. This
+        method must be called before submitting the task to the pool.
+     */
+    void SetCompletionHandler(wxEvtHandler *handler);
+
+    /**
+        Returns the current state of the task.
+     */
+    wxThreadPoolTaskState GetState() const;
+
+    /**
+        Returns @true if the task has finished running or was cancelled.
+     */
+    bool IsFinished() const;
+
+    /**
+        Cancels the task.
+
+        If the task hasn't started running yet, it will not be run at all and
+        @true is returned. Otherwise @false is returned and
+        IsCancelRequested() returns @true from now on, which Run() should
+        check periodically to stop as soon as possible.
+
+        This method can be called from any thread.
+     */
+    bool Cancel();
+
+    /**
+        Returns @true if the cancellation of the task was requested by
+        calling Cancel() or wxThreadPool::CancelAll().
+     */
+    bool IsCancelRequested() const;
+
+    /**
+        Waits until the task finishes.
+
+        If this method is called from a task running in the same pool, the
+        calling thread executes the other tasks while waiting, so tasks can
+        safely submit subtasks and wait for them even if the pool has a
+        single thread.
+     */
+    void Wait();
+
+    /**
+        Waits until the task finishes or the timeout expires.
+
+        @return @true if the task finished or @false if the timeout expired.
+     */
+    bool WaitTimeout(unsigned long milliseconds);
+
+protected:
+    /**
+        The destructor is protected, use DecRef() to delete the task.
+     */
+    virtual ~wxThreadPoolTask();
+
+    /**
+        Performs the work of the task.
+
+        This method is called in one of the threads of the pool and must be
+        overridden in the derived classes.
+     */
+    virtual void Run() = 0;
+};
+
+/**
+    wxThreadPool executes wxThreadPoolTask objects using a fixed set of
+    worker threads.
+
+    Each thread of the pool has its own queue of tasks: the tasks submitted
+    from inside a running task are added to the queue of the thread running
+    it and the most recently added ones are executed first, which is optimal
+    for the tasks recursively splitting their work into subtasks. The tasks
+    submitted from the other threads are added to a queue shared by all the
+    threads of the pool. A thread without any tasks in its own queue takes
+    them from the shared queue or steals the oldest tasks from the queues of
+    the other threads, which distributes the work between all the threads
+    without using a single global lock.
+
+    Besides creating its own pools, the application can use the default one
+    returned by Get().
+
+    @since 2.9.4
+
+    @library{wxbase}
+    @category{threading}
+
+    @see wxThreadPoolTask, wxThread
+*/
+class wxThreadPool
+{
+public:
+    /**
+        Creates the pool with the given number of threads.
+
+        @param numThreads
+            The number of threads to use, if 0 the number of CPUs returned
+            by wxThread::GetCPUCount() is used.
+     */
+    wxThreadPool(unsigned numThreads = 0);
+
+    /**
+        Destroys the pool.
+
+        All the pending tasks are cancelled and the destructor waits until
+        the running ones finish.
+     */
+    ~wxThreadPool();
+
+    /**
+        Returns @true if the threads of the pool were created successfully.
+     */
+    bool IsOk() const;
+
+    /**
+        Returns the number of threads in the pool.
+     */
+    unsigned GetThreadCount() const;
+
+    /**
+        Submits a task for execution.
+
+        The pool takes its own reference to the task which it releases when
+        the task finishes, so the caller may call wxThreadPoolTask::DecRef()
+        immediately if it is not interested in the task any more.
+
+        This method can be called from any thread, including the threads of
+        the pool itself.
+
+        @return @false if the task was already cancelled or the pool is being
+            destroyed.
+     */
+    bool Submit(wxThreadPoolTask *task);
+
+    /**
+        Cancels all the tasks submitted to the pool.
+
+        The pending tasks are not run and wxThreadPoolTask::IsCancelRequested()
+        returns @true for the running ones. The tasks submitted after calling
+        this method are not affected.
+     */
+    void CancelAll();
+
+    /**
+        Waits until all the submitted tasks finish.
+
+        This method can't be called from the tasks running in the pool.
+     */
+    void WaitAll();
+
+    /**
+        Returns the default pool with one thread per CPU.
+
+        The pool is created on the first call to this function and destroyed
+        during the library shutdown.
+     */
+    static wxThreadPool& Get();
+};
@@ -37,6 +37,7 @@
 #endif //WX_PRECOMP
 
 #include "wx/apptrait.h"
+#include "wx/atomic.h"
 #include "wx/cmdline.h"
 #include "wx/confbase.h"
 #include "wx/evtloop.h"
@@ -44,8 +45,10 @@
 #include "wx/msgout.h"
 #include "wx/scopedptr.h"
 #include "wx/sysopt.h"
+#include "wx/time.h"
 #include "wx/tokenzr.h"
 #include "wx/thread.h"
+#include "wx/weakref.h"
 
 #if wxUSE_EXCEPTIONS && wxUSE_STL
     #include <exception>
@@ -137,7 +140,10 @@ wxAppConsoleBase::wxAppConsoleBase()
 {
     m_traits = NULL;
     m_mainLoop = NULL;
+    m_scheduledHandlers = NULL;
     m_bDoPendingEventProcessing = true;
+    m_pendingEventsBatchSize = 1;
+    m_pendingEventsBatchTime = 0;
 
     ms_appInstance = static_cast<wxAppConsole *>(this);
 
@@ -426,6 +432,9 @@ void wxAppConsoleBase::RemovePendingEventHandler(wxEvtHandler* toRemove)
 {
     wxENTER_CRIT_SECT(m_handlersWithPendingEventsLocker);
 
+    // the handler could have been scheduled but not merged yet
+    MergeScheduledHandlers();
+
     if (m_handlersWithPendingEvents.Index(toRemove) != wxNOT_FOUND)
     {
         m_handlersWithPendingEvents.Remove(toRemove);
@@ -451,19 +460,55 @@ void wxAppConsoleBase::RemovePendingEventHandler(wxEvtHandler* toRemove)
 
 void wxAppConsoleBase::AppendPendingEventHandler(wxEvtHandler* toAppend)
 {
-    wxENTER_CRIT_SECT(m_handlersWithPendingEventsLocker);
+    // this is called from QueueEvent() which can be called from any thread so
+    // don't take any locks here but just push the handler on the lock-free
+    // list, it will be moved to m_handlersWithPendingEvents by the main thread
+    wxEvtHandler *head;
+    do
+    {
+        head = m_scheduledHandlers;
+        toAppend->m_nextScheduledHandler = head;
+    } while ( !wxAtomicCompareAndSwapPtr(m_scheduledHandlers, head, toAppend) );
+}
+
+void wxAppConsoleBase::MergeScheduledHandlers()
+{
+    // take all the handlers scheduled so far at once
+    wxEvtHandler *
+        handler = wxAtomicExchangePtr(m_scheduledHandlers, (wxEvtHandler *)NULL);
+    if ( !handler )
+        return;
 
-    if ( m_handlersWithPendingEvents.Index(toAppend) == wxNOT_FOUND )
-        m_handlersWithPendingEvents.Add(toAppend);
+    // they are in LIFO order in the list, reverse it to process the handlers
+    // in the order in which they got their first pending events
+    wxEvtHandler *reversed = NULL;
+    while ( handler )
+    {
+        wxEvtHandler * const next = handler->m_nextScheduledHandler;
+        handler->m_nextScheduledHandler = reversed;
+        reversed = handler;
+        handler = next;
+    }
 
-    wxLEAVE_CRIT_SECT(m_handlersWithPendingEventsLocker);
+    for ( handler = reversed; handler; )
+    {
+        wxEvtHandler * const next = handler->m_nextScheduledHandler;
+        handler->m_nextScheduledHandler = NULL;
+
+        if ( m_handlersWithPendingEvents.Index(handler) == wxNOT_FOUND &&
+                m_handlersWithPendingDelayedEvents.Index(handler) == wxNOT_FOUND )
+            m_handlersWithPendingEvents.Add(handler);
+
+        handler = next;
+    }
 }
 
 bool wxAppConsoleBase::HasPendingEvents() const
 {
     wxENTER_CRIT_SECT(const_cast<wxAppConsoleBase*>(this)->m_handlersWithPendingEventsLocker);
 
-    bool has = !m_handlersWithPendingEvents.IsEmpty();
+    bool has = !m_handlersWithPendingEvents.IsEmpty() ||
+                    m_scheduledHandlers != NULL;
 
     wxLEAVE_CRIT_SECT(const_cast<wxAppConsoleBase*>(this)->m_handlersWithPendingEventsLocker);
 
@@ -480,6 +525,42 @@ void wxAppConsoleBase::ResumeProcessingOfPendingEvents()
     m_bDoPendingEventProcessing = true;
 }
 
+void wxAppConsoleBase::SetPendingEventsBatch(size_t maxEvents,
+                                             unsigned long maxTime)
+{
+    m_pendingEventsBatchSize = maxEvents;
+    m_pendingEventsBatchTime = maxTime;
+}
+
+void wxAppConsoleBase::ProcessPendingEventsBatch(wxEvtHandler *handler)
+{
+    // by default we process just a single event to be fair to the other
+    // handlers, don't do anything more than before in this case
+    if ( m_pendingEventsBatchSize == 1 )
+    {
+        handler->ProcessPendingEvents();
+        return;
+    }
+
+    // any of the event handlers may destroy the handler itself, we need to
+    // detect this to avoid using it any more
+    wxWeakRef<wxEvtHandler> handlerRef(handler);
+
+    const wxLongLong start = m_pendingEventsBatchTime ? wxGetUTCTimeUSec() : 0;
+    for ( size_t n = 1; ; n++ )
+    {
+        if ( !handler->DoProcessPendingEvent() || !handlerRef )
+            break;
+
+        if ( n == m_pendingEventsBatchSize || !m_bDoPendingEventProcessing )
+            break;
+
+        if ( m_pendingEventsBatchTime &&
+                wxGetUTCTimeUSec() - start >= (long)m_pendingEventsBatchTime )
+            break;
+    }
+}
+
 void wxAppConsoleBase::ProcessPendingEvents()
 {
     if ( m_bDoPendingEventProcessing )
@@ -489,6 +570,8 @@ void wxAppConsoleBase::ProcessPendingEvents()
         wxCHECK_RET( m_handlersWithPendingDelayedEvents.IsEmpty(),
                      "this helper list should be empty" );
 
+        MergeScheduledHandlers();
+
         // iterate until the list becomes empty: the handlers remove themselves
         // from it when they don't have any more pending events
         while (!m_handlersWithPendingEvents.IsEmpty())
@@ -501,9 +584,12 @@ void wxAppConsoleBase::ProcessPendingEvents()
             //       with pending events because handlers auto-remove themselves
             //       from this list (see RemovePendingEventHandler) if they have no
             //       more pending events.
-            m_handlersWithPendingEvents[0]->ProcessPendingEvents();
+            ProcessPendingEventsBatch(m_handlersWithPendingEvents[0]);
 
             wxENTER_CRIT_SECT(m_handlersWithPendingEventsLocker);
+
+            // pick up the handlers which got their events in the meanwhile
+            MergeScheduledHandlers();
         }
 
         // now the wxHandlersWithPendingEvents is surely empty; however some event
@@ -528,8 +614,17 @@ void wxAppConsoleBase::DeletePendingEvents()
     wxCHECK_RET( m_handlersWithPendingDelayedEvents.IsEmpty(),
                  "this helper list should be empty" );
 
+    MergeScheduledHandlers();
+
     for (unsigned int i=0; i<m_handlersWithPendingEvents.GetCount(); i++)
-        m_handlersWithPendingEvents[i]->DeletePendingEvents();
+    {
+        wxEvtHandler * const handler = m_handlersWithPendingEvents[i];
+        handler->DeletePendingEvents();
+
+        // it's not in the list any more, so it must be scheduled again when
+        // it gets a new event, including one queued after we deleted them
+        handler->ResetPendingEventsScheduled();
+    }
 
     m_handlersWithPendingEvents.Clear();
 
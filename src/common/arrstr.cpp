@@ -67,6 +67,17 @@ wxArrayString::wxArrayString(size_t sz, const wxString* a)
 #define   ARRAY_DEFAULT_INITIAL_SIZE    (16)
 #endif
 
+// move the string to its new position in the array: the source string is left
+// in unspecified state, so this is only used when it's going to be overwritten
+static inline void wxMoveArrayString(wxString& dst, wxString& src)
+{
+#ifdef wxHAS_RVALUE_REF
+    dst = std::move(src);
+#else
+    dst.swap(src);
+#endif
+}
+
 // ctor
 void wxArrayString::Init(bool autoSort)
 {
@@ -139,7 +150,7 @@ void wxArrayString::Grow(size_t nIncrement)
 
       // copy data to new location
       for ( size_t j = 0; j < m_nCount; j++ )
-          pNew[j] = m_pItems[j];
+          wxMoveArrayString(pNew[j], m_pItems[j]);
 
       // delete old memory (but do not release the strings!)
       delete [] m_pItems;
@@ -185,7 +196,7 @@ void wxArrayString::Alloc(size_t nSize)
         return;
 
     for ( size_t j = 0; j < m_nCount; j++ )
-        pNew[j] = m_pItems[j];
+        wxMoveArrayString(pNew[j], m_pItems[j]);
     delete [] m_pItems;
 
     m_pItems = pNew;
@@ -203,7 +214,7 @@ void wxArrayString::Shrink()
 
     // copy data to new location
     for ( size_t j = 0; j < m_nCount; j++ )
-        pNew[j] = m_pItems[j];
+        wxMoveArrayString(pNew[j], m_pItems[j]);
     delete [] m_pItems;
     m_pItems = pNew;
     m_nSize = m_nCount;
@@ -259,36 +270,52 @@ int wxArrayString::Index(const wxString& str, bool bCase, bool bFromEnd) const
   return wxNOT_FOUND;
 }
 
+// find the position at which the string should be inserted into a sorted
+// array
+size_t wxArrayString::GetSortedPos(const wxString& str) const
+{
+  size_t i,
+         lo = 0,
+         hi = m_nCount;
+  int res;
+  while ( lo < hi ) {
+    i = (lo + hi)/2;
+
+    res = str.Cmp(m_pItems[i]);
+    if ( res < 0 )
+      hi = i;
+    else if ( res > 0 )
+      lo = i + 1;
+    else {
+      lo = hi = i;
+      break;
+    }
+  }
+
+  wxASSERT_MSG( lo == hi, wxT("binary search broken") );
+
+  return lo;
+}
+
 // add item at the end
 size_t wxArrayString::Add(const wxString& str, size_t nInsert)
 {
   if ( m_autoSort ) {
     // insert the string at the correct position to keep the array sorted
-    size_t i,
-           lo = 0,
-           hi = m_nCount;
-    int res;
-    while ( lo < hi ) {
-      i = (lo + hi)/2;
+    const size_t pos = GetSortedPos(str);
 
-      res = str.Cmp(m_pItems[i]);
-      if ( res < 0 )
-        hi = i;
-      else if ( res > 0 )
-        lo = i + 1;
-      else {
-        lo = hi = i;
-        break;
-      }
-    }
+    Insert(str, pos, nInsert);
 
-    wxASSERT_MSG( lo == hi, wxT("binary search broken") );
-
-    Insert(str, lo, nInsert);
-
-    return (size_t)lo;
+    return pos;
   }
   else {
+    // as in Insert(), the string could be invalidated by Grow() below
+    if ( &str >= m_pItems && &str < m_pItems + m_nCount )
+    {
+        const wxString copy(str);
+        return Add(copy, nInsert);
+    }
+
     Grow(nInsert);
 
     for (size_t i = 0; i < nInsert; i++)
@@ -302,6 +329,18 @@ size_t wxArrayString::Add(const wxString& str, size_t nInsert)
   }
 }
 
+// make room for nInsert items at the given position, the new items are left
+// in unspecified state and must be assigned to by the caller
+void wxArrayString::MakeRoom(size_t nIndex, size_t nInsert)
+{
+  Grow(nInsert);
+
+  for (int j = m_nCount - nIndex - 1; j >= 0; j--)
+      wxMoveArrayString(m_pItems[nIndex + nInsert + j], m_pItems[nIndex + j]);
+
+  m_nCount += nInsert;
+}
+
 // add item at the given position
 void wxArrayString::Insert(const wxString& str, size_t nIndex, size_t nInsert)
 {
@@ -309,18 +348,54 @@ void wxArrayString::Insert(const wxString& str, size_t nIndex, size_t nInsert)
   wxCHECK_RET( m_nCount <= m_nCount + nInsert,
                wxT("array size overflow in wxArrayString::Insert") );
 
-  Grow(nInsert);
+  // the string may be one of our own elements which are moved around by
+  // MakeRoom(), so take a copy of it first in this case
+  if ( &str >= m_pItems && &str < m_pItems + m_nCount )
+  {
+      const wxString copy(str);
+      Insert(copy, nIndex, nInsert);
+      return;
+  }
 
-  for (int j = m_nCount - nIndex - 1; j >= 0; j--)
-      m_pItems[nIndex + nInsert + j] = m_pItems[nIndex + j];
+  MakeRoom(nIndex, nInsert);
 
   for (size_t i = 0; i < nInsert; i++)
   {
       m_pItems[nIndex + i] = str;
   }
-  m_nCount += nInsert;
 }
 
+#ifdef wxHAS_RVALUE_REF
+
+size_t wxArrayString::Add(wxString&& str)
+{
+  if ( m_autoSort ) {
+    const size_t pos = GetSortedPos(str);
+
+    Insert(std::move(str), pos);
+
+    return pos;
+  }
+  else {
+    Grow(1);
+
+    m_pItems[m_nCount] = std::move(str);
+
+    return m_nCount++;
+  }
+}
+
+void wxArrayString::Insert(wxString&& str, size_t nIndex)
+{
+  wxCHECK_RET( nIndex <= m_nCount, wxT("bad index in wxArrayString::Insert") );
+
+  MakeRoom(nIndex, 1);
+
+  m_pItems[nIndex] = std::move(str);
+}
+
+#endif // wxHAS_RVALUE_REF
+
 // range insert (STL 23.2.4.3)
 void
 wxArrayString::insert(iterator it, const_iterator first, const_iterator last)
@@ -371,7 +446,7 @@ void wxArrayString::RemoveAt(size_t nIndex, size_t nRemove)
                wxT("removing too many elements in wxArrayString::Remove") );
 
   for ( size_t j =  0; j < m_nCount - nIndex -nRemove; j++)
-      m_pItems[nIndex + j] = m_pItems[nIndex + nRemove + j];
+      wxMoveArrayString(m_pItems[nIndex + j], m_pItems[nIndex + nRemove + j]);
 
   m_nCount -= nRemove;
 }
@@ -15,6 +15,7 @@
 #endif
 
 #include "wx/encconv.h"
+#include "wx/private/encconv.h"
 
 #include <stdlib.h>
 
@@ -73,6 +74,11 @@ static const wxUint16* GetEncTable(wxFontEncoding enc)
     return NULL;
 }
 
+const wxUint16 *wxGetEncodingTable(wxFontEncoding enc)
+{
+    return GetEncTable(enc);
+}
+
 typedef struct {
     wxUint16 u;
     wxUint8  c;
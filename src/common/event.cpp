@@ -49,12 +49,396 @@
 #include "wx/thread.h"
 
 #if wxUSE_BASE
+    #include "wx/atomic.h"
+    #include "wx/hashmap.h"
     #include "wx/scopedptr.h"
+    #include "wx/tls.h"
+    #include "wx/vector.h"
 
     wxDECLARE_SCOPED_PTR(wxEvent, wxEventPtr)
     wxDEFINE_SCOPED_PTR(wxEvent, wxEventPtr)
 #endif // wxUSE_BASE
 
+// ----------------------------------------------------------------------------
+// private classes
+// ----------------------------------------------------------------------------
+
+#if wxUSE_BASE
+
+// a node of the singly linked lists of wxEvtHandler pending events
+class wxPendingEventNode
+{
+public:
+    wxPendingEventNode(wxEvent *event) : m_event(event), m_next(NULL) { }
+
+    wxDECLARE_EVENT_ALLOCATOR()
+
+    wxEvent *m_event;
+    wxPendingEventNode *m_next;
+
+    wxDECLARE_NO_COPY_CLASS(wxPendingEventNode);
+};
+
+WX_DECLARE_HASH_MAP(int, wxPendingEventNode *,
+                    wxIntegerHash, wxIntegerEqual,
+                    wxPendingEventNodesById);
+
+WX_DECLARE_HASH_MAP(wxEventType, wxPendingEventNodesById,
+                    wxIntegerHash, wxIntegerEqual,
+                    wxPendingEventNodesByType);
+
+// wxCoalescedEvents contains the types of the events coalesced by
+// wxEvtHandler::QueueEvent() and, for each of them, the still pending event of
+// this type for every id. It must be only used with m_pendingEventsLock of its
+// wxEvtHandler locked.
+class wxCoalescedEvents
+{
+public:
+    wxCoalescedEvents() { }
+
+    void Enable(wxEventType eventType, bool enable)
+    {
+        if ( enable )
+            m_types[eventType]; // just create the entry if it doesn't exist
+        else
+            m_types.erase(eventType);
+    }
+
+    // return NULL if the events of this type are not coalesced
+    wxPendingEventNodesById *GetNodes(wxEventType eventType)
+    {
+        wxPendingEventNodesByType::iterator it = m_types.find(eventType);
+
+        return it == m_types.end() ? NULL : &it->second;
+    }
+
+    // must be called before removing the node from the pending events list
+    void OnNodeRemoved(wxPendingEventNode *node)
+    {
+        wxPendingEventNodesById *
+            nodes = GetNodes(node->m_event->GetEventType());
+        if ( !nodes )
+            return;
+
+        wxPendingEventNodesById::iterator it = nodes->find(node->m_event->GetId());
+        if ( it != nodes->end() && it->second == node )
+            nodes->erase(it);
+    }
+
+    // must be called when all pending events are deleted
+    void OnAllNodesRemoved()
+    {
+        for ( wxPendingEventNodesByType::iterator it = m_types.begin();
+              it != m_types.end();
+              ++it )
+        {
+            it->second.clear();
+        }
+    }
+
+private:
+    wxPendingEventNodesByType m_types;
+
+    wxDECLARE_NO_COPY_CLASS(wxCoalescedEvents);
+};
+
+// an element of wxDynamicEventIndex: the entries with bigger sequence numbers
+// were bound more recently and so must be tried first
+struct wxDynamicEventSlot
+{
+    // NULL if the entry was unbound while the events were being dispatched
+    wxDynamicEventTableEntry *entry;
+    unsigned long seq;
+
+    // the node of the entry in wxEvtHandler::m_dynamicEvents
+    wxList::compatibility_iterator node;
+};
+
+typedef wxVector<wxDynamicEventSlot> wxDynamicEventSlots;
+
+WX_DECLARE_HASH_MAP(int, wxDynamicEventSlots,
+                    wxIntegerHash, wxIntegerEqual,
+                    wxDynamicEventSlotsById);
+
+// all the entries for the given event type
+struct wxDynamicEventTypeSlots
+{
+    // the entries for a single id, indexed by this id
+    wxDynamicEventSlotsById byId;
+
+    // the entries for wxID_ANY or a range of ids
+    wxDynamicEventSlots others;
+};
+
+WX_DECLARE_HASH_MAP(wxEventType, wxDynamicEventTypeSlots *,
+                    wxIntegerHash, wxIntegerEqual,
+                    wxDynamicEventSlotsByType);
+
+// return true if the entry should be removed by wxEvtHandler::DoUnbind()
+// called with the given parameters
+static bool
+IsEntryMatchingUnbind(const wxDynamicEventTableEntry& entry,
+                      int id,
+                      int lastId,
+                      wxEventType eventType,
+                      const wxEventFunctor& func,
+                      wxObject *userData)
+{
+    return entry.m_id == id &&
+           (entry.m_lastId == lastId || lastId == wxID_ANY) &&
+           (entry.m_eventType == eventType || eventType == wxEVT_NULL) &&
+           entry.m_fn->IsMatching(func) &&
+           (entry.m_callbackUserData == userData || !userData);
+}
+
+// wxDynamicEventIndex allows to find the entries of wxEvtHandler dynamic event
+// table which can handle the given event without iterating over all of them.
+//
+// It also makes it safe to unbind the event handlers while dispatching the
+// events, as the removed entries are only reset to NULL until the end of the
+// dispatching, and even to destroy the wxEvtHandler itself.
+class wxDynamicEventIndex
+{
+public:
+    wxDynamicEventIndex()
+    {
+        m_nextSeq = 0;
+        m_dispatching = 0;
+        m_hasRemoved =
+        m_ownerDestroyed = false;
+    }
+
+    ~wxDynamicEventIndex()
+    {
+        for ( wxDynamicEventSlotsByType::iterator it = m_types.begin();
+              it != m_types.end();
+              ++it )
+        {
+            delete it->second;
+        }
+    }
+
+    void Add(wxDynamicEventTableEntry *entry,
+             wxList::compatibility_iterator node)
+    {
+        wxDynamicEventTypeSlots *& types = m_types[entry->m_eventType];
+        if ( !types )
+            types = new wxDynamicEventTypeSlots;
+
+        wxDynamicEventSlot slot;
+        slot.entry = entry;
+        slot.seq = m_nextSeq++;
+        slot.node = node;
+
+        GetSlotsFor(*types, entry).push_back(slot);
+    }
+
+    void Remove(wxDynamicEventTableEntry *entry)
+    {
+        wxDynamicEventSlotsByType::iterator it = m_types.find(entry->m_eventType);
+        if ( it == m_types.end() )
+            return;
+
+        wxDynamicEventSlots& slots = GetSlotsFor(*it->second, entry);
+        for ( size_t n = 0; n < slots.size(); n++ )
+        {
+            if ( slots[n].entry != entry )
+                continue;
+
+            if ( m_dispatching )
+            {
+                // we can't modify the vectors used by the dispatching code
+                // right now, this will be done in EndDispatch()
+                slots[n].entry = NULL;
+                m_hasRemoved = true;
+            }
+            else
+            {
+                slots.erase(slots.begin() + n);
+            }
+
+            break;
+        }
+    }
+
+    // return the slot of the most recently bound entry which should be
+    // removed by wxEvtHandler::DoUnbind() called with the given parameters or
+    // NULL if there is none, eventType must not be wxEVT_NULL
+    const wxDynamicEventSlot *FindToUnbind(int id,
+                                           int lastId,
+                                           wxEventType eventType,
+                                           const wxEventFunctor& func,
+                                           wxObject *userData) const
+    {
+        const wxDynamicEventTypeSlots * const types = GetTypeSlots(eventType);
+        if ( !types )
+            return NULL;
+
+        // the entries with a single id different from wxID_ANY are only
+        // stored in byId, all the others, including the ranges starting at
+        // this id, in others
+        const wxDynamicEventSlot *slot = NULL;
+        if ( id != wxID_ANY )
+        {
+            wxDynamicEventSlotsById::const_iterator it = types->byId.find(id);
+            if ( it != types->byId.end() )
+                slot = FindLastMatching(it->second,
+                                        id, lastId, eventType, func, userData);
+        }
+
+        const wxDynamicEventSlot * const
+            other = FindLastMatching(types->others,
+                                     id, lastId, eventType, func, userData);
+        if ( other && (!slot || other->seq > slot->seq) )
+            slot = other;
+
+        return slot;
+    }
+
+    // return the slots for the given event type or NULL if there are none
+    wxDynamicEventTypeSlots *GetTypeSlots(wxEventType eventType) const
+    {
+        wxDynamicEventSlotsByType::const_iterator it = m_types.find(eventType);
+        return it == m_types.end() ? NULL : it->second;
+    }
+
+    // return the slots for the given specific id or NULL
+    static const wxDynamicEventSlots *
+    GetIdSlots(wxDynamicEventTypeSlots& types, int id)
+    {
+        wxDynamicEventSlotsById::const_iterator it = types.byId.find(id);
+        return it == types.byId.end() ? NULL : &it->second;
+    }
+
+    // must be called around dispatching the events using the slots
+    void BeginDispatch() { m_dispatching++; }
+    void EndDispatch()
+    {
+        if ( --m_dispatching )
+            return;
+
+        if ( m_ownerDestroyed )
+            delete this;
+        else if ( m_hasRemoved )
+            Compact();
+    }
+
+    // called when the associated wxEvtHandler is destroyed
+    void OnOwnerDestroyed()
+    {
+        if ( m_dispatching )
+            m_ownerDestroyed = true;
+        else
+            delete this;
+    }
+
+    bool IsOwnerDestroyed() const { return m_ownerDestroyed; }
+
+private:
+    static wxDynamicEventSlots&
+    GetSlotsFor(wxDynamicEventTypeSlots& types, wxDynamicEventTableEntry *entry)
+    {
+        if ( entry->m_id != wxID_ANY && entry->m_lastId == wxID_ANY )
+            return types.byId[entry->m_id];
+
+        return types.others;
+    }
+
+    static const wxDynamicEventSlot *
+    FindLastMatching(const wxDynamicEventSlots& slots,
+                     int id,
+                     int lastId,
+                     wxEventType eventType,
+                     const wxEventFunctor& func,
+                     wxObject *userData)
+    {
+        for ( size_t n = slots.size(); n > 0; n-- )
+        {
+            const wxDynamicEventSlot& slot = slots[n - 1];
+            if ( slot.entry &&
+                    IsEntryMatchingUnbind(*slot.entry,
+                                          id, lastId, eventType, func, userData) )
+            {
+                return &slot;
+            }
+        }
+
+        return NULL;
+    }
+
+    static void CompactSlots(wxDynamicEventSlots& slots)
+    {
+        size_t n = 0;
+        while ( n < slots.size() )
+        {
+            if ( slots[n].entry )
+                n++;
+            else
+                slots.erase(slots.begin() + n);
+        }
+    }
+
+    void Compact()
+    {
+        for ( wxDynamicEventSlotsByType::iterator it = m_types.begin();
+              it != m_types.end();
+              ++it )
+        {
+            wxDynamicEventTypeSlots& types = *it->second;
+            for ( wxDynamicEventSlotsById::iterator i = types.byId.begin();
+                  i != types.byId.end();
+                  ++i )
+            {
+                CompactSlots(i->second);
+            }
+
+            CompactSlots(types.others);
+        }
+
+        m_hasRemoved = false;
+    }
+
+    wxDynamicEventSlotsByType m_types;
+
+    // sequence number of the next added entry
+    unsigned long m_nextSeq;
+
+    // number of (possibly nested) dispatches in progress
+    int m_dispatching;
+
+    // true if some slots were reset to NULL and need to be removed
+    bool m_hasRemoved;
+
+    // true if the owner was destroyed during dispatching
+    bool m_ownerDestroyed;
+
+    wxDECLARE_NO_COPY_CLASS(wxDynamicEventIndex);
+};
+
+// calls wxDynamicEventIndex::{Begin,End}Dispatch(), even if an exception is
+// thrown by an event handler
+class wxDynamicEventDispatchLocker
+{
+public:
+    wxDynamicEventDispatchLocker(wxDynamicEventIndex *index)
+        : m_index(index)
+    {
+        m_index->BeginDispatch();
+    }
+
+    ~wxDynamicEventDispatchLocker()
+    {
+        m_index->EndDispatch();
+    }
+
+private:
+    wxDynamicEventIndex * const m_index;
+
+    wxDECLARE_NO_COPY_CLASS(wxDynamicEventDispatchLocker);
+};
+
+#endif // wxUSE_BASE
+
 // ----------------------------------------------------------------------------
 // wxWin macros
 // ----------------------------------------------------------------------------
@@ -345,6 +729,320 @@ wxEventFunctor::~wxEventFunctor()
 {
 }
 
+// ----------------------------------------------------------------------------
+// wxEventAllocator
+// ----------------------------------------------------------------------------
+
+#ifdef wxHAS_COMPILER_TLS
+
+namespace
+{
+
+// the sizes of the blocks are rounded up to the multiple of this value
+const size_t EVENT_ALLOC_GRANULARITY = 16;
+
+// the blocks bigger than this are always allocated from the heap directly
+const size_t EVENT_ALLOC_MAX_SIZE = 256;
+
+const size_t EVENT_ALLOC_NUM_SIZES = EVENT_ALLOC_MAX_SIZE/EVENT_ALLOC_GRANULARITY;
+
+// the blocks are moved between the thread caches and the common pool in
+// batches of this many blocks
+const unsigned EVENT_ALLOC_BATCH = 32;
+
+// the maximal number of blocks of the same size in a thread cache and in the
+// common pool, the extra ones are returned to the heap
+const unsigned EVENT_ALLOC_MAX_CACHED = 2*EVENT_ALLOC_BATCH;
+const unsigned EVENT_ALLOC_MAX_POOLED = 64*EVENT_ALLOC_BATCH;
+
+// the free blocks are used to store the pointer to the next one
+struct wxFreeEventBlock
+{
+    wxFreeEventBlock *next;
+};
+
+struct wxFreeEventBlocks
+{
+    wxFreeEventBlock *first;
+    unsigned count;
+};
+
+// whether the current thread can cache the blocks, see CanCacheEventBlocks()
+enum wxEventAllocatorThreadKind
+{
+    EventAllocThread_Unknown,   // must be 0 as this is the initial value
+    EventAllocThread_Caching,
+    EventAllocThread_NotCaching
+};
+
+// the cache of free blocks of the current thread: the blocks are allocated
+// from it and freed into it without any locking, this must be a POD to be
+// stored in TLS
+struct wxEventAllocatorCache
+{
+    wxFreeEventBlocks blocks[EVENT_ALLOC_NUM_SIZES];
+
+    // statistics not yet added to gs_eventAllocStats
+    wxEventAllocatorStats stats;
+
+    // one of wxEventAllocatorThreadKind values
+    int threadKind;
+};
+
+wxTLS_TYPE(wxEventAllocatorCache) gs_eventAllocCache;
+
+// the common pool of blocks used to pass them between the threads and the
+// global statistics, both protected by gs_eventAllocCS
+wxFreeEventBlocks gs_eventAllocPool[EVENT_ALLOC_NUM_SIZES];
+wxEventAllocatorStats gs_eventAllocStats;
+wxCRIT_SECT_DECLARE(gs_eventAllocCS);
+
+// move up to count blocks from one list to another one
+void MoveFreeEventBlocks(wxFreeEventBlocks& from,
+                         wxFreeEventBlocks& to,
+                         unsigned count)
+{
+    while ( count-- && from.first )
+    {
+        wxFreeEventBlock * const block = from.first;
+        from.first = block->next;
+        from.count--;
+
+        block->next = to.first;
+        to.first = block;
+        to.count++;
+    }
+}
+
+void DeleteFreeEventBlocks(wxFreeEventBlocks& blocks)
+{
+    while ( blocks.first )
+    {
+        wxFreeEventBlock * const block = blocks.first;
+        blocks.first = block->next;
+
+        ::operator delete(block);
+    }
+
+    blocks.count = 0;
+}
+
+// must be called with gs_eventAllocCS locked
+void FlushEventAllocatorStats(wxEventAllocatorStats& stats)
+{
+    gs_eventAllocStats.numAllocs += stats.numAllocs;
+    gs_eventAllocStats.numHeapAllocs += stats.numHeapAllocs;
+    gs_eventAllocStats.numFrees += stats.numFrees;
+    gs_eventAllocStats.numHeapFrees += stats.numHeapFrees;
+
+    stats.numAllocs =
+    stats.numHeapAllocs =
+    stats.numFrees =
+    stats.numHeapFrees = 0;
+}
+
+// move the given number of blocks from the cache to the common pool, or to
+// the heap if there are too many blocks in it already, and flush the stats
+void ReleaseCachedEventBlocks(wxEventAllocatorCache& cache,
+                              size_t n,
+                              unsigned count)
+{
+    wxFreeEventBlocks extra = { NULL, 0 };
+
+    {
+        wxCRIT_SECT_LOCKER(lock, gs_eventAllocCS);
+
+        wxFreeEventBlocks& pool = gs_eventAllocPool[n];
+        if ( pool.count < EVENT_ALLOC_MAX_POOLED )
+        {
+            const unsigned room = EVENT_ALLOC_MAX_POOLED - pool.count;
+            MoveFreeEventBlocks(cache.blocks[n], pool, wxMin(count, room));
+            if ( count > room )
+                MoveFreeEventBlocks(cache.blocks[n], extra, count - room);
+        }
+        else
+        {
+            MoveFreeEventBlocks(cache.blocks[n], extra, count);
+        }
+
+        cache.stats.numHeapFrees += extra.count;
+        FlushEventAllocatorStats(cache.stats);
+    }
+
+    DeleteFreeEventBlocks(extra);
+}
+
+// the blocks can only be cached by the main thread, which never exits, and by
+// wxThreads, which call wxEventAllocator::ReleaseThreadCache() when they do:
+// the blocks cached by any other threads would be leaked when they terminate
+// as there is no way to be notified about it
+bool CanCacheEventBlocks(wxEventAllocatorCache& cache)
+{
+#if wxUSE_THREADS
+    if ( cache.threadKind == EventAllocThread_Unknown )
+    {
+        cache.threadKind = wxThread::IsMain() || wxThread::This()
+                            ? EventAllocThread_Caching
+                            : EventAllocThread_NotCaching;
+    }
+
+    return cache.threadKind == EventAllocThread_Caching;
+#else // !wxUSE_THREADS
+    wxUnusedVar(cache);
+
+    return true;
+#endif // wxUSE_THREADS/!wxUSE_THREADS
+}
+
+void *AllocFromHeap(size_t size, bool nothrow)
+{
+    return nothrow ? ::operator new(size, std::nothrow) : ::operator new(size);
+}
+
+void *AllocEventBlock(size_t size, bool nothrow)
+{
+    const size_t n = (size - 1)/EVENT_ALLOC_GRANULARITY;
+    if ( n >= EVENT_ALLOC_NUM_SIZES )
+        return AllocFromHeap(size, nothrow);
+
+    // the blocks are always allocated with the full size of their slot, even
+    // when not cached, as they can be freed into a cache by another thread
+    const size_t sizeBlock = (n + 1)*EVENT_ALLOC_GRANULARITY;
+
+    wxEventAllocatorCache& cache = wxTLS_VALUE(gs_eventAllocCache);
+    if ( !CanCacheEventBlocks(cache) )
+        return AllocFromHeap(sizeBlock, nothrow);
+
+    wxFreeEventBlocks& blocks = cache.blocks[n];
+    if ( !blocks.first )
+    {
+        // we can't check whether the pool has any blocks without locking,
+        // but this only happens once per EVENT_ALLOC_BATCH allocations if it
+        // does and otherwise we're going to use the heap, which is slower
+        wxCRIT_SECT_LOCKER(lock, gs_eventAllocCS);
+
+        MoveFreeEventBlocks(gs_eventAllocPool[n], blocks, EVENT_ALLOC_BATCH);
+        FlushEventAllocatorStats(cache.stats);
+    }
+
+    cache.stats.numAllocs++;
+
+    wxFreeEventBlock * const block = blocks.first;
+    if ( !block )
+    {
+        cache.stats.numHeapAllocs++;
+
+        return AllocFromHeap(sizeBlock, nothrow);
+    }
+
+    blocks.first = block->next;
+    blocks.count--;
+
+    return block;
+}
+
+} // anonymous namespace
+
+/* static */
+void *wxEventAllocator::Alloc(size_t size)
+{
+    return AllocEventBlock(size, false);
+}
+
+/* static */
+void *wxEventAllocator::Alloc(size_t size, const std::nothrow_t&)
+{
+    return AllocEventBlock(size, true);
+}
+
+/* static */
+void wxEventAllocator::Free(void *p, size_t size)
+{
+    const size_t n = (size - 1)/EVENT_ALLOC_GRANULARITY;
+    if ( !p || n >= EVENT_ALLOC_NUM_SIZES )
+    {
+        ::operator delete(p);
+        return;
+    }
+
+    wxEventAllocatorCache& cache = wxTLS_VALUE(gs_eventAllocCache);
+    if ( !CanCacheEventBlocks(cache) )
+    {
+        ::operator delete(p);
+        return;
+    }
+
+    wxFreeEventBlocks& blocks = cache.blocks[n];
+
+    wxFreeEventBlock * const block = static_cast<wxFreeEventBlock *>(p);
+    block->next = blocks.first;
+    blocks.first = block;
+    blocks.count++;
+
+    cache.stats.numFrees++;
+
+    // the blocks are typically freed by a different thread than the one which
+    // allocated them, so make them available to the other threads
+    if ( blocks.count > EVENT_ALLOC_MAX_CACHED )
+        ReleaseCachedEventBlocks(cache, n, EVENT_ALLOC_BATCH);
+}
+
+/* static */
+void wxEventAllocator::ReleaseThreadCache()
+{
+    wxEventAllocatorCache& cache = wxTLS_VALUE(gs_eventAllocCache);
+
+    for ( size_t n = 0; n < EVENT_ALLOC_NUM_SIZES; n++ )
+        ReleaseCachedEventBlocks(cache, n, cache.blocks[n].count);
+}
+
+/* static */
+wxEventAllocatorStats wxEventAllocator::GetStats()
+{
+    wxCRIT_SECT_LOCKER(lock, gs_eventAllocCS);
+
+    FlushEventAllocatorStats(wxTLS_VALUE(gs_eventAllocCache).stats);
+
+    return gs_eventAllocStats;
+}
+
+#else // !wxHAS_COMPILER_TLS
+
+// without efficient thread-specific storage there is no way to make caching
+// faster than just using the heap
+
+/* static */
+void *wxEventAllocator::Alloc(size_t size)
+{
+    return ::operator new(size);
+}
+
+/* static */
+void *wxEventAllocator::Alloc(size_t size, const std::nothrow_t& nt)
+{
+    return ::operator new(size, nt);
+}
+
+/* static */
+void wxEventAllocator::Free(void *p, size_t WXUNUSED(size))
+{
+    ::operator delete(p);
+}
+
+/* static */
+void wxEventAllocator::ReleaseThreadCache()
+{
+}
+
+/* static */
+wxEventAllocatorStats wxEventAllocator::GetStats()
+{
+    wxEventAllocatorStats stats = { 0, 0, 0, 0 };
+    return stats;
+}
+
+#endif // wxHAS_COMPILER_TLS/!wxHAS_COMPILER_TLS
+
 // ----------------------------------------------------------------------------
 // wxEvent
 // ----------------------------------------------------------------------------
@@ -1059,7 +1757,13 @@ wxEvtHandler::wxEvtHandler()
     m_previousHandler = NULL;
     m_enabled = true;
     m_dynamicEvents = NULL;
-    m_pendingEvents = NULL;
+    m_dynamicEventsIndex = NULL;
+    m_incomingEvents = NULL;
+    m_pendingEventsHead =
+    m_pendingEventsTail = NULL;
+    m_pendingEventsScheduled = 0;
+    m_nextScheduledHandler = NULL;
+    m_coalescedEvents = NULL;
 
     // no client data (yet)
     m_clientData = NULL;
@@ -1097,6 +1801,10 @@ wxEvtHandler::~wxEvtHandler()
             delete entry;
         }
         delete m_dynamicEvents;
+
+        // this may not delete the index immediately if we're being destroyed
+        // from inside one of our own event handlers
+        m_dynamicEventsIndex->OnOwnerDestroyed();
     }
 
     // Remove us from the list of the pending events if necessary.
@@ -1105,6 +1813,8 @@ wxEvtHandler::~wxEvtHandler()
 
     DeletePendingEvents();
 
+    delete m_coalescedEvents;
+
     // we only delete object data, not untyped
     if ( m_clientDataType == wxClientData_Object )
         delete m_clientObject;
@@ -1198,47 +1908,202 @@ void wxEvtHandler::QueueEvent(wxEvent *event)
         return;
     }
 
-    // 1) Add this event to our list of pending events
-    wxENTER_CRIT_SECT( m_pendingEventsLock );
-
-    if ( !m_pendingEvents )
-        m_pendingEvents = new wxList;
-
-    m_pendingEvents->Append(event);
+    // 1) Add this event to our list of pending events: this is done without
+    //    locking, we just push it on the lock-free list of incoming events,
+    //    unless coalescing was enabled for this handler, in which case we
+    //    need to lock to check whether it is enabled for this event type
+    bool replaced;
+    if ( m_coalescedEvents && QueueCoalescedEvent(event, &replaced) )
+    {
+        // if the event replaced an already pending one, this handler must be
+        // scheduled already and the event loop woken up
+        if ( replaced )
+            return;
+    }
+    else
+    {
+        wxPendingEventNode * const node = new wxPendingEventNode(event);
+        do
+        {
+            node->m_next = m_incomingEvents;
+        } while ( !wxAtomicCompareAndSwapPtr(m_incomingEvents,
+                                             node->m_next, node) );
+    }
 
     // 2) Add this event handler to list of event handlers that
-    //    have pending events.
-
-    wxTheApp->AppendPendingEventHandler(this);
-
-    // only release m_pendingEventsLock now because otherwise there is a race
-    // condition as described in the ticket #9093: we could process the event
-    // just added to m_pendingEvents in our ProcessPendingEvents() below before
-    // we had time to append this pointer to wxHandlersWithPendingEvents list; thus
-    // breaking the invariant that a handler should be in the list iff it has
-    // any pending events to process
-    wxLEAVE_CRIT_SECT( m_pendingEventsLock );
+    //    have pending events if it's not there yet.
+    //
+    //    Notice that this must be done after adding the event to the list
+    //    above: ProcessPendingEvents() resets m_pendingEventsScheduled before
+    //    checking m_incomingEvents for the last time, so either it sees our
+    //    event and keeps the handler scheduled or we see the flag reset and
+    //    schedule the handler again, but the event can't be lost (this used to
+    //    be ensured by keeping m_pendingEventsLock locked, see #9093)
+    if ( wxAtomicCompareAndSwap(m_pendingEventsScheduled, 0, 1) )
+        wxTheApp->AppendPendingEventHandler(this);
 
     // 3) Inform the system that new pending events are somewhere,
     //    and that these should be processed in idle time.
     wxWakeUpIdle();
 }
 
+bool wxEvtHandler::QueueCoalescedEvent(wxEvent *event, bool *replaced)
+{
+    wxEvent *eventOld;
+
+    {
+        wxCRIT_SECT_LOCKER(lock, m_pendingEventsLock);
+
+        wxPendingEventNodesById * const
+            nodes = m_coalescedEvents->GetNodes(event->GetEventType());
+        if ( !nodes )
+            return false;
+
+        // add the events queued before this one to the pending list first, to
+        // preserve their order
+        TakeIncomingEvents();
+
+        wxPendingEventNode *& node = (*nodes)[event->GetId()];
+        if ( !node )
+        {
+            node = new wxPendingEventNode(event);
+
+            if ( m_pendingEventsTail )
+                m_pendingEventsTail->m_next = node;
+            else
+                m_pendingEventsHead = node;
+
+            m_pendingEventsTail = node;
+
+            *replaced = false;
+
+            return true;
+        }
+
+        // the event will be processed at the position of the pending one but
+        // with the latest data
+        eventOld = node->m_event;
+        node->m_event = event;
+    }
+
+    // delete it outside of the critical section as this executes arbitrary
+    // code in the event class dtor
+    delete eventOld;
+
+    *replaced = true;
+
+    return true;
+}
+
+void wxEvtHandler::EnableEventCoalescing(wxEventType eventType, bool enable)
+{
+    wxCRIT_SECT_LOCKER(lock, m_pendingEventsLock);
+
+    if ( !m_coalescedEvents )
+    {
+        if ( !enable )
+            return;
+
+        // QueueEvent() tests m_coalescedEvents without locking, so it must
+        // only become non-NULL once the object is fully initialized
+        wxCoalescedEvents * const coalescedEvents = new wxCoalescedEvents;
+        coalescedEvents->Enable(eventType, true);
+
+        wxAtomicCompareAndSwapPtr(m_coalescedEvents,
+                                  static_cast<wxCoalescedEvents *>(NULL),
+                                  coalescedEvents);
+        return;
+    }
+
+    m_coalescedEvents->Enable(eventType, enable);
+}
+
+void wxEvtHandler::TakeIncomingEvents()
+{
+    wxPendingEventNode *
+        node = wxAtomicExchangePtr(m_incomingEvents, (wxPendingEventNode *)NULL);
+    if ( !node )
+        return;
+
+    // the incoming events are in LIFO order, reverse them before appending
+    wxPendingEventNode * const last = node;
+    wxPendingEventNode *first = NULL;
+    while ( node )
+    {
+        wxPendingEventNode * const next = node->m_next;
+        node->m_next = first;
+        first = node;
+        node = next;
+    }
+
+    if ( m_pendingEventsTail )
+        m_pendingEventsTail->m_next = first;
+    else
+        m_pendingEventsHead = first;
+
+    m_pendingEventsTail = last;
+}
+
+void wxEvtHandler::UnschedulePendingEvents()
+{
+    // remove ourselves from the list while we're still marked as scheduled so
+    // that QueueEvent() can't add us to it again in the meanwhile
+    wxTheApp->RemovePendingEventHandler(this);
+
+    ResetPendingEventsScheduled();
+}
+
+void wxEvtHandler::ResetPendingEventsScheduled()
+{
+    wxAtomicCompareAndSwap(m_pendingEventsScheduled, 1, 0);
+
+    // if an event was queued after we last checked for them and QueueEvent()
+    // hasn't rescheduled us yet, do it ourselves
+    if ( m_incomingEvents &&
+            wxAtomicCompareAndSwap(m_pendingEventsScheduled, 0, 1) )
+        wxTheApp->AppendPendingEventHandler(this);
+}
+
 void wxEvtHandler::DeletePendingEvents()
 {
-    if (m_pendingEvents)
-        m_pendingEvents->DeleteContents(true);
-    wxDELETE(m_pendingEvents);
+    wxPendingEventNode *node;
+
+    {
+        wxCRIT_SECT_LOCKER(lock, m_pendingEventsLock);
+
+        TakeIncomingEvents();
+
+        node = m_pendingEventsHead;
+
+        m_pendingEventsHead =
+        m_pendingEventsTail = NULL;
+
+        if ( m_coalescedEvents )
+            m_coalescedEvents->OnAllNodesRemoved();
+    }
+
+    while ( node )
+    {
+        wxPendingEventNode * const next = node->m_next;
+        delete node->m_event;
+        delete node;
+        node = next;
+    }
 }
 
 void wxEvtHandler::ProcessPendingEvents()
+{
+    DoProcessPendingEvent();
+}
+
+bool wxEvtHandler::DoProcessPendingEvent()
 {
     if (!wxTheApp)
     {
         // we need an event loop which manages the list of event handlers with
         // pending events... cannot proceed without it!
         wxLogDebug("No application object! Cannot process pending events!");
-        return;
+        return false;
     }
 
     // we need to process only a single pending event in this call because
@@ -1247,22 +2112,31 @@ void wxEvtHandler::ProcessPendingEvents()
 
     wxENTER_CRIT_SECT( m_pendingEventsLock );
 
-    // this method is only called by wxApp if this handler does have
-    // pending events
-    wxCHECK_RET( m_pendingEvents && !m_pendingEvents->IsEmpty(),
-                 "should have pending events if called" );
+    TakeIncomingEvents();
 
-    wxList::compatibility_iterator node = m_pendingEvents->GetFirst();
-    wxEvent* pEvent = static_cast<wxEvent *>(node->GetData());
+    // this method is only called by wxApp if this handler does have pending
+    // events, but they could have been deleted by DeletePendingEvents() since
+    // then, so don't assert about it but just stop being scheduled
+    if ( !m_pendingEventsHead )
+    {
+        UnschedulePendingEvents();
+
+        wxLEAVE_CRIT_SECT( m_pendingEventsLock );
+
+        return false;
+    }
+
+    wxPendingEventNode *prev = NULL,
+                       *node = m_pendingEventsHead;
 
     // find the first event which can be processed now:
     wxEventLoopBase* evtLoop = wxEventLoopBase::GetActive();
     if (evtLoop && evtLoop->IsYielding())
     {
-        while (node && pEvent && !evtLoop->IsEventAllowedInsideYield(pEvent->GetEventCategory()))
+        while (node && !evtLoop->IsEventAllowedInsideYield(node->m_event->GetEventCategory()))
         {
-            node = node->GetNext();
-            pEvent = node ? static_cast<wxEvent *>(node->GetData()) : NULL;
+            prev = node;
+            node = node->m_next;
         }
 
         if (!node)
@@ -1275,24 +2149,39 @@ void wxEvtHandler::ProcessPendingEvents()
 
             wxLEAVE_CRIT_SECT( m_pendingEventsLock );
 
-            return;
+            return false;
         }
     }
 
-    wxEventPtr event(pEvent);
+    wxEventPtr event(node->m_event);
 
     // it's important we remove event from list before processing it, else a
     // nested event loop, for example from a modal dialog, might process the
     // same event again.
-    m_pendingEvents->Erase(node);
+    if ( prev )
+        prev->m_next = node->m_next;
+    else
+        m_pendingEventsHead = node->m_next;
+
+    if ( node == m_pendingEventsTail )
+        m_pendingEventsTail = prev;
+
+    if ( m_coalescedEvents )
+        m_coalescedEvents->OnNodeRemoved(node);
 
-    if ( m_pendingEvents->IsEmpty() )
+    delete node;
+
+    if ( !m_pendingEventsHead )
     {
         // if there are no more pending events left, we don't need to
         // stay in this list
-        wxTheApp->RemovePendingEventHandler(this);
+        TakeIncomingEvents();
+        if ( !m_pendingEventsHead )
+            UnschedulePendingEvents();
     }
 
+    const bool hasMore = m_pendingEventsHead != NULL;
+
     wxLEAVE_CRIT_SECT( m_pendingEventsLock );
 
     ProcessEvent(*event);
@@ -1300,6 +2189,8 @@ void wxEvtHandler::ProcessPendingEvents()
     // careful: this object could have been deleted by the event handler
     // executed by the above ProcessEvent() call, so we can't access any fields
     // of this object any more
+
+    return hasMore;
 }
 
 /* static */
@@ -1594,10 +2485,14 @@ void wxEvtHandler::DoBind(int id,
         new wxDynamicEventTableEntry(eventType, id, lastId, func, userData);
 
     if (!m_dynamicEvents)
+    {
         m_dynamicEvents = new wxList;
+        m_dynamicEventsIndex = new wxDynamicEventIndex;
+    }
 
     // Insert at the front of the list so most recent additions are found first
     m_dynamicEvents->Insert( (wxObject*) entry );
+    m_dynamicEventsIndex->Add(entry, m_dynamicEvents->GetFirst());
 
     // Make sure we get to know when a sink is destroyed
     wxEvtHandler *eventSink = func->GetEvtHandler();
@@ -1630,25 +2525,42 @@ wxEvtHandler::DoUnbind(int id,
             evtConnRef->DecRef();
     }
 
-    wxList::compatibility_iterator node = m_dynamicEvents->GetFirst();
-    while (node)
+    wxDynamicEventTableEntry *entry = NULL;
+    wxList::compatibility_iterator node;
+    if ( eventType != wxEVT_NULL )
     {
-        wxDynamicEventTableEntry *entry = (wxDynamicEventTableEntry*)node->GetData();
-
-        if ((entry->m_id == id) &&
-            ((entry->m_lastId == lastId) || (lastId == wxID_ANY)) &&
-            ((entry->m_eventType == eventType) || (eventType == wxEVT_NULL)) &&
-            entry->m_fn->IsMatching(func) &&
-            ((entry->m_callbackUserData == userData) || !userData))
+        // use the index to avoid iterating over all the entries
+        const wxDynamicEventSlot * const
+            slot = m_dynamicEventsIndex->FindToUnbind(id, lastId, eventType,
+                                                      func, userData);
+        if ( slot )
         {
-            delete entry->m_callbackUserData;
-            m_dynamicEvents->Erase( node );
-            delete entry;
-            return true;
+            entry = slot->entry;
+            node = slot->node;
         }
-        node = node->GetNext();
     }
-    return false;
+    else // any event type matches, so we have to check all the entries
+    {
+        for ( node = m_dynamicEvents->GetFirst(); node; node = node->GetNext() )
+        {
+            wxDynamicEventTableEntry * const
+                e = (wxDynamicEventTableEntry*)node->GetData();
+            if ( IsEntryMatchingUnbind(*e, id, lastId, eventType, func, userData) )
+            {
+                entry = e;
+                break;
+            }
+        }
+    }
+
+    if ( !entry )
+        return false;
+
+    delete entry->m_callbackUserData;
+    m_dynamicEvents->Erase( node );
+    m_dynamicEventsIndex->Remove(entry);
+    delete entry;
+    return true;
 }
 
 bool wxEvtHandler::SearchDynamicEventTable( wxEvent& event )
@@ -1656,23 +2568,45 @@ bool wxEvtHandler::SearchDynamicEventTable( wxEvent& event )
     wxCHECK_MSG( m_dynamicEvents, false,
                  wxT("caller should check that we have dynamic events") );
 
-    wxList::compatibility_iterator node = m_dynamicEvents->GetFirst();
-    while (node)
+    wxDynamicEventTypeSlots * const
+        types = m_dynamicEventsIndex->GetTypeSlots(event.GetEventType());
+    if ( !types )
+        return false;
+
+    // only the entries for this event id or for any/a range of ids can match
+    const wxDynamicEventSlots * const
+        byId = wxDynamicEventIndex::GetIdSlots(*types, event.GetId());
+    const wxDynamicEventSlots& others = types->others;
+
+    // the index may outlive us if we're destroyed by an event handler, so
+    // use a local pointer to it and not m_dynamicEventsIndex below
+    wxDynamicEventIndex * const index = m_dynamicEventsIndex;
+    wxDynamicEventDispatchLocker lock(index);
+
+    // iterate over both vectors in the reverse order of binding, notice that
+    // they can only grow while we do it and the new entries are not used
+    size_t nById = byId ? byId->size() : 0,
+           nOthers = others.size();
+    while ( nById || nOthers )
     {
-        wxDynamicEventTableEntry *entry = (wxDynamicEventTableEntry*)node->GetData();
+        wxDynamicEventTableEntry *entry;
+        if ( nById && (!nOthers || (*byId)[nById - 1].seq > others[nOthers - 1].seq) )
+            entry = (*byId)[--nById].entry;
+        else
+            entry = others[--nOthers].entry;
 
-        // get next node before (maybe) calling the event handler as it could
-        // call Disconnect() invalidating the current node
-        node = node->GetNext();
+        // skip the entries unbound by the previously called handlers
+        if ( !entry )
+            continue;
 
-        if ( event.GetEventType() == entry->m_eventType )
-        {
-            wxEvtHandler *handler = entry->m_fn->GetEvtHandler();
-            if ( !handler )
-               handler = this;
-            if ( ProcessEventIfMatchesId(*entry, handler, event) )
-                return true;
-        }
+        wxEvtHandler *handler = entry->m_fn->GetEvtHandler();
+        if ( !handler )
+           handler = this;
+        if ( ProcessEventIfMatchesId(*entry, handler, event) )
+            return true;
+
+        if ( index->IsOwnerDestroyed() )
+            break;
     }
 
     return false;
@@ -1752,6 +2686,7 @@ void wxEvtHandler::OnSinkDestroyed( wxEvtHandler *sink )
         {
             delete entry->m_callbackUserData;
             m_dynamicEvents->Erase( node );
+            m_dynamicEventsIndex->Remove(entry);
             delete entry;
         }
         node = node_nxt;
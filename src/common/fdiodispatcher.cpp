@@ -28,10 +28,12 @@
 #endif //WX_PRECOMP
 
 #include "wx/private/fdiodispatcher.h"
+#include "wx/sysopt.h"
 
 #include "wx/private/selectdispatcher.h"
 #ifdef __UNIX__
     #include "wx/unix/private/epolldispatcher.h"
+    #include "wx/unix/private/iouringdispatcher.h"
 #endif
 
 wxFDIODispatcher *gs_dispatcher = NULL;
@@ -50,10 +52,24 @@ wxFDIODispatcher *wxFDIODispatcher::Get()
     if ( !gs_dispatcher )
     {
 #if wxUSE_EPOLL_DISPATCHER
-        gs_dispatcher = wxEpollDispatcher::Create();
-        if ( !gs_dispatcher )
+        // the dispatcher to use can be chosen at run-time, the best available
+        // one is used by default and also if the chosen one can't be created
+        const wxString
+            name = wxSystemOptions::GetOption("unix.fdio-dispatcher").Lower();
 #endif // wxUSE_EPOLL_DISPATCHER
+
+#ifdef wxHAS_IOURING_DISPATCHER
+        if ( name == "io_uring" )
+            gs_dispatcher = wxIoUringDispatcher::Create();
+#endif // wxHAS_IOURING_DISPATCHER
+
+#if wxUSE_EPOLL_DISPATCHER
+        if ( !gs_dispatcher && name != "select" )
+            gs_dispatcher = wxEpollDispatcher::Create();
+#endif // wxUSE_EPOLL_DISPATCHER
+
 #if wxUSE_SELECT_DISPATCHER
+        if ( !gs_dispatcher )
             gs_dispatcher = new wxSelectDispatcher();
 #endif // wxUSE_SELECT_DISPATCHER
     }
@@ -33,10 +33,11 @@
 #include "wx/filefn.h"
 #include "wx/wfstream.h"
 #include "wx/quantize.h"
+#include "wx/scopedarray.h"
 #include "wx/scopeguard.h"
 #include "wx/anidecod.h"
 
-// For memcpy
+// For memcpy and memset
 #include <string.h>
 
 // ----------------------------------------------------------------------------
@@ -1091,6 +1092,143 @@ bool wxBMPHandler::LoadFile(wxImage *image, wxInputStream& stream,
     return LoadDib(image, stream, verbose, true/*isBmp*/);
 }
 
+bool wxBMPHandler::LoadRows(wxImage *image, wxImageRowSink& sink,
+                            wxInputStream& stream,
+                            bool verbose, int index)
+{
+    wxCHECK_MSG( image, false, "NULL image pointer" );
+
+    const wxFileOffset posOld = stream.IsSeekable() ? stream.TellI()
+                                                    : wxInvalidOffset;
+
+    wxUint16        aWord;
+    wxInt32         dbuf[4];
+
+    stream.Read(&aWord, 2);
+    stream.Read(dbuf, 16);
+    const wxFileOffset offset = wxINT32_SWAP_ON_BE(dbuf[2]);
+    const int headerSize = wxINT32_SWAP_ON_BE((int)dbuf[3]);
+
+    stream.Read(dbuf, 4 * 2);
+    const int width = wxINT32_SWAP_ON_BE((int)dbuf[0]);
+    int height = wxINT32_SWAP_ON_BE((int)dbuf[1]);
+
+    stream.Read(&aWord, 2);
+    stream.Read(&aWord, 2);
+    const int bpp = wxUINT16_SWAP_ON_BE((int)aWord);
+
+    stream.Read(dbuf, 4 * 4);
+    const int comp = wxINT32_SWAP_ON_BE((int)dbuf[0]);
+    const int resX = wxINT32_SWAP_ON_BE((int)dbuf[2]),
+              resY = wxINT32_SWAP_ON_BE((int)dbuf[3]);
+
+    stream.Read(dbuf, 4 * 2);
+    int ncolors = wxINT32_SWAP_ON_BE((int)dbuf[0]);
+    if ( ncolors == 0 && bpp < 16 )
+        ncolors = 1 << bpp;
+
+    // only the uncompressed bitmaps with the standard header are read row by
+    // row, everything else is loaded entirely by LoadFile()
+    if ( !stream.IsOk() || headerSize != 40 || comp != BI_RGB ||
+            (bpp != 1 && bpp != 4 && bpp != 8 && bpp != 24) ||
+                width <= 0 || width > 32767 ||
+                    height == 0 || height > 32767 || height < -32767 ||
+                        ncolors < 0 || (bpp < 16 && ncolors > 1 << bpp) )
+    {
+        if ( posOld == wxInvalidOffset || stream.SeekI(posOld) == wxInvalidOffset )
+            return false;
+
+        return wxImageHandler::LoadRows(image, sink, stream, verbose, index);
+    }
+
+    bool isUpsideDown = true;
+    if ( height < 0 )
+    {
+        isUpsideDown = false;
+        height = -height;
+    }
+
+    // the palette follows the header directly, unused entries stay black
+    unsigned char cmap[256][3];
+    memset(cmap, 0, sizeof(cmap));
+    for ( int j = 0; j < ncolors && bpp < 16; j++ )
+    {
+        unsigned char entry[4];
+        stream.Read(entry, 4);
+        cmap[j][0] = entry[2];
+        cmap[j][1] = entry[1];
+        cmap[j][2] = entry[0];
+    }
+
+    // as in DoLoadDib(), seek forward relatively to allow using non-seekable
+    // streams too
+    const wxFileOffset pos = stream.TellI();
+    if ( pos != wxInvalidOffset && offset > pos )
+    {
+        if ( stream.SeekI(offset - pos, wxFromCurrent) == wxInvalidOffset )
+            return false;
+    }
+
+    const size_t linesize = ((width * bpp + 31) / 32) * 4;
+    wxScopedArray<unsigned char> line(new unsigned char[linesize]);
+    wxScopedArray<unsigned char> rgb(new unsigned char[3*width]);
+
+    if ( !sink.Start(width, height, false) )
+        return false;
+
+    const int mask = (1 << bpp) - 1;
+    for ( int row = 0; row < height; row++ )
+    {
+        if ( stream.Read(line.get(), linesize).LastRead() != linesize )
+        {
+            if (verbose)
+            {
+                wxLogError(_("Error in reading image DIB."));
+            }
+            return false;
+        }
+
+        unsigned char *dst = rgb.get();
+        if ( bpp == 24 )
+        {
+            const unsigned char *src = line.get();
+            for ( int x = 0; x < width; x++, src += 3, dst += 3 )
+            {
+                dst[0] = src[2];
+                dst[1] = src[1];
+                dst[2] = src[0];
+            }
+        }
+        else // palette
+        {
+            for ( int x = 0; x < width; x++, dst += 3 )
+            {
+                // the pixels are packed starting from the most significant
+                // bits of each byte
+                const int bit = x * bpp;
+                const int shift = 8 - bpp - bit % 8;
+                const unsigned char * const
+                    colour = cmap[(line[bit / 8] >> shift) & mask];
+
+                dst[0] = colour[0];
+                dst[1] = colour[1];
+                dst[2] = colour[2];
+            }
+        }
+
+        if ( !sink.ProcessRow(isUpsideDown ? height - 1 - row : row,
+                              rgb.get(), NULL) )
+            return false;
+    }
+
+    // the resolution in the bitmap header is in meters, convert to centimeters
+    image->SetOption(wxIMAGE_OPTION_RESOLUTIONUNIT, wxIMAGE_RESOLUTION_CM);
+    image->SetOption(wxIMAGE_OPTION_RESOLUTIONX, resX/100);
+    image->SetOption(wxIMAGE_OPTION_RESOLUTIONY, resY/100);
+
+    return true;
+}
+
 bool wxBMPHandler::DoCanRead(wxInputStream& stream)
 {
     unsigned char hdr[2];
@@ -29,6 +29,13 @@
     #include "wx/colour.h"
 #endif
 
+#include "wx/filename.h"
+#include "wx/imagecache.h"
+#include "wx/scopedarray.h"
+#include "wx/private/imageband.h"
+#include "wx/private/pixelops.h"
+#include "wx/threadpool.h"
+#include "wx/vector.h"
 #include "wx/wfstream.h"
 #include "wx/xpmdecod.h"
 
@@ -57,8 +64,156 @@ IMPLEMENT_VARIANT_OBJECT_EXPORTED_SHALLOWCMP(wxImage,WXDLLEXPORT)
 //-----------------------------------------------------------------------------
 
 wxList wxImage::sm_handlers;
+unsigned wxImage::sm_maxThreads = 1;
 wxImage wxNullImage;
 
+// protects sm_handlers which can be used from several threads at once
+wxCRIT_SECT_DECLARE(gs_csHandlers);
+
+namespace
+{
+
+typedef wxVector<wxImageHandler *> wxImageHandlersArray;
+
+// return a copy of the list of the handlers which can be iterated over
+// without keeping the lock, unlike the list itself
+wxImageHandlersArray GetHandlersArray()
+{
+    wxCRIT_SECT_LOCKER(lock, gs_csHandlers);
+
+    const wxList& list = wxImage::GetHandlers();
+
+    wxImageHandlersArray handlers;
+    handlers.reserve(list.GetCount());
+    for ( wxList::compatibility_iterator node = list.GetFirst();
+          node;
+          node = node->GetNext() )
+    {
+        handlers.push_back(static_cast<wxImageHandler *>(node->GetData()));
+    }
+
+    return handlers;
+}
+
+} // anonymous namespace
+
+//-----------------------------------------------------------------------------
+// parallel processing helpers
+//-----------------------------------------------------------------------------
+
+#if wxUSE_THREADS
+
+// don't use an extra thread for less than this number of pixels, the
+// overhead of doing it would be bigger than the gain
+const int MIN_PIXELS_PER_THREAD = 65536;
+
+// task processing a band of items in a thread of the pool
+class wxImageBandTask : public wxThreadPoolTask
+{
+public:
+    wxImageBandTask(wxImageBandProcessor& processor, int from, int to)
+        : m_processor(processor),
+          m_from(from),
+          m_to(to),
+          m_submitted(false),
+          m_done(false)
+    {
+    }
+
+    // submit the task to the pool, if this fails the band will be processed
+    // in the current thread by EnsureDone()
+    void Submit(wxThreadPool& pool)
+    {
+        m_submitted = pool.Submit(this);
+    }
+
+    // process the band in the current thread if it wasn't done by the pool
+    // because the task couldn't be submitted to it or was cancelled
+    void EnsureDone()
+    {
+        if ( m_submitted )
+            Wait();
+
+        if ( !m_done )
+            Run();
+    }
+
+protected:
+    virtual void Run()
+    {
+        m_processor.ProcessBand(m_from, m_to);
+        m_done = true;
+    }
+
+private:
+    wxImageBandProcessor& m_processor;
+    const int m_from,
+              m_to;
+    bool m_submitted,
+         m_done;
+};
+
+#endif // wxUSE_THREADS
+
+void wxImageBandProcessor::Process(int numItems, int pixelsPerItem)
+{
+#if wxUSE_THREADS
+    unsigned numThreads = wxImage::GetMaxThreads();
+    if ( !numThreads )
+    {
+        const int numCPUs = wxThread::GetCPUCount();
+        numThreads = numCPUs > 0 ? numCPUs : 1;
+    }
+
+    const wxLongLong_t
+        maxThreads = (wxLongLong_t)numItems*pixelsPerItem / MIN_PIXELS_PER_THREAD;
+    if ( numThreads > maxThreads )
+        numThreads = maxThreads;
+
+    if ( numThreads > 1 )
+    {
+        wxThreadPool& pool = wxThreadPool::Get();
+
+        // the global pool has no threads if they couldn't be created, just
+        // process everything in this thread then
+        if ( pool.IsOk() )
+        {
+            // process the first band in this thread and all the others in the
+            // pool, the bands are computed in the same way as for the serial case
+            // and so the results are always the same
+            wxVector<wxImageBandTask *> tasks;
+            tasks.reserve(numThreads - 1);
+            for ( unsigned n = 1; n < numThreads; n++ )
+            {
+                wxImageBandTask * const task = new wxImageBandTask
+                                              (
+                                                  *this,
+                                                  (wxLongLong_t)numItems*n/numThreads,
+                                                  (wxLongLong_t)numItems*(n + 1)/numThreads
+                                              );
+                task->Submit(pool);
+                tasks.push_back(task);
+            }
+
+            ProcessBand(0, numItems/numThreads);
+
+            for ( size_t n = 0; n < tasks.size(); n++ )
+            {
+                tasks[n]->EnsureDone();
+                tasks[n]->DecRef();
+            }
+
+            return;
+        }
+    }
+#else // !wxUSE_THREADS
+    wxUnusedVar(pixelsPerItem);
+#endif // wxUSE_THREADS/!wxUSE_THREADS
+
+    ProcessBand(0, numItems);
+}
+
+
 //-----------------------------------------------------------------------------
 // wxImageRefData
 //-----------------------------------------------------------------------------
@@ -474,6 +629,14 @@ wxImage::Scale( int width, int height, wxImageResizeQuality quality ) const
         case wxIMAGE_QUALITY_BOX_AVERAGE:
             image = ResampleBox(width, height);
             break;
+
+        case wxIMAGE_QUALITY_LANCZOS3:
+            image = ResampleLanczos3(width, height);
+            break;
+
+        case wxIMAGE_QUALITY_HIGH:
+            wxFAIL_MSG( "wxIMAGE_QUALITY_HIGH should have been replaced" );
+            break;
     }
 
     // If the original image has a mask, apply the mask to the new image
@@ -495,60 +658,188 @@ wxImage::Scale( int width, int height, wxImageResizeQuality quality ) const
     return image;
 }
 
-wxImage wxImage::ResampleNearest(int width, int height) const
+namespace
 {
-    wxImage image;
-    image.Create( width, height, false );
 
-    unsigned char *data = image.GetData();
+// resample the rows of the image using the nearest neighbour algorithm
+class NearestResampler : public wxImageBandProcessor
+{
+public:
+    NearestResampler(const wxImage& src, wxImage& dst)
+        : m_srcData(src.GetData()),
+          m_srcAlpha(dst.HasAlpha() ? src.GetAlpha() : NULL),
+          m_dstData(dst.GetData()),
+          m_dstAlpha(dst.GetAlpha()),
+          m_srcWidth(src.GetWidth()),
+          m_dstWidth(dst.GetWidth()),
+          m_xDelta((m_srcWidth<<16) / m_dstWidth),
+          m_yDelta(((long)src.GetHeight()<<16) / dst.GetHeight())
+    {
+    }
 
-    wxCHECK_MSG( data, image, wxT("unable to create image") );
+protected:
+    virtual void ProcessBand(int from, int to)
+    {
+        const unsigned char *source_data = m_srcData;
+        const unsigned char *source_alpha = m_srcAlpha;
+        unsigned char *target_alpha = m_dstAlpha ? m_dstAlpha + from*m_dstWidth
+                                                 : NULL;
 
-    const unsigned char *source_data = M_IMGDATA->m_data;
-    unsigned char *target_data = data;
-    const unsigned char *source_alpha = 0 ;
-    unsigned char *target_alpha = 0 ;
+        const long old_width = m_srcWidth,
+                   width = m_dstWidth;
 
-    if ( !M_IMGDATA->m_hasMask )
-    {
-        source_alpha = M_IMGDATA->m_alpha ;
-        if ( source_alpha )
+        unsigned char* dest_pixel = m_dstData + from*width*3;
+
+        long y = from*m_yDelta;
+        for ( long j = from; j < to; j++ )
         {
-            image.SetAlpha() ;
-            target_alpha = image.GetAlpha() ;
+            const unsigned char* src_line = &source_data[(y>>16)*old_width*3];
+            const unsigned char* src_alpha_line = source_alpha ? &source_alpha[(y>>16)*old_width] : 0 ;
+
+            long x = 0;
+            for ( long i = 0; i < width; i++ )
+            {
+                const unsigned char* src_pixel = &src_line[(x>>16)*3];
+                const unsigned char* src_alpha_pixel = source_alpha ? &src_alpha_line[(x>>16)] : 0 ;
+                dest_pixel[0] = src_pixel[0];
+                dest_pixel[1] = src_pixel[1];
+                dest_pixel[2] = src_pixel[2];
+                dest_pixel += 3;
+                if ( source_alpha )
+                    *(target_alpha++) = *src_alpha_pixel ;
+                x += m_xDelta;
+            }
+
+            y += m_yDelta;
         }
     }
 
-    long old_height = M_IMGDATA->m_height,
-         old_width  = M_IMGDATA->m_width;
-    long x_delta = (old_width<<16) / width;
-    long y_delta = (old_height<<16) / height;
+private:
+    const unsigned char * const m_srcData;
+    const unsigned char * const m_srcAlpha;
+    unsigned char * const m_dstData;
+    unsigned char * const m_dstAlpha;
+    const long m_srcWidth,
+               m_dstWidth,
+               m_xDelta,
+               m_yDelta;
+};
 
-    unsigned char* dest_pixel = target_data;
+// resample the rows of the image using box averaging
+class BoxResampler : public wxImageBandProcessor
+{
+public:
+    BoxResampler(const wxImage& src, wxImage& dst)
+        : m_srcData(src.GetData()),
+          m_srcAlpha(src.GetAlpha()),
+          m_dstData(dst.GetData()),
+          m_dstAlpha(dst.GetAlpha()),
+          m_srcWidth(src.GetWidth()),
+          m_srcHeight(src.GetHeight()),
+          m_dstWidth(dst.GetWidth()),
+          m_scaleFactorX(double(m_srcWidth) / m_dstWidth),
+          m_scaleFactorY(double(m_srcHeight) / dst.GetHeight())
+    {
+    }
 
-    long y = 0;
-    for ( long j = 0; j < height; j++ )
+protected:
+    virtual void ProcessBand(int from, int to)
     {
-        const unsigned char* src_line = &source_data[(y>>16)*old_width*3];
-        const unsigned char* src_alpha_line = source_alpha ? &source_alpha[(y>>16)*old_width] : 0 ;
+        const double scale_factor_x = m_scaleFactorX;
+        const double scale_factor_y = m_scaleFactorY;
 
-        long x = 0;
-        for ( long i = 0; i < width; i++ )
+        const int scale_factor_x_2 = (int)(scale_factor_x / 2);
+        const int scale_factor_y_2 = (int)(scale_factor_y / 2);
+
+        const unsigned char* src_data = m_srcData;
+        const unsigned char* src_alpha = m_srcAlpha;
+        unsigned char* dst_data = m_dstData + from*m_dstWidth*3;
+        unsigned char* dst_alpha = m_dstAlpha ? m_dstAlpha + from*m_dstWidth
+                                              : NULL;
+
+        int averaged_pixels, src_pixel_index;
+        double sum_r, sum_g, sum_b, sum_a;
+
+        for ( int y = from; y < to; y++ )       // Destination image - Y direction
         {
-            const unsigned char* src_pixel = &src_line[(x>>16)*3];
-            const unsigned char* src_alpha_pixel = source_alpha ? &src_alpha_line[(x>>16)] : 0 ;
-            dest_pixel[0] = src_pixel[0];
-            dest_pixel[1] = src_pixel[1];
-            dest_pixel[2] = src_pixel[2];
-            dest_pixel += 3;
-            if ( source_alpha )
-                *(target_alpha++) = *src_alpha_pixel ;
-            x += x_delta;
-        }
+            // Source pixel in the Y direction
+            int src_y = (int)(y * scale_factor_y);
+
+            for ( int x = 0; x < m_dstWidth; x++ ) // Destination image - X direction
+            {
+                // Source pixel in the X direction
+                int src_x = (int)(x * scale_factor_x);
+
+                // Box of pixels to average
+                averaged_pixels = 0;
+                sum_r = sum_g = sum_b = sum_a = 0.0;
+
+                for ( int j = int(src_y - scale_factor_y/2.0 + 1), k = j;
+                      j <= int(src_y + scale_factor_y_2) || j < k + 2;
+                      j++ )
+                {
+                    // We don't care to average pixels that don't exist (edges)
+                    if ( j < 0 || j > m_srcHeight - 1 )
+                        continue;
+
+                    for ( int i = int(src_x - scale_factor_x/2.0 + 1), e = i;
+                          i <= src_x + scale_factor_x_2 || i < e + 2;
+                          i++ )
+                    {
+                        // Don't average edge pixels
+                        if ( i < 0 || i > m_srcWidth - 1 )
+                            continue;
+
+                        // Calculate the actual index in our source pixels
+                        src_pixel_index = j * m_srcWidth + i;
+
+                        sum_r += src_data[src_pixel_index * 3 + 0];
+                        sum_g += src_data[src_pixel_index * 3 + 1];
+                        sum_b += src_data[src_pixel_index * 3 + 2];
+                        if ( src_alpha )
+                            sum_a += src_alpha[src_pixel_index];
+
+                        averaged_pixels++;
+                    }
+                }
 
-        y += y_delta;
+                // Calculate the average from the sum and number of averaged pixels
+                dst_data[0] = (unsigned char)(sum_r / averaged_pixels);
+                dst_data[1] = (unsigned char)(sum_g / averaged_pixels);
+                dst_data[2] = (unsigned char)(sum_b / averaged_pixels);
+                dst_data += 3;
+                if ( src_alpha )
+                    *dst_alpha++ = (unsigned char)(sum_a / averaged_pixels);
+            }
+        }
     }
 
+private:
+    const unsigned char * const m_srcData;
+    const unsigned char * const m_srcAlpha;
+    unsigned char * const m_dstData;
+    unsigned char * const m_dstAlpha;
+    const int m_srcWidth,
+              m_srcHeight,
+              m_dstWidth;
+    const double m_scaleFactorX,
+                 m_scaleFactorY;
+};
+
+} // anonymous namespace
+
+wxImage wxImage::ResampleNearest(int width, int height) const
+{
+    wxImage image;
+    image.Create( width, height, false );
+
+    wxCHECK_MSG( image.GetData(), image, wxT("unable to create image") );
+
+    if ( !M_IMGDATA->m_hasMask && M_IMGDATA->m_alpha )
+        image.SetAlpha();
+
+    NearestResampler(*this, image).Process(height, width);
+
     return image;
 }
 
@@ -561,181 +852,491 @@ wxImage wxImage::ResampleBox(int width, int height) const
 
     wxImage ret_image(width, height, false);
 
-    const double scale_factor_x = double(M_IMGDATA->m_width) / width;
-    const double scale_factor_y = double(M_IMGDATA->m_height) / height;
+    if ( M_IMGDATA->m_alpha )
+        ret_image.SetAlpha();
+
+    // each destination row uses all the pixels of at least one source row,
+    // take it into account when deciding whether to use threads
+    BoxResampler(*this, ret_image)
+        .Process(height, wxMax(M_IMGDATA->m_width, width) *
+                            wxMax(M_IMGDATA->m_height / height, 1));
+
+    return ret_image;
+}
+
+// ----------------------------------------------------------------------------
+// separable resampling
+// ----------------------------------------------------------------------------
+
+// All the resampling algorithms except for the nearest neighbour and box
+// averaging ones are implemented by applying a one-dimensional filter first
+// to all the rows and then to all the columns of the image. The weights of
+// the source pixels used for each destination row and column don't depend on
+// the image contents, so they're computed only once and stored as fixed point
+// numbers which allows to use integer (and SIMD) arithmetic for the filtering
+// itself.
+
+namespace
+{
 
-    const int scale_factor_x_2 = (int)(scale_factor_x / 2);
-    const int scale_factor_y_2 = (int)(scale_factor_y / 2);
+// the number of fractional bits in the fixed point filter weights: this must
+// be small enough for 255 times the sum of the absolute values of the weights
+// to fit into an int and for each weight to fit into wxInt16
+const int RESAMPLE_PRECISION_BITS = 14;
 
-    const unsigned char* src_data = M_IMGDATA->m_data;
-    const unsigned char* src_alpha = M_IMGDATA->m_alpha;
-    unsigned char* dst_data = ret_image.GetData();
-    unsigned char* dst_alpha = NULL;
+// description of a filter used for resampling
+struct ResampleFilter
+{
+    // the filter kernel and its support, i.e. the kernel must be 0 outside of
+    // [-support, support] interval
+    double (*kernel)(double x);
+    double support;
+
+    // if true, the source pixel corresponding to a destination one is at the
+    // centre of the area covered by it and the kernel is widened when
+    // reducing the image size, so that all the source pixels contribute to
+    // the result; otherwise the kernel is just evaluated around the position
+    // of the top left corner of the destination pixel, as the bilinear and
+    // bicubic algorithms always did
+    bool antialias;
+};
 
-    if ( src_alpha )
+// the weights used for resampling in one direction
+class ResampleWeights
+{
+public:
+    ResampleWeights(int srcSize, int dstSize, const ResampleFilter& filter);
+
+    // the index of the first source pixel used for the destination pixel n
+    int GetFirst(int n) const { return m_first[n]; }
+
+    // the number of the source pixels used for the destination pixel n
+    int GetCount(int n) const { return m_count[n]; }
+
+    // the weights of these source pixels
+    const wxInt16 *GetWeights(int n) const { return &m_weights[n*m_maxCount]; }
+
+private:
+    wxVector<int> m_first,
+                  m_count;
+    wxVector<wxInt16> m_weights;
+
+    // the maximal number of weights for any pixel
+    int m_maxCount;
+};
+
+ResampleWeights::ResampleWeights(int srcSize,
+                                 int dstSize,
+                                 const ResampleFilter& filter)
+{
+    const double scale = double(srcSize) / dstSize;
+
+    double filterScale = 1.;
+    double support = filter.support;
+    if ( filter.antialias && scale > 1. )
     {
-        ret_image.SetAlpha();
-        dst_alpha = ret_image.GetAlpha();
+        filterScale = scale;
+        support *= scale;
     }
 
-    int averaged_pixels, src_pixel_index;
-    double sum_r, sum_g, sum_b, sum_a;
+    m_maxCount = 2*(int)ceil(support) + 1;
+
+    m_first.resize(dstSize);
+    m_count.resize(dstSize);
+    m_weights.resize(dstSize*m_maxCount);
 
-    for ( int y = 0; y < height; y++ )         // Destination image - Y direction
+    wxVector<double> weights(m_maxCount);
+    for ( int n = 0; n < dstSize; n++ )
     {
-        // Source pixel in the Y direction
-        int src_y = (int)(y * scale_factor_y);
+        double center;
+        int from, to;
+        if ( filter.antialias )
+        {
+            center = (n + 0.5)*scale - 0.5;
+            from = (int)floor(center - support) + 1;
+            to = (int)floor(center + support);
+        }
+        else
+        {
+            center = double(n*srcSize) / dstSize;
+            const int base = (int)center;
+            from = base + (int)floor(-filter.support) + 1;
+            to = base + (int)floor(filter.support);
+        }
+
+        // the source pixels outside of the image are replaced by the nearest
+        // edge pixel, so merge their weights into the weight of the latter
+        const int first = wxMax(0, wxMin(from, srcSize - 1));
+        const int last = wxMax(0, wxMin(to, srcSize - 1));
+        const int count = last - first + 1;
+
+        wxASSERT_MSG( count <= m_maxCount, "too many resampling weights" );
 
-        for ( int x = 0; x < width; x++ )      // Destination image - X direction
+        for ( int i = 0; i < count; i++ )
+            weights[i] = 0.;
+
+        double sum = 0.;
+        for ( int i = from; i <= to; i++ )
         {
-            // Source pixel in the X direction
-            int src_x = (int)(x * scale_factor_x);
+            const double w = filter.kernel((i - center) / filterScale);
+            weights[wxMax(0, wxMin(i, srcSize - 1)) - first] += w;
+            sum += w;
+        }
 
-            // Box of pixels to average
-            averaged_pixels = 0;
-            sum_r = sum_g = sum_b = sum_a = 0.0;
+        if ( sum == 0. )
+        {
+            // this can't happen with any of the filters we use, but avoid
+            // dividing by 0 just in case
+            weights[0] = sum = 1.;
+        }
 
-            for ( int j = int(src_y - scale_factor_y/2.0 + 1), k = j;
-                  j <= int(src_y + scale_factor_y_2) || j < k + 2;
-                  j++ )
-            {
-                // We don't care to average pixels that don't exist (edges)
-                if ( j < 0 || j > M_IMGDATA->m_height - 1 )
-                    continue;
+        wxInt16 * const fixedWeights = &m_weights[n*m_maxCount];
+        for ( int i = 0; i < count; i++ )
+        {
+            fixedWeights[i] = (wxInt16)floor(weights[i] / sum
+                                                * (1 << RESAMPLE_PRECISION_BITS)
+                                                + 0.5);
+        }
 
-                for ( int i = int(src_x - scale_factor_x/2.0 + 1), e = i;
-                      i <= src_x + scale_factor_x_2 || i < e + 2;
-                      i++ )
-                {
-                    // Don't average edge pixels
-                    if ( i < 0 || i > M_IMGDATA->m_width - 1 )
-                        continue;
+        m_first[n] = first;
+        m_count[n] = count;
+    }
+}
 
-                    // Calculate the actual index in our source pixels
-                    src_pixel_index = j * M_IMGDATA->m_width + i;
+// convert the fixed point result of filtering to a colour component value
+inline unsigned char ClampResampled(int value)
+{
+    value >>= RESAMPLE_PRECISION_BITS;
 
-                    sum_r += src_data[src_pixel_index * 3 + 0];
-                    sum_g += src_data[src_pixel_index * 3 + 1];
-                    sum_b += src_data[src_pixel_index * 3 + 2];
-                    if ( src_alpha )
-                        sum_a += src_alpha[src_pixel_index];
+    return value < 0 ? 0 : value > 255 ? 255 : (unsigned char)value;
+}
+
+// resample the rows [rowStart, rowEnd) of the source data with the given
+// number of channels horizontally
+void ResampleRows(const unsigned char *src, int srcWidth,
+                  unsigned char *dst, int dstWidth,
+                  int channels,
+                  const ResampleWeights& weights,
+                  int rowStart, int rowEnd)
+{
+    const int rounding = 1 << (RESAMPLE_PRECISION_BITS - 1);
+
+    for ( int y = rowStart; y < rowEnd; y++ )
+    {
+        const unsigned char * const srcRow = src + y*srcWidth*channels;
+        unsigned char *dstPixel = dst + y*dstWidth*channels;
+
+        for ( int x = 0; x < dstWidth; x++ )
+        {
+            const wxInt16 * const w = weights.GetWeights(x);
+            const int count = weights.GetCount(x);
+            const unsigned char *p = srcRow + weights.GetFirst(x)*channels;
 
-                    averaged_pixels++;
+            if ( channels == 3 )
+            {
+                int r = rounding,
+                    g = rounding,
+                    b = rounding;
+                for ( int i = 0; i < count; i++, p += 3 )
+                {
+                    r += p[0]*w[i];
+                    g += p[1]*w[i];
+                    b += p[2]*w[i];
                 }
+
+                dstPixel[0] = ClampResampled(r);
+                dstPixel[1] = ClampResampled(g);
+                dstPixel[2] = ClampResampled(b);
+                dstPixel += 3;
             }
+            else // single channel
+            {
+                int a = rounding;
+                for ( int i = 0; i < count; i++ )
+                    a += p[i]*w[i];
 
-            // Calculate the average from the sum and number of averaged pixels
-            dst_data[0] = (unsigned char)(sum_r / averaged_pixels);
-            dst_data[1] = (unsigned char)(sum_g / averaged_pixels);
-            dst_data[2] = (unsigned char)(sum_b / averaged_pixels);
-            dst_data += 3;
-            if ( src_alpha )
-                *dst_alpha++ = (unsigned char)(sum_a / averaged_pixels);
+                *dstPixel++ = ClampResampled(a);
+            }
         }
     }
+}
 
-    return ret_image;
+// compute the rows [rowStart, rowEnd) of the destination by resampling the
+// source data vertically, the length of the rows is given in bytes
+void ResampleColumns(const unsigned char *src,
+                     unsigned char *dst,
+                     int rowLength,
+                     const ResampleWeights& weights,
+                     int rowStart, int rowEnd)
+{
+    const int rounding = 1 << (RESAMPLE_PRECISION_BITS - 1);
+
+    for ( int y = rowStart; y < rowEnd; y++ )
+    {
+        const wxInt16 * const w = weights.GetWeights(y);
+        const int count = weights.GetCount(y);
+        const unsigned char * const srcFirst = src + weights.GetFirst(y)*rowLength;
+        unsigned char * const dstRow = dst + y*rowLength;
+
+        int x = 0;
+
+#ifdef wxHAS_SSE2
+        // process 8 bytes of all source rows at once, taking the rows by pairs
+        // to use the multiply-add instruction
+        const __m128i zero = _mm_setzero_si128();
+        for ( ; x + 8 <= rowLength; x += 8 )
+        {
+            __m128i accLo = _mm_set1_epi32(rounding),
+                    accHi = accLo;
+
+            const unsigned char *p = srcFirst + x;
+            for ( int i = 0; i < count; i += 2, p += 2*rowLength )
+            {
+                __m128i row1 = _mm_unpacklo_epi8(
+                                _mm_loadl_epi64((const __m128i *)p), zero);
+                __m128i row2;
+                int weightsPair = (wxUint16)w[i];
+                if ( i + 1 < count )
+                {
+                    row2 = _mm_unpacklo_epi8(
+                            _mm_loadl_epi64((const __m128i *)(p + rowLength)),
+                            zero);
+                    weightsPair |= (int)w[i + 1] << 16;
+                }
+                else
+                {
+                    row2 = zero;
+                }
+
+                const __m128i weights2 = _mm_set1_epi32(weightsPair);
+                accLo = _mm_add_epi32(accLo,
+                            _mm_madd_epi16(_mm_unpacklo_epi16(row1, row2),
+                                           weights2));
+                accHi = _mm_add_epi32(accHi,
+                            _mm_madd_epi16(_mm_unpackhi_epi16(row1, row2),
+                                           weights2));
+            }
+
+            accLo = _mm_srai_epi32(accLo, RESAMPLE_PRECISION_BITS);
+            accHi = _mm_srai_epi32(accHi, RESAMPLE_PRECISION_BITS);
+
+            // pack with saturation which clamps the values to 0..255 range
+            const __m128i result = _mm_packs_epi32(accLo, accHi);
+            _mm_storel_epi64((__m128i *)(dstRow + x),
+                             _mm_packus_epi16(result, result));
+        }
+#endif // wxHAS_SSE2
+
+        for ( ; x < rowLength; x++ )
+        {
+            int value = rounding;
+            const unsigned char *p = srcFirst + x;
+            for ( int i = 0; i < count; i++, p += rowLength )
+                value += *p*w[i];
+
+            dstRow[x] = ClampResampled(value);
+        }
+    }
 }
 
-wxImage wxImage::ResampleBilinear(int width, int height) const
+// resample the rows of the source data horizontally, either all of them or
+// only those in the given array
+class RowsResampler : public wxImageBandProcessor
 {
-    // This function implements a Bilinear algorithm for resampling.
-    wxImage ret_image(width, height, false);
-    const unsigned char* src_data = M_IMGDATA->m_data;
-    const unsigned char* src_alpha = M_IMGDATA->m_alpha;
-    unsigned char* dst_data = ret_image.GetData();
-    unsigned char* dst_alpha = NULL;
+public:
+    RowsResampler(const unsigned char *src, int srcWidth,
+                  unsigned char *dst, int dstWidth,
+                  int channels,
+                  const ResampleWeights& weights,
+                  const int *rows = NULL)
+        : m_src(src),
+          m_dst(dst),
+          m_srcWidth(srcWidth),
+          m_dstWidth(dstWidth),
+          m_channels(channels),
+          m_weights(weights),
+          m_rows(rows)
+    {
+    }
 
-    if ( src_alpha )
+protected:
+    virtual void ProcessBand(int from, int to)
     {
-        ret_image.SetAlpha();
-        dst_alpha = ret_image.GetAlpha();
+        if ( !m_rows )
+        {
+            ResampleRows(m_src, m_srcWidth, m_dst, m_dstWidth, m_channels,
+                         m_weights, from, to);
+            return;
+        }
+
+        for ( int n = from; n < to; n++ )
+        {
+            ResampleRows(m_src, m_srcWidth, m_dst, m_dstWidth, m_channels,
+                         m_weights, m_rows[n], m_rows[n] + 1);
+        }
     }
-    double HFactor = double(M_IMGDATA->m_height) / height;
-    double WFactor = double(M_IMGDATA->m_width) / width;
 
-    int srcpixymax = M_IMGDATA->m_height - 1;
-    int srcpixxmax = M_IMGDATA->m_width - 1;
+private:
+    const unsigned char * const m_src;
+    unsigned char * const m_dst;
+    const int m_srcWidth,
+              m_dstWidth,
+              m_channels;
+    const ResampleWeights& m_weights;
+    const int * const m_rows;
+};
+
+// compute the destination rows by resampling the source data vertically
+class ColumnsResampler : public wxImageBandProcessor
+{
+public:
+    ColumnsResampler(const unsigned char *src,
+                     unsigned char *dst,
+                     int rowLength,
+                     const ResampleWeights& weights)
+        : m_src(src),
+          m_dst(dst),
+          m_rowLength(rowLength),
+          m_weights(weights)
+    {
+    }
 
-    double srcpixy, srcpixy1, srcpixy2, dy, dy1;
-    double srcpixx, srcpixx1, srcpixx2, dx, dx1;
+protected:
+    virtual void ProcessBand(int from, int to)
+    {
+        ResampleColumns(m_src, m_dst, m_rowLength, m_weights, from, to);
+    }
+
+private:
+    const unsigned char * const m_src;
+    unsigned char * const m_dst;
+    const int m_rowLength;
+    const ResampleWeights& m_weights;
+};
+
+// resample one plane of the image data with the given number of channels
+void ResamplePlane(const unsigned char *src, int srcWidth, int srcHeight,
+                   unsigned char *dst, int dstWidth, int dstHeight,
+                   int channels,
+                   const ResampleWeights& weightsX,
+                   const ResampleWeights& weightsY)
+{
+    if ( srcWidth == dstWidth )
+    {
+        ColumnsResampler(src, dst, dstWidth*channels, weightsY)
+            .Process(dstHeight, dstWidth);
+        return;
+    }
 
-    // initialize alpha values to avoid g++ warnings about possibly
-    // uninitialized variables
-    double r1, g1, b1, a1 = 0;
-    double r2, g2, b2, a2 = 0;
+    if ( srcHeight == dstHeight )
+    {
+        RowsResampler(src, srcWidth, dst, dstWidth, channels, weightsX)
+            .Process(dstHeight, dstWidth);
+        return;
+    }
 
-    for ( int dsty = 0; dsty < height; dsty++ )
+    // only resample horizontally the rows which are used for computing the
+    // destination rows, this matters when reducing the image size with a
+    // filter of fixed width which doesn't use all the source rows
+    //
+    // notice that the buffer is intentionally not initialized as its rows not
+    // used by the filter are never accessed
+    wxVector<int> rows;
+    rows.reserve(srcHeight);
+    int rowDone = 0;
+    for ( int y = 0; y < dstHeight; y++ )
     {
-        // We need to calculate the source pixel to interpolate from - Y-axis
-        srcpixy = double(dsty) * HFactor;
-        srcpixy1 = int(srcpixy);
-        srcpixy2 = ( srcpixy1 == srcpixymax ) ? srcpixy1 : srcpixy1 + 1.0;
-        dy = srcpixy - (int)srcpixy;
-        dy1 = 1.0 - dy;
+        const int rowEnd = weightsY.GetFirst(y) + weightsY.GetCount(y);
+        for ( int row = wxMax(rowDone, weightsY.GetFirst(y)); row < rowEnd; row++ )
+            rows.push_back(row);
 
+        rowDone = wxMax(rowDone, rowEnd);
+    }
 
-        for ( int dstx = 0; dstx < width; dstx++ )
-        {
-            // X-axis of pixel to interpolate from
-            srcpixx = double(dstx) * WFactor;
-            srcpixx1 = int(srcpixx);
-            srcpixx2 = ( srcpixx1 == srcpixxmax ) ? srcpixx1 : srcpixx1 + 1.0;
-            dx = srcpixx - (int)srcpixx;
-            dx1 = 1.0 - dx;
-
-            int x_offset1 = srcpixx1 < 0.0 ? 0 : srcpixx1 > srcpixxmax ? srcpixxmax : (int)srcpixx1;
-            int x_offset2 = srcpixx2 < 0.0 ? 0 : srcpixx2 > srcpixxmax ? srcpixxmax : (int)srcpixx2;
-            int y_offset1 = srcpixy1 < 0.0 ? 0 : srcpixy1 > srcpixymax ? srcpixymax : (int)srcpixy1;
-            int y_offset2 = srcpixy2 < 0.0 ? 0 : srcpixy2 > srcpixymax ? srcpixymax : (int)srcpixy2;
-
-            int src_pixel_index00 = y_offset1 * M_IMGDATA->m_width + x_offset1;
-            int src_pixel_index01 = y_offset1 * M_IMGDATA->m_width + x_offset2;
-            int src_pixel_index10 = y_offset2 * M_IMGDATA->m_width + x_offset1;
-            int src_pixel_index11 = y_offset2 * M_IMGDATA->m_width + x_offset2;
-
-            // first line
-            r1 = src_data[src_pixel_index00 * 3 + 0] * dx1 + src_data[src_pixel_index01 * 3 + 0] * dx;
-            g1 = src_data[src_pixel_index00 * 3 + 1] * dx1 + src_data[src_pixel_index01 * 3 + 1] * dx;
-            b1 = src_data[src_pixel_index00 * 3 + 2] * dx1 + src_data[src_pixel_index01 * 3 + 2] * dx;
-            if ( src_alpha )
-                a1 = src_alpha[src_pixel_index00] * dx1 + src_alpha[src_pixel_index01] * dx;
+    wxScopedArray<unsigned char>
+        tmp(new unsigned char[dstWidth*srcHeight*channels]);
 
-            // second line
-            r2 = src_data[src_pixel_index10 * 3 + 0] * dx1 + src_data[src_pixel_index11 * 3 + 0] * dx;
-            g2 = src_data[src_pixel_index10 * 3 + 1] * dx1 + src_data[src_pixel_index11 * 3 + 1] * dx;
-            b2 = src_data[src_pixel_index10 * 3 + 2] * dx1 + src_data[src_pixel_index11 * 3 + 2] * dx;
-            if ( src_alpha )
-                a2 = src_alpha[src_pixel_index10] * dx1 + src_alpha[src_pixel_index11] * dx;
+    RowsResampler(src, srcWidth, tmp.get(), dstWidth, channels, weightsX,
+                  &rows[0])
+        .Process(rows.size(), dstWidth);
 
-            // result lines
+    ColumnsResampler(tmp.get(), dst, dstWidth*channels, weightsY)
+        .Process(dstHeight, dstWidth);
+}
 
-            dst_data[0] = static_cast<unsigned char>(r1 * dy1 + r2 * dy);
-            dst_data[1] = static_cast<unsigned char>(g1 * dy1 + g2 * dy);
-            dst_data[2] = static_cast<unsigned char>(b1 * dy1 + b2 * dy);
-            dst_data += 3;
+// resample the image using the given filter
+wxImage ResampleSeparable(const wxImage& image,
+                          int width, int height,
+                          const ResampleFilter& filter)
+{
+    wxImage ret_image(width, height, false);
+    wxCHECK_MSG( ret_image.IsOk(), ret_image, "unable to create image" );
 
-            if ( src_alpha )
-                *dst_alpha++ = static_cast<unsigned char>(a1 * dy1 + a2 * dy);
-        }
+    const int old_width = image.GetWidth(),
+              old_height = image.GetHeight();
+
+    const ResampleWeights weightsX(old_width, width, filter),
+                          weightsY(old_height, height, filter);
+
+    ResamplePlane(image.GetData(), old_width, old_height,
+                  ret_image.GetData(), width, height,
+                  3, weightsX, weightsY);
+
+    if ( image.HasAlpha() )
+    {
+        ret_image.SetAlpha();
+        ResamplePlane(image.GetAlpha(), old_width, old_height,
+                      ret_image.GetAlpha(), width, height,
+                      1, weightsX, weightsY);
     }
 
     return ret_image;
 }
 
-// The following two local functions are for the B-spline weighting of the
-// bicubic sampling algorithm
-static inline double spline_cube(double value)
+// triangle filter used by the bilinear algorithm
+double TriangleKernel(double x)
+{
+    x = fabs(x);
+    return x < 1. ? 1. - x : 0.;
+}
+
+// B-spline filter used by the bicubic algorithm
+inline double SplineCube(double value)
 {
     return value <= 0.0 ? 0.0 : value * value * value;
 }
 
-static inline double spline_weight(double value)
+double BicubicKernel(double value)
+{
+    return (SplineCube(value + 2) -
+            4 * SplineCube(value + 1) +
+            6 * SplineCube(value) -
+            4 * SplineCube(value - 1)) / 6;
+}
+
+// windowed sinc filter used by Lanczos algorithm
+inline double Sinc(double x)
+{
+    if ( x == 0. )
+        return 1.;
+
+    x *= M_PI;
+    return sin(x) / x;
+}
+
+double Lanczos3Kernel(double x)
 {
-    return (spline_cube(value + 2) -
-            4 * spline_cube(value + 1) +
-            6 * spline_cube(value) -
-            4 * spline_cube(value - 1)) / 6;
+    return x > -3. && x < 3. ? Sinc(x)*Sinc(x / 3) : 0.;
+}
+
+} // anonymous namespace
+
+wxImage wxImage::ResampleBilinear(int width, int height) const
+{
+    // This function implements a Bilinear algorithm for resampling.
+    static const ResampleFilter filter = { TriangleKernel, 1., false };
+
+    return ResampleSeparable(*this, width, height, filter);
 }
 
 // This is the bicubic resampling algorithm
@@ -753,307 +1354,300 @@ wxImage wxImage::ResampleBicubic(int width, int height) const
     // upsampling by large factors.  This is basically because a slight
     // gaussian blur is being performed to get the smooth look of the upsampled
     // image.
-
-    // Edge pixels: 3-4 possible solutions
-    // - (Wrap/tile) Wrap the image, take the color value from the opposite
-    // side of the image.
-    // - (Mirror)    Duplicate edge pixels, so that pixel at coordinate (2, n),
-    // where n is nonpositive, will have the value of (2, 1).
-    // - (Ignore)    Simply ignore the edge pixels and apply the kernel only to
-    // pixels which do have all neighbours.
-    // - (Clamp)     Choose the nearest pixel along the border. This takes the
-    // border pixels and extends them out to infinity.
     //
-    // NOTE: below the y_offset and x_offset variables are being set for edge
-    // pixels using the "Mirror" method mentioned above
+    // The edge pixels are handled by clamping, i.e. the pixels outside of the
+    // image are taken to be the same as the nearest pixel on its border.
+    static const ResampleFilter filter = { BicubicKernel, 2., false };
 
-    wxImage ret_image;
+    return ResampleSeparable(*this, width, height, filter);
+}
 
-    ret_image.Create(width, height, false);
+wxImage wxImage::ResampleLanczos3(int width, int height) const
+{
+    // Lanczos filter is a sinc function windowed by another, 3 times wider,
+    // sinc lobe. It gives sharper results than the bicubic B-spline, both
+    // when enlarging and reducing the image, and, because it's widened when
+    // reducing, takes all the source pixels into account, avoiding aliasing.
+    static const ResampleFilter filter = { Lanczos3Kernel, 3., true };
+
+    return ResampleSeparable(*this, width, height, filter);
+}
 
-    const unsigned char* src_data = M_IMGDATA->m_data;
-    const unsigned char* src_alpha = M_IMGDATA->m_alpha;
-    unsigned char* dst_data = ret_image.GetData();
-    unsigned char* dst_alpha = NULL;
+namespace
+{
 
-    if ( src_alpha )
+// blur the rows of the image horizontally
+class HorzBlurProcessor : public wxImageBandProcessor
+{
+public:
+    HorzBlurProcessor(const wxImage& src, wxImage& dst, int blurRadius)
+        : m_srcData(src.GetData()),
+          m_srcAlpha(src.GetAlpha()),
+          m_dstData(dst.GetData()),
+          m_dstAlpha(dst.GetAlpha()),
+          m_width(src.GetWidth()),
+          m_height(src.GetHeight()),
+          m_blurRadius(blurRadius)
     {
-        ret_image.SetAlpha();
-        dst_alpha = ret_image.GetAlpha();
     }
 
-    for ( int dsty = 0; dsty < height; dsty++ )
+protected:
+    virtual void ProcessBand(int from, int to)
     {
-        // We need to calculate the source pixel to interpolate from - Y-axis
-        double srcpixy = double(dsty * M_IMGDATA->m_height) / height;
-        double dy = srcpixy - (int)srcpixy;
+        const unsigned char* src_data = m_srcData;
+        unsigned char* dst_data = m_dstData;
+        const unsigned char* src_alpha = m_srcAlpha;
+        unsigned char* dst_alpha = m_dstAlpha;
 
-        for ( int dstx = 0; dstx < width; dstx++ )
-        {
-            // X-axis of pixel to interpolate from
-            double srcpixx = double(dstx * M_IMGDATA->m_width) / width;
-            double dx = srcpixx - (int)srcpixx;
+        const int blurRadius = m_blurRadius;
 
-            // Sums for each color channel
-            double sum_r = 0, sum_g = 0, sum_b = 0, sum_a = 0;
+        // number of pixels we average over
+        const int blurArea = blurRadius*2 + 1;
 
-            // Here we actually determine the RGBA values for the destination pixel
-            for ( int k = -1; k <= 2; k++ )
+        // Horizontal blurring algorithm - average all pixels in the specified blur
+        // radius in the X or horizontal direction
+        for ( int y = from; y < to; y++ )
+        {
+            // Variables used in the blurring algorithm
+            long sum_r = 0,
+                 sum_g = 0,
+                 sum_b = 0,
+                 sum_a = 0;
+
+            long pixel_idx;
+            const unsigned char *src;
+            unsigned char *dst;
+
+            // Calculate the average of all pixels in the blur radius for the first
+            // pixel of the row
+            for ( int kernel_x = -blurRadius; kernel_x <= blurRadius; kernel_x++ )
             {
-                // Y offset
-                int y_offset = srcpixy + k < 0.0
-                                ? 0
-                                : srcpixy + k >= M_IMGDATA->m_height
-                                       ? M_IMGDATA->m_height - 1
-                                       : (int)(srcpixy + k);
-
-                // Loop across the X axis
-                for ( int i = -1; i <= 2; i++ )
-                {
-                    // X offset
-                    int x_offset = srcpixx + i < 0.0
-                                    ? 0
-                                    : srcpixx + i >= M_IMGDATA->m_width
-                                            ? M_IMGDATA->m_width - 1
-                                            : (int)(srcpixx + i);
-
-                    // Calculate the exact position where the source data
-                    // should be pulled from based on the x_offset and y_offset
-                    int src_pixel_index = y_offset*M_IMGDATA->m_width + x_offset;
-
-                    // Calculate the weight for the specified pixel according
-                    // to the bicubic b-spline kernel we're using for
-                    // interpolation
-                    double
-                        pixel_weight = spline_weight(i - dx)*spline_weight(k - dy);
-
-                    // Create a sum of all velues for each color channel
-                    // adjusted for the pixel's calculated weight
-                    sum_r += src_data[src_pixel_index * 3 + 0] * pixel_weight;
-                    sum_g += src_data[src_pixel_index * 3 + 1] * pixel_weight;
-                    sum_b += src_data[src_pixel_index * 3 + 2] * pixel_weight;
-                    if ( src_alpha )
-                        sum_a += src_alpha[src_pixel_index] * pixel_weight;
-                }
+                // To deal with the pixels at the start of a row so it's not
+                // grabbing GOK values from memory at negative indices of the
+                // image's data or grabbing from the previous row
+                if ( kernel_x < 0 )
+                    pixel_idx = y * m_width;
+                else
+                    pixel_idx = kernel_x + y * m_width;
+
+                src = src_data + pixel_idx*3;
+                sum_r += src[0];
+                sum_g += src[1];
+                sum_b += src[2];
+                if ( src_alpha )
+                    sum_a += src_alpha[pixel_idx];
             }
 
-            // Put the data into the destination image.  The summed values are
-            // of double data type and are rounded here for accuracy
-            dst_data[0] = (unsigned char)(sum_r + 0.5);
-            dst_data[1] = (unsigned char)(sum_g + 0.5);
-            dst_data[2] = (unsigned char)(sum_b + 0.5);
-            dst_data += 3;
-
+            dst = dst_data + y * m_width*3;
+            dst[0] = (unsigned char)(sum_r / blurArea);
+            dst[1] = (unsigned char)(sum_g / blurArea);
+            dst[2] = (unsigned char)(sum_b / blurArea);
             if ( src_alpha )
-                *dst_alpha++ = (unsigned char)sum_a;
+                dst_alpha[y * m_width] = (unsigned char)(sum_a / blurArea);
+
+            // Now average the values of the rest of the pixels by just moving the
+            // blur radius box along the row
+            for ( int x = 1; x < m_width; x++ )
+            {
+                // Take care of edge pixels on the left edge by essentially
+                // duplicating the edge pixel
+                if ( x - blurRadius - 1 < 0 )
+                    pixel_idx = y * m_width;
+                else
+                    pixel_idx = (x - blurRadius - 1) + y * m_width;
+
+                // Subtract the value of the pixel at the left side of the blur
+                // radius box
+                src = src_data + pixel_idx*3;
+                sum_r -= src[0];
+                sum_g -= src[1];
+                sum_b -= src[2];
+                if ( src_alpha )
+                    sum_a -= src_alpha[pixel_idx];
+
+                // Take care of edge pixels on the right edge
+                if ( x + blurRadius > m_width - 1 )
+                    pixel_idx = m_width - 1 + y * m_width;
+                else
+                    pixel_idx = x + blurRadius + y * m_width;
+
+                // Add the value of the pixel being added to the end of our box
+                src = src_data + pixel_idx*3;
+                sum_r += src[0];
+                sum_g += src[1];
+                sum_b += src[2];
+                if ( src_alpha )
+                    sum_a += src_alpha[pixel_idx];
+
+                // Save off the averaged data
+                dst = dst_data + x*3 + y*m_width*3;
+                dst[0] = (unsigned char)(sum_r / blurArea);
+                dst[1] = (unsigned char)(sum_g / blurArea);
+                dst[2] = (unsigned char)(sum_b / blurArea);
+                if ( src_alpha )
+                    dst_alpha[x + y * m_width] = (unsigned char)(sum_a / blurArea);
+            }
         }
     }
 
-    return ret_image;
-}
+private:
+    const unsigned char * const m_srcData;
+    const unsigned char * const m_srcAlpha;
+    unsigned char * const m_dstData;
+    unsigned char * const m_dstAlpha;
+    const int m_width,
+              m_height,
+              m_blurRadius;
+};
 
-// Blur in the horizontal direction
-wxImage wxImage::BlurHorizontal(int blurRadius) const
+// blur the columns of the image vertically
+class VertBlurProcessor : public wxImageBandProcessor
 {
-    wxImage ret_image(MakeEmptyClone());
-
-    wxCHECK( ret_image.IsOk(), ret_image );
-
-    const unsigned char* src_data = M_IMGDATA->m_data;
-    unsigned char* dst_data = ret_image.GetData();
-    const unsigned char* src_alpha = M_IMGDATA->m_alpha;
-    unsigned char* dst_alpha = ret_image.GetAlpha();
-
-    // number of pixels we average over
-    const int blurArea = blurRadius*2 + 1;
+public:
+    VertBlurProcessor(const wxImage& src, wxImage& dst, int blurRadius)
+        : m_srcData(src.GetData()),
+          m_srcAlpha(src.GetAlpha()),
+          m_dstData(dst.GetData()),
+          m_dstAlpha(dst.GetAlpha()),
+          m_width(src.GetWidth()),
+          m_height(src.GetHeight()),
+          m_blurRadius(blurRadius)
+    {
+    }
 
-    // Horizontal blurring algorithm - average all pixels in the specified blur
-    // radius in the X or horizontal direction
-    for ( int y = 0; y < M_IMGDATA->m_height; y++ )
+protected:
+    virtual void ProcessBand(int from, int to)
     {
-        // Variables used in the blurring algorithm
-        long sum_r = 0,
-             sum_g = 0,
-             sum_b = 0,
-             sum_a = 0;
+        const unsigned char* src_data = m_srcData;
+        unsigned char* dst_data = m_dstData;
+        const unsigned char* src_alpha = m_srcAlpha;
+        unsigned char* dst_alpha = m_dstAlpha;
 
-        long pixel_idx;
-        const unsigned char *src;
-        unsigned char *dst;
+        const int blurRadius = m_blurRadius;
 
-        // Calculate the average of all pixels in the blur radius for the first
-        // pixel of the row
-        for ( int kernel_x = -blurRadius; kernel_x <= blurRadius; kernel_x++ )
-        {
-            // To deal with the pixels at the start of a row so it's not
-            // grabbing GOK values from memory at negative indices of the
-            // image's data or grabbing from the previous row
-            if ( kernel_x < 0 )
-                pixel_idx = y * M_IMGDATA->m_width;
-            else
-                pixel_idx = kernel_x + y * M_IMGDATA->m_width;
+        // number of pixels we average over
+        const int blurArea = blurRadius*2 + 1;
 
-            src = src_data + pixel_idx*3;
-            sum_r += src[0];
-            sum_g += src[1];
-            sum_b += src[2];
-            if ( src_alpha )
-                sum_a += src_alpha[pixel_idx];
-        }
-
-        dst = dst_data + y * M_IMGDATA->m_width*3;
-        dst[0] = (unsigned char)(sum_r / blurArea);
-        dst[1] = (unsigned char)(sum_g / blurArea);
-        dst[2] = (unsigned char)(sum_b / blurArea);
-        if ( src_alpha )
-            dst_alpha[y * M_IMGDATA->m_width] = (unsigned char)(sum_a / blurArea);
-
-        // Now average the values of the rest of the pixels by just moving the
-        // blur radius box along the row
-        for ( int x = 1; x < M_IMGDATA->m_width; x++ )
+        // Vertical blurring algorithm - same as horizontal but switched the
+        // opposite direction
+        for ( int x = from; x < to; x++ )
         {
-            // Take care of edge pixels on the left edge by essentially
-            // duplicating the edge pixel
-            if ( x - blurRadius - 1 < 0 )
-                pixel_idx = y * M_IMGDATA->m_width;
-            else
-                pixel_idx = (x - blurRadius - 1) + y * M_IMGDATA->m_width;
-
-            // Subtract the value of the pixel at the left side of the blur
-            // radius box
-            src = src_data + pixel_idx*3;
-            sum_r -= src[0];
-            sum_g -= src[1];
-            sum_b -= src[2];
-            if ( src_alpha )
-                sum_a -= src_alpha[pixel_idx];
-
-            // Take care of edge pixels on the right edge
-            if ( x + blurRadius > M_IMGDATA->m_width - 1 )
-                pixel_idx = M_IMGDATA->m_width - 1 + y * M_IMGDATA->m_width;
-            else
-                pixel_idx = x + blurRadius + y * M_IMGDATA->m_width;
-
-            // Add the value of the pixel being added to the end of our box
-            src = src_data + pixel_idx*3;
-            sum_r += src[0];
-            sum_g += src[1];
-            sum_b += src[2];
-            if ( src_alpha )
-                sum_a += src_alpha[pixel_idx];
+            // Variables used in the blurring algorithm
+            long sum_r = 0,
+                 sum_g = 0,
+                 sum_b = 0,
+                 sum_a = 0;
+
+            long pixel_idx;
+            const unsigned char *src;
+            unsigned char *dst;
+
+            // Calculate the average of all pixels in our blur radius box for the
+            // first pixel of the column
+            for ( int kernel_y = -blurRadius; kernel_y <= blurRadius; kernel_y++ )
+            {
+                // To deal with the pixels at the start of a column so it's not
+                // grabbing GOK values from memory at negative indices of the
+                // image's data or grabbing from the previous column
+                if ( kernel_y < 0 )
+                    pixel_idx = x;
+                else
+                    pixel_idx = x + kernel_y * m_width;
+
+                src = src_data + pixel_idx*3;
+                sum_r += src[0];
+                sum_g += src[1];
+                sum_b += src[2];
+                if ( src_alpha )
+                    sum_a += src_alpha[pixel_idx];
+            }
 
-            // Save off the averaged data
-            dst = dst_data + x*3 + y*M_IMGDATA->m_width*3;
+            dst = dst_data + x*3;
             dst[0] = (unsigned char)(sum_r / blurArea);
             dst[1] = (unsigned char)(sum_g / blurArea);
             dst[2] = (unsigned char)(sum_b / blurArea);
             if ( src_alpha )
-                dst_alpha[x + y * M_IMGDATA->m_width] = (unsigned char)(sum_a / blurArea);
+                dst_alpha[x] = (unsigned char)(sum_a / blurArea);
+
+            // Now average the values of the rest of the pixels by just moving the
+            // box along the column from top to bottom
+            for ( int y = 1; y < m_height; y++ )
+            {
+                // Take care of pixels that would be beyond the top edge by
+                // duplicating the top edge pixel for the column
+                if ( y - blurRadius - 1 < 0 )
+                    pixel_idx = x;
+                else
+                    pixel_idx = x + (y - blurRadius - 1) * m_width;
+
+                // Subtract the value of the pixel at the top of our blur radius box
+                src = src_data + pixel_idx*3;
+                sum_r -= src[0];
+                sum_g -= src[1];
+                sum_b -= src[2];
+                if ( src_alpha )
+                    sum_a -= src_alpha[pixel_idx];
+
+                // Take care of the pixels that would be beyond the bottom edge of
+                // the image similar to the top edge
+                if ( y + blurRadius > m_height - 1 )
+                    pixel_idx = x + (m_height - 1) * m_width;
+                else
+                    pixel_idx = x + (blurRadius + y) * m_width;
+
+                // Add the value of the pixel being added to the end of our box
+                src = src_data + pixel_idx*3;
+                sum_r += src[0];
+                sum_g += src[1];
+                sum_b += src[2];
+                if ( src_alpha )
+                    sum_a += src_alpha[pixel_idx];
+
+                // Save off the averaged data
+                dst = dst_data + (x + y * m_width) * 3;
+                dst[0] = (unsigned char)(sum_r / blurArea);
+                dst[1] = (unsigned char)(sum_g / blurArea);
+                dst[2] = (unsigned char)(sum_b / blurArea);
+                if ( src_alpha )
+                    dst_alpha[x + y * m_width] = (unsigned char)(sum_a / blurArea);
+            }
         }
     }
 
-    return ret_image;
-}
+private:
+    const unsigned char * const m_srcData;
+    const unsigned char * const m_srcAlpha;
+    unsigned char * const m_dstData;
+    unsigned char * const m_dstAlpha;
+    const int m_width,
+              m_height,
+              m_blurRadius;
+};
 
-// Blur in the vertical direction
-wxImage wxImage::BlurVertical(int blurRadius) const
+} // anonymous namespace
+
+// Blur in the horizontal direction
+wxImage wxImage::BlurHorizontal(int blurRadius) const
 {
     wxImage ret_image(MakeEmptyClone());
 
     wxCHECK( ret_image.IsOk(), ret_image );
 
-    const unsigned char* src_data = M_IMGDATA->m_data;
-    unsigned char* dst_data = ret_image.GetData();
-    const unsigned char* src_alpha = M_IMGDATA->m_alpha;
-    unsigned char* dst_alpha = ret_image.GetAlpha();
-
-    // number of pixels we average over
-    const int blurArea = blurRadius*2 + 1;
-
-    // Vertical blurring algorithm - same as horizontal but switched the
-    // opposite direction
-    for ( int x = 0; x < M_IMGDATA->m_width; x++ )
-    {
-        // Variables used in the blurring algorithm
-        long sum_r = 0,
-             sum_g = 0,
-             sum_b = 0,
-             sum_a = 0;
-
-        long pixel_idx;
-        const unsigned char *src;
-        unsigned char *dst;
-
-        // Calculate the average of all pixels in our blur radius box for the
-        // first pixel of the column
-        for ( int kernel_y = -blurRadius; kernel_y <= blurRadius; kernel_y++ )
-        {
-            // To deal with the pixels at the start of a column so it's not
-            // grabbing GOK values from memory at negative indices of the
-            // image's data or grabbing from the previous column
-            if ( kernel_y < 0 )
-                pixel_idx = x;
-            else
-                pixel_idx = x + kernel_y * M_IMGDATA->m_width;
+    HorzBlurProcessor(*this, ret_image, blurRadius)
+        .Process(M_IMGDATA->m_height, M_IMGDATA->m_width);
 
-            src = src_data + pixel_idx*3;
-            sum_r += src[0];
-            sum_g += src[1];
-            sum_b += src[2];
-            if ( src_alpha )
-                sum_a += src_alpha[pixel_idx];
-        }
-
-        dst = dst_data + x*3;
-        dst[0] = (unsigned char)(sum_r / blurArea);
-        dst[1] = (unsigned char)(sum_g / blurArea);
-        dst[2] = (unsigned char)(sum_b / blurArea);
-        if ( src_alpha )
-            dst_alpha[x] = (unsigned char)(sum_a / blurArea);
-
-        // Now average the values of the rest of the pixels by just moving the
-        // box along the column from top to bottom
-        for ( int y = 1; y < M_IMGDATA->m_height; y++ )
-        {
-            // Take care of pixels that would be beyond the top edge by
-            // duplicating the top edge pixel for the column
-            if ( y - blurRadius - 1 < 0 )
-                pixel_idx = x;
-            else
-                pixel_idx = x + (y - blurRadius - 1) * M_IMGDATA->m_width;
-
-            // Subtract the value of the pixel at the top of our blur radius box
-            src = src_data + pixel_idx*3;
-            sum_r -= src[0];
-            sum_g -= src[1];
-            sum_b -= src[2];
-            if ( src_alpha )
-                sum_a -= src_alpha[pixel_idx];
+    return ret_image;
+}
 
-            // Take care of the pixels that would be beyond the bottom edge of
-            // the image similar to the top edge
-            if ( y + blurRadius > M_IMGDATA->m_height - 1 )
-                pixel_idx = x + (M_IMGDATA->m_height - 1) * M_IMGDATA->m_width;
-            else
-                pixel_idx = x + (blurRadius + y) * M_IMGDATA->m_width;
+// Blur in the vertical direction
+wxImage wxImage::BlurVertical(int blurRadius) const
+{
+    wxImage ret_image(MakeEmptyClone());
 
-            // Add the value of the pixel being added to the end of our box
-            src = src_data + pixel_idx*3;
-            sum_r += src[0];
-            sum_g += src[1];
-            sum_b += src[2];
-            if ( src_alpha )
-                sum_a += src_alpha[pixel_idx];
+    wxCHECK( ret_image.IsOk(), ret_image );
 
-            // Save off the averaged data
-            dst = dst_data + (x + y * M_IMGDATA->m_width) * 3;
-            dst[0] = (unsigned char)(sum_r / blurArea);
-            dst[1] = (unsigned char)(sum_g / blurArea);
-            dst[2] = (unsigned char)(sum_b / blurArea);
-            if ( src_alpha )
-                dst_alpha[x + y * M_IMGDATA->m_width] = (unsigned char)(sum_a / blurArea);
-        }
-    }
+    VertBlurProcessor(*this, ret_image, blurRadius)
+        .Process(M_IMGDATA->m_width, M_IMGDATA->m_height);
 
     return ret_image;
 }
@@ -1071,97 +1665,138 @@ wxImage wxImage::Blur(int blurRadius) const
     return ret_image;
 }
 
-wxImage wxImage::Rotate90( bool clockwise ) const
+namespace
 {
-    wxImage image(MakeEmptyClone(Clone_SwapOrientation));
-
-    wxCHECK( image.IsOk(), image );
-
-    long height = M_IMGDATA->m_height;
-    long width  = M_IMGDATA->m_width;
 
-    if ( HasOption(wxIMAGE_OPTION_CUR_HOTSPOT_X) )
+// rotate the bands of the source image rows by 90 degrees
+class Rotate90Processor : public wxImageBandProcessor
+{
+public:
+    Rotate90Processor(const wxImage& src, wxImage& dst, bool clockwise)
+        : m_srcData(src.GetData()),
+          m_srcAlpha(src.GetAlpha()),
+          m_dstData(dst.GetData()),
+          m_dstAlpha(dst.GetAlpha()),
+          m_width(src.GetWidth()),
+          m_height(src.GetHeight()),
+          m_clockwise(clockwise)
     {
-        int hot_x = GetOptionInt( wxIMAGE_OPTION_CUR_HOTSPOT_X );
-        image.SetOption(wxIMAGE_OPTION_CUR_HOTSPOT_Y,
-                        clockwise ? hot_x : width - 1 - hot_x);
     }
 
-    if ( HasOption(wxIMAGE_OPTION_CUR_HOTSPOT_Y) )
+protected:
+    virtual void ProcessBand(int from, int to)
     {
-        int hot_y = GetOptionInt( wxIMAGE_OPTION_CUR_HOTSPOT_Y );
-        image.SetOption(wxIMAGE_OPTION_CUR_HOTSPOT_X,
-                        clockwise ? height - 1 - hot_y : hot_y);
-    }
-
-    unsigned char *data = image.GetData();
-    unsigned char *target_data;
+        const long height = m_height;
+        const long width  = m_width;
+        const bool clockwise = m_clockwise;
 
-    // we rotate the image in 21-pixel (63-byte) wide strips
-    // to make better use of cpu cache - memory transfers
-    // (note: while much better than single-pixel "strips",
-    //  our vertical strips will still generally straddle 64-byte cachelines)
-    for (long ii = 0; ii < width; )
-    {
-        long next_ii = wxMin(ii + 21, width);
+        unsigned char *data = m_dstData;
+        unsigned char *target_data;
 
-        for (long j = 0; j < height; j++)
+        // we rotate the image in 21-pixel (63-byte) wide strips
+        // to make better use of cpu cache - memory transfers
+        // (note: while much better than single-pixel "strips",
+        //  our vertical strips will still generally straddle 64-byte cachelines)
+        for (long ii = 0; ii < width; )
         {
-            const unsigned char *source_data
-                                     = M_IMGDATA->m_data + (j*width + ii)*3;
+            long next_ii = wxMin(ii + 21, width);
 
-            for (long i = ii; i < next_ii; i++)
+            for (long j = from; j < to; j++)
             {
-                if ( clockwise )
-                {
-                    target_data = data + ((i + 1)*height - j - 1)*3;
-                }
-                else
+                const unsigned char *source_data
+                                         = m_srcData + (j*width + ii)*3;
+
+                for (long i = ii; i < next_ii; i++)
                 {
-                    target_data = data + (height*(width - 1 - i) + j)*3;
+                    if ( clockwise )
+                    {
+                        target_data = data + ((i + 1)*height - j - 1)*3;
+                    }
+                    else
+                    {
+                        target_data = data + (height*(width - 1 - i) + j)*3;
+                    }
+                    memcpy( target_data, source_data, 3 );
+                    source_data += 3;
                 }
-                memcpy( target_data, source_data, 3 );
-                source_data += 3;
             }
-        }
 
-        ii = next_ii;
-    }
-
-    const unsigned char *source_alpha = M_IMGDATA->m_alpha;
+            ii = next_ii;
+        }
 
-    if ( source_alpha )
-    {
-        unsigned char *alpha_data = image.GetAlpha();
-        unsigned char *target_alpha = 0 ;
+        const unsigned char *source_alpha = m_srcAlpha;
 
-        for (long ii = 0; ii < width; )
+        if ( source_alpha )
         {
-            long next_ii = wxMin(ii + 64, width);
+            unsigned char *alpha_data = m_dstAlpha;
+            unsigned char *target_alpha = 0 ;
 
-            for (long j = 0; j < height; j++)
+            for (long ii = 0; ii < width; )
             {
-                source_alpha = M_IMGDATA->m_alpha + j*width + ii;
+                long next_ii = wxMin(ii + 64, width);
 
-                for (long i = ii; i < next_ii; i++)
+                for (long j = from; j < to; j++)
                 {
-                    if ( clockwise )
-                    {
-                        target_alpha = alpha_data + (i+1)*height - j - 1;
-                    }
-                    else
+                    source_alpha = m_srcAlpha + j*width + ii;
+
+                    for (long i = ii; i < next_ii; i++)
                     {
-                        target_alpha = alpha_data + height*(width - i - 1) + j;
-                    }
+                        if ( clockwise )
+                        {
+                            target_alpha = alpha_data + (i+1)*height - j - 1;
+                        }
+                        else
+                        {
+                            target_alpha = alpha_data + height*(width - i - 1) + j;
+                        }
 
-                    *target_alpha = *source_alpha++;
+                        *target_alpha = *source_alpha++;
+                    }
                 }
-            }
 
-            ii = next_ii;
+                ii = next_ii;
+            }
         }
     }
 
+private:
+    const unsigned char * const m_srcData;
+    const unsigned char * const m_srcAlpha;
+    unsigned char * const m_dstData;
+    unsigned char * const m_dstAlpha;
+    const int m_width,
+              m_height;
+    const bool m_clockwise;
+};
+
+} // anonymous namespace
+
+wxImage wxImage::Rotate90( bool clockwise ) const
+{
+    wxImage image(MakeEmptyClone(Clone_SwapOrientation));
+
+    wxCHECK( image.IsOk(), image );
+
+    long height = M_IMGDATA->m_height;
+    long width  = M_IMGDATA->m_width;
+
+    if ( HasOption(wxIMAGE_OPTION_CUR_HOTSPOT_X) )
+    {
+        int hot_x = GetOptionInt( wxIMAGE_OPTION_CUR_HOTSPOT_X );
+        image.SetOption(wxIMAGE_OPTION_CUR_HOTSPOT_Y,
+                        clockwise ? hot_x : width - 1 - hot_x);
+    }
+
+    if ( HasOption(wxIMAGE_OPTION_CUR_HOTSPOT_Y) )
+    {
+        int hot_y = GetOptionInt( wxIMAGE_OPTION_CUR_HOTSPOT_Y );
+        image.SetOption(wxIMAGE_OPTION_CUR_HOTSPOT_X,
+                        clockwise ? height - 1 - hot_y : hot_y);
+    }
+
+    // each band of the source rows is written to a band of the target columns
+    Rotate90Processor(*this, image, clockwise).Process(height, width);
+
     return image;
 }
 
@@ -1398,7 +2033,8 @@ wxImage wxImage::Size( const wxSize& size, const wxPoint& pos,
     return image;
 }
 
-void wxImage::Paste( const wxImage &image, int x, int y )
+void wxImage::Paste( const wxImage &image, int x, int y,
+                     wxImageAlphaBlendMode alphaBlend )
 {
     wxCHECK_RET( IsOk(), wxT("invalid image") );
     wxCHECK_RET( image.IsOk(), wxT("invalid image") );
@@ -1429,11 +2065,39 @@ void wxImage::Paste( const wxImage &image, int x, int y )
     if (width < 1) return;
     if (height < 1) return;
 
+    // Compose the pasted image over this one if requested, its alpha channel
+    // is used instead of the mask in this case.
+    const bool compose = alphaBlend == wxIMAGE_ALPHA_BLEND_COMPOSE &&
+                            image.HasAlpha();
+    if ( compose )
+    {
+        if ( !HasAlpha() )
+            InitAlpha();
+
+        const unsigned char* source_data = image.GetData() + 3*(xx + yy*image.GetWidth());
+        const unsigned char* source_alpha = image.GetAlpha() + xx + yy*image.GetWidth();
+        int source_step = image.GetWidth();
+
+        unsigned char* target_data = GetData() + 3*((x+xx) + (y+yy)*M_IMGDATA->m_width);
+        unsigned char* target_alpha = GetAlpha() + (x+xx) + (y+yy)*M_IMGDATA->m_width;
+        int target_step = M_IMGDATA->m_width;
+
+        for (int j = 0; j < height; j++)
+        {
+            wxPixelOps::BlendOver(target_data, target_alpha,
+                                  source_data, source_alpha, width);
+            source_data += 3*source_step;
+            source_alpha += source_step;
+            target_data += 3*target_step;
+            target_alpha += target_step;
+        }
+    }
+
     // If we can, copy the data using memcpy() as this is the fastest way. But
     // for this  the image being pasted must have "compatible" mask with this
     // one meaning that either it must not have one at all or it must use the
     // same masked colour.
-    if ( !image.HasMask() ||
+    else if ( !image.HasMask() ||
         ((HasMask() &&
          (GetMaskRed()==image.GetMaskRed()) &&
          (GetMaskGreen()==image.GetMaskGreen()) &&
@@ -1453,7 +2117,7 @@ void wxImage::Paste( const wxImage &image, int x, int y )
     }
 
     // Copy over the alpha channel from the original image
-    if ( image.HasAlpha() )
+    if ( image.HasAlpha() && !compose )
     {
         if ( !HasAlpha() )
             InitAlpha();
@@ -1472,7 +2136,7 @@ void wxImage::Paste( const wxImage &image, int x, int y )
         }
     }
 
-    if (!HasMask() && image.HasMask())
+    if (!HasMask() && image.HasMask() && !compose)
     {
         unsigned char r = image.GetMaskRed();
         unsigned char g = image.GetMaskGreen();
@@ -1516,20 +2180,81 @@ void wxImage::Replace( unsigned char r1, unsigned char g1, unsigned char b1,
     for (int j = 0; j < h; j++)
         for (int i = 0; i < w; i++)
         {
-            if ((data[0] == r1) && (data[1] == g1) && (data[2] == b1))
+            if ((data[0] == r1) && (data[1] == g1) && (data[2] == b1))
+            {
+                data[0] = r2;
+                data[1] = g2;
+                data[2] = b2;
+            }
+            data += 3;
+        }
+}
+
+wxImage wxImage::ConvertToGreyscale(void) const
+{
+    return ConvertToGreyscale(0.299, 0.587, 0.114);
+}
+
+namespace
+{
+
+// convert the bands of the image rows to greyscale
+class GreyscaleProcessor : public wxImageBandProcessor
+{
+public:
+    GreyscaleProcessor(const wxImage& src, wxImage& dst,
+                       double weight_r, double weight_g, double weight_b)
+        : m_src(src),
+          m_dstData(dst.GetData()),
+          m_dstAlpha(dst.GetAlpha()),
+          m_weightR(weight_r),
+          m_weightG(weight_g),
+          m_weightB(weight_b)
+    {
+    }
+
+protected:
+    virtual void ProcessBand(int from, int to)
+    {
+        const int width = m_src.GetWidth();
+        const long offset = (long)from*width,
+                   size = (long)(to - from)*width;
+
+        const unsigned char *src = m_src.GetData() + offset*3;
+        unsigned char *dest = m_dstData + offset*3;
+
+        const bool hasMask = m_src.HasMask();
+        const unsigned char maskRed = m_src.GetMaskRed();
+        const unsigned char maskGreen = m_src.GetMaskGreen();
+        const unsigned char maskBlue = m_src.GetMaskBlue();
+
+        for ( long i = 0; i < size; i++, src += 3, dest += 3 )
+        {
+            memcpy(dest, src, 3);
+            // only modify non-masked pixels
+            if ( !hasMask || src[0] != maskRed || src[1] != maskGreen || src[2] != maskBlue )
             {
-                data[0] = r2;
-                data[1] = g2;
-                data[2] = b2;
+                wxColour::MakeGrey(dest + 0, dest + 1, dest + 2, m_weightR, m_weightG, m_weightB);
             }
-            data += 3;
         }
-}
 
-wxImage wxImage::ConvertToGreyscale(void) const
-{
-    return ConvertToGreyscale(0.299, 0.587, 0.114);
-}
+        // copy the alpha channel, if any
+        if ( m_dstAlpha )
+        {
+            memcpy( m_dstAlpha + offset, m_src.GetAlpha() + offset, size );
+        }
+    }
+
+private:
+    const wxImage& m_src;
+    unsigned char * const m_dstData;
+    unsigned char * const m_dstAlpha;
+    const double m_weightR,
+                 m_weightG,
+                 m_weightB;
+};
+
+} // anonymous namespace
 
 wxImage wxImage::ConvertToGreyscale(double weight_r, double weight_g, double weight_b) const
 {
@@ -1537,30 +2262,8 @@ wxImage wxImage::ConvertToGreyscale(double weight_r, double weight_g, double wei
 
     wxCHECK( image.IsOk(), image );
 
-    const unsigned char *src = M_IMGDATA->m_data;
-    unsigned char *dest = image.GetData();
-
-    const bool hasMask = M_IMGDATA->m_hasMask;
-    const unsigned char maskRed = M_IMGDATA->m_maskRed;
-    const unsigned char maskGreen = M_IMGDATA->m_maskGreen;
-    const unsigned char maskBlue = M_IMGDATA->m_maskBlue;
-
-    const long size = M_IMGDATA->m_width * M_IMGDATA->m_height;
-    for ( long i = 0; i < size; i++, src += 3, dest += 3 )
-    {
-        memcpy(dest, src, 3);
-        // only modify non-masked pixels
-        if ( !hasMask || src[0] != maskRed || src[1] != maskGreen || src[2] != maskBlue )
-        {
-            wxColour::MakeGrey(dest + 0, dest + 1, dest + 2, weight_r, weight_g, weight_b);
-        }
-    }
-
-    // copy the alpha channel, if any
-    if ( image.HasAlpha() )
-    {
-        memcpy( image.GetAlpha(), GetAlpha(), GetWidth() * GetHeight() );
-    }
+    GreyscaleProcessor(*this, image, weight_r, weight_g, weight_b)
+        .Process(M_IMGDATA->m_height, M_IMGDATA->m_width);
 
     return image;
 }
@@ -1909,19 +2612,10 @@ void wxImage::InitAlpha()
     if ( HasMask() )
     {
         // use the mask to initialize the alpha channel.
-        const unsigned char * const alphaEnd = alpha + lenAlpha;
-
-        const unsigned char mr = M_IMGDATA->m_maskRed;
-        const unsigned char mg = M_IMGDATA->m_maskGreen;
-        const unsigned char mb = M_IMGDATA->m_maskBlue;
-        for ( unsigned char *src = M_IMGDATA->m_data;
-              alpha < alphaEnd;
-              src += 3, alpha++ )
-        {
-            *alpha = (src[0] == mr && src[1] == mg && src[2] == mb)
-                            ? wxIMAGE_ALPHA_TRANSPARENT
-                            : wxIMAGE_ALPHA_OPAQUE;
-        }
+        wxPixelOps::MaskToAlpha(alpha, M_IMGDATA->m_data, lenAlpha,
+                                M_IMGDATA->m_maskRed,
+                                M_IMGDATA->m_maskGreen,
+                                M_IMGDATA->m_maskBlue);
 
         M_IMGDATA->m_hasMask = false;
     }
@@ -2120,24 +2814,8 @@ bool wxImage::ConvertAlphaToMask(unsigned char mr,
     SetMask(true);
     SetMaskColour(mr, mg, mb);
 
-    unsigned char *imgdata = GetData();
-    unsigned char *alphadata = GetAlpha();
-
-    int w = GetWidth();
-    int h = GetHeight();
-
-    for (int y = 0; y < h; y++)
-    {
-        for (int x = 0; x < w; x++, imgdata += 3, alphadata++)
-        {
-            if (*alphadata < threshold)
-            {
-                imgdata[0] = mr;
-                imgdata[1] = mg;
-                imgdata[2] = mb;
-            }
-        }
-    }
+    wxPixelOps::AlphaToMask(GetData(), GetAlpha(), GetWidth()*GetHeight(),
+                            threshold, mr, mg, mb);
 
     if ( !M_IMGDATA->m_staticAlpha )
         free(M_IMGDATA->m_alpha);
@@ -2231,6 +2909,87 @@ bool wxImage::HasOption(const wxString& name) const
                      : false;
 }
 
+// ----------------------------------------------------------------------------
+// wxImageCache support
+// ----------------------------------------------------------------------------
+
+// return a copy of the image not sharing any data with it, so that the copy
+// can be used in another thread: notice that the palette is still shared, but
+// it's a GDI object which can only be used from the main thread anyhow
+//
+// this is used by wxImageCache in imagecache.cpp and needs to be defined here
+// as it accesses wxImageRefData directly
+wxImage wxCopyImageForCache(const wxImage& image)
+{
+    wxImage copy = image.Copy();
+    copy.SetType(image.GetType());
+
+    wxImageRefData * const
+        refData = static_cast<wxImageRefData*>(copy.GetRefData());
+    for ( size_t n = 0; n < refData->m_optionNames.size(); n++ )
+    {
+        refData->m_optionNames[n] = refData->m_optionNames[n].Clone();
+        refData->m_optionValues[n] = refData->m_optionValues[n].Clone();
+    }
+
+    return copy;
+}
+
+#if HAS_FILE_STREAMS
+
+namespace
+{
+
+// return the key identifying the image loaded from the given file with the
+// options of the given image in the cache or an empty string if the file
+// doesn't exist: the key includes the file size and modification time to
+// avoid returning stale images if the file changes
+wxString MakeFileCacheKey(const wxString& filename,
+                          const wxString& type,
+                          int index,
+                          const wxImage& image)
+{
+    wxString key;
+
+#if wxUSE_DATETIME
+    wxFileName fn(filename);
+    fn.MakeAbsolute();
+
+    const wxDateTime mtime = fn.GetModificationTime();
+    const wxULongLong size = fn.GetSize();
+    if ( !mtime.IsValid() || size == wxInvalidSize )
+        return key;
+
+    key << fn.GetFullPath() << wxS('\t')
+        << mtime.GetValue().ToString() << wxS('\t')
+        << size.ToString() << wxS('\t')
+        << type << wxS('\t')
+        << index;
+
+    const wxImageRefData * const
+        refData = static_cast<const wxImageRefData*>(image.GetRefData());
+    if ( refData )
+    {
+        for ( size_t n = 0; n < refData->m_optionNames.size(); n++ )
+        {
+            key << wxS('\t') << refData->m_optionNames[n]
+                << wxS('=') << refData->m_optionValues[n];
+        }
+    }
+#else // !wxUSE_DATETIME
+    wxUnusedVar(filename);
+    wxUnusedVar(type);
+    wxUnusedVar(index);
+    wxUnusedVar(image);
+#endif // wxUSE_DATETIME/!wxUSE_DATETIME
+
+    return key;
+}
+
+} // anonymous namespace
+
+#endif // HAS_FILE_STREAMS
+
 // ----------------------------------------------------------------------------
 // image I/O
 // ----------------------------------------------------------------------------
@@ -2240,12 +2999,27 @@ bool wxImage::LoadFile( const wxString& WXUNUSED_UNLESS_STREAMS(filename),
                         int WXUNUSED_UNLESS_STREAMS(index) )
 {
 #if HAS_FILE_STREAMS
+    wxImageCache& cache = wxImageCache::Get();
+    wxString key;
+    if ( cache.IsEnabled() )
+    {
+        key = MakeFileCacheKey(filename, wxString::Format("%d", type),
+                               index, *this);
+        if ( !key.empty() && cache.Lookup(key, this) )
+            return true;
+    }
+
     wxImageFileInputStream stream(filename);
     if ( stream.IsOk() )
     {
         wxBufferedInputStream bstream( stream );
         if ( LoadFile(bstream, type, index) )
+        {
+            if ( !key.empty() )
+                cache.Store(key, *this);
+
             return true;
+        }
     }
 
     wxLogError(_("Failed to load image from file \"%s\"."), filename);
@@ -2259,12 +3033,26 @@ bool wxImage::LoadFile( const wxString& WXUNUSED_UNLESS_STREAMS(filename),
                         int WXUNUSED_UNLESS_STREAMS(index) )
 {
 #if HAS_FILE_STREAMS
+    wxImageCache& cache = wxImageCache::Get();
+    wxString key;
+    if ( cache.IsEnabled() )
+    {
+        key = MakeFileCacheKey(filename, mimetype, index, *this);
+        if ( !key.empty() && cache.Lookup(key, this) )
+            return true;
+    }
+
     wxImageFileInputStream stream(filename);
     if ( stream.IsOk() )
     {
         wxBufferedInputStream bstream( stream );
         if ( LoadFile(bstream, mimetype, index) )
+        {
+            if ( !key.empty() )
+                cache.Store(key, *this);
+
             return true;
+        }
     }
 
     wxLogError(_("Failed to load image from file \"%s\"."), filename);
@@ -2274,6 +3062,177 @@ bool wxImage::LoadFile( const wxString& WXUNUSED_UNLESS_STREAMS(filename),
 }
 
 
+// ----------------------------------------------------------------------------
+// loading several files at once
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+// copy the options of one image to another one: unlike CopyImageOptions()
+// below, this makes deep copies of the strings, as wxString itself is not
+// thread-safe, so that the images can be used in different threads
+void CloneImageOptions(const wxImage& from, wxImage& to)
+{
+    const wxImageRefData * const
+        refData = static_cast<const wxImageRefData*>(from.GetRefData());
+    if ( !refData )
+        return;
+
+    for ( size_t n = 0; n < refData->m_optionNames.size(); n++ )
+    {
+        to.SetOption(refData->m_optionNames[n].Clone(),
+                     refData->m_optionValues[n].Clone());
+    }
+}
+
+#if wxUSE_THREADS
+
+// task loading a single image file in a thread of the pool
+class LoadImageTask : public wxThreadPoolTask
+{
+public:
+    LoadImageTask(const wxString& filename,
+                  wxBitmapType type,
+                  const wxImage *options)
+        : m_filename(filename.Clone()),
+          m_type(type),
+          m_submitted(false),
+          m_done(false)
+    {
+        if ( options )
+            CloneImageOptions(*options, m_image);
+    }
+
+    // submit the task to the pool, if this fails the image will be loaded in
+    // the current thread by TakeImage()
+    void Submit(wxThreadPool& pool)
+    {
+        m_submitted = pool.Submit(this);
+    }
+
+    // return the image after waiting until it is loaded, loading it in the
+    // current thread if it wasn't done by the pool
+    //
+    // the image is detached from the task, so that the task doesn't keep any
+    // reference to it: the last reference to the task may be released by the
+    // pool thread and wxImage reference counting is not thread-safe
+    wxImage TakeImage()
+    {
+        if ( m_submitted )
+            Wait();
+
+        if ( !m_done )
+            Run();
+
+        wxImage image = m_image;
+        m_image = wxNullImage;
+        return image;
+    }
+
+    // don't load the image if it hadn't started loading yet or wait until it
+    // finishes loading otherwise
+    void Abandon()
+    {
+        if ( m_submitted && !Cancel() )
+            Wait();
+    }
+
+protected:
+    virtual void Run()
+    {
+        if ( !m_image.LoadFile(m_filename, m_type) )
+            m_image.Destroy();
+
+        m_done = true;
+    }
+
+private:
+    const wxString m_filename;
+    const wxBitmapType m_type;
+    bool m_submitted,
+         m_done;
+
+    wxImage m_image;
+};
+
+#endif // wxUSE_THREADS
+
+} // anonymous namespace
+
+/* static */
+size_t wxImage::LoadFiles(const wxArrayString& names,
+                          wxImageLoadCallback& callback,
+                          wxBitmapType type,
+                          const wxImage *options)
+{
+    const size_t count = names.size();
+    size_t numLoaded = 0;
+
+#if wxUSE_THREADS
+    wxThreadPool& pool = wxThreadPool::Get();
+    if ( count > 1 && pool.IsOk() )
+    {
+        // load enough images in advance to keep all the threads busy but not
+        // too many of them as they're kept in memory until the callback can be
+        // called for them
+        const size_t maxPending = 2*pool.GetThreadCount();
+
+        // the tasks loading the files [n, next)
+        wxVector<LoadImageTask *> tasks(count);
+        size_t next = 0;
+
+        for ( size_t n = 0; n < count; n++ )
+        {
+            for ( ; next < count && next - n < maxPending; next++ )
+            {
+                tasks[next] = new LoadImageTask(names[next], type, options);
+                tasks[next]->Submit(pool);
+            }
+
+            // take the image from the task before releasing it, so that it
+            // is not shared with the pool thread which may still hold the
+            // last reference to the task
+            wxImage image = tasks[n]->TakeImage();
+            tasks[n]->DecRef();
+
+            if ( image.IsOk() )
+                numLoaded++;
+
+            if ( !callback.OnImageLoaded(n, names[n], image) )
+            {
+                for ( n++; n < next; n++ )
+                {
+                    tasks[n]->Abandon();
+                    tasks[n]->DecRef();
+                }
+
+                break;
+            }
+        }
+
+        return numLoaded;
+    }
+#endif // wxUSE_THREADS
+
+    for ( size_t n = 0; n < count; n++ )
+    {
+        wxImage image;
+        if ( options )
+            CloneImageOptions(*options, image);
+
+        if ( image.LoadFile(names[n], type) )
+            numLoaded++;
+        else
+            image.Destroy();
+
+        if ( !callback.OnImageLoaded(n, names[n], image) )
+            break;
+    }
+
+    return numLoaded;
+}
+
 bool wxImage::SaveFile( const wxString& filename ) const
 {
     wxString ext = filename.AfterLast('.').Lower();
@@ -2355,12 +3314,11 @@ int wxImage::GetImageCount( const wxString& WXUNUSED_UNLESS_STREAMS(name),
 
 bool wxImage::CanRead( wxInputStream &stream )
 {
-    const wxList& list = GetHandlers();
+    const wxImageHandlersArray handlers = GetHandlersArray();
 
-    for ( wxList::compatibility_iterator node = list.GetFirst(); node; node = node->GetNext() )
+    for ( size_t n = 0; n < handlers.size(); n++ )
     {
-        wxImageHandler *handler=(wxImageHandler*)node->GetData();
-        if (handler->CanRead( stream ))
+        if ( handlers[n]->CanRead(stream) )
             return true;
     }
 
@@ -2373,13 +3331,11 @@ int wxImage::GetImageCount( wxInputStream &stream, wxBitmapType type )
 
     if ( type == wxBITMAP_TYPE_ANY )
     {
-        const wxList& list = GetHandlers();
+        const wxImageHandlersArray handlers = GetHandlersArray();
 
-        for ( wxList::compatibility_iterator node = list.GetFirst();
-              node;
-              node = node->GetNext() )
+        for ( size_t n = 0; n < handlers.size(); n++ )
         {
-             handler = (wxImageHandler*)node->GetData();
+             handler = handlers[n];
              if ( handler->CanRead(stream) )
              {
                  const int count = handler->GetImageCount(stream);
@@ -2412,6 +3368,177 @@ int wxImage::GetImageCount( wxInputStream &stream, wxBitmapType type )
     }
 }
 
+namespace
+{
+
+// copy the options of one image to another one
+void CopyImageOptions(const wxImage& from, wxImage& to, bool withOriginalSize)
+{
+    const wxImageRefData * const
+        refData = static_cast<const wxImageRefData*>(from.GetRefData());
+    if ( !refData )
+        return;
+
+    for ( size_t n = 0; n < refData->m_optionNames.size(); n++ )
+    {
+        const wxString& name = refData->m_optionNames[n];
+        if ( !withOriginalSize &&
+                (name.IsSameAs(wxIMAGE_OPTION_ORIGINAL_WIDTH, false) ||
+                    name.IsSameAs(wxIMAGE_OPTION_ORIGINAL_HEIGHT, false)) )
+            continue;
+
+        to.SetOption(name, refData->m_optionValues[n]);
+    }
+}
+
+// compute the size of the image reduced to fit into the given maximal size:
+// this uses the same (trivial) algorithm as the JPEG handler
+wxSize GetReducedSize(unsigned width, unsigned height,
+                      unsigned maxWidth, unsigned maxHeight,
+                      int *shift = NULL)
+{
+    int n = 0;
+    while ( (maxWidth && width > maxWidth) ||
+                (maxHeight && height > maxHeight) )
+    {
+        width /= 2;
+        height /= 2;
+        n++;
+    }
+
+    if ( shift )
+        *shift = n;
+
+    return wxSize(wxMax(width, 1u), wxMax(height, 1u));
+}
+
+// sink reducing the image by a power of 2 factor while it's being loaded by
+// averaging the blocks of its pixels, which allows to load thumbnails of huge
+// images without ever having the entire image in memory
+class ReducingRowSink : public wxImageRowSink
+{
+public:
+    ReducingRowSink(unsigned maxWidth, unsigned maxHeight)
+        : m_maxWidth(maxWidth),
+          m_maxHeight(maxHeight)
+    {
+        m_width =
+        m_height =
+        m_shift = 0;
+    }
+
+    wxImage& GetImage() { return m_image; }
+    wxSize GetOriginalSize() const { return wxSize(m_width, m_height); }
+
+    virtual bool Start(int width, int height, bool hasAlpha)
+    {
+        m_width = width;
+        m_height = height;
+
+        const wxSize size = GetReducedSize(width, height,
+                                           m_maxWidth, m_maxHeight,
+                                           &m_shift);
+
+        if ( !m_image.Create(size, false) )
+            return false;
+
+        if ( hasAlpha )
+            m_image.SetAlpha();
+
+        if ( m_shift )
+        {
+            m_sums.clear();
+            m_sums.resize(size.x*size.y*(hasAlpha ? 4 : 3), 0);
+            m_rowsDone.clear();
+            m_rowsDone.resize(size.y, 0);
+        }
+
+        return true;
+    }
+
+    virtual bool ProcessRow(int y,
+                            const unsigned char *data,
+                            const unsigned char *alpha)
+    {
+        const int width = m_image.GetWidth();
+        unsigned char * const dstAlpha = m_image.GetAlpha();
+
+        if ( !m_shift )
+        {
+            memcpy(m_image.GetData() + y*width*3, data, width*3);
+            if ( dstAlpha && alpha )
+                memcpy(dstAlpha + y*width, alpha, width);
+
+            return true;
+        }
+
+        // the rows and columns not fitting into a whole block are just
+        // ignored, as is done when the size is divided by 2, but notice that
+        // GetReducedSize() never returns 0, so if the image is much smaller
+        // in one direction than in the other, the blocks at its edge may be
+        // only partially covered by it
+        const int dstY = y >> m_shift;
+        if ( dstY >= m_image.GetHeight() )
+            return true;
+
+        const int channels = dstAlpha ? 4 : 3;
+        const int srcWidth = wxMin(width << m_shift, m_width);
+        wxUint32 * const sums = &m_sums[dstY*width*channels];
+        for ( int x = 0; x < srcWidth; x++ )
+        {
+            wxUint32 * const p = sums + (x >> m_shift)*channels;
+            p[0] += data[3*x];
+            p[1] += data[3*x + 1];
+            p[2] += data[3*x + 2];
+            if ( dstAlpha )
+                p[3] += alpha ? alpha[x] : wxIMAGE_ALPHA_OPAQUE;
+        }
+
+        // compute the average when we have all the rows of this block
+        const int blockSize = 1 << m_shift;
+        const int rows = wxMin(blockSize, m_height - (dstY << m_shift));
+        if ( ++m_rowsDone[dstY] == rows )
+        {
+            unsigned char *dst = m_image.GetData() + dstY*width*3;
+            for ( int x = 0; x < width; x++, dst += 3 )
+            {
+                const int cols = wxMin(blockSize, m_width - (x << m_shift));
+                const wxUint32 count = cols*rows,
+                               rounding = count / 2;
+
+                const wxUint32 * const p = sums + x*channels;
+                dst[0] = (p[0] + rounding) / count;
+                dst[1] = (p[1] + rounding) / count;
+                dst[2] = (p[2] + rounding) / count;
+                if ( dstAlpha )
+                    dstAlpha[dstY*width + x] = (p[3] + rounding) / count;
+            }
+        }
+
+        return true;
+    }
+
+private:
+    const unsigned m_maxWidth,
+                   m_maxHeight;
+
+    // the size of the image being loaded
+    int m_width,
+        m_height;
+
+    // the image is reduced by 2 to the power of this number
+    int m_shift;
+
+    wxImage m_image;
+
+    // the sums of the channels values for all the pixels of the reduced image
+    // and the number of rows summed for each of its rows
+    wxVector<wxUint32> m_sums;
+    wxVector<int> m_rowsDone;
+};
+
+} // anonymous namespace
+
 bool wxImage::DoLoad(wxImageHandler& handler, wxInputStream& stream, int index)
 {
     // save the options values which can be clobbered by the handler (e.g. many
@@ -2426,6 +3553,43 @@ bool wxImage::DoLoad(wxImageHandler& handler, wxInputStream& stream, int index)
     if ( stream.IsSeekable() )
         posOld = stream.TellI();
 
+    // if the image needs to be reduced and the handler can do it row by row,
+    // do it while loading it instead of loading the entire image first
+    if ( (maxWidth || maxHeight) && handler.CanLoadRows() )
+    {
+        // pass our options to the handler but not the original size which
+        // could be left from the previously loaded image
+        wxImage options;
+        CopyImageOptions(*this, options, false /* no original size */);
+
+        ReducingRowSink sink(maxWidth, maxHeight);
+        if ( !handler.LoadRows(&options, sink, stream, true/*verbose*/, index) )
+        {
+            if ( posOld != wxInvalidOffset )
+                stream.SeekI(posOld);
+
+            return false;
+        }
+
+        // the new image only has the options set by the handler, as when
+        // LoadFile() is used
+        wxImage& image = sink.GetImage();
+        CopyImageOptions(options, image, true /* with original size */);
+
+        const wxSize sizeOrig = sink.GetOriginalSize();
+        if ( image.GetSize() != sizeOrig &&
+                !image.HasOption(wxIMAGE_OPTION_ORIGINAL_WIDTH) )
+        {
+            image.SetOption(wxIMAGE_OPTION_ORIGINAL_WIDTH, sizeOrig.x);
+            image.SetOption(wxIMAGE_OPTION_ORIGINAL_HEIGHT, sizeOrig.y);
+        }
+
+        *this = image;
+        M_IMGDATA->m_type = handler.GetType();
+
+        return true;
+    }
+
     if ( !handler.LoadFile(this, stream, true/*verbose*/, index) )
     {
         if ( posOld != wxInvalidOffset )
@@ -2440,15 +3604,10 @@ bool wxImage::DoLoad(wxImageHandler& handler, wxInputStream& stream, int index)
         const unsigned widthOrig = GetWidth(),
                        heightOrig = GetHeight();
 
-        // this uses the same (trivial) algorithm as the JPEG handler
-        unsigned width = widthOrig,
-                 height = heightOrig;
-        while ( (maxWidth && width > maxWidth) ||
-                    (maxHeight && height > maxHeight) )
-        {
-            width /= 2;
-            height /= 2;
-        }
+        const wxSize size = GetReducedSize(widthOrig, heightOrig,
+                                           maxWidth, maxHeight);
+        const unsigned width = size.x,
+                       height = size.y;
 
         if ( width != widthOrig || height != heightOrig )
         {
@@ -2489,12 +3648,10 @@ bool wxImage::LoadFile( wxInputStream& stream, wxBitmapType type, int index )
             return false;
         }
 
-        const wxList& list = GetHandlers();
-        for ( wxList::compatibility_iterator node = list.GetFirst();
-              node;
-              node = node->GetNext() )
+        const wxImageHandlersArray handlers = GetHandlersArray();
+        for ( size_t n = 0; n < handlers.size(); n++ )
         {
-             handler = (wxImageHandler*)node->GetData();
+             handler = handlers[n];
              if ( handler->CanRead(stream) && DoLoad(*handler, stream, index) )
                  return true;
         }
@@ -2589,6 +3746,8 @@ bool wxImage::SaveFile( wxOutputStream& stream, const wxString& mimetype ) const
 
 void wxImage::AddHandler( wxImageHandler *handler )
 {
+    wxCRIT_SECT_LOCKER(lock, gs_csHandlers);
+
     // Check for an existing handler of the type being added.
     if (FindHandler( handler->GetType() ) == 0)
     {
@@ -2610,6 +3769,8 @@ void wxImage::AddHandler( wxImageHandler *handler )
 
 void wxImage::InsertHandler( wxImageHandler *handler )
 {
+    wxCRIT_SECT_LOCKER(lock, gs_csHandlers);
+
     // Check for an existing handler of the type being added.
     if (FindHandler( handler->GetType() ) == 0)
     {
@@ -2626,6 +3787,8 @@ void wxImage::InsertHandler( wxImageHandler *handler )
 
 bool wxImage::RemoveHandler( const wxString& name )
 {
+    wxCRIT_SECT_LOCKER(lock, gs_csHandlers);
+
     wxImageHandler *handler = FindHandler(name);
     if (handler)
     {
@@ -2637,8 +3800,13 @@ bool wxImage::RemoveHandler( const wxString& name )
         return false;
 }
 
+// notice that wxCriticalSection is recursive, so the functions below can be
+// called with the lock already held by the functions above
+
 wxImageHandler *wxImage::FindHandler( const wxString& name )
 {
+    wxCRIT_SECT_LOCKER(lock, gs_csHandlers);
+
     wxList::compatibility_iterator node = sm_handlers.GetFirst();
     while (node)
     {
@@ -2652,6 +3820,8 @@ wxImageHandler *wxImage::FindHandler( const wxString& name )
 
 wxImageHandler *wxImage::FindHandler( const wxString& extension, wxBitmapType bitmapType )
 {
+    wxCRIT_SECT_LOCKER(lock, gs_csHandlers);
+
     wxList::compatibility_iterator node = sm_handlers.GetFirst();
     while (node)
     {
@@ -2670,6 +3840,8 @@ wxImageHandler *wxImage::FindHandler( const wxString& extension, wxBitmapType bi
 
 wxImageHandler *wxImage::FindHandler(wxBitmapType bitmapType )
 {
+    wxCRIT_SECT_LOCKER(lock, gs_csHandlers);
+
     wxList::compatibility_iterator node = sm_handlers.GetFirst();
     while (node)
     {
@@ -2682,6 +3854,8 @@ wxImageHandler *wxImage::FindHandler(wxBitmapType bitmapType )
 
 wxImageHandler *wxImage::FindHandlerMime( const wxString& mimetype )
 {
+    wxCRIT_SECT_LOCKER(lock, gs_csHandlers);
+
     wxList::compatibility_iterator node = sm_handlers.GetFirst();
     while (node)
     {
@@ -2701,6 +3875,8 @@ void wxImage::InitStandardHandlers()
 
 void wxImage::CleanUpHandlers()
 {
+    wxCRIT_SECT_LOCKER(lock, gs_csHandlers);
+
     wxList::compatibility_iterator node = sm_handlers.GetFirst();
     while (node)
     {
@@ -2717,16 +3893,14 @@ wxString wxImage::GetImageExtWildcard()
 {
     wxString fmts;
 
-    wxList& Handlers = wxImage::GetHandlers();
-    wxList::compatibility_iterator Node = Handlers.GetFirst();
-    while ( Node )
+    const wxImageHandlersArray handlers = GetHandlersArray();
+    for ( size_t n = 0; n < handlers.size(); n++ )
     {
-        wxImageHandler* Handler = (wxImageHandler*)Node->GetData();
+        wxImageHandler* Handler = handlers[n];
         fmts += wxT("*.") + Handler->GetExtension();
         for (size_t i = 0; i < Handler->GetAltExtensions().size(); i++)
             fmts += wxT(";*.") + Handler->GetAltExtensions()[i];
-        Node = Node->GetNext();
-        if ( Node ) fmts += wxT(";");
+        if ( n + 1 < handlers.size() ) fmts += wxT(";");
     }
 
     return wxT("(") + fmts + wxT(")|") + fmts;
@@ -2905,6 +4079,18 @@ void wxImage::RotateHue(double angle)
     }
 }
 
+/* static */
+void wxImage::SetMaxThreads(unsigned numThreads)
+{
+    sm_maxThreads = numThreads;
+}
+
+/* static */
+unsigned wxImage::GetMaxThreads()
+{
+    return sm_maxThreads;
+}
+
 //-----------------------------------------------------------------------------
 // wxImageHandler
 //-----------------------------------------------------------------------------
@@ -2971,6 +4157,40 @@ bool wxImageHandler::CallDoCanRead(wxInputStream& stream)
     return ok;
 }
 
+bool wxImageHandler::LoadRows(wxImage *image, wxImageRowSink& sink,
+                              wxInputStream& stream,
+                              bool verbose, int index)
+{
+    wxCHECK_MSG( image, false, "NULL image pointer" );
+
+    // share the options with the image we load into, they're not affected by
+    // Destroy() called by LoadFile() as it only releases our reference
+    wxImage loaded(*image);
+    if ( !LoadFile(&loaded, stream, verbose, index) )
+        return false;
+
+    // copy the options set by the handler back to the image
+    CopyImageOptions(loaded, *image, true /* with original size */);
+
+    const int width = loaded.GetWidth(),
+              height = loaded.GetHeight();
+    const unsigned char * const data = loaded.GetData();
+    const unsigned char * const alpha = loaded.GetAlpha();
+
+    if ( !sink.Start(width, height, alpha != NULL) )
+        return false;
+
+    for ( int y = 0; y < height; y++ )
+    {
+        if ( !sink.ProcessRow(y,
+                              data + y*width*3,
+                              alpha ? alpha + y*width : NULL) )
+            return false;
+    }
+
+    return true;
+}
+
 #endif // wxUSE_STREAMS
 
 /* static */
@@ -0,0 +1,371 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        src/common/imagecache.cpp
+// Purpose:     wxImageCache implementation
+// Author:      agent
+// Created:     2026-10-17
+// RCS-ID:      $Id$
+// Copyright:   (c) 2026 agent <agent@local>
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+// ============================================================================
+// declarations
+// ============================================================================
+
+// ----------------------------------------------------------------------------
+// headers
+// ----------------------------------------------------------------------------
+
+// for compilers that support precompilation, includes "wx.h".
+#include "wx/wxprec.h"
+
+#ifdef __BORLANDC__
+    #pragma hdrstop
+#endif
+
+#if wxUSE_IMAGE
+
+#include "wx/imagecache.h"
+
+#ifndef WX_PRECOMP
+    #include "wx/image.h"
+    #include "wx/module.h"
+    #include "wx/string.h"
+#endif // WX_PRECOMP
+
+#include "wx/hashmap.h"
+#include "wx/thread.h"
+
+// defined in image.cpp as it needs to access wxImageRefData: returns a copy
+// of the image not sharing any data with it
+extern wxImage wxCopyImageForCache(const wxImage& image);
+
+// ----------------------------------------------------------------------------
+// private classes
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+// the global cache returned by wxImageCache::Get()
+wxImageCache *gs_imageCache = NULL;
+
+wxCRIT_SECT_DECLARE(gs_imageCacheCS);
+
+// return the number of bytes used by the image data
+size_t GetImageMemory(const wxImage& image)
+{
+    const size_t numPixels = size_t(image.GetWidth())*image.GetHeight();
+
+    return image.HasAlpha() ? 4*numPixels : 3*numPixels;
+}
+
+// a cached image, the entries form a list sorted by the time of last use
+struct wxImageCacheEntry
+{
+    wxString key;
+    wxImage image;
+    size_t size;
+
+    wxImageCacheEntry *prev,
+                      *next;
+};
+
+WX_DECLARE_STRING_HASH_MAP(wxImageCacheEntry *, wxImageCacheEntries);
+
+} // anonymous namespace
+
+class wxImageCacheImpl
+{
+public:
+    wxImageCacheImpl(size_t maxMemory)
+    {
+        m_maxMemory = maxMemory;
+        m_memoryUsed = 0;
+
+        m_head =
+        m_tail = NULL;
+
+        m_hits =
+        m_misses = 0;
+    }
+
+    ~wxImageCacheImpl()
+    {
+        Clear();
+    }
+
+    // all the functions below must be called with m_cs locked
+
+    void Clear()
+    {
+        while ( m_tail )
+            Remove(m_tail);
+    }
+
+    // remove the least recently used entries until no more than the given
+    // amount of memory is used
+    void Shrink(size_t maxMemory)
+    {
+        while ( m_memoryUsed > maxMemory )
+            Remove(m_tail);
+    }
+
+    wxImageCacheEntry *Find(const wxString& key) const
+    {
+        wxImageCacheEntries::const_iterator it = m_entries.find(key);
+
+        return it == m_entries.end() ? NULL : it->second;
+    }
+
+    void Add(wxImageCacheEntry *entry)
+    {
+        m_entries[entry->key] = entry;
+        m_memoryUsed += entry->size;
+
+        Link(entry);
+    }
+
+    void Remove(wxImageCacheEntry *entry)
+    {
+        Unlink(entry);
+
+        m_memoryUsed -= entry->size;
+        m_entries.erase(entry->key);
+
+        delete entry;
+    }
+
+    // move the entry to the head of the list as the most recently used one
+    void Touch(wxImageCacheEntry *entry)
+    {
+        if ( entry != m_head )
+        {
+            Unlink(entry);
+            Link(entry);
+        }
+    }
+
+    wxCRIT_SECT_DECLARE_MEMBER(m_cs);
+
+    wxImageCacheEntries m_entries;
+
+    size_t m_maxMemory,
+           m_memoryUsed;
+
+    unsigned long m_hits,
+                  m_misses;
+
+private:
+    void Link(wxImageCacheEntry *entry)
+    {
+        entry->prev = NULL;
+        entry->next = m_head;
+
+        if ( m_head )
+            m_head->prev = entry;
+        else
+            m_tail = entry;
+
+        m_head = entry;
+    }
+
+    void Unlink(wxImageCacheEntry *entry)
+    {
+        if ( entry->prev )
+            entry->prev->next = entry->next;
+        else
+            m_head = entry->next;
+
+        if ( entry->next )
+            entry->next->prev = entry->prev;
+        else
+            m_tail = entry->prev;
+    }
+
+    // the most and the least recently used entries
+    wxImageCacheEntry *m_head,
+                      *m_tail;
+
+    wxDECLARE_NO_COPY_CLASS(wxImageCacheImpl);
+};
+
+// ============================================================================
+// wxImageCache implementation
+// ============================================================================
+
+wxImageCache::wxImageCache(size_t maxMemory)
+{
+    m_impl = new wxImageCacheImpl(maxMemory);
+}
+
+wxImageCache::~wxImageCache()
+{
+    delete m_impl;
+}
+
+/* static */
+wxImageCache& wxImageCache::Get()
+{
+    wxCRIT_SECT_LOCKER(lock, gs_imageCacheCS);
+
+    if ( !gs_imageCache )
+        gs_imageCache = new wxImageCache;
+
+    return *gs_imageCache;
+}
+
+void wxImageCache::SetMaxMemory(size_t maxMemory)
+{
+    wxCRIT_SECT_LOCKER(lock, m_impl->m_cs);
+
+    m_impl->m_maxMemory = maxMemory;
+    m_impl->Shrink(maxMemory);
+}
+
+size_t wxImageCache::GetMaxMemory() const
+{
+    wxCRIT_SECT_LOCKER(lock, m_impl->m_cs);
+
+    return m_impl->m_maxMemory;
+}
+
+size_t wxImageCache::GetMemoryUsed() const
+{
+    wxCRIT_SECT_LOCKER(lock, m_impl->m_cs);
+
+    return m_impl->m_memoryUsed;
+}
+
+size_t wxImageCache::GetCount() const
+{
+    wxCRIT_SECT_LOCKER(lock, m_impl->m_cs);
+
+    return m_impl->m_entries.size();
+}
+
+bool wxImageCache::Lookup(const wxString& key, wxImage *image)
+{
+    wxCHECK_MSG( image, false, wxS("NULL pointer") );
+
+    wxImage copy;
+
+    {
+        wxCRIT_SECT_LOCKER(lock, m_impl->m_cs);
+
+        wxImageCacheEntry * const entry = m_impl->Find(key);
+        if ( !entry )
+        {
+            m_impl->m_misses++;
+            return false;
+        }
+
+        m_impl->m_hits++;
+        m_impl->Touch(entry);
+
+        copy = wxCopyImageForCache(entry->image);
+    }
+
+    *image = copy;
+
+    return true;
+}
+
+bool wxImageCache::Store(const wxString& key, const wxImage& image)
+{
+    wxCHECK_MSG( image.IsOk(), false, wxS("invalid image") );
+
+    const size_t size = GetImageMemory(image);
+
+    // check if the image fits before copying it
+    if ( size > GetMaxMemory() )
+    {
+        Remove(key);
+        return false;
+    }
+
+    wxImageCacheEntry * const entry = new wxImageCacheEntry;
+    entry->key = key.Clone();
+    entry->image = wxCopyImageForCache(image);
+    entry->size = size;
+
+    wxCRIT_SECT_LOCKER(lock, m_impl->m_cs);
+
+    wxImageCacheEntry * const old = m_impl->Find(key);
+    if ( old )
+        m_impl->Remove(old);
+
+    // the budget could have been changed by another thread in the meanwhile
+    if ( size > m_impl->m_maxMemory )
+    {
+        delete entry;
+        return false;
+    }
+
+    m_impl->Shrink(m_impl->m_maxMemory - size);
+    m_impl->Add(entry);
+
+    return true;
+}
+
+bool wxImageCache::Remove(const wxString& key)
+{
+    wxCRIT_SECT_LOCKER(lock, m_impl->m_cs);
+
+    wxImageCacheEntry * const entry = m_impl->Find(key);
+    if ( !entry )
+        return false;
+
+    m_impl->Remove(entry);
+
+    return true;
+}
+
+void wxImageCache::Clear()
+{
+    wxCRIT_SECT_LOCKER(lock, m_impl->m_cs);
+
+    m_impl->Clear();
+}
+
+unsigned long wxImageCache::GetHits() const
+{
+    wxCRIT_SECT_LOCKER(lock, m_impl->m_cs);
+
+    return m_impl->m_hits;
+}
+
+unsigned long wxImageCache::GetMisses() const
+{
+    wxCRIT_SECT_LOCKER(lock, m_impl->m_cs);
+
+    return m_impl->m_misses;
+}
+
+void wxImageCache::ResetStatistics()
+{
+    wxCRIT_SECT_LOCKER(lock, m_impl->m_cs);
+
+    m_impl->m_hits =
+    m_impl->m_misses = 0;
+}
+
+// ----------------------------------------------------------------------------
+// wxImageCacheModule: deletes the global cache on shutdown
+// ----------------------------------------------------------------------------
+
+class wxImageCacheModule : public wxModule
+{
+public:
+    wxImageCacheModule() { }
+
+    virtual bool OnInit() { return true; }
+    virtual void OnExit() { wxDELETE(gs_imageCache); }
+
+private:
+    DECLARE_DYNAMIC_CLASS(wxImageCacheModule)
+};
+
+IMPLEMENT_DYNAMIC_CLASS(wxImageCacheModule, wxModule)
+
+#endif // wxUSE_IMAGE
@@ -26,6 +26,7 @@
 #include "wx/imaggif.h"
 #include "wx/gifdecod.h"
 #include "wx/stream.h"
+#include "wx/mstream.h"
 #include "wx/anidecod.h" // wxImageArray
 
 #define GIF89_HDR     "GIF89a"
@@ -206,6 +207,288 @@ int wxGIFHandler::DoGetImageCount( wxInputStream& stream )
     return decod.GetFrameCount();
 }
 
+// ----------------------------------------------------------------------------
+// incremental loading
+// ----------------------------------------------------------------------------
+
+// The GIF data is buffered until all the blocks of the next frame have been
+// received and then this frame, preceded by the GIF header and followed by
+// the trailer, is decoded by wxGIFDecoder as a stand alone GIF image. So the
+// frames are decoded one by one as soon as possible without the decoder
+// having to be able to suspend itself in the middle of LZW data.
+class wxGIFIncrementalDecoder : public wxImageIncrementalDecoder
+{
+public:
+    wxGIFIncrementalDecoder(wxImageDecodeCallback& callback, bool verbose)
+        : m_callback(callback),
+          m_verbose(verbose)
+    {
+        m_state = State_Header;
+        m_anim = true;
+        m_frame = 0;
+        m_pos =
+        m_subBlock = 0;
+        m_isImage = false;
+    }
+
+    virtual bool Feed(const void *data, size_t len);
+    virtual bool IsDone() const { return m_state == State_Done; }
+
+private:
+    // parse the header if we have all of it
+    bool ParseHeader();
+
+    // parse as many complete blocks as we have, decoding the frames
+    bool ParseBlocks();
+
+    // decode the frame consisting of the first len bytes of the buffer
+    bool DecodeFrame(size_t len);
+
+    // forget the first len bytes of the buffer
+    void Consume(size_t len);
+
+    // return false after logging an error if verbose
+    bool Fail();
+
+
+    wxImageDecodeCallback& m_callback;
+    const bool m_verbose;
+
+    enum
+    {
+        State_Header,
+        State_Blocks,
+        State_Done,
+        State_Error
+    } m_state;
+
+    // the GIF signature, logical screen descriptor and global palette
+    wxMemoryBuffer m_header;
+
+    // the data received after the end of the last decoded frame
+    wxMemoryBuffer m_data;
+
+    // the offset of the block being parsed in m_data
+    size_t m_pos;
+
+    // the offset of the next data sub-block length byte in m_data or 0 if
+    // the block header wasn't parsed yet
+    size_t m_subBlock;
+
+    // whether the current block is an image one
+    bool m_isImage;
+
+    // false if this is a GIF87a image which only has a single frame
+    bool m_anim;
+
+    // the number of frames decoded so far
+    unsigned m_frame;
+
+    wxDECLARE_NO_COPY_CLASS(wxGIFIncrementalDecoder);
+};
+
+bool wxGIFIncrementalDecoder::Feed(const void *data, size_t len)
+{
+    switch ( m_state )
+    {
+        case State_Error:
+            return false;
+
+        case State_Done:
+            return true;
+
+        case State_Header:
+        case State_Blocks:
+            break;
+    }
+
+    m_data.AppendData(data, len);
+
+    if ( m_state == State_Header && !ParseHeader() )
+        return Fail();
+
+    if ( m_state == State_Blocks && !ParseBlocks() )
+        return Fail();
+
+    return true;
+}
+
+bool wxGIFIncrementalDecoder::ParseHeader()
+{
+    // signature, version and logical screen descriptor
+    static const size_t lsdbEnd = 3 + 3 + 2 + 2 + 1 + 1 + 1;
+
+    const unsigned char * const p = (unsigned char *)m_data.GetData();
+    const size_t len = m_data.GetDataLen();
+    if ( len < lsdbEnd )
+        return true;
+
+    if ( memcmp(p, "GIF", 3) != 0 )
+        return false;
+
+    size_t headerLen = lsdbEnd;
+    if ( (p[10] & 0x80) == 0x80 )
+        headerLen += 3 * (2 << (p[10] & 0x07));
+
+    if ( len < headerLen )
+        return true;
+
+    m_anim = memcmp(p + 3, "89a", 3) >= 0;
+
+    m_header.AppendData(p, headerLen);
+    Consume(headerLen);
+
+    m_state = State_Blocks;
+
+    return true;
+}
+
+bool wxGIFIncrementalDecoder::ParseBlocks()
+{
+    for ( ;; )
+    {
+        const unsigned char * const p = (unsigned char *)m_data.GetData();
+        const size_t len = m_data.GetDataLen();
+
+        if ( !m_subBlock )
+        {
+            if ( m_pos >= len )
+                return true;
+
+            switch ( p[m_pos] )
+            {
+                case GIF_MARKER_ENDOFDATA:
+                    m_state = State_Done;
+                    return true;
+
+                case GIF_MARKER_EXT:
+                    // skip the extension label
+                    if ( m_pos + 2 > len )
+                        return true;
+
+                    m_subBlock = m_pos + 2;
+                    m_isImage = false;
+                    break;
+
+                case GIF_MARKER_SEP:
+                {
+                    // image descriptor, optional local palette and the
+                    // initial LZW code size
+                    static const size_t idbLen = 1 + 2 + 2 + 2 + 2 + 1;
+                    if ( m_pos + idbLen > len )
+                        return true;
+
+                    const unsigned char flags = p[m_pos + idbLen - 1];
+                    size_t headerLen = idbLen + 1;
+                    if ( (flags & 0x80) == 0x80 )
+                        headerLen += 3 * (2 << (flags & 0x07));
+
+                    if ( m_pos + headerLen > len )
+                        return true;
+
+                    m_subBlock = m_pos + headerLen;
+                    m_isImage = true;
+                    break;
+                }
+
+                default:
+                    // wxGIFDecoder ignores anything unexpected, so do we
+                    m_pos++;
+                    continue;
+            }
+        }
+
+        // skip the data sub-blocks until the terminating empty one
+        while ( m_subBlock < len && p[m_subBlock] )
+            m_subBlock += p[m_subBlock] + 1;
+
+        if ( m_subBlock >= len )
+            return true;
+
+        const size_t end = m_subBlock + 1;
+        m_subBlock = 0;
+
+        if ( !m_isImage )
+        {
+            // keep the extensions as they apply to the next frame
+            m_pos = end;
+            continue;
+        }
+
+        if ( !DecodeFrame(end) )
+            return false;
+
+        Consume(end);
+        m_pos = 0;
+
+        if ( m_state != State_Blocks )
+            return true;
+    }
+}
+
+bool wxGIFIncrementalDecoder::DecodeFrame(size_t len)
+{
+    wxMemoryBuffer gif(m_header.GetDataLen() + len + 1);
+    gif.AppendData(m_header.GetData(), m_header.GetDataLen());
+    gif.AppendData(m_data.GetData(), len);
+    gif.AppendByte(GIF_MARKER_ENDOFDATA);
+
+    wxMemoryInputStream stream(gif.GetData(), gif.GetDataLen());
+
+    wxGIFDecoder decod;
+    if ( decod.LoadGIF(stream) != wxGIF_OK )
+        return false;
+
+    wxImage image;
+    if ( !decod.ConvertToImage(0, &image) )
+        return false;
+
+    // GIF frames are decoded all at once
+    if ( !m_callback.OnRowsDecoded(m_frame, image, 0, image.GetHeight()) ||
+            !m_callback.OnFrameDecoded(m_frame, image) )
+    {
+        m_state = State_Error;
+        return false;
+    }
+
+    m_frame++;
+
+    // GIF87a images can have only one frame
+    if ( !m_anim )
+        m_state = State_Done;
+
+    return true;
+}
+
+void wxGIFIncrementalDecoder::Consume(size_t len)
+{
+    unsigned char * const p = (unsigned char *)m_data.GetData();
+    const size_t total = m_data.GetDataLen();
+
+    memmove(p, p + len, total - len);
+    m_data.SetDataLen(total - len);
+}
+
+bool wxGIFIncrementalDecoder::Fail()
+{
+    // don't complain if the callback aborted decoding
+    if ( m_verbose && m_state != State_Error )
+    {
+        wxLogError(_("GIF: error in GIF image format."));
+    }
+
+    m_state = State_Error;
+
+    return false;
+}
+
+wxImageIncrementalDecoder *
+wxGIFHandler::CreateIncrementalDecoder(wxImageDecodeCallback& callback,
+                                       bool verbose)
+{
+    return new wxGIFIncrementalDecoder(callback, verbose);
+}
+
 bool wxGIFHandler::DoSaveFile(const wxImage& image, wxOutputStream *stream,
     bool WXUNUSED(verbose), bool first, int delayMilliSecs, bool loop,
     const wxRGB *pal, int palCount, int maskIndex)
@@ -259,6 +542,8 @@ bool wxGIFHandler::DoSaveFile(const wxImage& image, wxOutputStream *stream,
         return false;
     }
 
+    wxCRIT_SECT_LOCKER(lock, m_csSave);
+
     if (!InitHashTable())
     {
         wxLogError(_("Couldn't initialize GIF hash table."));
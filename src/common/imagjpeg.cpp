@@ -227,18 +227,68 @@ static inline void wx_cmyk_to_rgb(unsigned char* rgb, const unsigned char* cmyk)
     #pragma warning(disable:4611)
 #endif /* VC++ */
 
-bool wxJPEGHandler::LoadFile( wxImage *image, wxInputStream& stream, bool verbose, int WXUNUSED(index) )
+namespace
+{
+
+// sink storing the rows in the image
+class wxJPEGImageSink : public wxImageRowSink
+{
+public:
+    wxJPEGImageSink(wxImage *image) : m_image(image) { }
+
+    virtual bool Start(int width, int height, bool WXUNUSED(hasAlpha))
+    {
+        if ( !m_image->Create(width, height, false) )
+            return false;
+
+        m_image->SetMask(false);
+        return true;
+    }
+
+    virtual bool ProcessRow(int y,
+                            const unsigned char *data,
+                            const unsigned char * WXUNUSED(alpha))
+    {
+        const int width = m_image->GetWidth();
+        memcpy(m_image->GetData() + y*width*3, data, width*3);
+        return true;
+    }
+
+private:
+    wxImage * const m_image;
+};
+
+} // anonymous namespace
+
+bool wxJPEGHandler::LoadFile( wxImage *image, wxInputStream& stream, bool verbose, int index )
+{
+    wxCHECK_MSG( image, false, "NULL image pointer" );
+
+    wxJPEGImageSink sink(image);
+    if ( !LoadRows(image, sink, stream, verbose, index) )
+    {
+        if ( image->IsOk() )
+            image->Destroy();
+
+        return false;
+    }
+
+    return true;
+}
+
+bool wxJPEGHandler::LoadRows( wxImage *image, wxImageRowSink& sink,
+                              wxInputStream& stream,
+                              bool verbose, int WXUNUSED(index) )
 {
     wxCHECK_MSG( image, false, "NULL image pointer" );
 
     struct jpeg_decompress_struct cinfo;
     wx_error_mgr jerr;
-    unsigned char *ptr;
 
-    // save this before calling Destroy()
+    // save this before the sink can call Destroy()
     const unsigned maxWidth = image->GetOptionInt(wxIMAGE_OPTION_MAX_WIDTH),
                    maxHeight = image->GetOptionInt(wxIMAGE_OPTION_MAX_HEIGHT);
-    image->Destroy();
+    const bool fastDecode = image->GetOptionInt(wxIMAGE_OPTION_JPEG_FAST_DECODE) != 0;
 
     cinfo.err = jpeg_std_error( &jerr );
     jerr.error_exit = wx_error_exit;
@@ -257,7 +307,6 @@ bool wxJPEGHandler::LoadFile( wxImage *image, wxInputStream& stream, bool verbos
       }
       (cinfo.src->term_source)(&cinfo);
       jpeg_destroy_decompress(&cinfo);
-      if (image->IsOk()) image->Destroy();
       return false;
     }
 
@@ -277,42 +326,64 @@ bool wxJPEGHandler::LoadFile( wxImage *image, wxInputStream& stream, bool verbos
         bytesPerPixel = 3;
     }
 
-    // scale the picture to fit in the specified max size if necessary
+    if ( fastDecode )
+    {
+        cinfo.dct_method = JDCT_IFAST;
+        cinfo.do_fancy_upsampling = FALSE;
+    }
+
+    // scale the picture to fit in the specified max size if necessary: this
+    // is done by libjpeg in DCT domain which is much faster than decoding the
+    // full image and rescaling it, but only the scale factors of 1/2, 1/4 and
+    // 1/8 are supported and the image is rescaled further by wxImage itself
+    // if even the smallest of them is not enough
     if ( maxWidth > 0 || maxHeight > 0 )
     {
-        unsigned& scale = cinfo.scale_denom;
-        while ( (maxWidth && (cinfo.image_width / scale > maxWidth)) ||
-                    (maxHeight && (cinfo.image_height / scale > maxHeight)) )
+        for ( ;; )
         {
-            scale *= 2;
+            // notice that the output size is rounded up and not down, so we
+            // need to let libjpeg compute it to be sure that it fits
+            jpeg_calc_output_dimensions( &cinfo );
+
+            if ( (!maxWidth || cinfo.output_width <= maxWidth) &&
+                    (!maxHeight || cinfo.output_height <= maxHeight) )
+                break;
+
+            if ( cinfo.scale_denom == 8 )
+                break;
+
+            cinfo.scale_denom *= 2;
         }
     }
 
     jpeg_start_decompress( &cinfo );
 
-    image->Create( cinfo.output_width, cinfo.output_height );
-    if (!image->IsOk()) {
-        jpeg_finish_decompress( &cinfo );
+    if ( !sink.Start(cinfo.output_width, cinfo.output_height, false) )
+    {
+        jpeg_abort_decompress( &cinfo );
         jpeg_destroy_decompress( &cinfo );
         return false;
     }
-    image->SetMask( false );
-    ptr = image->GetData();
 
     unsigned stride = cinfo.output_width * bytesPerPixel;
     JSAMPARRAY tempbuf = (*cinfo.mem->alloc_sarray)
                             ((j_common_ptr) &cinfo, JPOOL_IMAGE, stride, 1 );
 
+    // buffer for the rows converted from CMYK, if necessary
+    JSAMPARRAY rgbbuf = bytesPerPixel == 3
+                            ? tempbuf
+                            : (*cinfo.mem->alloc_sarray)
+                                ((j_common_ptr) &cinfo, JPOOL_IMAGE,
+                                 cinfo.output_width * 3, 1 );
+
     while ( cinfo.output_scanline < cinfo.output_height )
     {
+        const int y = cinfo.output_scanline;
         jpeg_read_scanlines( &cinfo, tempbuf, 1 );
-        if (cinfo.out_color_space == JCS_RGB)
-        {
-            memcpy( ptr, tempbuf[0], stride );
-            ptr += stride;
-        }
-        else // CMYK
+        if (cinfo.out_color_space != JCS_RGB)
         {
+            // CMYK
+            unsigned char* ptr = (unsigned char*) rgbbuf[0];
             const unsigned char* inptr = (const unsigned char*) tempbuf[0];
             for (size_t i = 0; i < cinfo.output_width; i++)
             {
@@ -321,6 +392,13 @@ bool wxJPEGHandler::LoadFile( wxImage *image, wxInputStream& stream, bool verbos
                 inptr += 4;
             }
         }
+
+        if ( !sink.ProcessRow(y, (const unsigned char*) rgbbuf[0], NULL) )
+        {
+            jpeg_abort_decompress( &cinfo );
+            jpeg_destroy_decompress( &cinfo );
+            return false;
+        }
     }
 
     // set up resolution if available: it's part of optional JFIF APP0 chunk
@@ -128,6 +128,8 @@ IMPLEMENT_DYNAMIC_CLASS(wxPNGHandler,wxImageHandler)
 //     png_set_write_fn. The hacky part is that we use io_ptr to store
 //     a pointer to wxPNGInfoStruct that holds I/O structures _and_ jmp_buf.
 
+class wxPNGIncrementalDecoder;
+
 struct wxPNGInfoStruct
 {
     jmp_buf jmpbuf;
@@ -138,6 +140,9 @@ struct wxPNGInfoStruct
         wxInputStream  *in;
         wxOutputStream *out;
     } stream;
+
+    // only used when decoding incrementally, when there is no stream
+    wxPNGIncrementalDecoder *decoder;
 };
 
 #define WX_PNG_INFO(png_ptr) ((wxPNGInfoStruct*)png_get_io_ptr(png_ptr))
@@ -498,6 +503,49 @@ void CopyDataFromPNG(wxImage *image,
     #pragma warning(disable:4611)
 #endif /* VC++ */
 
+// set the image resolution options if it's available
+static
+void SetResolutionFromPNG(wxImage *image, png_structp png_ptr, png_infop info_ptr)
+{
+    png_uint_32 resX, resY;
+    int unitType;
+    if (png_get_pHYs(png_ptr, info_ptr, &resX, &resY, &unitType)
+        == PNG_INFO_pHYs)
+    {
+        wxImageResolution res = wxIMAGE_RESOLUTION_CM;
+
+        switch (unitType)
+        {
+            default:
+                wxLogWarning(_("Unknown PNG resolution unit %d"), unitType);
+                // fall through
+
+            case PNG_RESOLUTION_UNKNOWN:
+                image->SetOption(wxIMAGE_OPTION_RESOLUTIONX, resX);
+                image->SetOption(wxIMAGE_OPTION_RESOLUTIONY, resY);
+
+                res = wxIMAGE_RESOLUTION_NONE;
+                break;
+
+            case PNG_RESOLUTION_METER:
+                /*
+                Convert meters to centimeters.
+                Use a string to not lose precision (converting to cm and then
+                to inch would result in integer rounding error).
+                If an app wants an int, GetOptionInt will convert and round
+                down for them.
+                */
+                image->SetOption(wxIMAGE_OPTION_RESOLUTIONX,
+                    wxString::FromCDouble((double) resX / 100.0, 2));
+                image->SetOption(wxIMAGE_OPTION_RESOLUTIONY,
+                    wxString::FromCDouble((double) resY / 100.0, 2));
+                break;
+        }
+
+        image->SetOption(wxIMAGE_OPTION_RESOLUTIONUNIT, res);
+    }
+}
+
 bool
 wxPNGHandler::LoadFile(wxImage *image,
                        wxInputStream& stream,
@@ -603,45 +651,7 @@ wxPNGHandler::LoadFile(wxImage *image,
 #endif // wxUSE_PALETTE
 
 
-    // set the image resolution if it's available
-    png_uint_32 resX, resY;
-    int unitType;
-    if (png_get_pHYs(png_ptr, info_ptr, &resX, &resY, &unitType)
-        == PNG_INFO_pHYs)
-    {
-        wxImageResolution res = wxIMAGE_RESOLUTION_CM;
-
-        switch (unitType)
-        {
-            default:
-                wxLogWarning(_("Unknown PNG resolution unit %d"), unitType);
-                // fall through
-
-            case PNG_RESOLUTION_UNKNOWN:
-                image->SetOption(wxIMAGE_OPTION_RESOLUTIONX, resX);
-                image->SetOption(wxIMAGE_OPTION_RESOLUTIONY, resY);
-
-                res = wxIMAGE_RESOLUTION_NONE;
-                break;
-
-            case PNG_RESOLUTION_METER:
-                /*
-                Convert meters to centimeters.
-                Use a string to not lose precision (converting to cm and then
-                to inch would result in integer rounding error).
-                If an app wants an int, GetOptionInt will convert and round
-                down for them.
-                */
-                image->SetOption(wxIMAGE_OPTION_RESOLUTIONX,
-                    wxString::FromCDouble((double) resX / 100.0, 2));
-                image->SetOption(wxIMAGE_OPTION_RESOLUTIONY,
-                    wxString::FromCDouble((double) resY / 100.0, 2));
-                break;
-        }
-
-        image->SetOption(wxIMAGE_OPTION_RESOLUTIONUNIT, res);
-    }
-
+    SetResolutionFromPNG(image, png_ptr, info_ptr);
 
     png_destroy_read_struct( &png_ptr, &info_ptr, (png_infopp) NULL );
 
@@ -686,6 +696,429 @@ error:
     return false;
 }
 
+bool
+wxPNGHandler::LoadRows(wxImage *image,
+                       wxImageRowSink& sink,
+                       wxInputStream& stream,
+                       bool verbose,
+                       int index)
+{
+    wxCHECK_MSG( image, false, "NULL image pointer" );
+
+    // as in LoadFile(), we can only use goto for error handling here
+    const wxFileOffset posOld = stream.IsSeekable() ? stream.TellI()
+                                                    : wxInvalidOffset;
+
+    unsigned char *buf = NULL;
+    png_infop info_ptr = (png_infop) NULL;
+    wxPNGInfoStruct wxinfo;
+
+    png_uint_32 width, height;
+    int bit_depth, color_type, interlace_type;
+    bool hasAlpha;
+    unsigned char *rgb, *alpha;
+
+    wxinfo.verbose = verbose;
+    wxinfo.stream.in = &stream;
+
+    png_structp png_ptr = png_create_read_struct
+                          (
+                            PNG_LIBPNG_VER_STRING,
+                            NULL,
+                            wx_png_error,
+                            wx_png_warning
+                          );
+    if (!png_ptr)
+        goto error;
+
+    png_set_read_fn( png_ptr, &wxinfo, wx_PNG_stream_reader);
+
+    info_ptr = png_create_info_struct( png_ptr );
+    if (!info_ptr)
+        goto error;
+
+    if (setjmp(wxinfo.jmpbuf))
+        goto error;
+
+    png_read_info( png_ptr, info_ptr );
+    png_get_IHDR( png_ptr, info_ptr, &width, &height, &bit_depth, &color_type, &interlace_type, NULL, NULL );
+
+    if ( interlace_type != PNG_INTERLACE_NONE )
+    {
+        // interlaced images can't be decoded row by row, so load the entire
+        // image if we can rewind the stream
+        png_destroy_read_struct( &png_ptr, &info_ptr, (png_infopp) NULL );
+
+        if ( posOld == wxInvalidOffset || stream.SeekI(posOld) == wxInvalidOffset )
+            return false;
+
+        return wxImageHandler::LoadRows(image, sink, stream, verbose, index);
+    }
+
+    hasAlpha = (color_type & PNG_COLOR_MASK_ALPHA) ||
+                    png_get_valid( png_ptr, info_ptr, PNG_INFO_tRNS);
+
+    // unlike LoadFile(), always use the alpha channel instead of a mask as we
+    // can't check all the alpha values before passing them to the sink
+    if (color_type == PNG_COLOR_TYPE_PALETTE || bit_depth < 8 || hasAlpha)
+        png_set_expand( png_ptr );
+
+    png_set_strip_16( png_ptr );
+    png_set_packing( png_ptr );
+    png_set_gray_to_rgb( png_ptr );
+
+    // the buffer contains the row as returned by libpng, i.e. RGBA if there
+    // is alpha, followed by RGB and alpha parts of it
+    buf = (unsigned char *)malloc(width*8);
+    if ( !buf )
+        goto error;
+
+    rgb = hasAlpha ? buf + width*4 : buf;
+    alpha = hasAlpha ? rgb + width*3 : NULL;
+
+    if ( !sink.Start(width, height, hasAlpha) )
+        goto error;
+
+    for ( png_uint_32 y = 0; y < height; y++ )
+    {
+        png_read_row( png_ptr, buf, NULL );
+
+        if ( hasAlpha )
+        {
+            const unsigned char *src = buf;
+            for ( png_uint_32 x = 0; x < width; x++, src += 4 )
+            {
+                rgb[3*x] = src[0];
+                rgb[3*x + 1] = src[1];
+                rgb[3*x + 2] = src[2];
+                alpha[x] = src[3];
+            }
+        }
+
+        if ( !sink.ProcessRow(y, rgb, alpha) )
+            goto error;
+    }
+
+    png_read_end( png_ptr, info_ptr );
+
+    SetResolutionFromPNG(image, png_ptr, info_ptr);
+
+    png_destroy_read_struct( &png_ptr, &info_ptr, (png_infopp) NULL );
+
+    free( buf );
+
+    return true;
+
+error:
+    if (verbose)
+    {
+       wxLogError(_("Couldn't load a PNG image - file is corrupted or not enough memory."));
+    }
+
+    free( buf );
+
+    if ( png_ptr )
+    {
+        if ( info_ptr )
+            png_destroy_read_struct( &png_ptr, &info_ptr, (png_infopp) NULL );
+        else
+            png_destroy_read_struct( &png_ptr, (png_infopp) NULL, (png_infopp) NULL );
+    }
+
+    return false;
+}
+
+// ----------------------------------------------------------------------------
+// incremental loading
+// ----------------------------------------------------------------------------
+
+// decoder using libpng progressive reading API: the image data is pushed into
+// it and it calls us back from png_process_data() when it has decoded a row
+class wxPNGIncrementalDecoder : public wxImageIncrementalDecoder
+{
+public:
+    wxPNGIncrementalDecoder(wxImageDecodeCallback& callback, bool verbose);
+    virtual ~wxPNGIncrementalDecoder();
+
+    // must be called after constructing the object, returns false on error
+    bool Create();
+
+    virtual bool Feed(const void *data, size_t len);
+    virtual bool IsDone() const { return m_done; }
+
+    // these functions are called by libpng from png_process_data()
+    void OnInfo();
+    void OnRow(png_bytep row, png_uint_32 y);
+    void OnEnd() { m_done = true; }
+
+private:
+    wxImageDecodeCallback& m_callback;
+
+    wxPNGInfoStruct m_wxinfo;
+    png_structp m_png;
+    png_infop m_info;
+
+    // the image being decoded
+    wxImage m_image;
+
+    // the rows of an interlaced image as combined by libpng from all the
+    // passes so far, NULL for the non-interlaced images
+    unsigned char *m_rows;
+    png_size_t m_rowBytes;
+    bool m_hasAlpha;
+
+    // the rows updated during the current Feed() call
+    int m_yStart,
+        m_yEnd;
+
+    bool m_done,
+         m_failed;
+
+    wxDECLARE_NO_COPY_CLASS(wxPNGIncrementalDecoder);
+};
+
+extern "C"
+{
+
+static void
+PNGLINKAGEMODE wx_png_info_callback(png_structp png_ptr,
+                                    png_infop WXUNUSED(info_ptr))
+{
+    WX_PNG_INFO(png_ptr)->decoder->OnInfo();
+}
+
+static void
+PNGLINKAGEMODE wx_png_row_callback(png_structp png_ptr,
+                                   png_bytep row,
+                                   png_uint_32 y,
+                                   int WXUNUSED(pass))
+{
+    WX_PNG_INFO(png_ptr)->decoder->OnRow(row, y);
+}
+
+static void
+PNGLINKAGEMODE wx_png_end_callback(png_structp png_ptr,
+                                   png_infop WXUNUSED(info_ptr))
+{
+    WX_PNG_INFO(png_ptr)->decoder->OnEnd();
+}
+
+} // extern "C"
+
+wxPNGIncrementalDecoder::wxPNGIncrementalDecoder(wxImageDecodeCallback& callback,
+                                                 bool verbose)
+    : m_callback(callback)
+{
+    m_wxinfo.verbose = verbose;
+    m_wxinfo.stream.in = NULL;
+    m_wxinfo.decoder = this;
+
+    m_png = NULL;
+    m_info = NULL;
+
+    m_rows = NULL;
+    m_rowBytes = 0;
+    m_hasAlpha = false;
+
+    m_yStart =
+    m_yEnd = 0;
+
+    m_done =
+    m_failed = false;
+}
+
+bool wxPNGIncrementalDecoder::Create()
+{
+    m_png = png_create_read_struct
+            (
+                PNG_LIBPNG_VER_STRING,
+                NULL,
+                wx_png_error,
+                wx_png_warning
+            );
+    if ( !m_png )
+        return false;
+
+    // this also sets the I/O pointer used by WX_PNG_INFO() to our wxinfo, see
+    // the comment near wxPNGInfoStruct declaration
+    png_set_progressive_read_fn(m_png, &m_wxinfo,
+                                wx_png_info_callback,
+                                wx_png_row_callback,
+                                wx_png_end_callback);
+
+    m_info = png_create_info_struct(m_png);
+
+    return m_info != NULL;
+}
+
+wxPNGIncrementalDecoder::~wxPNGIncrementalDecoder()
+{
+    if ( m_png )
+    {
+        png_destroy_read_struct( &m_png,
+                                 m_info ? &m_info : (png_infopp) NULL,
+                                 (png_infopp) NULL );
+    }
+
+    free( m_rows );
+}
+
+void wxPNGIncrementalDecoder::OnInfo()
+{
+    png_uint_32 width, height;
+    int bit_depth, color_type, interlace_type;
+    png_get_IHDR( m_png, m_info, &width, &height, &bit_depth, &color_type, &interlace_type, NULL, NULL );
+
+    // use the same transformations as LoadRows() as we can't decide whether
+    // a mask would be enough before seeing all the image either
+    m_hasAlpha = (color_type & PNG_COLOR_MASK_ALPHA) ||
+                    png_get_valid( m_png, m_info, PNG_INFO_tRNS);
+
+    if (color_type == PNG_COLOR_TYPE_PALETTE || bit_depth < 8 || m_hasAlpha)
+        png_set_expand( m_png );
+
+    png_set_strip_16( m_png );
+    png_set_packing( m_png );
+    png_set_gray_to_rgb( m_png );
+
+    if ( interlace_type != PNG_INTERLACE_NONE )
+        png_set_interlace_handling( m_png );
+
+    png_read_update_info( m_png, m_info );
+    m_rowBytes = png_get_rowbytes( m_png, m_info );
+
+    // the pixels not decoded yet are shown as black or transparent
+    if ( !m_image.Create((int)width, (int)height) )
+        png_error( m_png, "Not enough memory for the image." );
+
+    if ( m_hasAlpha )
+    {
+        m_image.SetAlpha();
+        memset(m_image.GetAlpha(), 0, width*height);
+    }
+
+    if ( interlace_type != PNG_INTERLACE_NONE )
+    {
+        m_rows = (unsigned char *)calloc(height, m_rowBytes);
+        if ( !m_rows )
+            png_error( m_png, "Not enough memory for the image." );
+    }
+
+    SetResolutionFromPNG(&m_image, m_png, m_info);
+}
+
+void wxPNGIncrementalDecoder::OnRow(png_bytep row, png_uint_32 y)
+{
+    // libpng doesn't give us anything for the rows not changed by the
+    // current pass of an interlaced image
+    if ( !row )
+        return;
+
+    if ( m_rows )
+    {
+        unsigned char * const combined = m_rows + y*m_rowBytes;
+        png_progressive_combine_row( m_png, combined, row );
+        row = combined;
+    }
+
+    const png_uint_32 width = m_image.GetWidth();
+    unsigned char * const rgb = m_image.GetData() + 3*y*width;
+    if ( m_hasAlpha )
+    {
+        unsigned char * const alpha = m_image.GetAlpha() + y*width;
+
+        const unsigned char *src = row;
+        for ( png_uint_32 x = 0; x < width; x++, src += 4 )
+        {
+            rgb[3*x] = src[0];
+            rgb[3*x + 1] = src[1];
+            rgb[3*x + 2] = src[2];
+            alpha[x] = src[3];
+        }
+    }
+    else
+    {
+        memcpy(rgb, row, 3*width);
+    }
+
+    if ( m_yStart == m_yEnd )
+    {
+        m_yStart = y;
+        m_yEnd = y + 1;
+    }
+    else
+    {
+        if ( (int)y < m_yStart )
+            m_yStart = y;
+        if ( (int)y >= m_yEnd )
+            m_yEnd = y + 1;
+    }
+}
+
+bool wxPNGIncrementalDecoder::Feed(const void *data, size_t len)
+{
+    if ( m_failed )
+        return false;
+
+    if ( m_done )
+        return true;
+
+    m_yStart =
+    m_yEnd = 0;
+
+    // as in LoadFile(), no objects with dtors must be alive while libpng can
+    // longjmp() here, so the callback is only notified after decoding
+    if ( setjmp(m_wxinfo.jmpbuf) )
+    {
+        m_failed = true;
+
+        if ( m_wxinfo.verbose )
+        {
+           wxLogError(_("Couldn't load a PNG image - file is corrupted or not enough memory."));
+        }
+
+        return false;
+    }
+
+    png_process_data( m_png, m_info, (png_bytep)data, len );
+
+    if ( m_yEnd > m_yStart &&
+            !m_callback.OnRowsDecoded(0, m_image, m_yStart, m_yEnd) )
+    {
+        m_failed = true;
+        return false;
+    }
+
+    if ( m_done )
+    {
+        free( m_rows );
+        m_rows = NULL;
+
+        if ( !m_callback.OnFrameDecoded(0, m_image) )
+        {
+            m_failed = true;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+wxImageIncrementalDecoder *
+wxPNGHandler::CreateIncrementalDecoder(wxImageDecodeCallback& callback,
+                                       bool verbose)
+{
+    wxPNGIncrementalDecoder * const
+        decoder = new wxPNGIncrementalDecoder(callback, verbose);
+    if ( !decoder->Create() )
+    {
+        delete decoder;
+        return NULL;
+    }
+
+    return decoder;
+}
+
 // ----------------------------------------------------------------------------
 // SaveFile() palette helpers
 // ----------------------------------------------------------------------------
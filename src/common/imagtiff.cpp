@@ -293,6 +293,87 @@ TIFFwxOpen(wxOutputStream &stream, const char* name, const char* mode)
     return tif;
 }
 
+// set the image options corresponding to the TIFF tags
+static void SetOptionsFromTIFF(wxImage *image, TIFF *tif,
+                               uint16 photometric,
+                               uint16 samplesPerPixel,
+                               uint16 bitsPerSample)
+{
+    image->SetOption(wxIMAGE_OPTION_TIFF_PHOTOMETRIC, photometric);
+
+    uint16 compression;
+    /*
+    Copy some baseline TIFF tags which helps when re-saving a TIFF
+    to be similar to the original image.
+    */
+    if (samplesPerPixel)
+    {
+        image->SetOption(wxIMAGE_OPTION_TIFF_SAMPLESPERPIXEL, samplesPerPixel);
+    }
+
+    if (bitsPerSample)
+    {
+        image->SetOption(wxIMAGE_OPTION_TIFF_BITSPERSAMPLE, bitsPerSample);
+    }
+
+    if ( TIFFGetFieldDefaulted(tif, TIFFTAG_COMPRESSION, &compression) )
+    {
+        image->SetOption(wxIMAGE_OPTION_TIFF_COMPRESSION, compression);
+    }
+
+    // Set the resolution unit.
+    wxImageResolution resUnit = wxIMAGE_RESOLUTION_NONE;
+    uint16 tiffRes;
+    if ( TIFFGetFieldDefaulted(tif, TIFFTAG_RESOLUTIONUNIT, &tiffRes) )
+    {
+        switch (tiffRes)
+        {
+            default:
+                wxLogWarning(_("Unknown TIFF resolution unit %d ignored"),
+                    tiffRes);
+                // fall through
+
+            case RESUNIT_NONE:
+                resUnit = wxIMAGE_RESOLUTION_NONE;
+                break;
+
+            case RESUNIT_INCH:
+                resUnit = wxIMAGE_RESOLUTION_INCHES;
+                break;
+
+            case RESUNIT_CENTIMETER:
+                resUnit = wxIMAGE_RESOLUTION_CM;
+                break;
+        }
+    }
+
+    image->SetOption(wxIMAGE_OPTION_RESOLUTIONUNIT, resUnit);
+
+    /*
+    Set the image resolution if it's available. Resolution tag is not
+    dependant on RESOLUTIONUNIT != RESUNIT_NONE (according to TIFF spec).
+    */
+    float resX, resY;
+
+    if ( TIFFGetField(tif, TIFFTAG_XRESOLUTION, &resX) )
+    {
+        /*
+        Use a string value to not lose precision.
+        rounding to int as cm and then converting to inch may
+        result in whole integer rounding error, eg. 201 instead of 200 dpi.
+        If an app wants an int, GetOptionInt will convert and round down.
+        */
+        image->SetOption(wxIMAGE_OPTION_RESOLUTIONX,
+            wxString::FromCDouble((double) resX));
+    }
+
+    if ( TIFFGetField(tif, TIFFTAG_YRESOLUTION, &resY) )
+    {
+        image->SetOption(wxIMAGE_OPTION_RESOLUTIONY,
+            wxString::FromCDouble((double) resY));
+    }
+}
+
 bool wxTIFFHandler::LoadFile( wxImage *image, wxInputStream& stream, bool verbose, int index )
 {
     if (index == -1)
@@ -504,85 +585,171 @@ bool wxTIFFHandler::LoadFile( wxImage *image, wxInputStream& stream, bool verbos
     }
 
 
-    image->SetOption(wxIMAGE_OPTION_TIFF_PHOTOMETRIC, photometric);
+    SetOptionsFromTIFF(image, tif, photometric, samplesPerPixel, bitsPerSample);
 
-    uint16 compression;
-    /*
-    Copy some baseline TIFF tags which helps when re-saving a TIFF
-    to be similar to the original image.
-    */
-    if (samplesPerPixel)
+    _TIFFfree( raster );
+
+    TIFFClose( tif );
+
+    return true;
+}
+
+bool wxTIFFHandler::LoadRows( wxImage *image, wxImageRowSink& sink,
+                              wxInputStream& stream,
+                              bool verbose, int index )
+{
+    wxCHECK_MSG( image, false, "NULL image pointer" );
+
+    const wxFileOffset posOld = stream.TellI();
+
+    TIFF *tif = TIFFwxOpen( stream, "image", "r" );
+
+    if (!tif)
     {
-        image->SetOption(wxIMAGE_OPTION_TIFF_SAMPLESPERPIXEL, samplesPerPixel);
+        if (verbose)
+        {
+            wxLogError( _("TIFF: Error loading image.") );
+        }
+
+        return false;
     }
 
-    if (bitsPerSample)
+    if (!TIFFSetDirectory( tif, (tdir_t)(index == -1 ? 0 : index) ))
     {
-        image->SetOption(wxIMAGE_OPTION_TIFF_BITSPERSAMPLE, bitsPerSample);
+        if (verbose)
+        {
+            wxLogError( _("Invalid TIFF image index.") );
+        }
+
+        TIFFClose( tif );
+
+        return false;
     }
 
-    if ( TIFFGetFieldDefaulted(tif, TIFFTAG_COMPRESSION, &compression) )
+    uint32 w, h;
+
+    TIFFGetField( tif, TIFFTAG_IMAGEWIDTH, &w );
+    TIFFGetField( tif, TIFFTAG_IMAGELENGTH, &h );
+
+    uint16 samplesPerPixel = 0;
+    (void) TIFFGetFieldDefaulted(tif, TIFFTAG_SAMPLESPERPIXEL, &samplesPerPixel);
+
+    uint16 bitsPerSample = 0;
+    (void) TIFFGetFieldDefaulted(tif, TIFFTAG_BITSPERSAMPLE, &bitsPerSample);
+
+    uint16 extraSamples;
+    uint16* samplesInfo;
+    TIFFGetFieldDefaulted(tif, TIFFTAG_EXTRASAMPLES,
+                          &extraSamples, &samplesInfo);
+
+    uint16 photometric;
+    if (!TIFFGetField(tif, TIFFTAG_PHOTOMETRIC, &photometric))
     {
-        image->SetOption(wxIMAGE_OPTION_TIFF_COMPRESSION, compression);
+        photometric = PHOTOMETRIC_MINISWHITE;
     }
+    const bool hasAlpha = (extraSamples >= 1
+        && ((samplesInfo[0] == EXTRASAMPLE_UNSPECIFIED)
+            || samplesInfo[0] == EXTRASAMPLE_ASSOCALPHA
+            || samplesInfo[0] == EXTRASAMPLE_UNASSALPHA))
+        || (extraSamples == 0 && samplesPerPixel == 4
+            && photometric == PHOTOMETRIC_RGB);
 
-    // Set the resolution unit.
-    wxImageResolution resUnit = wxIMAGE_RESOLUTION_NONE;
-    uint16 tiffRes;
-    if ( TIFFGetFieldDefaulted(tif, TIFFTAG_RESOLUTIONUNIT, &tiffRes) )
+    // the images with grey and alpha samples are handled specially by
+    // LoadFile(), just use it for them as they're rare anyhow
+    char msg[1024] = "";
+    TIFFRGBAImage img;
+    if ( (samplesPerPixel == 2 && extraSamples == 1) ||
+            !TIFFRGBAImageOK(tif, msg) ||
+                !TIFFRGBAImageBegin(&img, tif, 0, msg) )
     {
-        switch (tiffRes)
-        {
-            default:
-                wxLogWarning(_("Unknown TIFF resolution unit %d ignored"),
-                    tiffRes);
-                // fall through
+        TIFFClose( tif );
 
-            case RESUNIT_NONE:
-                resUnit = wxIMAGE_RESOLUTION_NONE;
-                break;
+        if ( stream.SeekI(posOld) == wxInvalidOffset )
+            return false;
 
-            case RESUNIT_INCH:
-                resUnit = wxIMAGE_RESOLUTION_INCHES;
-                break;
+        return wxImageHandler::LoadRows(image, sink, stream, verbose, index);
+    }
 
-            case RESUNIT_CENTIMETER:
-                resUnit = wxIMAGE_RESOLUTION_CM;
-                break;
-        }
+    // decode the image by bands of the size of its strips (or tiles), which
+    // is the most efficient way of doing it, unless we need to flip it
+    // vertically in which case the entire image must be decoded at once
+    uint32 bandHeight = h;
+    if ( img.orientation == ORIENTATION_TOPLEFT )
+    {
+        if ( TIFFIsTiled(tif) )
+            TIFFGetField(tif, TIFFTAG_TILELENGTH, &bandHeight);
+        else
+            TIFFGetFieldDefaulted(tif, TIFFTAG_ROWSPERSTRIP, &bandHeight);
+
+        if ( bandHeight == 0 || bandHeight > h )
+            bandHeight = h;
     }
 
-    image->SetOption(wxIMAGE_OPTION_RESOLUTIONUNIT, resUnit);
+    img.req_orientation = ORIENTATION_TOPLEFT;
 
-    /*
-    Set the image resolution if it's available. Resolution tag is not
-    dependant on RESOLUTIONUNIT != RESUNIT_NONE (according to TIFF spec).
-    */
-    float resX, resY;
+    // guard against integer overflow as in LoadFile()
+    const double bytesNeeded = (double)w * (double)bandHeight * sizeof(uint32);
+    uint32 *raster = bytesNeeded < wxUINT32_MAX
+                        ? (uint32*) _TIFFmalloc( (uint32)bytesNeeded )
+                        : NULL;
+    unsigned char *rgb = (unsigned char *) _TIFFmalloc( w*4 );
 
-    if ( TIFFGetField(tif, TIFFTAG_XRESOLUTION, &resX) )
+    bool ok = raster && rgb && sink.Start(w, h, hasAlpha);
+    if ( !ok && (!raster || !rgb) && verbose )
     {
-        /*
-        Use a string value to not lose precision.
-        rounding to int as cm and then converting to inch may
-        result in whole integer rounding error, eg. 201 instead of 200 dpi.
-        If an app wants an int, GetOptionInt will convert and round down.
-        */
-        image->SetOption(wxIMAGE_OPTION_RESOLUTIONX,
-            wxString::FromCDouble((double) resX));
+        wxLogError( _("TIFF: Couldn't allocate memory.") );
     }
 
-    if ( TIFFGetField(tif, TIFFTAG_YRESOLUTION, &resY) )
+    unsigned char * const alpha = hasAlpha ? rgb + w*3 : NULL;
+
+    for ( uint32 y = 0; ok && y < h; y += bandHeight )
     {
-        image->SetOption(wxIMAGE_OPTION_RESOLUTIONY,
-            wxString::FromCDouble((double) resY));
+        const uint32 rows = wxMin(bandHeight, h - y);
+
+        img.row_offset = y;
+        if ( !TIFFRGBAImageGet(&img, raster, w, rows) )
+        {
+            if (verbose)
+            {
+                wxLogError( _("TIFF: Error reading image.") );
+            }
+
+            ok = false;
+            break;
+        }
+
+        const uint32 *pos = raster;
+        for ( uint32 i = 0; i < rows; i++ )
+        {
+            unsigned char *ptr = rgb;
+            for ( uint32 j = 0; j < w; j++, pos++ )
+            {
+                *(ptr++) = (unsigned char)TIFFGetR(*pos);
+                *(ptr++) = (unsigned char)TIFFGetG(*pos);
+                *(ptr++) = (unsigned char)TIFFGetB(*pos);
+                if ( hasAlpha )
+                    alpha[j] = (unsigned char)TIFFGetA(*pos);
+            }
+
+            if ( !sink.ProcessRow(y + i, rgb, alpha) )
+            {
+                ok = false;
+                break;
+            }
+        }
     }
 
-    _TIFFfree( raster );
+    if ( ok )
+        SetOptionsFromTIFF(image, tif, photometric, samplesPerPixel, bitsPerSample);
 
+    if ( rgb )
+        _TIFFfree( rgb );
+    if ( raster )
+        _TIFFfree( raster );
+    TIFFRGBAImageEnd( &img );
     TIFFClose( tif );
 
-    return true;
+    return ok;
 }
 
 int wxTIFFHandler::DoGetImageCount( wxInputStream& stream )
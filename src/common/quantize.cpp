@@ -40,6 +40,8 @@
 #if wxUSE_IMAGE
 
 #include "wx/quantize.h"
+#include "wx/scopedarray.h"
+#include "wx/private/imageband.h"
 
 #ifndef WX_PRECOMP
     #include "wx/palette.h"
@@ -50,6 +52,7 @@
     #include "wx/msw/private.h"
 #endif
 
+#include <limits.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -1444,6 +1447,537 @@ prepare_range_limit_table (j_decompress_ptr cinfo)
 
 
 
+/*
+ * Fast quantizer.
+ *
+ * This is an implementation of the colour quantization algorithm described in
+ *   Wu, Xiaolin.  "Efficient Statistical Computations for Optimal Color
+ *   Quantization", Graphics Gems II, pp. 126-133.
+ *
+ * The colour space is divided into 32*32*32 cells and the cumulative moments
+ * of the colours of the pixels falling into them are computed, which allows
+ * to compute the variance of the colours in any box of cells in constant
+ * time. The box containing all colours is then split in two along the plane
+ * minimizing the sum of the variances of the two parts and this is repeated
+ * for the box with the biggest variance until we have the desired number of
+ * boxes, whose mean colours form the palette.
+ *
+ * The pixels are then mapped to the palette using an inverse colour map with
+ * 64 levels per component, whose entries are only computed for the cells
+ * actually used by the image. Both computing the inverse map and remapping
+ * the image are done by several threads if wxImage::SetMaxThreads() allows
+ * it. Unlike the quantizer above, no dithering is done.
+ */
+
+namespace
+{
+
+// the number of bits per component used for the cells of the moments arrays
+const int WU_BITS = 5;
+
+// the size of the moments arrays along each axis: they have an extra zero
+// element at the beginning of each axis to simplify the computations
+const int WU_SIDE = (1 << WU_BITS) + 1;
+const int WU_SIZE = WU_SIDE*WU_SIDE*WU_SIDE;
+
+// the number of bits per component used for the inverse colour map cells
+const int INVMAP_BITS = 6;
+const int INVMAP_SIDE = 1 << INVMAP_BITS;
+const int INVMAP_SIZE = INVMAP_SIDE*INVMAP_SIDE*INVMAP_SIDE;
+
+inline int WuIndex(int r, int g, int b)
+{
+    return (r*WU_SIDE + g)*WU_SIDE + b;
+}
+
+inline int InvMapIndex(const unsigned char *rgb)
+{
+    return ((rgb[0] >> (8 - INVMAP_BITS)) << 2*INVMAP_BITS) |
+           ((rgb[1] >> (8 - INVMAP_BITS)) << INVMAP_BITS) |
+            (rgb[2] >> (8 - INVMAP_BITS));
+}
+
+// box of cells (lo, hi] along each of the R, G and B axis
+struct WuBox
+{
+    int lo[3],
+        hi[3];
+
+    int GetVolume() const
+    {
+        return (hi[0] - lo[0])*(hi[1] - lo[1])*(hi[2] - lo[2]);
+    }
+};
+
+// selects the palette colours
+class WuQuantizer
+{
+public:
+    WuQuantizer();
+
+    // accumulate the statistics of the given pixels and mark the inverse map
+    // cells used by them in the provided bitmap
+    void AddPixels(const unsigned char *rgb, unsigned count, unsigned char *used);
+
+    // fill the palette with at most maxColours colours and return their
+    // number
+    int ComputePalette(int maxColours, unsigned char *palette);
+
+private:
+    enum
+    {
+        Moment_Weight,
+        Moment_Red,
+        Moment_Green,
+        Moment_Blue,
+        Moment_Square,
+        Moment_Max
+    };
+
+    // convert the moments to the cumulative ones
+    void ComputeCumulativeMoments();
+
+    // return the sum of the given moment over the box
+    double Volume(const WuBox& box, int moment) const;
+
+    // return the variance of the colours in the box multiplied by its weight
+    double Variance(const WuBox& box) const;
+
+    // find the best position for cutting the box along the given axis
+    double Maximize(const WuBox& box, int axis, const double *whole, int *cut) const;
+
+    // split box into two parts, the second of which is stored in other,
+    // return false if it can't be split
+    bool Cut(WuBox& box, WuBox& other) const;
+
+
+    wxScopedArray<double> m_data;
+    double *m_moments[Moment_Max];
+
+    wxDECLARE_NO_COPY_CLASS(WuQuantizer);
+};
+
+WuQuantizer::WuQuantizer()
+    : m_data(new double[Moment_Max*WU_SIZE])
+{
+    memset(m_data.get(), 0, Moment_Max*WU_SIZE*sizeof(double));
+
+    for ( int n = 0; n < Moment_Max; n++ )
+        m_moments[n] = m_data.get() + n*WU_SIZE;
+}
+
+void WuQuantizer::AddPixels(const unsigned char *rgb,
+                            unsigned count,
+                            unsigned char *used)
+{
+    for ( unsigned n = 0; n < count; n++, rgb += 3 )
+    {
+        const int r = rgb[0],
+                  g = rgb[1],
+                  b = rgb[2];
+
+        const int ind = WuIndex((r >> (8 - WU_BITS)) + 1,
+                                (g >> (8 - WU_BITS)) + 1,
+                                (b >> (8 - WU_BITS)) + 1);
+        m_moments[Moment_Weight][ind] += 1;
+        m_moments[Moment_Red][ind] += r;
+        m_moments[Moment_Green][ind] += g;
+        m_moments[Moment_Blue][ind] += b;
+        m_moments[Moment_Square][ind] += r*r + g*g + b*b;
+
+        const int cell = InvMapIndex(rgb);
+        used[cell >> 3] |= 1 << (cell & 7);
+    }
+}
+
+void WuQuantizer::ComputeCumulativeMoments()
+{
+    for ( int n = 0; n < Moment_Max; n++ )
+    {
+        double * const m = m_moments[n];
+
+        for ( int r = 1; r < WU_SIDE; r++ )
+        {
+            double area[WU_SIDE] = { 0 };
+
+            for ( int g = 1; g < WU_SIDE; g++ )
+            {
+                double line = 0;
+
+                for ( int b = 1; b < WU_SIDE; b++ )
+                {
+                    const int ind = WuIndex(r, g, b);
+                    line += m[ind];
+                    area[b] += line;
+                    m[ind] = m[ind - WU_SIDE*WU_SIDE] + area[b];
+                }
+            }
+        }
+    }
+}
+
+double WuQuantizer::Volume(const WuBox& box, int moment) const
+{
+    const double * const m = m_moments[moment];
+
+    return m[WuIndex(box.hi[0], box.hi[1], box.hi[2])]
+         - m[WuIndex(box.hi[0], box.hi[1], box.lo[2])]
+         - m[WuIndex(box.hi[0], box.lo[1], box.hi[2])]
+         + m[WuIndex(box.hi[0], box.lo[1], box.lo[2])]
+         - m[WuIndex(box.lo[0], box.hi[1], box.hi[2])]
+         + m[WuIndex(box.lo[0], box.hi[1], box.lo[2])]
+         + m[WuIndex(box.lo[0], box.lo[1], box.hi[2])]
+         - m[WuIndex(box.lo[0], box.lo[1], box.lo[2])];
+}
+
+double WuQuantizer::Variance(const WuBox& box) const
+{
+    const double r = Volume(box, Moment_Red),
+                 g = Volume(box, Moment_Green),
+                 b = Volume(box, Moment_Blue);
+
+    return Volume(box, Moment_Square) -
+                (r*r + g*g + b*b)/Volume(box, Moment_Weight);
+}
+
+double WuQuantizer::Maximize(const WuBox& box,
+                             int axis,
+                             const double *whole,
+                             int *cut) const
+{
+    double best = 0;
+    *cut = -1;
+
+    WuBox half = box;
+    for ( int pos = box.lo[axis] + 1; pos < box.hi[axis]; pos++ )
+    {
+        half.hi[axis] = pos;
+
+        const double w = Volume(half, Moment_Weight);
+        const double wOther = whole[Moment_Weight] - w;
+        if ( w == 0 || wOther == 0 )
+            continue;
+
+        double value = 0;
+        for ( int n = Moment_Red; n <= Moment_Blue; n++ )
+        {
+            const double m = Volume(half, n);
+            const double mOther = whole[n] - m;
+            value += m*m/w + mOther*mOther/wOther;
+        }
+
+        if ( value > best )
+        {
+            best = value;
+            *cut = pos;
+        }
+    }
+
+    return best;
+}
+
+bool WuQuantizer::Cut(WuBox& box, WuBox& other) const
+{
+    double whole[Moment_Blue + 1];
+    for ( int n = Moment_Weight; n <= Moment_Blue; n++ )
+        whole[n] = Volume(box, n);
+
+    int bestAxis = -1,
+        bestCut = -1;
+    double best = 0;
+    for ( int axis = 0; axis < 3; axis++ )
+    {
+        int cut;
+        const double value = Maximize(box, axis, whole, &cut);
+        if ( cut != -1 && (bestAxis == -1 || value > best) )
+        {
+            best = value;
+            bestAxis = axis;
+            bestCut = cut;
+        }
+    }
+
+    if ( bestAxis == -1 )
+        return false;
+
+    other = box;
+    box.hi[bestAxis] =
+    other.lo[bestAxis] = bestCut;
+
+    return true;
+}
+
+int WuQuantizer::ComputePalette(int maxColours, unsigned char *palette)
+{
+    ComputeCumulativeMoments();
+
+    WuBox boxes[256];
+    double variances[256];
+
+    for ( int axis = 0; axis < 3; axis++ )
+    {
+        boxes[0].lo[axis] = 0;
+        boxes[0].hi[axis] = WU_SIDE - 1;
+    }
+
+    // always split the box with the biggest variance
+    int numBoxes = 1;
+    int next = 0;
+    while ( numBoxes < maxColours )
+    {
+        if ( Cut(boxes[next], boxes[numBoxes]) )
+        {
+            variances[next] = boxes[next].GetVolume() > 1
+                                ? Variance(boxes[next]) : 0;
+            variances[numBoxes] = boxes[numBoxes].GetVolume() > 1
+                                    ? Variance(boxes[numBoxes]) : 0;
+            numBoxes++;
+        }
+        else // this box can't be split any more
+        {
+            variances[next] = 0;
+        }
+
+        next = 0;
+        for ( int n = 1; n < numBoxes; n++ )
+        {
+            if ( variances[n] > variances[next] )
+                next = n;
+        }
+
+        if ( variances[next] <= 0 )
+            break;
+    }
+
+    for ( int n = 0; n < numBoxes; n++ )
+    {
+        const double weight = Volume(boxes[n], Moment_Weight);
+        for ( int c = 0; c < 3; c++ )
+        {
+            palette[3*n + c] = weight
+                ? (unsigned char)(Volume(boxes[n], Moment_Red + c)/weight + 0.5)
+                : 0;
+        }
+    }
+
+    return numBoxes;
+}
+
+// finds the nearest palette colour by looking at the colours sorted by their
+// green component outwards from the green value of the colour being searched
+class NearestColourFinder
+{
+public:
+    NearestColourFinder(const unsigned char *palette, int numColours)
+        : m_numColours(numColours)
+    {
+        for ( int n = 0; n < numColours; n++ )
+        {
+            m_colours[n].r = palette[3*n];
+            m_colours[n].g = palette[3*n + 1];
+            m_colours[n].b = palette[3*n + 2];
+            m_colours[n].index = (unsigned char)n;
+        }
+
+        qsort(m_colours, numColours, sizeof(Colour), CompareGreen);
+    }
+
+    unsigned char Find(int r, int g, int b) const
+    {
+        // find the first colour with green not less than ours
+        int lo = 0,
+            hi = m_numColours;
+        while ( lo < hi )
+        {
+            const int mid = (lo + hi)/2;
+            if ( m_colours[mid].g < g )
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+
+        int best = INT_MAX;
+        unsigned char index = 0;
+
+        // the colours are examined in both directions until the difference in
+        // green alone is bigger than the best distance found so far
+        for ( int up = lo, down = lo - 1; up < m_numColours || down >= 0; )
+        {
+            if ( up < m_numColours )
+            {
+                const Colour& c = m_colours[up++];
+                const int dg = c.g - g;
+                if ( dg*dg >= best )
+                {
+                    up = m_numColours;
+                }
+                else
+                {
+                    const int dist = Distance(c, r, g, b);
+                    if ( dist < best )
+                    {
+                        best = dist;
+                        index = c.index;
+                    }
+                }
+            }
+
+            if ( down >= 0 )
+            {
+                const Colour& c = m_colours[down--];
+                const int dg = c.g - g;
+                if ( dg*dg >= best )
+                {
+                    down = -1;
+                }
+                else
+                {
+                    const int dist = Distance(c, r, g, b);
+                    if ( dist < best )
+                    {
+                        best = dist;
+                        index = c.index;
+                    }
+                }
+            }
+        }
+
+        return index;
+    }
+
+private:
+    struct Colour
+    {
+        int r, g, b;
+        unsigned char index;
+    };
+
+    static int Distance(const Colour& c, int r, int g, int b)
+    {
+        return (c.r - r)*(c.r - r) + (c.g - g)*(c.g - g) + (c.b - b)*(c.b - b);
+    }
+
+    static int CompareGreen(const void *p1, const void *p2)
+    {
+        return static_cast<const Colour *>(p1)->g -
+                    static_cast<const Colour *>(p2)->g;
+    }
+
+    Colour m_colours[256];
+    const int m_numColours;
+
+    wxDECLARE_NO_COPY_CLASS(NearestColourFinder);
+};
+
+// computes the inverse colour map entries for the used cells: the items are
+// the planes of the map with the same red component
+class InverseMapProcessor : public wxImageBandProcessor
+{
+public:
+    InverseMapProcessor(const NearestColourFinder& finder,
+                        const unsigned char *used,
+                        unsigned char *map)
+        : m_finder(finder),
+          m_used(used),
+          m_map(map)
+    {
+    }
+
+protected:
+    virtual void ProcessBand(int from, int to)
+    {
+        // use the centre of the cell as its colour
+        static const int half = 1 << (7 - INVMAP_BITS);
+
+        for ( int cell = from*INVMAP_SIDE*INVMAP_SIDE;
+              cell < to*INVMAP_SIDE*INVMAP_SIDE;
+              cell++ )
+        {
+            if ( !(m_used[cell >> 3] & (1 << (cell & 7))) )
+                continue;
+
+            const int r = cell >> 2*INVMAP_BITS,
+                      g = (cell >> INVMAP_BITS) & (INVMAP_SIDE - 1),
+                      b = cell & (INVMAP_SIDE - 1);
+
+            m_map[cell] = m_finder.Find((r << (8 - INVMAP_BITS)) + half,
+                                        (g << (8 - INVMAP_BITS)) + half,
+                                        (b << (8 - INVMAP_BITS)) + half);
+        }
+    }
+
+private:
+    const NearestColourFinder& m_finder;
+    const unsigned char * const m_used;
+    unsigned char * const m_map;
+};
+
+// maps the rows of the image to the palette indices
+class RemapProcessor : public wxImageBandProcessor
+{
+public:
+    RemapProcessor(unsigned width,
+                   unsigned char **inRows,
+                   unsigned char **outRows,
+                   const unsigned char *map)
+        : m_width(width),
+          m_inRows(inRows),
+          m_outRows(outRows),
+          m_map(map)
+    {
+    }
+
+protected:
+    virtual void ProcessBand(int from, int to)
+    {
+        for ( int y = from; y < to; y++ )
+        {
+            const unsigned char *src = m_inRows[y];
+            unsigned char *dst = m_outRows[y];
+            for ( unsigned x = 0; x < m_width; x++, src += 3 )
+                *dst++ = m_map[InvMapIndex(src)];
+        }
+    }
+
+private:
+    const unsigned m_width;
+    unsigned char ** const m_inRows;
+    unsigned char ** const m_outRows;
+    const unsigned char * const m_map;
+};
+
+void DoQuantizeFast(unsigned w, unsigned h,
+                    unsigned char **in_rows, unsigned char **out_rows,
+                    unsigned char *palette, int desiredNoColours)
+{
+    if ( desiredNoColours > 256 )
+        desiredNoColours = 256;
+    else if ( desiredNoColours < 1 )
+        desiredNoColours = 1;
+
+    wxScopedArray<unsigned char> used(new unsigned char[INVMAP_SIZE/8]);
+    memset(used.get(), 0, INVMAP_SIZE/8);
+
+    WuQuantizer quantizer;
+    for ( unsigned y = 0; y < h; y++ )
+        quantizer.AddPixels(in_rows[y], w, used.get());
+
+    const int numColours = quantizer.ComputePalette(desiredNoColours, palette);
+
+    // the callers expect to always get the requested number of entries
+    memset(palette + 3*numColours, 0, 3*(desiredNoColours - numColours));
+
+    const NearestColourFinder finder(palette, numColours);
+
+    wxScopedArray<unsigned char> map(new unsigned char[INVMAP_SIZE]);
+    InverseMapProcessor(finder, used.get(), map.get()).
+        Process(INVMAP_SIDE, INVMAP_SIDE*INVMAP_SIDE);
+
+    RemapProcessor(w, in_rows, out_rows, map.get()).Process(h, w);
+}
+
+} // anonymous namespace
+
 /*
  * wxQuantize
  */
@@ -1451,8 +1985,14 @@ prepare_range_limit_table (j_decompress_ptr cinfo)
 IMPLEMENT_DYNAMIC_CLASS(wxQuantize, wxObject)
 
 void wxQuantize::DoQuantize(unsigned w, unsigned h, unsigned char **in_rows, unsigned char **out_rows,
-    unsigned char *palette, int desiredNoColours)
+    unsigned char *palette, int desiredNoColours, int flags)
 {
+    if ( flags & wxQUANTIZE_FAST )
+    {
+        DoQuantizeFast(w, h, in_rows, out_rows, palette, desiredNoColours);
+        return;
+    }
+
     j_decompress dec;
     my_cquantize_ptr cquantize;
 
@@ -1537,7 +2077,7 @@ bool wxQuantize::Quantize(const wxImage& src, wxImage& dest,
         outrows[i] = data8bit + w * i;
 
     //RGB->palette
-    DoQuantize(w, h, rows, outrows, palette, desiredNoColours);
+    DoQuantize(w, h, rows, outrows, palette, desiredNoColours, flags);
 
     delete[] rows;
     delete[] outrows;
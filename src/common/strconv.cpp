@@ -45,10 +45,13 @@
 #ifdef HAVE_ICONV
     #include <iconv.h>
     #include "wx/thread.h"
+    #include "wx/vector.h"
 #endif
 
 #include "wx/encconv.h"
 #include "wx/fontmap.h"
+#include "wx/private/encconv.h"
+#include "wx/private/utf8ops.h"
 
 #ifdef __DARWIN__
 #include "wx/osx/core/private/strconv_cf.h"
@@ -414,20 +417,137 @@ wxMBConv::~wxMBConv()
     // nothing to do here (necessary for Darwin linking probably)
 }
 
+namespace
+{
+
+// set the length of the buffer after converting len characters into it,
+// releasing the unused memory if there is a lot of it
+template <typename T>
+void ShrinkToConverted(wxCharTypeBuffer<T>& buf, size_t len)
+{
+    if ( len < buf.length() / 2 )
+        buf.extend(len);
+
+    buf.shrink(len);
+}
+
+} // anonymous namespace
+
+size_t
+wxMBConv::ToWCharBuffer(wxWCharBuffer& dst,
+                        const char *src, size_t srcLen) const
+{
+    if ( CanConvertInOnePass() )
+    {
+        // all the encodings we support, except for the ones using escape
+        // sequences for some characters, produce at most one wide character
+        // per byte, so try converting into a buffer of this size first
+        size_t srcBytes = srcLen;
+        if ( srcBytes == wxNO_LEN )
+        {
+            const size_t nulLen = GetMBNulLen();
+            if ( nulLen == wxCONV_FAILED )
+                return wxCONV_FAILED;
+
+            if ( nulLen == 1 )
+            {
+                srcBytes = strlen(src);
+            }
+            else
+            {
+                for ( srcBytes = 0;
+                      NotAllNULs(src + srcBytes, nulLen);
+                      srcBytes += nulLen )
+                    ;
+            }
+
+            srcBytes += nulLen;
+        }
+
+        wxWCharBuffer buf(srcBytes);
+        const size_t len = ToWChar(buf.data(), srcBytes, src, srcLen);
+        if ( len != wxCONV_FAILED )
+        {
+            ShrinkToConverted(buf, len);
+            dst = buf;
+            return len;
+        }
+    }
+
+    // either we can't convert in one pass or the conversion failed because
+    // the input is invalid or because we didn't allocate enough space for it,
+    // do it in the usual way to find out which and to convert it in the
+    // latter case
+    const size_t len = ToWChar(NULL, 0, src, srcLen);
+    if ( len == wxCONV_FAILED )
+        return wxCONV_FAILED;
+
+    wxWCharBuffer buf(len);
+    if ( ToWChar(buf.data(), len, src, srcLen) == wxCONV_FAILED )
+        return wxCONV_FAILED;
+
+    dst = buf;
+    return len;
+}
+
+size_t
+wxMBConv::FromWCharBuffer(wxCharBuffer& dst,
+                          const wchar_t *src, size_t srcLen) const
+{
+    const size_t nulLen = GetMBNulLen();
+    if ( nulLen == wxCONV_FAILED )
+        return wxCONV_FAILED;
+
+    const size_t srcChars = srcLen == wxNO_LEN ? wxWcslen(src) + 1 : srcLen;
+
+    // as above, 4 bytes per wide character are enough for all encodings
+    // except for the ones using escape sequences, so try this first, unless
+    // the string is so huge that this would overflow
+    static const size_t MAX_BYTES_PER_CHAR = 4;
+    if ( CanConvertInOnePass() &&
+            srcChars < ((size_t)-1 - nulLen) / MAX_BYTES_PER_CHAR )
+    {
+        const size_t dstLen = srcChars*MAX_BYTES_PER_CHAR;
+
+        // ensure that the buffer is always NUL-terminated by enough NULs for
+        // this encoding, even if the input is not, as in cWC2MB()
+        wxCharBuffer buf(dstLen + nulLen - 1);
+        const size_t len = FromWChar(buf.data(), dstLen, src, srcLen);
+        if ( len != wxCONV_FAILED )
+        {
+            ShrinkToConverted(buf, len + nulLen - 1);
+            memset(buf.data() + len, 0, nulLen);
+            buf.shrink(len);
+            dst = buf;
+            return len;
+        }
+    }
+
+    const size_t len = FromWChar(NULL, 0, src, srcLen);
+    if ( len == wxCONV_FAILED )
+        return wxCONV_FAILED;
+
+    wxCharBuffer buf(len + nulLen - 1);
+    memset(buf.data() + len, 0, nulLen);
+    if ( FromWChar(buf.data(), len, src, srcLen) == wxCONV_FAILED )
+        return wxCONV_FAILED;
+
+    buf.shrink(len);
+    dst = buf;
+    return len;
+}
+
 const wxWCharBuffer wxMBConv::cMB2WC(const char *psz) const
 {
     if ( psz )
     {
-        // calculate the length of the buffer needed first
-        const size_t nLen = ToWChar(NULL, 0, psz);
-        if ( nLen != wxCONV_FAILED )
+        wxWCharBuffer buf;
+        if ( ToWCharBuffer(buf, psz) != wxCONV_FAILED )
         {
-            // now do the actual conversion
-            wxWCharBuffer buf(nLen - 1 /* +1 added implicitly */);
-
-            // +1 for the trailing NULL
-            if ( ToWChar(buf.data(), nLen, psz) != wxCONV_FAILED )
-                return buf;
+            // for compatibility, the buffer length doesn't include the NUL
+            // we converted
+            buf.shrink(buf.length() - 1);
+            return buf;
         }
     }
 
@@ -438,12 +558,11 @@ const wxCharBuffer wxMBConv::cWC2MB(const wchar_t *pwz) const
 {
     if ( pwz )
     {
-        const size_t nLen = FromWChar(NULL, 0, pwz);
-        if ( nLen != wxCONV_FAILED )
+        wxCharBuffer buf;
+        if ( FromWCharBuffer(buf, pwz) != wxCONV_FAILED )
         {
-            wxCharBuffer buf(nLen - 1);
-            if ( FromWChar(buf.data(), nLen, pwz) != wxCONV_FAILED )
-                return buf;
+            buf.shrink(buf.length() - 1);
+            return buf;
         }
     }
 
@@ -453,31 +572,24 @@ const wxCharBuffer wxMBConv::cWC2MB(const wchar_t *pwz) const
 const wxWCharBuffer
 wxMBConv::cMB2WC(const char *inBuff, size_t inLen, size_t *outLen) const
 {
-    const size_t dstLen = ToWChar(NULL, 0, inBuff, inLen);
+    wxWCharBuffer wbuf;
+    const size_t dstLen = ToWCharBuffer(wbuf, inBuff, inLen);
     if ( dstLen != wxCONV_FAILED )
     {
-        // notice that we allocate space for dstLen+1 wide characters here
-        // because we want the buffer to always be NUL-terminated, even if the
-        // input isn't (as otherwise the caller has no way to know its length)
-        wxWCharBuffer wbuf(dstLen);
-        wbuf.data()[dstLen] = L'\0';
-        if ( ToWChar(wbuf.data(), dstLen, inBuff, inLen) != wxCONV_FAILED )
+        if ( outLen )
         {
-            if ( outLen )
-            {
-                *outLen = dstLen;
-
-                // we also need to handle NUL-terminated input strings
-                // specially: for them the output is the length of the string
-                // excluding the trailing NUL, however if we're asked to
-                // convert a specific number of characters we return the length
-                // of the resulting output even if it's NUL-terminated
-                if ( inLen == wxNO_LEN )
-                    (*outLen)--;
-            }
+            *outLen = dstLen;
 
-            return wbuf;
+            // we also need to handle NUL-terminated input strings
+            // specially: for them the output is the length of the string
+            // excluding the trailing NUL, however if we're asked to
+            // convert a specific number of characters we return the length
+            // of the resulting output even if it's NUL-terminated
+            if ( inLen == wxNO_LEN )
+                (*outLen)--;
         }
+
+        return wbuf;
     }
 
     if ( outLen )
@@ -489,31 +601,23 @@ wxMBConv::cMB2WC(const char *inBuff, size_t inLen, size_t *outLen) const
 const wxCharBuffer
 wxMBConv::cWC2MB(const wchar_t *inBuff, size_t inLen, size_t *outLen) const
 {
-    size_t dstLen = FromWChar(NULL, 0, inBuff, inLen);
+    wxCharBuffer buf;
+    const size_t dstLen = FromWCharBuffer(buf, inBuff, inLen);
     if ( dstLen != wxCONV_FAILED )
     {
-        const size_t nulLen = GetMBNulLen();
-
-        // as above, ensure that the buffer is always NUL-terminated, even if
-        // the input is not
-        wxCharBuffer buf(dstLen + nulLen - 1);
-        memset(buf.data() + dstLen, 0, nulLen);
-        if ( FromWChar(buf.data(), dstLen, inBuff, inLen) != wxCONV_FAILED )
+        if ( outLen )
         {
-            if ( outLen )
-            {
-                *outLen = dstLen;
+            *outLen = dstLen;
 
-                if ( inLen == wxNO_LEN )
-                {
-                    // in this case both input and output are NUL-terminated
-                    // and we're not supposed to count NUL
-                    *outLen -= nulLen;
-                }
+            if ( inLen == wxNO_LEN )
+            {
+                // in this case both input and output are NUL-terminated
+                // and we're not supposed to count NUL
+                *outLen -= GetMBNulLen();
             }
-
-            return buf;
         }
+
+        return buf;
     }
 
     if ( outLen )
@@ -527,14 +631,9 @@ const wxWCharBuffer wxMBConv::cMB2WC(const wxScopedCharBuffer& buf) const
     const size_t srcLen = buf.length();
     if ( srcLen )
     {
-        const size_t dstLen = ToWChar(NULL, 0, buf, srcLen);
-        if ( dstLen != wxCONV_FAILED )
-        {
-            wxWCharBuffer wbuf(dstLen);
-            wbuf.data()[dstLen] = L'\0';
-            if ( ToWChar(wbuf.data(), dstLen, buf, srcLen) != wxCONV_FAILED )
-                return wbuf;
-        }
+        wxWCharBuffer wbuf;
+        if ( ToWCharBuffer(wbuf, buf, srcLen) != wxCONV_FAILED )
+            return wbuf;
     }
 
     return wxScopedWCharBuffer::CreateNonOwned(L"", 0);
@@ -545,14 +644,9 @@ const wxCharBuffer wxMBConv::cWC2MB(const wxScopedWCharBuffer& wbuf) const
     const size_t srcLen = wbuf.length();
     if ( srcLen )
     {
-        const size_t dstLen = FromWChar(NULL, 0, wbuf, srcLen);
-        if ( dstLen != wxCONV_FAILED )
-        {
-            wxCharBuffer buf(dstLen);
-            buf.data()[dstLen] = '\0';
-            if ( FromWChar(buf.data(), dstLen, wbuf, srcLen) != wxCONV_FAILED )
-                return buf;
-        }
+        wxCharBuffer buf;
+        if ( FromWCharBuffer(buf, wbuf, srcLen) != wxCONV_FAILED )
+            return buf;
     }
 
     return wxScopedCharBuffer::CreateNonOwned("", 0);
@@ -1023,16 +1117,62 @@ wxMBConvStrictUTF8::ToWChar(wchar_t *dst, size_t dstLen,
 
         if ( c < 0x80 )
         {
-            if ( srcLen == 0 ) // the test works for wxNO_LEN too
-                break;
+            // ASCII characters are by far the most common ones, so convert
+            // the entire run of them starting with this one at once, which
+            // is much faster than doing it character by character (notice
+            // that srcLen can't be wxNO_LEN here any more)
+            size_t n = srcLen;
+            if ( out && n > dstLen + 1 )
+                n = dstLen + 1;
 
-            if ( srcLen != wxNO_LEN )
-                srcLen--;
+            if ( n > 1 && (p[1] & 0x80) )
+                n = 1; // don't bother with a single ASCII character
+
+            if ( n == 1 )
+            {
+                if ( out )
+                    *out = c;
+            }
+            else
+            {
+                n = wxUtf8Ops::AsciiToWChar(out, p, n);
+            }
 
-            code = c;
+            if ( out )
+            {
+                out += n;
+                dstLen -= n - 1;
+            }
+
+            srcLen -= n;
+            written += n;
+            p += n - 1;
+
+            continue;
         }
         else
         {
+            // try to convert the entire block of text starting with this
+            // character at once too, this only fails for the text near the
+            // end of the string or not valid according to RFC 3629
+            size_t nOut;
+            const size_t n = wxUtf8Ops::ToWChar(out, out ? dstLen + 1 : 0,
+                                                p, srcLen, nOut);
+            if ( n )
+            {
+                if ( out )
+                {
+                    out += nOut;
+                    dstLen -= nOut - 1;
+                }
+
+                srcLen -= n;
+                written += nOut;
+                p += n - 1;
+
+                continue;
+            }
+
             unsigned len = tableUtf8Lengths[c];
             if ( !len )
                 break;
@@ -1113,30 +1253,60 @@ wxMBConvStrictUTF8::FromWChar(char *dst, size_t dstLen,
     char *out = dstLen ? dst : NULL;
     size_t written = 0;
 
+    // this allows to use the fast path below for NUL-terminated strings too
+    if ( srcLen == wxNO_LEN )
+        srcLen = wxWcslen(src) + 1;
+
     for ( const wchar_t *wp = src; ; wp++ )
     {
-        if ( (srcLen == wxNO_LEN ? !*wp : !srcLen) )
+        if ( !srcLen )
+            return written;
+
+        if ( (wxUint32)*wp < 0x80 )
         {
-            // all done successfully, just add the trailing NULL if we are not
-            // using explicit length
-            if ( srcLen == wxNO_LEN )
+            // as in ToWChar(), convert the entire run of ASCII characters
+            size_t n = srcLen;
+            if ( out && n > dstLen )
             {
-                if ( out )
-                {
-                    if ( !dstLen )
-                        break;
+                n = dstLen;
+                if ( !n )
+                    break;
+            }
 
-                    *out = '\0';
-                }
+            n = wxUtf8Ops::WCharToAscii(out, wp, n);
 
-                written++;
+            if ( out )
+            {
+                out += n;
+                dstLen -= n;
             }
 
-            return written;
+            srcLen -= n;
+            written += n;
+            wp += n - 1;
+
+            continue;
+        }
+
+        // and the same for the blocks of non-ASCII characters
+        size_t nOut;
+        const size_t n = wxUtf8Ops::FromWChar(out, dstLen, wp, srcLen, nOut);
+        if ( n )
+        {
+            if ( out )
+            {
+                out += nOut;
+                dstLen -= nOut;
+            }
+
+            srcLen -= n;
+            written += nOut;
+            wp += n - 1;
+
+            continue;
         }
 
-        if ( srcLen != wxNO_LEN )
-            srcLen--;
+        srcLen--;
 
         wxUint32 code;
 #ifdef WC_UTF16
@@ -2102,6 +2272,132 @@ wxMBConvUTF32swap::FromWChar(char *dst, size_t dstLen,
     #error "Unknown sizeof(wchar_t): please report this to wx-dev@lists.wxwindows.org"
 #endif
 
+#if wxUSE_THREADS
+
+// ----------------------------------------------------------------------------
+// wxIconvHandleLocker: provides exclusive access to an iconv handle
+// ----------------------------------------------------------------------------
+
+// iconv() is MT-safe, but each thread must use its own iconv_t handle.
+// Unfortunately there are a couple of global wxCSConv objects such as
+// wxConvLocal that are used all over wx code, so we have to make sure a handle
+// is used by at most one thread at the time. Instead of serializing all the
+// conversions using the same object, we use the main handle if it's free and
+// a spare one otherwise, opening a new spare handle if all of them are
+// currently used by the other threads. This allows the conversions to run in
+// parallel, which is important for the applications processing text in
+// several threads.
+class wxIconvHandlePool
+{
+public:
+    wxIconvHandlePool() { }
+
+    ~wxIconvHandlePool()
+    {
+        for ( size_t n = 0; n < m_spare.size(); n++ )
+            iconv_close(m_spare[n]);
+    }
+
+    // must be called before using GetSpare() to specify the arguments to use
+    // for opening the new handles
+    void Init(const char *tocode, const char *fromcode)
+    {
+        m_tocode = tocode;
+        m_fromcode = fromcode;
+    }
+
+    wxMutex& GetMainMutex() { return m_mutexMain; }
+
+    // return a free spare handle, opening a new one if there are none, or
+    // ICONV_T_INVALID if this failed
+    iconv_t GetSpare()
+    {
+        {
+            wxMutexLocker lock(m_mutexSpare);
+            if ( !m_spare.empty() )
+            {
+                const iconv_t handle = m_spare.back();
+                m_spare.pop_back();
+                return handle;
+            }
+        }
+
+        return iconv_open(m_tocode, m_fromcode);
+    }
+
+    // give back the handle returned by GetSpare() to the pool
+    void PutSpare(iconv_t handle)
+    {
+        wxMutexLocker lock(m_mutexSpare);
+        m_spare.push_back(handle);
+    }
+
+private:
+    // the encodings to convert from and to
+    wxCharBuffer m_tocode,
+                 m_fromcode;
+
+    // protects the main handle stored in wxMBConv_iconv itself
+    wxMutex m_mutexMain;
+
+    // protects m_spare
+    wxMutex m_mutexSpare;
+
+    // the handles not used by any thread right now
+    wxVector<iconv_t> m_spare;
+
+    wxDECLARE_NO_COPY_CLASS(wxIconvHandlePool);
+};
+
+class wxIconvHandleLocker
+{
+public:
+    // the pool stores the spare handles for the same conversion as the main
+    // handle passed to this ctor
+    wxIconvHandleLocker(wxIconvHandlePool& pool, iconv_t handle)
+        : m_pool(pool)
+    {
+        if ( m_pool.GetMainMutex().TryLock() == wxMUTEX_NO_ERROR )
+        {
+            m_handle = handle;
+            m_isMain = true;
+            return;
+        }
+
+        m_handle = m_pool.GetSpare();
+        if ( m_handle != ICONV_T_INVALID )
+        {
+            m_isMain = false;
+            return;
+        }
+
+        // if we failed to open a new handle, wait until the main one becomes
+        // available
+        m_pool.GetMainMutex().Lock();
+        m_handle = handle;
+        m_isMain = true;
+    }
+
+    ~wxIconvHandleLocker()
+    {
+        if ( m_isMain )
+            m_pool.GetMainMutex().Unlock();
+        else
+            m_pool.PutSpare(m_handle);
+    }
+
+    operator iconv_t() const { return m_handle; }
+
+private:
+    wxIconvHandlePool& m_pool;
+    iconv_t m_handle;
+    bool m_isMain;
+
+    wxDECLARE_NO_COPY_CLASS(wxIconvHandleLocker);
+};
+
+#endif // wxUSE_THREADS
+
 // ----------------------------------------------------------------------------
 // wxMBConv_iconv: encapsulates an iconv character set
 // ----------------------------------------------------------------------------
@@ -2123,6 +2419,10 @@ public:
     virtual bool IsUTF8() const;
 #endif
 
+    // iconv() fails with E2BIG if the output buffer is too small and we reset
+    // the conversion state in this case
+    virtual bool CanConvertInOnePass() const { return true; }
+
     virtual wxMBConv *Clone() const
     {
         wxMBConv_iconv *p = new wxMBConv_iconv(m_name);
@@ -2140,8 +2440,10 @@ protected:
             w2m;
 
 #if wxUSE_THREADS
-    // guards access to m2w and w2m objects
-    wxMutex m_iconvMutex;
+    // guard access to m2w and w2m objects and store the extra handles used
+    // when they are in use by another thread
+    wxIconvHandlePool m_m2wPool,
+                      m_w2mPool;
 #endif
 
 private:
@@ -2291,6 +2593,12 @@ wxMBConv_iconv::wxMBConv_iconv(const char *name)
                        wxT("\"%s\" -> \"%s\" works but not the converse!?"),
                        ms_wcCharsetName.c_str(), name);
         }
+
+#if wxUSE_THREADS
+        const wxCharBuffer nameWC(ms_wcCharsetName.ToAscii());
+        m_m2wPool.Init(nameWC, name);
+        m_w2mPool.Init(name, nameWC);
+#endif // wxUSE_THREADS
     }
 }
 
@@ -2346,13 +2654,12 @@ wxMBConv_iconv::ToWChar(wchar_t *dst, size_t dstLen,
     dstLen *= SIZEOF_WCHAR_T;
 
 #if wxUSE_THREADS
-    // NB: iconv() is MT-safe, but each thread must use its own iconv_t handle.
-    //     Unfortunately there are a couple of global wxCSConv objects such as
-    //     wxConvLocal that are used all over wx code, so we have to make sure
-    //     the handle is used by at most one thread at the time. Otherwise
-    //     only a few wx classes would be safe to use from non-main threads
-    //     as MB<->WC conversion would fail "randomly".
-    wxMutexLocker lock(wxConstCast(this, wxMBConv_iconv)->m_iconvMutex);
+    // NB: iconv() is MT-safe, but each thread must use its own iconv_t handle,
+    //     see wxIconvHandlePool
+    wxIconvHandleLocker handle(wxConstCast(this, wxMBConv_iconv)->m_m2wPool,
+                               m2w);
+#else
+    const iconv_t handle = m2w;
 #endif // wxUSE_THREADS
 
     size_t res, cres;
@@ -2364,7 +2671,7 @@ wxMBConv_iconv::ToWChar(wchar_t *dst, size_t dstLen,
 
         // have destination buffer, convert there
         size_t dstLenOrig = dstLen;
-        cres = iconv(m2w,
+        cres = iconv(handle,
                      ICONV_CHAR_CAST(&pszPtr), &srcLen,
                      &bufPtr, &dstLen);
 
@@ -2390,7 +2697,7 @@ wxMBConv_iconv::ToWChar(wchar_t *dst, size_t dstLen,
             char* bufPtr = (char*)tbuf;
             dstLen = 8 * SIZEOF_WCHAR_T;
 
-            cres = iconv(m2w,
+            cres = iconv(handle,
                          ICONV_CHAR_CAST(&pszPtr), &srcLen,
                          &bufPtr, &dstLen );
 
@@ -2401,6 +2708,10 @@ wxMBConv_iconv::ToWChar(wchar_t *dst, size_t dstLen,
 
     if (ICONV_FAILED(cres, srcLen))
     {
+        // don't leave the handle in the middle of a shift sequence, it could
+        // break the next conversion done using it
+        iconv(handle, NULL, NULL, NULL, NULL);
+
         //VS: it is ok if iconv fails, hence trace only
         wxLogTrace(TRACE_STRCONV, wxT("iconv failed: %s"), wxSysErrorMsg(wxSysErrorCode()));
         return wxCONV_FAILED;
@@ -2413,8 +2724,11 @@ size_t wxMBConv_iconv::FromWChar(char *dst, size_t dstLen,
                                  const wchar_t *src, size_t srcLen) const
 {
 #if wxUSE_THREADS
-    // NB: explained in MB2WC
-    wxMutexLocker lock(wxConstCast(this, wxMBConv_iconv)->m_iconvMutex);
+    // NB: explained in ToWChar()
+    wxIconvHandleLocker handle(wxConstCast(this, wxMBConv_iconv)->m_w2mPool,
+                               w2m);
+#else
+    const iconv_t handle = w2m;
 #endif
 
     if ( srcLen == wxNO_LEN )
@@ -2442,7 +2756,7 @@ size_t wxMBConv_iconv::FromWChar(char *dst, size_t dstLen,
     if ( dst )
     {
         // have destination buffer, convert there
-        cres = iconv(w2m, ICONV_CHAR_CAST(&inbuf), &inbuflen, &dst, &outbuflen);
+        cres = iconv(handle, ICONV_CHAR_CAST(&inbuf), &inbuflen, &dst, &outbuflen);
 
         res = dstLen - outbuflen;
     }
@@ -2456,7 +2770,7 @@ size_t wxMBConv_iconv::FromWChar(char *dst, size_t dstLen,
             dst = tbuf;
             outbuflen = WXSIZEOF(tbuf);
 
-            cres = iconv(w2m, ICONV_CHAR_CAST(&inbuf), &inbuflen, &dst, &outbuflen);
+            cres = iconv(handle, ICONV_CHAR_CAST(&inbuf), &inbuflen, &dst, &outbuflen);
 
             res += WXSIZEOF(tbuf) - outbuflen;
         }
@@ -2470,6 +2784,8 @@ size_t wxMBConv_iconv::FromWChar(char *dst, size_t dstLen,
 
     if (ICONV_FAILED(cres, inbuflen))
     {
+        iconv(handle, NULL, NULL, NULL, NULL);
+
         wxLogTrace(TRACE_STRCONV, wxT("iconv failed: %s"), wxSysErrorMsg(wxSysErrorCode()));
         return wxCONV_FAILED;
     }
@@ -2484,8 +2800,10 @@ size_t wxMBConv_iconv::GetMBNulLen() const
         wxMBConv_iconv * const self = wxConstCast(this, wxMBConv_iconv);
 
 #if wxUSE_THREADS
-        // NB: explained in MB2WC
-        wxMutexLocker lock(self->m_iconvMutex);
+        // NB: explained in ToWChar()
+        wxIconvHandleLocker handle(self->m_w2mPool, w2m);
+#else
+        const iconv_t handle = w2m;
 #endif
 
         const wchar_t *wnul = L"";
@@ -2494,7 +2812,7 @@ size_t wxMBConv_iconv::GetMBNulLen() const
                outLen = WXSIZEOF(buf);
         char *inBuff = (char *)wnul;
         char *outBuff = buf;
-        if ( iconv(w2m, ICONV_CHAR_CAST(&inBuff), &inLen, &outBuff, &outLen) == (size_t)-1 )
+        if ( iconv(handle, ICONV_CHAR_CAST(&inBuff), &inLen, &outBuff, &outLen) == (size_t)-1 )
         {
             self->m_minMBCharWidth = (size_t)-1;
         }
@@ -2842,26 +3160,58 @@ private:
 
 
 // ============================================================================
-// wxEncodingConverter based conversion classes
+// Table-driven conversion class for single byte encodings
 // ============================================================================
 
 #if wxUSE_FONTMAP
 
+struct wxMBConvCharItem
+{
+    wxUint16 u;
+    unsigned char c;
+};
+
+extern "C"
+{
+static int wxCMPFUNC_CONV
+CompareMBConvCharItems(const void *i1, const void *i2)
+{
+    return static_cast<const wxMBConvCharItem *>(i1)->u -
+                static_cast<const wxMBConvCharItem *>(i2)->u;
+}
+}
+
 class wxMBConv_wxwin : public wxMBConv
 {
 private:
     void Init()
     {
-        // Refuse to use broken wxEncodingConverter code for Mac-specific encodings.
-        // The wxMBConv_cf class does a better job.
-        m_ok = (m_enc < wxFONTENCODING_MACMIN || m_enc > wxFONTENCODING_MACMAX) &&
-               m2w.Init(m_enc, wxFONTENCODING_UNICODE) &&
-               w2m.Init(wxFONTENCODING_UNICODE, m_enc);
+        // Don't use the tables for Mac-specific encodings, the wxMBConv_cf
+        // class does a better job for them.
+        m_toUnicode = m_enc < wxFONTENCODING_MACMIN || m_enc > wxFONTENCODING_MACMAX
+                        ? wxGetEncodingTable(m_enc)
+                        : NULL;
+        if ( !m_toUnicode )
+            return;
+
+        // build the reverse table sorted by the Unicode values for FromWChar(),
+        // omitting the characters not defined in this encoding
+        m_fromUnicodeCount = 0;
+        for ( unsigned n = 0; n < 128; n++ )
+        {
+            if ( m_toUnicode[n] )
+            {
+                m_fromUnicode[m_fromUnicodeCount].u = m_toUnicode[n];
+                m_fromUnicode[m_fromUnicodeCount].c = (unsigned char)(128 + n);
+                m_fromUnicodeCount++;
+            }
+        }
+
+        qsort(m_fromUnicode, m_fromUnicodeCount, sizeof(wxMBConvCharItem),
+              CompareMBConvCharItems);
     }
 
 public:
-    // temporarily just use wxEncodingConverter stuff,
-    // so that it works while a better implementation is built
     wxMBConv_wxwin(const char* name)
     {
         if (name)
@@ -2879,57 +3229,119 @@ public:
         Init();
     }
 
-    size_t MB2WC(wchar_t *buf, const char *psz, size_t WXUNUSED(n)) const
+    virtual size_t ToWChar(wchar_t *dst, size_t dstLen,
+                           const char *src, size_t srcLen = wxNO_LEN) const
     {
-        size_t inbuf = strlen(psz);
-        if (buf)
-        {
-            if (!m2w.Convert(psz, buf))
-                return wxCONV_FAILED;
-        }
-        return inbuf;
-    }
+        if ( srcLen == wxNO_LEN )
+            srcLen = strlen(src) + 1;
 
-    size_t WC2MB(char *buf, const wchar_t *psz, size_t WXUNUSED(n)) const
-    {
-        const size_t inbuf = wxWcslen(psz);
-        if (buf)
+        // each character is encoded by exactly one byte
+        if ( dst && dstLen < srcLen )
+            return wxCONV_FAILED;
+
+        for ( size_t n = 0; n < srcLen; )
         {
-            if (!w2m.Convert(psz, buf))
+            const unsigned char c = src[n];
+            if ( c < 0x80 )
+            {
+                // ASCII characters are the same in all the supported
+                // encodings, so convert the entire run of them at once unless
+                // it's just a single character, e.g. a space between words
+                if ( n + 1 < srcLen && (src[n + 1] & 0x80) )
+                {
+                    if ( dst )
+                        dst[n] = c;
+                    n++;
+                }
+                else
+                {
+                    n += wxUtf8Ops::AsciiToWChar(dst ? dst + n : NULL,
+                                                 src + n, srcLen - n);
+                }
+
+                continue;
+            }
+
+            const wxUint16 wc = m_toUnicode[c - 128];
+            if ( !wc )
                 return wxCONV_FAILED;
+
+            if ( dst )
+                dst[n] = wc;
+            n++;
         }
 
-        return inbuf;
+        return srcLen;
     }
 
-    virtual size_t GetMBNulLen() const
+    virtual size_t FromWChar(char *dst, size_t dstLen,
+                             const wchar_t *src, size_t srcLen = wxNO_LEN) const
     {
-        switch ( m_enc )
+        if ( srcLen == wxNO_LEN )
+            srcLen = wxWcslen(src) + 1;
+
+        if ( dst && dstLen < srcLen )
+            return wxCONV_FAILED;
+
+        for ( size_t n = 0; n < srcLen; )
         {
-            case wxFONTENCODING_UTF16BE:
-            case wxFONTENCODING_UTF16LE:
-                return 2;
+            const wxUint32 wc = src[n];
+            if ( wc < 0x80 )
+            {
+                if ( n + 1 < srcLen && (wxUint32)src[n + 1] >= 0x80 )
+                {
+                    if ( dst )
+                        dst[n] = (char)wc;
+                    n++;
+                }
+                else
+                {
+                    n += wxUtf8Ops::WCharToAscii(dst ? dst + n : NULL,
+                                                 src + n, srcLen - n);
+                }
 
-            case wxFONTENCODING_UTF32BE:
-            case wxFONTENCODING_UTF32LE:
-                return 4;
+                continue;
+            }
 
-            default:
-                return 1;
+            // binary search for this character in the reverse table
+            size_t lo = 0,
+                   hi = m_fromUnicodeCount;
+            while ( lo < hi )
+            {
+                const size_t mid = (lo + hi) / 2;
+                if ( m_fromUnicode[mid].u < wc )
+                    lo = mid + 1;
+                else
+                    hi = mid;
+            }
+
+            if ( lo == m_fromUnicodeCount || m_fromUnicode[lo].u != wc )
+                return wxCONV_FAILED;
+
+            if ( dst )
+                dst[n] = (char)m_fromUnicode[lo].c;
+            n++;
         }
+
+        return srcLen;
     }
 
+    virtual bool CanConvertInOnePass() const { return true; }
+
     virtual wxMBConv *Clone() const { return new wxMBConv_wxwin(m_enc); }
 
-    bool IsOk() const { return m_ok; }
+    bool IsOk() const { return m_toUnicode != NULL; }
 
-public:
+private:
     wxFontEncoding m_enc;
-    wxEncodingConverter m2w, w2m;
 
-private:
-    // were we initialized successfully?
-    bool m_ok;
+    // the table for the characters 128..255, ASCII ones are mapped to
+    // themselves
+    const wxUint16 *m_toUnicode;
+
+    // the reverse table containing m_fromUnicodeCount elements
+    wxMBConvCharItem m_fromUnicode[128];
+    unsigned m_fromUnicodeCount;
 
     wxDECLARE_NO_COPY_CLASS(wxMBConv_wxwin);
 };
@@ -3097,12 +3509,56 @@ wxMBConv *wxCSConv::DoCreate() const
     }
 
     // we trust OS to do conversion better than we can so try external
-    // conversion methods first
+    // conversion methods first, except for the single byte encodings for which
+    // we have exact tables when using iconv: converting using them is much
+    // faster, notably because it doesn't require serializing the accesses to
+    // the iconv conversion object from different threads
     //
     // the full order is:
+    //      0. table-driven conversion for single byte encodings (only if the
+    //         OS conversion would use iconv)
     //      1. OS conversion (iconv() under Unix or Win32 API)
     //      2. hard coded conversions for UTF
-    //      3. wxEncodingConverter as fall back
+    //      3. table-driven conversion for the charsets known only to the
+    //         font mapper as fall back
+
+    // step (0)
+#if wxUSE_FONTMAP && !defined(wxHAVE_WIN32_MB2WC) && !defined(__DARWIN__)
+    {
+        // notice that we don't use CharsetToEncoding() here as it can use
+        // the config and so is too heavyweight to be called for every
+        // conversion object creation
+        wxFontEncoding encoding = m_encoding;
+        if ( encoding == wxFONTENCODING_SYSTEM && m_name )
+            encoding = wxFontMapperBase::GetEncodingFromName(m_name);
+
+        switch ( encoding )
+        {
+            case wxFONTENCODING_SYSTEM:
+            case wxFONTENCODING_MAX:
+            // our tables for these encodings don't match the current versions
+            // of the standard mappings (e.g. they lack the euro sign in
+            // ISO-8859-7), so let the OS convert them
+            case wxFONTENCODING_ISO8859_7:
+            case wxFONTENCODING_ISO8859_8:
+            case wxFONTENCODING_KOI8_U:
+            // and glibc iconv composes the Hebrew points with the preceding
+            // letters in this one, e.g. "\xe0\xe1\xe9\xcc" is converted to
+            // U+05D0 U+05D1 U+FB39, which the tables can't do
+            case wxFONTENCODING_CP1255:
+                break;
+
+            default:
+            {
+                wxMBConv_wxwin *conv = new wxMBConv_wxwin(encoding);
+                if ( conv->IsOk() )
+                    return conv;
+
+                delete conv;
+            }
+        }
+    }
+#endif // wxUSE_FONTMAP && !wxHAVE_WIN32_MB2WC && !__DARWIN__
 
     // step (1)
 #ifdef HAVE_ICONV
@@ -3354,6 +3810,15 @@ bool wxCSConv::IsUTF8() const
 }
 #endif
 
+bool wxCSConv::CanConvertInOnePass() const
+{
+    if ( m_convReal )
+        return m_convReal->CanConvertInOnePass();
+
+    // otherwise, we are ISO-8859-1 and check the output length correctly
+    return true;
+}
+
 
 #if wxUSE_UNICODE
 
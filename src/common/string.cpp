@@ -37,6 +37,7 @@
 #include <string.h>
 #include <stdlib.h>
 
+#include "wx/atomic.h"
 #include "wx/hashmap.h"
 #include "wx/vector.h"
 #include "wx/xlocale.h"
@@ -176,6 +177,12 @@ struct wxStrCacheStatsDumper
             printf("\tNumber of calls to length(): %u, hits=%.2f%%\n",
                    stats.lentot, 100.*float(stats.lenhits)/stats.lentot);
         }
+
+        if ( stats.idxhits )
+        {
+            printf("\tCalls to PosToImpl() using the index: %u\n",
+                   stats.idxhits);
+        }
     }
 };
 
@@ -267,6 +274,20 @@ void wxString::PosLenToImpl(size_t pos, size_t len,
         {
             *implLen = npos;
         }
+#if wxUSE_STRING_POS_INDEX
+        // using the index is only worth it if the substring is long enough,
+        // otherwise scanning it is faster
+        else if ( len > wxStringPosIndex::STEP && GetPosIndex() )
+        {
+            const wxStringPosIndex * const index = GetPosIndex();
+            const size_t lenStr = index->GetLength();
+            const size_t posEnd = pos < lenStr && len < lenStr - pos
+                                    ? pos + len
+                                    : lenStr;
+
+            *implLen = index->PosToImpl(m_impl, posEnd) - *implPos;
+        }
+#endif // wxUSE_STRING_POS_INDEX
         else // have valid length too
         {
             // we need to handle the case of length specifying a substring
@@ -284,6 +305,117 @@ void wxString::PosLenToImpl(size_t pos, size_t len,
     }
 }
 
+#if wxUSE_STRING_POS_INDEX
+
+// ----------------------------------------------------------------------------
+// wxStringPosIndex
+// ----------------------------------------------------------------------------
+
+wxStringPosIndex::wxStringPosIndex(const wxStringImpl& str)
+{
+    const char * const start = str.data();
+    const size_t lenImpl = str.length();
+
+    // we can count the characters by counting their lead bytes, i.e. all
+    // bytes except the continuation ones (10xxxxxx), as the string is valid
+    // UTF-8
+    m_length = 0;
+    for ( size_t n = 0; n < lenImpl; n++ )
+    {
+        if ( (start[n] & 0xC0) != 0x80 )
+            m_length++;
+    }
+
+    if ( m_length == lenImpl )
+    {
+        // no need for the index at all
+        m_offsets = NULL;
+        m_count = 0;
+        return;
+    }
+
+    m_count = m_length / STEP + 1;
+    m_offsets = new size_t[m_count];
+
+    size_t pos = 0,
+           count = 0;
+    for ( size_t n = 0; n < lenImpl; n++ )
+    {
+        if ( (start[n] & 0xC0) == 0x80 )
+            continue;
+
+        if ( pos++ % STEP == 0 )
+            m_offsets[count++] = n;
+    }
+
+    // if the length is a multiple of STEP, the last element corresponds to
+    // the end of the string
+    if ( count < m_count )
+        m_offsets[count] = lenImpl;
+}
+
+size_t wxStringPosIndex::PosToImpl(const wxStringImpl& str, size_t pos) const
+{
+    if ( pos >= m_length )
+        return str.length();
+
+    if ( !m_offsets )
+        return pos;
+
+    const char * const start = str.data();
+    const char *p = start + m_offsets[pos / STEP];
+    for ( size_t n = pos % STEP; n; n-- )
+        wxStringOperations::IncIter(p);
+
+    return p - start;
+}
+
+size_t wxStringPosIndex::PosFromImpl(const wxStringImpl& str, size_t impl) const
+{
+    if ( impl >= str.length() )
+        return m_length;
+
+    if ( !m_offsets )
+        return impl;
+
+    // find the last indexed character before the given offset
+    size_t lo = 0,
+           hi = m_count;
+    while ( hi - lo > 1 )
+    {
+        const size_t mid = (lo + hi) / 2;
+        if ( m_offsets[mid] <= impl )
+            lo = mid;
+        else
+            hi = mid;
+    }
+
+    const char * const start = str.data();
+    const char * const end = start + impl;
+    size_t pos = lo * STEP;
+    for ( const char *p = start + m_offsets[lo]; p < end; pos++ )
+        wxStringOperations::IncIter(p);
+
+    return pos;
+}
+
+const wxStringPosIndex *wxStringPosIndexPtr::Create(const wxStringImpl& str)
+{
+    wxStringPosIndex * const index = new wxStringPosIndex(str);
+
+    // another thread could have created the index for the same string while
+    // we were doing it, use the existing one then
+    if ( !wxAtomicCompareAndSwapPtr(m_ptr, NULL, index) )
+    {
+        delete index;
+        return Get();
+    }
+
+    return index;
+}
+
+#endif // wxUSE_STRING_POS_INDEX
+
 #endif // wxUSE_UNICODE_UTF8
 
 // ----------------------------------------------------------------------------
@@ -489,34 +621,37 @@ const wchar_t *wxString::AsWChar(const wxMBConv& conv) const
     const char * const strMB = m_impl.c_str();
     const size_t lenMB = m_impl.length();
 
-    // find out the size of the buffer needed
-    const size_t lenWC = conv.ToWChar(NULL, 0, strMB, lenMB);
-    if ( lenWC == wxCONV_FAILED )
-        return NULL;
+    ConvertedBuffer<wchar_t>& converted =
+        const_cast<wxString *>(this)->m_convertedToWChar;
 
-    // keep the same buffer if the string size didn't change: this is not only
-    // an optimization but also ensure that code which modifies string
-    // character by character (without changing its length) can continue to use
-    // the pointer returned by a previous wc_str() call even after changing the
+    // try to convert into the existing buffer first: this is not only an
+    // optimization but also ensures that code which modifies string character
+    // by character (without changing its length) can continue to use the
+    // pointer returned by a previous wc_str() call even after changing the
     // string
-
-    // TODO-UTF8: we could check for ">" instead of "!=" here as this would
-    //            allow to save on buffer reallocations but at the cost of
-    //            consuming (even) more memory, we should benchmark this to
-    //            determine if it's worth doing
-    if ( !m_convertedToWChar.m_str || lenWC != m_convertedToWChar.m_len )
+    if ( converted.m_str && converted.m_len && conv.CanConvertInOnePass() )
     {
-        if ( !const_cast<wxString *>(this)->m_convertedToWChar.Extend(lenWC) )
-            return NULL;
+        const size_t lenWC = conv.ToWChar(converted.m_str, converted.m_len,
+                                          strMB, lenMB);
+        if ( lenWC != wxCONV_FAILED )
+        {
+            converted.m_len = lenWC;
+            converted.m_str[lenWC] = L'\0';
+            return converted.m_str;
+        }
     }
 
-    // finally do convert
-    m_convertedToWChar.m_str[lenWC] = L'\0';
-    if ( conv.ToWChar(m_convertedToWChar.m_str, lenWC,
-                      strMB, lenMB) == wxCONV_FAILED )
+    // otherwise convert into a new buffer in a single pass
+    wxWCharBuffer buf;
+    const size_t lenWC = conv.ToWCharBuffer(buf, strMB, lenMB);
+    if ( lenWC == wxCONV_FAILED )
         return NULL;
 
-    return m_convertedToWChar.m_str;
+    free(converted.m_str);
+    converted.m_str = buf.release();
+    converted.m_len = lenWC;
+
+    return converted.m_str;
 }
 
 #endif // !wxUSE_UNICODE_WCHAR
@@ -541,22 +676,32 @@ const char *wxString::AsChar(const wxMBConv& conv) const
     const size_t lenWC = m_impl.length();
 #endif // wxUSE_UNICODE_UTF8/wxUSE_UNICODE_WCHAR
 
-    const size_t lenMB = conv.FromWChar(NULL, 0, strWC, lenWC);
-    if ( lenMB == wxCONV_FAILED )
-        return NULL;
+    ConvertedBuffer<char>& converted =
+        const_cast<wxString *>(this)->m_convertedToChar;
 
-    if ( !m_convertedToChar.m_str || lenMB != m_convertedToChar.m_len )
+    // see the comments in AsWChar() above
+    if ( converted.m_str && converted.m_len && conv.CanConvertInOnePass() )
     {
-        if ( !const_cast<wxString *>(this)->m_convertedToChar.Extend(lenMB) )
-            return NULL;
+        const size_t lenMB = conv.FromWChar(converted.m_str, converted.m_len,
+                                            strWC, lenWC);
+        if ( lenMB != wxCONV_FAILED )
+        {
+            converted.m_len = lenMB;
+            converted.m_str[lenMB] = '\0';
+            return converted.m_str;
+        }
     }
 
-    m_convertedToChar.m_str[lenMB] = '\0';
-    if ( conv.FromWChar(m_convertedToChar.m_str, lenMB,
-                        strWC, lenWC) == wxCONV_FAILED )
+    wxCharBuffer buf;
+    const size_t lenMB = conv.FromWCharBuffer(buf, strWC, lenWC);
+    if ( lenMB == wxCONV_FAILED )
         return NULL;
 
-    return m_convertedToChar.m_str;
+    free(converted.m_str);
+    converted.m_str = buf.release();
+    converted.m_len = lenMB;
+
+    return converted.m_str;
 }
 
 #endif // wxUSE_UNICODE
@@ -24,6 +24,8 @@
     #include "wx/stringops.h"
 #endif
 
+#include "wx/private/utf8ops.h"
+
 // ===========================================================================
 // implementation
 // ===========================================================================
@@ -73,122 +75,24 @@ const unsigned char wxStringOperationsUtf8::ms_utf8IterTable[256] = {
 // UTF-8 operations
 // ---------------------------------------------------------------------------
 
-//
-// Table 3.1B from Unicode spec: Legal UTF-8 Byte Sequences
-//
-//     Code Points    | 1st Byte | 2nd Byte | 3rd Byte | 4th Byte |
-// -------------------+----------+----------+----------+----------+
-//   U+0000..U+007F   |  00..7F  |          |          |          |
-//   U+0080..U+07FF   |  C2..DF  |  80..BF  |          |          |
-//   U+0800..U+0FFF   |  E0      |  A0..BF  |  80..BF  |          |
-//   U+1000..U+FFFF   |  E1..EF  |  80..BF  |  80..BF  |          |
-//  U+10000..U+3FFFF  |  F0      |  90..BF  |  80..BF  |  80..BF  |
-//  U+40000..U+FFFFF  |  F1..F3  |  80..BF  |  80..BF  |  80..BF  |
-// U+100000..U+10FFFF |  F4      |  80..8F  |  80..BF  |  80..BF  |
-// -------------------+----------+----------+----------+----------+
-
 bool wxStringOperationsUtf8::IsValidUtf8String(const char *str, size_t len)
 {
     if ( !str )
         return true; // empty string is UTF8 string
 
-    const unsigned char *c = (const unsigned char*)str;
-    const unsigned char * const end = (len == wxStringImpl::npos) ? NULL : c + len;
-
-    for ( ; c != end && *c; ++c )
+    // the string ends at the first NUL even if its length is given
+    if ( len == wxStringImpl::npos )
+    {
+        len = strlen(str);
+    }
+    else
     {
-        unsigned char b = *c;
-
-        if ( end != NULL )
-        {
-            // if the string is not NULL-terminated, verify we have enough
-            // bytes in it left for current character's encoding:
-            if ( c + ms_utf8IterTable[*c] > end )
-                return false;
-        }
-
-        if ( b <= 0x7F ) // 00..7F
-            continue;
-
-        else if ( b < 0xC2 ) // invalid lead bytes: 80..C1
-            return false;
-
-        // two-byte sequences:
-        else if ( b <= 0xDF ) // C2..DF
-        {
-            b = *(++c);
-            if ( !(b >= 0x80 && b <= 0xBF ) )
-                return false;
-        }
-
-        // three-byte sequences:
-        else if ( b == 0xE0 )
-        {
-            b = *(++c);
-            if ( !(b >= 0xA0 && b <= 0xBF ) )
-                return false;
-            b = *(++c);
-            if ( !(b >= 0x80 && b <= 0xBF ) )
-                return false;
-        }
-        else if ( b == 0xED )
-        {
-            b = *(++c);
-            if ( !(b >= 0x80 && b <= 0x9F ) )
-                return false;
-            b = *(++c);
-            if ( !(b >= 0x80 && b <= 0xBF ) )
-                return false;
-        }
-        else if ( b <= 0xEF ) // E1..EC EE..EF
-        {
-            for ( int i = 0; i < 2; ++i )
-            {
-                b = *(++c);
-                if ( !(b >= 0x80 && b <= 0xBF ) )
-                    return false;
-            }
-        }
-
-        // four-byte sequences:
-        else if ( b == 0xF0 )
-        {
-            b = *(++c);
-            if ( !(b >= 0x90 && b <= 0xBF ) )
-                return false;
-            for ( int i = 0; i < 2; ++i )
-            {
-                b = *(++c);
-                if ( !(b >= 0x80 && b <= 0xBF ) )
-                    return false;
-            }
-        }
-        else if ( b <= 0xF3 ) // F1..F3
-        {
-            for ( int i = 0; i < 3; ++i )
-            {
-                b = *(++c);
-                if ( !(b >= 0x80 && b <= 0xBF ) )
-                    return false;
-            }
-        }
-        else if ( b == 0xF4 )
-        {
-            b = *(++c);
-            if ( !(b >= 0x80 && b <= 0x8F ) )
-                return false;
-            for ( int i = 0; i < 2; ++i )
-            {
-                b = *(++c);
-                if ( !(b >= 0x80 && b <= 0xBF ) )
-                    return false;
-            }
-        }
-        else // otherwise, it's invalid lead byte
-            return false;
+        const char * const nul = (const char *)memchr(str, '\0', len);
+        if ( nul )
+            len = nul - str;
     }
 
-    return true;
+    return wxUtf8Ops::IsValid(str, len);
 }
 
 // NB: this is in this file and not unichar.cpp to keep all UTF-8 encoding
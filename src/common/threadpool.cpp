@@ -0,0 +1,571 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        src/common/threadpool.cpp
+// Purpose:     wxThreadPool and wxThreadPoolTask implementation
+// Author:      agent
+// Created:     2026-10-16
+// RCS-ID:      $Id$
+// Copyright:   (c) 2026 agent <agent@local>
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+// ============================================================================
+// declarations
+// ============================================================================
+
+// ----------------------------------------------------------------------------
+// headers
+// ----------------------------------------------------------------------------
+
+// for compilers that support precompilation, includes "wx.h".
+#include "wx/wxprec.h"
+
+#ifdef __BORLANDC__
+    #pragma hdrstop
+#endif
+
+#if wxUSE_THREADS
+
+#include "wx/threadpool.h"
+
+#ifndef WX_PRECOMP
+    #include "wx/log.h"
+    #include "wx/intl.h"
+    #include "wx/module.h"
+#endif // WX_PRECOMP
+
+#include "wx/stopwatch.h"
+#include "wx/tls.h"
+
+#include "wx/beforestd.h"
+#include <deque>
+#include "wx/afterstd.h"
+
+// ----------------------------------------------------------------------------
+// constants
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+// the interval at which a worker thread waiting for a task which is being run
+// by another thread checks whether it can help with the other tasks
+const long HELPER_WAIT_INTERVAL = 1;
+
+} // anonymous namespace
+
+// ----------------------------------------------------------------------------
+// private classes
+// ----------------------------------------------------------------------------
+
+// a queue of tasks: the worker owning it adds and removes the tasks at its
+// back while the other threads take them from the front
+class wxThreadPoolQueue
+{
+public:
+    wxThreadPoolQueue() { }
+
+    void PushBack(wxThreadPoolTask *task)
+    {
+        wxCriticalSectionLocker lock(m_cs);
+
+        m_tasks.push_back(task);
+    }
+
+    wxThreadPoolTask *PopBack()
+    {
+        wxCriticalSectionLocker lock(m_cs);
+
+        if ( m_tasks.empty() )
+            return NULL;
+
+        wxThreadPoolTask * const task = m_tasks.back();
+        m_tasks.pop_back();
+        return task;
+    }
+
+    wxThreadPoolTask *PopFront()
+    {
+        wxCriticalSectionLocker lock(m_cs);
+
+        if ( m_tasks.empty() )
+            return NULL;
+
+        wxThreadPoolTask * const task = m_tasks.front();
+        m_tasks.pop_front();
+        return task;
+    }
+
+private:
+    // the lock is only held for a few instructions and almost never contended
+    // as the other threads only access this queue when they have no tasks of
+    // their own
+    wxCriticalSection m_cs;
+
+    std::deque<wxThreadPoolTask *> m_tasks;
+
+    wxDECLARE_NO_COPY_CLASS(wxThreadPoolQueue);
+};
+
+class wxThreadPoolWorker : public wxThread
+{
+public:
+    wxThreadPoolWorker(wxThreadPool *pool, unsigned index)
+        : wxThread(wxTHREAD_JOINABLE),
+          m_pool(pool),
+          m_index(index)
+    {
+    }
+
+    wxThreadPool *GetPool() const { return m_pool; }
+    unsigned GetIndex() const { return m_index; }
+    wxThreadPoolQueue& GetQueue() { return m_queue; }
+
+protected:
+    virtual void *Entry();
+
+private:
+    wxThreadPool * const m_pool;
+    const unsigned m_index;
+
+    wxThreadPoolQueue m_queue;
+
+    wxDECLARE_NO_COPY_CLASS(wxThreadPoolWorker);
+};
+
+// ----------------------------------------------------------------------------
+// globals
+// ----------------------------------------------------------------------------
+
+wxDEFINE_EVENT(wxEVT_THREAD_POOL_TASK, wxThreadEvent);
+
+namespace
+{
+
+// the worker running in the current thread, if any
+wxTLS_TYPE(wxThreadPoolWorker *) gs_currentWorker;
+
+// the global pool returned by wxThreadPool::Get()
+wxThreadPool *gs_threadPool = NULL;
+
+wxCRIT_SECT_DECLARE(gs_threadPoolCS);
+
+} // anonymous namespace
+
+// ============================================================================
+// wxThreadPoolWorker implementation
+// ============================================================================
+
+void *wxThreadPoolWorker::Entry()
+{
+    wxTLS_VALUE(gs_currentWorker) = this;
+
+    m_pool->WorkerMain(this);
+
+    return NULL;
+}
+
+// ============================================================================
+// wxThreadPoolTask implementation
+// ============================================================================
+
+wxThreadPoolTask::wxThreadPoolTask(int id)
+    : m_id(id)
+{
+    m_refCount = 1;
+    m_state = wxTHREAD_POOL_TASK_PENDING;
+    m_cancelRequested = 0;
+    m_pool = NULL;
+    m_cancelEpoch = 0;
+    m_handler = NULL;
+}
+
+wxThreadPoolTask::~wxThreadPoolTask()
+{
+}
+
+bool wxThreadPoolTask::Cancel()
+{
+    wxAtomicCompareAndSwap(m_cancelRequested, 0, 1);
+
+    if ( !ChangeState(wxTHREAD_POOL_TASK_PENDING, wxTHREAD_POOL_TASK_CANCELLED) )
+        return false;
+
+    // the task remains in the queue of the pool until a worker takes it from
+    // there and releases it without running, but as far as the user code is
+    // concerned it is finished now
+    NotifyFinished();
+
+    return true;
+}
+
+bool wxThreadPoolTask::IsCancelRequested() const
+{
+    if ( m_cancelRequested )
+        return true;
+
+    return m_pool && m_pool->m_cancelEpoch != m_cancelEpoch;
+}
+
+void wxThreadPoolTask::NotifyFinished()
+{
+    if ( m_handler )
+    {
+        wxThreadEvent * const event = new wxThreadEvent(wxEVT_THREAD_POOL_TASK,
+                                                        m_id);
+        event->SetInt(GetState());
+        m_handler->QueueEvent(event);
+    }
+
+    if ( m_pool )
+        m_pool->WakeUpWaiters();
+}
+
+void wxThreadPoolTask::Wait()
+{
+    DoWait(-1);
+}
+
+bool wxThreadPoolTask::WaitTimeout(unsigned long milliseconds)
+{
+    return DoWait(milliseconds);
+}
+
+bool wxThreadPoolTask::DoWait(long timeout)
+{
+    if ( IsFinished() )
+        return true;
+
+    wxCHECK_MSG( m_pool, false, "can't wait for a task not submitted to a pool" );
+
+    return m_pool->WaitForTask(this, timeout);
+}
+
+// ============================================================================
+// wxThreadPool implementation
+// ============================================================================
+
+wxThreadPool::wxThreadPool(unsigned numThreads)
+    : m_idleCond(m_idleMutex),
+      m_doneCond(m_doneMutex)
+{
+    m_sharedQueue = new wxThreadPoolQueue;
+    m_numQueued = 0;
+    m_numActive = 0;
+    m_cancelEpoch = 0;
+    m_numIdle = 0;
+    m_shutdown = false;
+    m_numWaiting = 0;
+
+    if ( !numThreads )
+    {
+        const int numCPUs = wxThread::GetCPUCount();
+        numThreads = numCPUs > 0 ? numCPUs : 1;
+    }
+
+    // the worker threads access m_workers, so create all of them before
+    // starting any
+    m_workers.reserve(numThreads);
+    for ( unsigned n = 0; n < numThreads; n++ )
+    {
+        wxThreadPoolWorker * const
+            worker = new wxThreadPoolWorker(this, m_workers.size());
+        if ( worker->Create() != wxTHREAD_NO_ERROR )
+        {
+            wxLogError(_("Failed to create a thread of the thread pool."));
+            delete worker;
+            break;
+        }
+
+        m_workers.push_back(worker);
+    }
+
+    for ( size_t n = 0; n < m_workers.size(); n++ )
+        m_workers[n]->Run();
+}
+
+wxThreadPool::~wxThreadPool()
+{
+    CancelAll();
+
+    {
+        wxMutexLocker lock(m_idleMutex);
+        m_shutdown = true;
+        m_idleCond.Broadcast();
+    }
+
+    for ( size_t n = 0; n < m_workers.size(); n++ )
+    {
+        m_workers[n]->Wait();
+        delete m_workers[n];
+    }
+
+    delete m_sharedQueue;
+}
+
+/* static */
+wxThreadPool& wxThreadPool::Get()
+{
+    wxCRIT_SECT_LOCKER(lock, gs_threadPoolCS);
+
+    if ( !gs_threadPool )
+        gs_threadPool = new wxThreadPool;
+
+    return *gs_threadPool;
+}
+
+wxThreadPoolWorker *wxThreadPool::GetCurrentWorker() const
+{
+    wxThreadPoolWorker * const worker = wxTLS_VALUE(gs_currentWorker);
+
+    return worker && worker->GetPool() == this ? worker : NULL;
+}
+
+bool wxThreadPool::Submit(wxThreadPoolTask *task)
+{
+    wxCHECK_MSG( task, false, "NULL task" );
+    wxCHECK_MSG( IsOk(), false, "thread pool has no threads" );
+
+    // the finished or cancelled tasks can't be submitted and no new tasks
+    // are accepted during shutdown
+    if ( task->GetState() != wxTHREAD_POOL_TASK_PENDING || m_shutdown )
+        return false;
+
+    wxCHECK_MSG( !task->m_pool, false, "task was already submitted" );
+
+    task->m_cancelEpoch = m_cancelEpoch;
+    task->m_pool = this;
+    task->IncRef();
+
+    // the atomic increment above is a full barrier, so if Cancel() was called
+    // concurrently with us, either we see the new state here or it sees the
+    // pool we have just set
+    if ( task->GetState() != wxTHREAD_POOL_TASK_PENDING )
+    {
+        task->DecRef();
+        return false;
+    }
+
+    wxAtomicInc(m_numActive);
+
+    // the tasks submitted by the tasks running in this pool go to the queue of
+    // the current worker to be executed by it unless they're stolen
+    Enqueue(GetCurrentWorker(), task);
+
+    return true;
+}
+
+void wxThreadPool::Enqueue(wxThreadPoolWorker *worker, wxThreadPoolTask *task)
+{
+    if ( worker )
+        worker->GetQueue().PushBack(task);
+    else
+        m_sharedQueue->PushBack(task);
+
+    wxAtomicInc(m_numQueued);
+
+    // only take the lock if there are any idle workers, the workers increment
+    // m_numIdle before checking m_numQueued so we can't miss them
+    if ( m_numIdle )
+    {
+        wxMutexLocker lock(m_idleMutex);
+        m_idleCond.Signal();
+    }
+}
+
+wxThreadPoolTask *wxThreadPool::Dequeue(wxThreadPoolWorker *worker)
+{
+    wxThreadPoolTask *task = worker->GetQueue().PopBack();
+    if ( !task )
+        task = m_sharedQueue->PopFront();
+
+    if ( !task )
+    {
+        // try to steal a task from the other workers, starting with the next
+        // one to avoid all idle workers trying to steal from the same victim
+        const size_t numWorkers = m_workers.size();
+        const size_t index = worker->GetIndex();
+        for ( size_t n = 1; n < numWorkers && !task; n++ )
+        {
+            task = m_workers[(index + n) % numWorkers]->GetQueue().PopFront();
+        }
+
+        if ( !task )
+            return NULL;
+    }
+
+    wxAtomicDec(m_numQueued);
+
+    return task;
+}
+
+void wxThreadPool::Execute(wxThreadPoolTask *task)
+{
+    // the task could have been cancelled while it was in the queue, in which
+    // case Cancel() has already notified about it
+    if ( task->ChangeState(wxTHREAD_POOL_TASK_PENDING,
+                           wxTHREAD_POOL_TASK_RUNNING) )
+    {
+        if ( !task->IsCancelRequested() )
+            task->Run();
+
+        task->ChangeState(wxTHREAD_POOL_TASK_RUNNING,
+                          task->IsCancelRequested()
+                            ? wxTHREAD_POOL_TASK_CANCELLED
+                            : wxTHREAD_POOL_TASK_DONE);
+
+        task->NotifyFinished();
+    }
+
+    task->DecRef();
+
+    if ( !wxAtomicDec(m_numActive) )
+        WakeUpWaiters();
+}
+
+void wxThreadPool::WakeUpWaiters()
+{
+    // the waiting threads increment m_numWaiting before checking whether the
+    // task they wait for is finished, so we can't miss them
+    if ( m_numWaiting )
+    {
+        wxMutexLocker lock(m_doneMutex);
+        m_doneCond.Broadcast();
+    }
+}
+
+void wxThreadPool::WorkerMain(wxThreadPoolWorker *worker)
+{
+    for ( ;; )
+    {
+        wxThreadPoolTask * const task = Dequeue(worker);
+        if ( task )
+        {
+            Execute(task);
+            continue;
+        }
+
+        wxMutexLocker lock(m_idleMutex);
+
+        // don't exit while there are any tasks left in the queues, they could
+        // have been submitted by the tasks we were running during shutdown
+        if ( m_numQueued )
+            continue;
+
+        if ( m_shutdown )
+            break;
+
+        wxAtomicInc(m_numIdle);
+        if ( !m_numQueued )
+            m_idleCond.Wait();
+        wxAtomicDec(m_numIdle);
+    }
+}
+
+bool wxThreadPool::WaitForTask(wxThreadPoolTask *task, long timeout)
+{
+    wxMilliClock_t deadline = 0;
+    if ( timeout >= 0 )
+        deadline = wxGetLocalTimeMillis() + timeout;
+
+    // blocking a worker thread until the task finishes could deadlock if the
+    // task is in the queue of this worker, so execute the tasks while waiting
+    wxThreadPoolWorker * const worker = GetCurrentWorker();
+
+    while ( !task->IsFinished() )
+    {
+        long delay = -1;
+        if ( timeout >= 0 )
+        {
+            delay = wxMilliClockToLong(deadline - wxGetLocalTimeMillis());
+            if ( delay <= 0 )
+                return false;
+        }
+
+        if ( worker )
+        {
+            wxThreadPoolTask * const other = Dequeue(worker);
+            if ( other )
+            {
+                Execute(other);
+                continue;
+            }
+
+            // the task is being run by another worker which can submit more
+            // tasks we could help with, so don't wait for too long
+            if ( delay < 0 || delay > HELPER_WAIT_INTERVAL )
+                delay = HELPER_WAIT_INTERVAL;
+        }
+
+        wxMutexLocker lock(m_doneMutex);
+        wxAtomicInc(m_numWaiting);
+        if ( !task->IsFinished() )
+        {
+            if ( delay < 0 )
+                m_doneCond.Wait();
+            else
+                m_doneCond.WaitTimeout(delay);
+        }
+        wxAtomicDec(m_numWaiting);
+    }
+
+    return true;
+}
+
+void wxThreadPool::WaitAll()
+{
+    wxCHECK_RET( !GetCurrentWorker(),
+                 "can't wait for all tasks from a task of the same pool" );
+
+    wxMutexLocker lock(m_doneMutex);
+    wxAtomicInc(m_numWaiting);
+    while ( m_numActive )
+        m_doneCond.Wait();
+    wxAtomicDec(m_numWaiting);
+}
+
+void wxThreadPool::CancelAll()
+{
+    // this cancels all the tasks submitted until now without having to find
+    // them: the pending ones are not run when they're dequeued and the running
+    // ones see IsCancelRequested() returning true
+    wxAtomicInc(m_cancelEpoch);
+}
+
+// ============================================================================
+// wxThreadPoolModule
+// ============================================================================
+
+class wxThreadPoolModule : public wxModule
+{
+public:
+    wxThreadPoolModule()
+    {
+        // the pool threads are joined when it's destroyed, so the threads
+        // support must still be initialized when we're cleaned up
+        AddDependency("wxThreadModule");
+    }
+
+    virtual bool OnInit() { return true; }
+    virtual void OnExit()
+    {
+        // reset the pointer under the lock to prevent Get() from returning
+        // the pool being destroyed but delete the pool without holding it, as
+        // its tasks could call Get() themselves
+        wxThreadPool *pool;
+        {
+            wxCRIT_SECT_LOCKER(lock, gs_threadPoolCS);
+
+            pool = gs_threadPool;
+            gs_threadPool = NULL;
+        }
+
+        delete pool;
+    }
+
+private:
+    DECLARE_DYNAMIC_CLASS(wxThreadPoolModule)
+};
+
+IMPLEMENT_DYNAMIC_CLASS(wxThreadPoolModule, wxModule)
+
+#endif // wxUSE_THREADS
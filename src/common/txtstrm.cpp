@@ -432,9 +432,10 @@ void wxTextOutputStream::WriteString(const wxString& string)
     }
 
 #if wxUSE_UNICODE
-    // FIXME-UTF8: use wxCharBufferWithLength if/when we have it
-    wxCharBuffer buffer = m_conv->cWC2MB(out.wc_str(), out.length(), &len);
-    m_output.Write(buffer, len);
+    wxCharBuffer buffer;
+    len = m_conv->FromWCharBuffer(buffer, out.wc_str(), out.length());
+    if ( len != wxCONV_FAILED )
+        m_output.Write(buffer, len);
 #else
     m_output.Write(out.c_str(), out.length() );
 #endif
@@ -453,13 +454,10 @@ wxTextOutputStream& wxTextOutputStream::PutChar(wxChar c)
 void wxTextOutputStream::Flush()
 {
 #if wxUSE_UNICODE
-    const size_t len = m_conv->FromWChar(NULL, 0, L"", 1);
-    if ( len > m_conv->GetMBNulLen() )
-    {
-        wxCharBuffer buf(len);
-        m_conv->FromWChar(buf.data(), len, L"", 1);
+    wxCharBuffer buf;
+    const size_t len = m_conv->FromWCharBuffer(buf, L"", 1);
+    if ( len != wxCONV_FAILED && len > m_conv->GetMBNulLen() )
         m_output.Write(buf, len - m_conv->GetMBNulLen());
-    }
 #endif // wxUSE_UNICODE
 }
 
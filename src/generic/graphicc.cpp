@@ -39,6 +39,7 @@
 #endif
 
 #include "wx/private/graphics.h"
+#include "wx/private/pixelops.h"
 #include "wx/rawbmp.h"
 #include "wx/vector.h"
 
@@ -1286,31 +1287,22 @@ wxCairoBitmapData::wxCairoBitmapData( wxGraphicsRenderer* renderer, const wxBitm
             pixData(bmpSource, wxPoint(0, 0), wxSize(m_width, m_height));
         wxCHECK_RET( pixData, wxT("Failed to gain raw access to bitmap data."));
 
+        // The 32-bit quantities are stored native-endian and pre-multiplied
+        // alpha is used.
         wxAlphaPixelData::Iterator p(pixData);
         for (int y=0; y<m_height; y++)
         {
-            wxAlphaPixelData::Iterator rowStart = p;
-            wxUint32* const rowStartDst = data;
-            for (int x=0; x<m_width; x++)
-            {
-                // Each pixel in CAIRO_FORMAT_ARGB32 is a 32-bit quantity,
-                // with alpha in the upper 8 bits, then red, then green, then
-                // blue. The 32-bit quantities are stored native-endian.
-                // Pre-multiplied alpha is used.
-                unsigned char alpha = p.Alpha();
-                if (alpha == 0)
-                    *data = 0;
-                else
-                    *data = ( alpha                      << 24
-                              | (p.Red() * alpha/255)    << 16
-                              | (p.Green() * alpha/255)  <<  8
-                              | (p.Blue() * alpha/255) );
-                ++data;
-                ++p;
-            }
-
-            data = rowStartDst + stride / 4;
-            p = rowStart;
+            wxPixelOps::PixelsToARGB<wxAlphaPixelFormat::RED,
+                                     wxAlphaPixelFormat::GREEN,
+                                     wxAlphaPixelFormat::BLUE,
+                                     wxAlphaPixelFormat::ALPHA>
+            (
+                data,
+                reinterpret_cast<const unsigned char*>(&p.Data()),
+                m_width
+            );
+
+            data += stride / 4;
             p.OffsetY(pixData, 1);
         }
     }
@@ -1381,22 +1373,6 @@ wxCairoBitmapData::wxCairoBitmapData( wxGraphicsRenderer* renderer, const wxBitm
 
 #if wxUSE_IMAGE
 
-// Helper functions for dealing with alpha pre-multiplication.
-namespace
-{
-
-inline unsigned char Premultiply(unsigned char alpha, unsigned char data)
-{
-    return alpha ? (data * alpha)/0xff : data;
-}
-
-inline unsigned char Unpremultiply(unsigned char alpha, unsigned char data)
-{
-    return alpha ? (data * 0xff)/alpha : data;
-}
-
-} // anonymous namespace
-
 wxCairoBitmapData::wxCairoBitmapData(wxGraphicsRenderer* renderer,
                                      const wxImage& image)
     : wxGraphicsObjectRefData(renderer)
@@ -1413,44 +1389,17 @@ wxCairoBitmapData::wxCairoBitmapData(wxGraphicsRenderer* renderer,
     wxUint32* dst = reinterpret_cast<wxUint32*>(m_buffer);
     const unsigned char* src = image.GetData();
 
-    if ( bufferFormat == CAIRO_FORMAT_ARGB32 )
-    {
-        const unsigned char* alpha = image.GetAlpha();
-
-        for ( int y = 0; y < m_height; y++ )
-        {
-            wxUint32* const rowStartDst = dst;
-
-            for ( int x = 0; x < m_width; x++ )
-            {
-                const unsigned char a = *alpha++;
-
-                *dst++ = a                      << 24 |
-                         Premultiply(a, src[0]) << 16 |
-                         Premultiply(a, src[1]) <<  8 |
-                         Premultiply(a, src[2]);
-                src += 3;
-            }
-
-            dst = rowStartDst + stride / 4;
-        }
-    }
-    else // RGB
+    // The alpha is NULL for CAIRO_FORMAT_RGB24 and then the upper 8 bits of
+    // each pixel are unused.
+    const unsigned char* alpha = image.GetAlpha();
+    for ( int y = 0; y < m_height; y++ )
     {
-        for ( int y = 0; y < m_height; y++ )
-        {
-            wxUint32* const rowStartDst = dst;
+        wxPixelOps::RGBToARGB(dst, src, alpha, m_width);
 
-            for ( int x = 0; x < m_width; x++ )
-            {
-                *dst++ = src[0] << 16 |
-                         src[1] <<  8 |
-                         src[2];
-                src += 3;
-            }
-
-            dst = rowStartDst + stride / 4;
-        }
+        dst += stride / 4;
+        src += 3*m_width;
+        if ( alpha )
+            alpha += m_width;
     }
 
     InitSurface(bufferFormat, stride);
@@ -1499,47 +1448,19 @@ wxImage wxCairoBitmapData::ConvertToImage() const
     wxASSERT_MSG( !(stride % sizeof(wxUint32)), wxS("Unexpected stride.") );
     stride /= sizeof(wxUint32);
 
+    // We need to also copy alpha and undo the pre-multiplication as Cairo
+    // stores pre-multiplied values in this format while wxImage does not, if
+    // there is no alpha, just RGB bytes are copied.
     unsigned char* dst = image.GetData();
     unsigned char *alpha = image.GetAlpha();
-    if ( alpha )
+    for ( int y = 0; y < m_height; y++ )
     {
-        // We need to also copy alpha and undo the pre-multiplication as Cairo
-        // stores pre-multiplied values in this format while wxImage does not.
-        for ( int y = 0; y < m_height; y++ )
-        {
-            const wxUint32* const rowStart = src;
-            for ( int x = 0; x < m_width; x++ )
-            {
-                const wxUint32 argb = *src++;
+        wxPixelOps::ARGBToRGB(dst, alpha, src, m_width);
 
-                *alpha++ = (argb & 0xff000000) >> 24;
-
-                // Copy the RGB data undoing the pre-multiplication.
-                *dst++ = Unpremultiply(*alpha, (argb & 0x00ff0000) >> 16);
-                *dst++ = Unpremultiply(*alpha, (argb & 0x0000ff00) >>  8);
-                *dst++ = Unpremultiply(*alpha, (argb & 0x000000ff));
-            }
-
-            src = rowStart + stride;
-        }
-    }
-    else // RGB
-    {
-        // Things are pretty simple in this case, just copy RGB bytes.
-        for ( int y = 0; y < m_height; y++ )
-        {
-            const wxUint32* const rowStart = src;
-            for ( int x = 0; x < m_width; x++ )
-            {
-                const wxUint32 argb = *src++;
-
-                *dst++ = (argb & 0x00ff0000) >> 16;
-                *dst++ = (argb & 0x0000ff00) >>  8;
-                *dst++ = (argb & 0x000000ff);
-            }
-
-            src = rowStart + stride;
-        }
+        src += stride;
+        dst += 3*m_width;
+        if ( alpha )
+            alpha += m_width;
     }
 
     return image;
@@ -20,12 +20,168 @@
 
 #include "wx/rawbmp.h"
 
+#include "wx/private/simd.h"
+
 #include "wx/gtk/private/object.h"
 
 #include <gtk/gtk.h>
 
 extern GtkWidget *wxGetRootWindow();
 
+// ----------------------------------------------------------------------------
+// helpers for converting rows of pixels between wxImage and GdkPixbuf
+// ----------------------------------------------------------------------------
+
+// wxImage stores RGB and alpha in separate planes while GdkPixbuf interleaves
+// them, but neither of them uses pre-multiplied alpha, so the conversion is
+// just a copy of the bytes which is done here without any per pixel tests
+
+#if wxUSE_IMAGE
+
+#ifdef wxHAS_SSSE3_DISPATCH
+
+// Versions of the functions below shuffling the bytes of 4 pixels at once.
+// They return the number of pixels converted, the remaining ones must be
+// converted by the scalar code. As 16 bytes of RGB data are read or written
+// at once, they stop before the last 2 pixels of the row at least.
+
+static wxSSSE3_TARGET int
+InterleaveRGBASSSE3(guchar* out, const guchar* rgb, const guchar* alpha, int w)
+{
+    const __m128i rgbShuffle = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1,
+                                             6, 7, 8, -1, 9, 10, 11, -1);
+    const __m128i alphaShuffle = _mm_setr_epi8(-1, -1, -1, 0, -1, -1, -1, 1,
+                                               -1, -1, -1, 2, -1, -1, -1, 3);
+    int x;
+    for (x = 0; x + 6 <= w; x += 4)
+    {
+        int a;
+        memcpy(&a, alpha + x, 4);
+
+        const __m128i v = _mm_loadu_si128((const __m128i*)(rgb + 3 * x));
+        _mm_storeu_si128((__m128i*)(out + 4 * x),
+                         _mm_or_si128(_mm_shuffle_epi8(v, rgbShuffle),
+                                      _mm_shuffle_epi8(_mm_cvtsi32_si128(a),
+                                                       alphaShuffle)));
+    }
+
+    return x;
+}
+
+static wxSSSE3_TARGET int
+InterleaveRGBASSSE3(guchar* out, const guchar* rgb, int w)
+{
+    const __m128i rgbShuffle = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1,
+                                             6, 7, 8, -1, 9, 10, 11, -1);
+    const __m128i opaque = _mm_set1_epi32(int(0xff000000));
+    int x;
+    for (x = 0; x + 6 <= w; x += 4)
+    {
+        const __m128i v = _mm_loadu_si128((const __m128i*)(rgb + 3 * x));
+        _mm_storeu_si128((__m128i*)(out + 4 * x),
+                         _mm_or_si128(_mm_shuffle_epi8(v, rgbShuffle), opaque));
+    }
+
+    return x;
+}
+
+static wxSSSE3_TARGET int
+DeinterleaveRGBASSSE3(guchar* rgb, guchar* alpha, const guchar* in, int w)
+{
+    const __m128i rgbShuffle = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9,
+                                             10, 12, 13, 14, -1, -1, -1, -1);
+    const __m128i alphaShuffle = _mm_setr_epi8(3, 7, 11, 15, -1, -1, -1, -1,
+                                               -1, -1, -1, -1, -1, -1, -1, -1);
+    int x;
+    for (x = 0; x + 6 <= w; x += 4)
+    {
+        const __m128i v = _mm_loadu_si128((const __m128i*)(in + 4 * x));
+
+        // this overwrites the RGB data of the next pixel and a third too, but
+        // they're going to be written by the next iteration anyhow
+        _mm_storeu_si128((__m128i*)(rgb + 3 * x),
+                         _mm_shuffle_epi8(v, rgbShuffle));
+
+        const int a = _mm_cvtsi128_si32(_mm_shuffle_epi8(v, alphaShuffle));
+        memcpy(alpha + x, &a, 4);
+    }
+
+    return x;
+}
+
+#endif // wxHAS_SSSE3_DISPATCH
+
+static inline void
+InterleaveRGBA(guchar* out, const guchar* rgb, const guchar* alpha, int w)
+{
+#ifdef wxHAS_SSSE3_DISPATCH
+    if (wxCPUHasSSSE3())
+    {
+        const int done = InterleaveRGBASSSE3(out, rgb, alpha, w);
+        out += 4 * done;
+        rgb += 3 * done;
+        alpha += done;
+        w -= done;
+    }
+#endif // wxHAS_SSSE3_DISPATCH
+
+    for (const guchar* const end = alpha + w; alpha != end; out += 4, rgb += 3)
+    {
+        out[0] = rgb[0];
+        out[1] = rgb[1];
+        out[2] = rgb[2];
+        out[3] = *alpha++;
+    }
+}
+
+// same as above for the images without alpha: make the pixels opaque
+static inline void
+InterleaveRGBA(guchar* out, const guchar* rgb, int w)
+{
+#ifdef wxHAS_SSSE3_DISPATCH
+    if (wxCPUHasSSSE3())
+    {
+        const int done = InterleaveRGBASSSE3(out, rgb, w);
+        out += 4 * done;
+        rgb += 3 * done;
+        w -= done;
+    }
+#endif // wxHAS_SSSE3_DISPATCH
+
+    for (guchar* const end = out + 4 * w; out != end; out += 4, rgb += 3)
+    {
+        out[0] = rgb[0];
+        out[1] = rgb[1];
+        out[2] = rgb[2];
+        out[3] = wxIMAGE_ALPHA_OPAQUE;
+    }
+}
+
+static inline void
+DeinterleaveRGBA(guchar* rgb, guchar* alpha, const guchar* in, int w)
+{
+#ifdef wxHAS_SSSE3_DISPATCH
+    if (wxCPUHasSSSE3())
+    {
+        const int done = DeinterleaveRGBASSSE3(rgb, alpha, in, w);
+        rgb += 3 * done;
+        alpha += done;
+        in += 4 * done;
+        w -= done;
+    }
+#endif // wxHAS_SSSE3_DISPATCH
+
+    for (guchar* const end = alpha + w; alpha != end; in += 4, rgb += 3)
+    {
+        rgb[0] = in[0];
+        rgb[1] = in[1];
+        rgb[2] = in[2];
+        *alpha++ = in[3];
+    }
+}
+
+#endif // wxUSE_IMAGE
+
 static void PixmapToPixbuf(GdkPixmap* pixmap, GdkPixbuf* pixbuf, int w, int h)
 {
     gdk_pixbuf_get_from_drawable(pixbuf, pixmap, NULL, 0, 0, 0, 0, w, h);
@@ -431,19 +587,20 @@ bool wxBitmap::CreateFromImageAsPixbuf(const wxImage& image)
     // Copy the data:
     const unsigned char* in = image.GetData();
     unsigned char *out = gdk_pixbuf_get_pixels(pixbuf);
-    unsigned char *alpha = image.GetAlpha();
+    const unsigned char *alpha = image.GetAlpha();
 
-    int rowpad = gdk_pixbuf_get_rowstride(pixbuf) - 4 * width;
+    const int rowstride = gdk_pixbuf_get_rowstride(pixbuf);
 
-    for (int y = 0; y < height; y++, out += rowpad)
+    for (int y = 0; y < height; y++, out += rowstride, in += 3 * width)
     {
-        for (int x = 0; x < width; x++, out += 4, in += 3)
+        if (alpha)
+        {
+            InterleaveRGBA(out, in, alpha, width);
+            alpha += width;
+        }
+        else
         {
-            out[0] = in[0];
-            out[1] = in[1];
-            out[2] = in[2];
-            if (alpha)
-                out[3] = *alpha++;
+            InterleaveRGBA(out, in, width);
         }
     }
 
@@ -473,18 +630,26 @@ wxImage wxBitmap::ConvertToImage() const
         }
         const unsigned char* in = gdk_pixbuf_get_pixels(pixbuf);
         unsigned char *out = data;
-        const int inc = 3 + int(alpha != NULL);
-        const int rowpad = gdk_pixbuf_get_rowstride(pixbuf) - inc * w;
+        const int rowstride = gdk_pixbuf_get_rowstride(pixbuf);
 
-        for (int y = 0; y < h; y++, in += rowpad)
+        if (alpha == NULL && rowstride == 3 * w)
+        {
+            // the layouts are the same, copy everything at once
+            memcpy(out, in, size_t(3 * w) * unsigned(h));
+        }
+        else
         {
-            for (int x = 0; x < w; x++, in += inc, out += 3)
+            for (int y = 0; y < h; y++, in += rowstride, out += 3 * w)
             {
-                out[0] = in[0];
-                out[1] = in[1];
-                out[2] = in[2];
                 if (alpha != NULL)
-                    *alpha++ = in[3];
+                {
+                    DeinterleaveRGBA(out, alpha, in, w);
+                    alpha += w;
+                }
+                else
+                {
+                    memcpy(out, in, 3 * w);
+                }
             }
         }
     }
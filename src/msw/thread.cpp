@@ -553,6 +553,9 @@ void wxThreadInternal::DoThreadOnExit(wxThread *thread)
         thread->OnExit();
     }
     wxCATCH_ALL( wxTheApp->OnUnhandledException(); )
+
+    // return the memory cached by this thread for the events allocation
+    wxEventAllocator::ReleaseThreadCache();
 }
 
 /* static */
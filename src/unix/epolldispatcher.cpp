@@ -24,6 +24,7 @@
 #include "wx/unix/private/epolldispatcher.h"
 #include "wx/unix/private.h"
 #include "wx/stopwatch.h"
+#include "wx/scopeguard.h"
 
 #ifndef WX_PRECOMP
     #include "wx/log.h"
@@ -31,11 +32,19 @@
 #endif
 
 #include <sys/epoll.h>
+#include <poll.h>
 #include <errno.h>
 #include <unistd.h>
 
 #define wxEpollDispatcher_Trace wxT("epolldispatcher")
 
+// the initial and minimal size of the events buffer
+static const int wxEPOLL_EVENTS_MIN = 16;
+
+// the maximal size of the events buffer, if more descriptors are ready, the
+// remaining ones will be retrieved by the next call to epoll_wait()
+static const int wxEPOLL_EVENTS_MAX = 4096;
+
 // ============================================================================
 // implementation
 // ============================================================================
@@ -69,9 +78,36 @@ static uint32_t GetEpollMask(int flags, int fd)
                    wxT("Registered fd %d for exceptional events"), fd);
     }
 
+    if ( flags & wxFDIO_EDGE_TRIGGERED )
+    {
+        ep |= EPOLLET;
+        wxLogTrace(wxEpollDispatcher_Trace,
+                   wxT("Registered fd %d in edge-triggered mode"), fd);
+    }
+
     return ep;
 }
 
+// we use the lowest bit of the handler pointer stored in epoll_event, which is
+// always 0 because of the alignment, to remember whether the handler was
+// registered in edge-triggered mode
+static void *MakeEpollData(wxFDIOHandler *handler, int flags)
+{
+    wxUIntPtr data = wxPtrToUInt(handler);
+    if ( flags & wxFDIO_EDGE_TRIGGERED )
+        data |= 1;
+
+    return wxUIntToPtr(data);
+}
+
+static wxFDIOHandler *GetHandlerFromEpollData(void *ptr, bool *edgeTriggered)
+{
+    const wxUIntPtr data = wxPtrToUInt(ptr);
+    *edgeTriggered = (data & 1) != 0;
+
+    return static_cast<wxFDIOHandler *>(wxUIntToPtr(data & ~(wxUIntPtr)1));
+}
+
 // ----------------------------------------------------------------------------
 // wxEpollDispatcher
 // ----------------------------------------------------------------------------
@@ -95,6 +131,10 @@ wxEpollDispatcher::wxEpollDispatcher(int epollDescriptor)
     wxASSERT_MSG( epollDescriptor != -1, wxT("invalid descriptor") );
 
     m_epollDescriptor = epollDescriptor;
+    m_numFDs = 0;
+    m_numEventsMax = wxEPOLL_EVENTS_MIN;
+    m_events = new epoll_event[m_numEventsMax];
+    m_inDispatch = false;
 }
 
 wxEpollDispatcher::~wxEpollDispatcher()
@@ -103,13 +143,15 @@ wxEpollDispatcher::~wxEpollDispatcher()
     {
         wxLogSysError(_("Error closing epoll descriptor"));
     }
+
+    delete [] m_events;
 }
 
 bool wxEpollDispatcher::RegisterFD(int fd, wxFDIOHandler* handler, int flags)
 {
     epoll_event ev;
     ev.events = GetEpollMask(flags, fd);
-    ev.data.ptr = handler;
+    ev.data.ptr = MakeEpollData(handler, flags);
 
     const int ret = epoll_ctl(m_epollDescriptor, EPOLL_CTL_ADD, fd, &ev);
     if ( ret != 0 )
@@ -119,6 +161,8 @@ bool wxEpollDispatcher::RegisterFD(int fd, wxFDIOHandler* handler, int flags)
 
         return false;
     }
+
+    m_numFDs++;
     wxLogTrace(wxEpollDispatcher_Trace,
                wxT("Added fd %d (handler %p) to epoll %d"), fd, handler, m_epollDescriptor);
 
@@ -129,7 +173,7 @@ bool wxEpollDispatcher::ModifyFD(int fd, wxFDIOHandler* handler, int flags)
 {
     epoll_event ev;
     ev.events = GetEpollMask(flags, fd);
-    ev.data.ptr = handler;
+    ev.data.ptr = MakeEpollData(handler, flags);
 
     const int ret = epoll_ctl(m_epollDescriptor, EPOLL_CTL_MOD, fd, &ev);
     if ( ret != 0 )
@@ -156,6 +200,10 @@ bool wxEpollDispatcher::UnregisterFD(int fd)
         wxLogSysError(_("Failed to unregister descriptor %d from epoll descriptor %d"),
                       fd, m_epollDescriptor);
     }
+    else
+    {
+        m_numFDs--;
+    }
     wxLogTrace(wxEpollDispatcher_Trace,
                 wxT("removed fd %d from %d"), fd, m_epollDescriptor);
     return true;
@@ -172,7 +220,7 @@ wxEpollDispatcher::DoPoll(epoll_event *events, int numEvents, int timeout) const
 
     wxMilliClock_t timeEnd;
     if ( timeout > 0 )
-        timeEnd = wxGetLocalTimeMillis();
+        timeEnd = wxGetLocalTimeMillis() + timeout;
 
     int rc;
     for ( ;; )
@@ -195,19 +243,68 @@ wxEpollDispatcher::DoPoll(epoll_event *events, int numEvents, int timeout) const
 
 bool wxEpollDispatcher::HasPending() const
 {
-    epoll_event event;
+    // the epoll descriptor itself becomes readable when any events are
+    // available, so check for this instead of calling epoll_wait() as the
+    // latter would consume the event which, for a descriptor registered in
+    // edge-triggered mode, would then be lost
+    pollfd pfd;
+    pfd.fd = m_epollDescriptor;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
 
-    // NB: it's not really clear if epoll_wait() can return a number greater
-    //     than the number of events passed to it but just in case it can, use
-    //     >= instead of == here, see #10397
-    return DoPoll(&event, 1, 0) >= 1;
+    int rc;
+    do
+    {
+        rc = poll(&pfd, 1, 0);
+    }
+    while ( rc == -1 && errno == EINTR );
+
+    return rc > 0;
+}
+
+void wxEpollDispatcher::AdjustEventsBuffer()
+{
+    // use hysteresis to avoid reallocating the buffer too often when the
+    // number of descriptors oscillates around a power of 2
+    int numEventsMax = m_numEventsMax;
+    while ( numEventsMax < m_numFDs && numEventsMax < wxEPOLL_EVENTS_MAX )
+        numEventsMax *= 2;
+    while ( numEventsMax > 4*m_numFDs && numEventsMax > wxEPOLL_EVENTS_MIN )
+        numEventsMax /= 2;
+
+    if ( numEventsMax == m_numEventsMax )
+        return;
+
+    wxLogTrace(wxEpollDispatcher_Trace,
+               wxT("Resizing events buffer for %d fds to %d events"),
+               m_numFDs, numEventsMax);
+
+    delete [] m_events;
+    m_numEventsMax = numEventsMax;
+    m_events = new epoll_event[m_numEventsMax];
 }
 
 int wxEpollDispatcher::Dispatch(int timeout)
 {
-    epoll_event events[16];
+    // if we're called from one of the handlers called by an outer Dispatch(),
+    // use a small local buffer as m_events is still used by the outer call
+    epoll_event eventsNested[wxEPOLL_EVENTS_MIN];
+    epoll_event *events;
+    int numEventsMax;
+    if ( m_inDispatch )
+    {
+        events = eventsNested;
+        numEventsMax = WXSIZEOF(eventsNested);
+    }
+    else
+    {
+        AdjustEventsBuffer();
 
-    const int rc = DoPoll(events, WXSIZEOF(events), timeout);
+        events = m_events;
+        numEventsMax = m_numEventsMax;
+    }
+
+    const int rc = DoPoll(events, numEventsMax, timeout);
 
     if ( rc == -1 )
     {
@@ -216,21 +313,37 @@ int wxEpollDispatcher::Dispatch(int timeout)
         return -1;
     }
 
+    wxON_BLOCK_EXIT_SET(m_inDispatch, m_inDispatch);
+    m_inDispatch = true;
+
     int numEvents = 0;
     for ( epoll_event *p = events; p < events + rc; p++ )
     {
-        wxFDIOHandler * const handler = (wxFDIOHandler *)(p->data.ptr);
+        bool edgeTriggered;
+        wxFDIOHandler * const
+            handler = GetHandlerFromEpollData(p->data.ptr, &edgeTriggered);
         if ( !handler )
         {
             wxFAIL_MSG( wxT("NULL handler in epoll_event?") );
             continue;
         }
 
+        if ( edgeTriggered )
+        {
+            // we won't be notified about this descriptor again until its
+            // state changes, so call all the relevant handler methods
+            if ( p->events & (EPOLLIN | EPOLLHUP) )
+                handler->OnReadWaiting();
+            if ( p->events & EPOLLOUT )
+                handler->OnWriteWaiting();
+            if ( p->events & EPOLLERR )
+                handler->OnExceptionWaiting();
+        }
         // note that for compatibility with wxSelectDispatcher we call
         // OnReadWaiting() on EPOLLHUP as this is what epoll_wait() returns
         // when the write end of a pipe is closed while with select() the
         // remaining pipe end becomes ready for reading when this happens
-        if ( p->events & (EPOLLIN | EPOLLHUP) )
+        else if ( p->events & (EPOLLIN | EPOLLHUP) )
             handler->OnReadWaiting();
         else if ( p->events & EPOLLOUT )
             handler->OnWriteWaiting();
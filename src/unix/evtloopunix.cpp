@@ -287,9 +287,11 @@ bool wxConsoleEventLoop::Dispatch()
 int wxConsoleEventLoop::DispatchTimeout(unsigned long timeout)
 {
 #if wxUSE_TIMER
-    // check if we need to decrease the timeout to account for a timer
+    // check if we need to decrease the timeout to account for a timer, unless
+    // the dispatcher is going to wake up for it on its own anyhow
     wxUsecClock_t nextTimer;
-    if ( wxTimerScheduler::Get().GetNext(&nextTimer) )
+    if ( !wxTimerScheduler::Get().IsMonitoredByDispatcher() &&
+            wxTimerScheduler::Get().GetNext(&nextTimer) )
     {
         unsigned long timeUntilNextTimer = wxMilliClockToLong(nextTimer / 1000);
         if ( timeUntilNextTimer < timeout )
@@ -300,6 +302,8 @@ int wxConsoleEventLoop::DispatchTimeout(unsigned long timeout)
     bool hadEvent = m_dispatcher->Dispatch(timeout) > 0;
 
 #if wxUSE_TIMER
+    // notice that the timers are notified from here even if the dispatcher
+    // monitors them and not from inside Dispatch() above
     if ( wxTimerScheduler::Get().NotifyExpired() )
         hadEvent = true;
 #endif // wxUSE_TIMER
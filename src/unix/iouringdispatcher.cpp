@@ -0,0 +1,653 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        src/unix/iouringdispatcher.cpp
+// Purpose:     implements dispatcher using Linux io_uring
+// Author:      agent
+// Created:     2026-10-16
+// RCS-ID:      $Id$
+// Copyright:   (c) 2026 agent <agent@local>
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+// ============================================================================
+// declarations
+// ============================================================================
+
+// ----------------------------------------------------------------------------
+// headers
+// ----------------------------------------------------------------------------
+
+// for compilers that support precompilation, includes "wx.h".
+#include "wx/wxprec.h"
+
+#include "wx/unix/private/iouringdispatcher.h"
+
+#ifdef wxHAS_IOURING_DISPATCHER
+
+#include "wx/stopwatch.h"
+
+#ifndef WX_PRECOMP
+    #include "wx/log.h"
+    #include "wx/intl.h"
+#endif
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <poll.h>
+#include <errno.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define wxIoUringDispatcher_Trace wxT("iouringdispatcher")
+
+// the number of entries in the submission and completion rings, the latter is
+// bigger as unregistering a descriptor results in two completions
+static const unsigned wxIOURING_ENTRIES = 256;
+static const unsigned wxIOURING_CQ_ENTRIES = 4096;
+
+// the maximal number of completions processed by a single Dispatch() call
+static const unsigned wxIOURING_MAX_COMPLETIONS = 256;
+
+// ============================================================================
+// implementation
+// ============================================================================
+
+// ----------------------------------------------------------------------------
+// local helpers
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+// there are no wrappers for io_uring system calls in libc
+int wxIoUringSetup(unsigned entries, io_uring_params *params)
+{
+    return syscall(__NR_io_uring_setup, entries, params);
+}
+
+int wxIoUringEnter(int fd, unsigned toSubmit, unsigned minComplete,
+                   unsigned flags, const void *arg, size_t argSize)
+{
+    return syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags,
+                   arg, argSize);
+}
+
+// the ring indices are shared with the kernel and must be accessed atomically
+inline unsigned LoadAcquire(const unsigned *p)
+{
+    return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
+
+inline void StoreRelease(unsigned *p, unsigned value)
+{
+    __atomic_store_n(p, value, __ATOMIC_RELEASE);
+}
+
+// the user data of the poll requests contains both the descriptor and the
+// generation of its registration, the user data of all the other requests
+// has 0 generation as it is never used for the registrations
+inline wxUint64 MakeUserData(int fd, wxUint32 generation)
+{
+    return (static_cast<wxUint64>(generation) << 32) |
+                static_cast<wxUint32>(fd);
+}
+
+inline int GetFDFromUserData(wxUint64 data)
+{
+    return static_cast<int>(static_cast<wxUint32>(data));
+}
+
+inline wxUint32 GetGenerationFromUserData(wxUint64 data)
+{
+    return static_cast<wxUint32>(data >> 32);
+}
+
+// return the poll mask corresponding to the given flags
+wxUint32 GetPollMask(int flags)
+{
+    wxUint32 mask = 0;
+
+    if ( flags & wxFDIO_INPUT )
+        mask |= POLLIN;
+
+    if ( flags & wxFDIO_OUTPUT )
+        mask |= POLLOUT;
+
+    if ( flags & wxFDIO_EXCEPTION )
+        mask |= POLLERR | POLLHUP;
+
+#ifdef WORDS_BIGENDIAN
+    // the kernel expects the mask to have its 16 bit halves swapped on big
+    // endian systems
+    mask = (mask << 16) | (mask >> 16);
+#endif
+
+    return mask;
+}
+
+} // anonymous namespace
+
+// ----------------------------------------------------------------------------
+// wxIoUringDispatcher
+// ----------------------------------------------------------------------------
+
+/* static */
+wxIoUringDispatcher *wxIoUringDispatcher::Create()
+{
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    params.flags = IORING_SETUP_CQSIZE;
+    params.cq_entries = wxIOURING_CQ_ENTRIES;
+
+    const int ringFD = wxIoUringSetup(wxIOURING_ENTRIES, &params);
+    if ( ringFD == -1 )
+    {
+        // this is not an error, io_uring may be just unsupported or disabled
+        wxLogTrace(wxIoUringDispatcher_Trace,
+                   wxT("Failed to create io_uring: %s"), wxSysErrorMsg());
+        return NULL;
+    }
+
+    // we need to be able to wait with a timeout and we don't want to deal
+    // with the completion ring overflows
+    const unsigned featuresNeeded = IORING_FEAT_EXT_ARG | IORING_FEAT_NODROP;
+    if ( (params.features & featuresNeeded) != featuresNeeded )
+    {
+        wxLogTrace(wxIoUringDispatcher_Trace,
+                   wxT("io_uring features %#x not supported"),
+                   featuresNeeded & ~params.features);
+        close(ringFD);
+        return NULL;
+    }
+
+    wxIoUringDispatcher * const dispatcher
+        = new wxIoUringDispatcher(ringFD, params);
+    if ( !dispatcher->MapRings(params) )
+    {
+        delete dispatcher;
+        return NULL;
+    }
+
+    wxLogTrace(wxIoUringDispatcher_Trace,
+               wxT("io_uring fd %d created"), ringFD);
+
+    return dispatcher;
+}
+
+wxIoUringDispatcher::wxIoUringDispatcher(int ringFD,
+                                         const io_uring_params& params)
+{
+    m_ringFD = ringFD;
+
+    m_sqRing =
+    m_cqRing = MAP_FAILED;
+    m_sqes = static_cast<io_uring_sqe *>(MAP_FAILED);
+
+    m_sqRingSize = params.sq_off.array + params.sq_entries*sizeof(unsigned);
+    m_cqRingSize = params.cq_off.cqes + params.cq_entries*sizeof(io_uring_cqe);
+    m_sqesSize = params.sq_entries*sizeof(io_uring_sqe);
+
+    m_sqHead =
+    m_sqTail =
+    m_sqMask =
+    m_sqArray =
+    m_cqHead =
+    m_cqTail =
+    m_cqMask = NULL;
+    m_cqes = NULL;
+    m_sqEntries = params.sq_entries;
+
+    m_numToSubmit = 0;
+    m_nextGeneration = 1;
+    m_hasMultishotPoll = true;
+}
+
+bool wxIoUringDispatcher::MapRings(const io_uring_params& params)
+{
+    // with IORING_FEAT_SINGLE_MMAP both rings are in the same memory region
+    const bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if ( singleMap )
+    {
+        if ( m_cqRingSize > m_sqRingSize )
+            m_sqRingSize = m_cqRingSize;
+        m_cqRingSize = m_sqRingSize;
+    }
+
+    m_sqRing = mmap(NULL, m_sqRingSize, PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_POPULATE, m_ringFD, IORING_OFF_SQ_RING);
+    if ( m_sqRing == MAP_FAILED )
+    {
+        wxLogSysError(_("Failed to map io_uring submission ring"));
+        return false;
+    }
+
+    if ( singleMap )
+    {
+        m_cqRing = m_sqRing;
+    }
+    else
+    {
+        m_cqRing = mmap(NULL, m_cqRingSize, PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_POPULATE, m_ringFD, IORING_OFF_CQ_RING);
+        if ( m_cqRing == MAP_FAILED )
+        {
+            wxLogSysError(_("Failed to map io_uring completion ring"));
+            return false;
+        }
+    }
+
+    m_sqes = static_cast<io_uring_sqe *>(
+                mmap(NULL, m_sqesSize, PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_POPULATE, m_ringFD, IORING_OFF_SQES));
+    if ( m_sqes == MAP_FAILED )
+    {
+        wxLogSysError(_("Failed to map io_uring submission queue entries"));
+        return false;
+    }
+
+    char * const sq = static_cast<char *>(m_sqRing);
+    m_sqHead = reinterpret_cast<unsigned *>(sq + params.sq_off.head);
+    m_sqTail = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+    m_sqMask = reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+    m_sqArray = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+
+    char * const cq = static_cast<char *>(m_cqRing);
+    m_cqHead = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+    m_cqTail = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+    m_cqMask = reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+    m_cqes = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+
+    return true;
+}
+
+wxIoUringDispatcher::~wxIoUringDispatcher()
+{
+    if ( m_sqes != MAP_FAILED )
+        munmap(m_sqes, m_sqesSize);
+
+    if ( m_cqRing != MAP_FAILED && m_cqRing != m_sqRing )
+        munmap(m_cqRing, m_cqRingSize);
+
+    if ( m_sqRing != MAP_FAILED )
+        munmap(m_sqRing, m_sqRingSize);
+
+    if ( close(m_ringFD) != 0 )
+    {
+        wxLogSysError(_("Error closing io_uring descriptor"));
+    }
+}
+
+io_uring_sqe *wxIoUringDispatcher::GetSQE()
+{
+    unsigned tail = *m_sqTail;
+    if ( tail - LoadAcquire(m_sqHead) == m_sqEntries )
+    {
+        // the submission ring is full, submit the queued requests to the
+        // kernel to make space for the new one
+        if ( !Enter(0) )
+            return NULL;
+
+        if ( tail - LoadAcquire(m_sqHead) == m_sqEntries )
+        {
+            wxLogDebug(wxT("io_uring submission ring is full"));
+            return NULL;
+        }
+    }
+
+    io_uring_sqe * const sqe = &m_sqes[tail & *m_sqMask];
+    memset(sqe, 0, sizeof(*sqe));
+
+    return sqe;
+}
+
+void wxIoUringDispatcher::CommitSQE()
+{
+    const unsigned tail = *m_sqTail;
+    const unsigned index = tail & *m_sqMask;
+
+    // the release store ensures that the kernel sees the filled entry when it
+    // sees the new tail
+    m_sqArray[index] = index;
+    StoreRelease(m_sqTail, tail + 1);
+
+    m_numToSubmit++;
+}
+
+bool wxIoUringDispatcher::QueuePoll(int fd, const Entry& entry)
+{
+    io_uring_sqe * const sqe = GetSQE();
+    if ( !sqe )
+        return false;
+
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = fd;
+    sqe->poll32_events = GetPollMask(entry.flags);
+    sqe->user_data = MakeUserData(fd, entry.generation);
+
+    // multishot requests remain active after completing, which corresponds
+    // to the edge-triggered semantics, while the one-shot ones are submitted
+    // again after each notification and so complete immediately if the
+    // descriptor is still ready, as for the level-triggered ones
+    if ( (entry.flags & wxFDIO_EDGE_TRIGGERED) && m_hasMultishotPoll )
+        sqe->len = IORING_POLL_ADD_MULTI;
+
+    CommitSQE();
+
+    return true;
+}
+
+bool wxIoUringDispatcher::QueuePollRemove(int fd, const Entry& entry)
+{
+    io_uring_sqe * const sqe = GetSQE();
+    if ( !sqe )
+        return false;
+
+    sqe->opcode = IORING_OP_POLL_REMOVE;
+    sqe->fd = -1;
+    sqe->addr = MakeUserData(fd, entry.generation);
+    sqe->user_data = MakeUserData(fd, 0);
+
+    CommitSQE();
+
+    return true;
+}
+
+bool wxIoUringDispatcher::Enter(int timeout)
+{
+    // the code below relies on TIMEOUT_INFINITE being -1 as for epoll
+    wxCOMPILE_TIME_ASSERT( TIMEOUT_INFINITE == -1, UpdateThisCode );
+
+    if ( !timeout && !m_numToSubmit )
+        return true;
+
+    wxMilliClock_t timeEnd;
+    if ( timeout > 0 )
+        timeEnd = wxGetLocalTimeMillis() + timeout;
+
+    for ( ;; )
+    {
+        unsigned flags = 0;
+        unsigned minComplete = 0;
+
+        io_uring_getevents_arg arg;
+        memset(&arg, 0, sizeof(arg));
+
+        __kernel_timespec ts;
+        if ( timeout != 0 )
+        {
+            flags = IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG;
+            minComplete = 1;
+
+            if ( timeout > 0 )
+            {
+                ts.tv_sec = timeout / 1000;
+                ts.tv_nsec = (timeout % 1000)*1000000;
+                arg.ts = wxPtrToUInt(&ts);
+            }
+        }
+
+        const int rc = wxIoUringEnter(m_ringFD, m_numToSubmit, minComplete,
+                                      flags, &arg, sizeof(arg));
+        if ( rc >= 0 )
+        {
+            m_numToSubmit -= rc;
+            return true;
+        }
+
+        switch ( errno )
+        {
+            case ETIME:
+                // timeout expired, this is not an error, but the requests
+                // were still submitted
+                m_numToSubmit = 0;
+                return true;
+
+            case EINTR:
+                // we got interrupted, update the timeout and restart
+                if ( timeout > 0 )
+                {
+                    timeout = wxMilliClockToLong(timeEnd - wxGetLocalTimeMillis());
+                    if ( timeout <= 0 )
+                        return true;
+                }
+                break;
+
+            case EBUSY:
+            case EAGAIN:
+                // the kernel is short on resources, try again later after
+                // processing the already available completions
+                if ( HasCompletions() )
+                    return true;
+                // fall through
+
+            default:
+                wxLogSysError(_("Waiting for IO on io_uring descriptor %d failed"),
+                              m_ringFD);
+                return false;
+        }
+    }
+}
+
+bool wxIoUringDispatcher::HasCompletions() const
+{
+    return LoadAcquire(m_cqTail) != *m_cqHead;
+}
+
+bool wxIoUringDispatcher::RegisterFD(int fd, wxFDIOHandler* handler, int flags)
+{
+    wxCHECK_MSG( m_entries.find(fd) == m_entries.end(), false,
+                 wxT("descriptor is already registered") );
+
+    Entry entry;
+    entry.handler = handler;
+    entry.flags = flags;
+    entry.generation = m_nextGeneration++;
+    if ( !m_nextGeneration )
+        m_nextGeneration = 1;
+
+    if ( !QueuePoll(fd, entry) )
+    {
+        wxLogError(_("Failed to add descriptor %d to io_uring descriptor %d"),
+                   fd, m_ringFD);
+        return false;
+    }
+
+    m_entries[fd] = entry;
+
+    wxLogTrace(wxIoUringDispatcher_Trace,
+               wxT("Added fd %d (handler %p) to io_uring %d"),
+               fd, handler, m_ringFD);
+
+    return true;
+}
+
+bool wxIoUringDispatcher::ModifyFD(int fd, wxFDIOHandler* handler, int flags)
+{
+    EntriesMap::iterator it = m_entries.find(fd);
+    wxCHECK_MSG( it != m_entries.end(), false,
+                 wxT("modifying unregistered descriptor?") );
+
+    // we can't update the existing poll request as it may have already
+    // completed, so cancel it and create a new registration instead
+    QueuePollRemove(fd, it->second);
+    m_entries.erase(it);
+
+    wxLogTrace(wxIoUringDispatcher_Trace,
+               wxT("Modifying fd %d (handler: %p) on io_uring %d"),
+               fd, handler, m_ringFD);
+
+    return RegisterFD(fd, handler, flags);
+}
+
+bool wxIoUringDispatcher::UnregisterFD(int fd)
+{
+    EntriesMap::iterator it = m_entries.find(fd);
+    if ( it == m_entries.end() )
+        return false;
+
+    // any completions for this registration still in the ring will be
+    // ignored as the descriptor is not found in m_entries any more
+    QueuePollRemove(fd, it->second);
+    m_entries.erase(it);
+
+    wxLogTrace(wxIoUringDispatcher_Trace,
+               wxT("removed fd %d from %d"), fd, m_ringFD);
+
+    return true;
+}
+
+bool wxIoUringDispatcher::HasPending() const
+{
+    if ( HasCompletions() )
+        return true;
+
+    // the queued poll requests for the ready descriptors complete immediately
+    // when they're submitted, so do it now to know whether there are any
+    if ( !m_numToSubmit )
+        return false;
+
+    wxIoUringDispatcher * const self = const_cast<wxIoUringDispatcher *>(this);
+    return self->Enter(0) && HasCompletions();
+}
+
+int wxIoUringDispatcher::ProcessCompletions()
+{
+    // copy the completions to a local buffer and release their slots in the
+    // ring before calling the handlers as they can call Dispatch() again
+    io_uring_cqe cqes[wxIOURING_MAX_COMPLETIONS];
+    unsigned numCQEs = 0;
+
+    const unsigned tail = LoadAcquire(m_cqTail);
+    unsigned head = *m_cqHead;
+    for ( ; head != tail && numCQEs < WXSIZEOF(cqes); head++ )
+        cqes[numCQEs++] = m_cqes[head & *m_cqMask];
+
+    StoreRelease(m_cqHead, head);
+
+    int numEvents = 0;
+    for ( unsigned n = 0; n < numCQEs; n++ )
+    {
+        const io_uring_cqe& cqe = cqes[n];
+
+        const wxUint32 generation = GetGenerationFromUserData(cqe.user_data);
+        if ( !generation )
+        {
+            // completion of a poll removal request, nothing to do
+            continue;
+        }
+
+        const int fd = GetFDFromUserData(cqe.user_data);
+        EntriesMap::iterator it = m_entries.find(fd);
+        if ( it == m_entries.end() || it->second.generation != generation )
+        {
+            // completion of a request for a descriptor which was unregistered
+            // or modified since then
+            continue;
+        }
+
+        // copy the entry as the handler could unregister the descriptor
+        const Entry entry = it->second;
+
+        // the request is not active any more unless it's a multishot one
+        // which didn't terminate, so we need to resubmit it after calling
+        // the handler if the descriptor is still registered then
+        bool needsResubmit = !(cqe.flags & IORING_CQE_F_MORE);
+
+        if ( cqe.res < 0 )
+        {
+            if ( cqe.res == -EINVAL &&
+                    (entry.flags & wxFDIO_EDGE_TRIGGERED) && m_hasMultishotPoll )
+            {
+                // multishot poll requests are only supported since Linux
+                // 5.13, fall back to the level-triggered notifications which
+                // work for the edge-triggered handlers too
+                wxLogTrace(wxIoUringDispatcher_Trace,
+                           wxT("Multishot poll not supported"));
+                m_hasMultishotPoll = false;
+            }
+            else if ( cqe.res != -ECANCELED )
+            {
+                wxLogTrace(wxIoUringDispatcher_Trace,
+                           wxT("Polling fd %d failed: %s"),
+                           fd, wxSysErrorMsg(-cqe.res));
+
+                // don't resubmit the request which would just fail again
+                needsResubmit = false;
+
+                entry.handler->OnExceptionWaiting();
+                numEvents++;
+            }
+        }
+        else
+        {
+            wxUint32 events = cqe.res;
+
+            // note that, as in wxEpollDispatcher, we call OnReadWaiting() on
+            // POLLHUP for compatibility with wxSelectDispatcher
+            if ( entry.flags & wxFDIO_EDGE_TRIGGERED )
+            {
+                if ( events & (POLLIN | POLLHUP) )
+                    entry.handler->OnReadWaiting();
+                if ( events & POLLOUT )
+                    entry.handler->OnWriteWaiting();
+                if ( events & POLLERR )
+                    entry.handler->OnExceptionWaiting();
+            }
+            else if ( events & (POLLIN | POLLHUP) )
+                entry.handler->OnReadWaiting();
+            else if ( events & POLLOUT )
+                entry.handler->OnWriteWaiting();
+            else if ( events & POLLERR )
+                entry.handler->OnExceptionWaiting();
+
+            if ( events )
+                numEvents++;
+        }
+
+        if ( needsResubmit )
+        {
+            it = m_entries.find(fd);
+            if ( it != m_entries.end() && it->second.generation == generation )
+                QueuePoll(fd, it->second);
+        }
+    }
+
+    return numEvents;
+}
+
+int wxIoUringDispatcher::Dispatch(int timeout)
+{
+    wxMilliClock_t timeEnd;
+    if ( timeout > 0 )
+        timeEnd = wxGetLocalTimeMillis() + timeout;
+
+    for ( ;; )
+    {
+        // submit the queued requests, even if there are completions available
+        // already, and wait for the new ones only if there are none
+        if ( !Enter(HasCompletions() ? 0 : timeout) )
+            return -1;
+
+        if ( !HasCompletions() )
+        {
+            // the timeout expired
+            return 0;
+        }
+
+        const int numEvents = ProcessCompletions();
+        if ( numEvents || !timeout )
+            return numEvents;
+
+        // all the completions were for the already unregistered descriptors
+        // or for the cancellation requests, continue waiting for the real
+        // events as the caller doesn't expect to get 0 before the timeout
+        if ( timeout > 0 )
+        {
+            timeout = wxMilliClockToLong(timeEnd - wxGetLocalTimeMillis());
+            if ( timeout <= 0 )
+                return 0;
+        }
+    }
+}
+
+#endif // wxHAS_IOURING_DISPATCHER
@@ -1574,6 +1574,9 @@ void wxThread::Exit(ExitCode status)
     }
     wxCATCH_ALL( wxTheApp->OnUnhandledException(); )
 
+    // return the memory cached by this thread for the events allocation
+    wxEventAllocator::ReleaseThreadCache();
+
     // delete C++ thread object if this is a detached thread - user is
     // responsible for doing this for joinable ones
     if ( m_isDetached )
@@ -24,7 +24,6 @@
     #include "wx/log.h"
     #include "wx/module.h"
     #include "wx/app.h"
-    #include "wx/list.h"
     #include "wx/hashmap.h"
     #include "wx/event.h"
 #endif
@@ -39,8 +38,13 @@
 
 #include "wx/unix/private/timer.h"
 
-#include "wx/listimpl.cpp"
-WX_DEFINE_LIST(wxTimerList)
+#ifdef wxHAS_TIMERFD
+    #include "wx/private/fdiodispatcher.h"
+
+    #include <sys/timerfd.h>
+    #include <unistd.h>
+    #include <string.h>
+#endif // wxHAS_TIMERFD
 
 // trace mask for the debugging messages used here
 #define wxTrace_Timer wxT("timer")
@@ -59,6 +63,141 @@ static inline wxString wxUsecClockAsString(wxUsecClock_t usec)
     #endif
 }
 
+// ============================================================================
+// wxTimerFDHandler: notifies wxTimerScheduler when its timer fd expires
+// ============================================================================
+
+#ifdef wxHAS_TIMERFD
+
+class wxTimerFDHandler : public wxFDIOHandler
+{
+public:
+    // create the timer fd and register it with the global IO dispatcher,
+    // return NULL if either of these operations fails
+    static wxTimerFDHandler *Create();
+
+    virtual ~wxTimerFDHandler();
+
+    // arm the timer fd to expire at the given absolute time or disarm it if
+    // the expiration time is 0
+    void SetExpiration(wxUsecClock_t expiration);
+
+    // implement wxFDIOHandler pure virtual methods
+    virtual void OnReadWaiting();
+    virtual void OnWriteWaiting() { wxFAIL_MSG( wxT("unexpected") ); }
+    virtual void OnExceptionWaiting() { wxFAIL_MSG( wxT("unexpected") ); }
+
+private:
+    wxTimerFDHandler(int fd)
+        : m_fd(fd)
+    {
+        m_dispatcher = NULL;
+        m_expiration = 0;
+    }
+
+    // the timer fd itself
+    const int m_fd;
+
+    // the dispatcher we're registered with or NULL if we're not (yet)
+    wxFDIODispatcher *m_dispatcher;
+
+    // the time for which the timer fd is currently armed or 0 if it isn't
+    wxUsecClock_t m_expiration;
+
+    wxDECLARE_NO_COPY_CLASS(wxTimerFDHandler);
+};
+
+/* static */
+wxTimerFDHandler *wxTimerFDHandler::Create()
+{
+    // notice that we use the same clock as wxGetUTCTimeUSec() which is used
+    // for computing the timers expiration times
+    const int fd = timerfd_create(CLOCK_REALTIME, TFD_NONBLOCK | TFD_CLOEXEC);
+    if ( fd == -1 )
+    {
+        wxLogTrace(wxTrace_Timer, wxT("Failed to create timer fd: %s"),
+                   wxSysErrorMsg());
+        return NULL;
+    }
+
+    wxTimerFDHandler * const handler = new wxTimerFDHandler(fd);
+
+    wxFDIODispatcher * const dispatcher = wxFDIODispatcher::Get();
+    if ( !dispatcher || !dispatcher->RegisterFD(fd, handler, wxFDIO_INPUT) )
+    {
+        wxLogTrace(wxTrace_Timer, wxT("Failed to register timer fd %d"), fd);
+
+        delete handler;
+        return NULL;
+    }
+
+    handler->m_dispatcher = dispatcher;
+
+    wxLogTrace(wxTrace_Timer, wxT("Using timer fd %d"), fd);
+
+    return handler;
+}
+
+wxTimerFDHandler::~wxTimerFDHandler()
+{
+    if ( m_dispatcher )
+        m_dispatcher->UnregisterFD(m_fd);
+
+    close(m_fd);
+}
+
+void wxTimerFDHandler::SetExpiration(wxUsecClock_t expiration)
+{
+    // avoid the system call if nothing changes, which is the common case when
+    // a timer which doesn't expire first is added or removed
+    if ( expiration == m_expiration )
+        return;
+
+    itimerspec its;
+    memset(&its, 0, sizeof(its));
+
+    if ( expiration != 0 )
+    {
+        const long sec = wxMilliClockToLong(expiration / 1000000);
+        its.it_value.tv_sec = sec;
+        its.it_value.tv_nsec =
+            wxMilliClockToLong(expiration - wxUsecClock_t(sec)*1000000)*1000;
+
+        // all zeroes would disarm the timer instead of arming it
+        if ( !its.it_value.tv_sec && !its.it_value.tv_nsec )
+            its.it_value.tv_nsec = 1;
+    }
+
+    if ( timerfd_settime(m_fd, TFD_TIMER_ABSTIME, &its, NULL) != 0 )
+    {
+        wxLogSysError(_("Failed to set the timer expiration time"));
+        return;
+    }
+
+    m_expiration = expiration;
+}
+
+void wxTimerFDHandler::OnReadWaiting()
+{
+    // reset the fd readiness, we don't need the number of expirations as we
+    // always use the timer fd as a one-shot timer anyhow
+    wxUint64 numExpirations;
+    if ( read(m_fd, &numExpirations, sizeof(numExpirations)) == -1 )
+    {
+        // this is not really an error if the fd was rearmed since we were
+        // woken up, simply don't do anything then
+        return;
+    }
+
+    // the timer fd is disarmed after expiring, NotifyExpired() will rearm it
+    // if there are any timers left
+    m_expiration = 0;
+
+    wxTimerScheduler::Get().OnTimerFDExpired();
+}
+
+#endif // wxHAS_TIMERFD
+
 // ============================================================================
 // wxTimerScheduler implementation
 // ============================================================================
@@ -67,56 +206,137 @@ wxTimerScheduler *wxTimerScheduler::ms_instance = NULL;
 
 wxTimerScheduler::~wxTimerScheduler()
 {
-    for ( wxTimerList::iterator node = m_timers.begin();
-          node != m_timers.end();
-          ++node )
+#ifdef wxHAS_TIMERFD
+    delete m_timerFD;
+#endif // wxHAS_TIMERFD
+
+    for ( wxTimerHeap::iterator i = m_timers.begin(); i != m_timers.end(); ++i )
     {
-        delete *node;
+        (*i)->m_timer->m_schedule = NULL;
+        delete *i;
     }
 }
 
-void wxTimerScheduler::AddTimer(wxUnixTimerImpl *timer, wxUsecClock_t expiration)
+void wxTimerScheduler::SetAt(size_t index, wxTimerSchedule *s)
 {
-    DoAddTimer(new wxTimerSchedule(timer, expiration));
+    m_timers[index] = s;
+    s->m_index = index;
 }
 
-void wxTimerScheduler::DoAddTimer(wxTimerSchedule *s)
+void wxTimerScheduler::SiftUp(size_t index, wxTimerSchedule *s)
+{
+    while ( index > 0 )
+    {
+        const size_t parent = (index - 1) / 2;
+        if ( !ExpiresBefore(s, m_timers[parent]) )
+            break;
+
+        SetAt(index, m_timers[parent]);
+        index = parent;
+    }
+
+    SetAt(index, s);
+}
+
+void wxTimerScheduler::SiftDown(size_t index, wxTimerSchedule *s)
 {
-    // do an insertion sort to keep the list sorted in expiration order
-    wxTimerList::iterator node;
-    for ( node = m_timers.begin(); node != m_timers.end(); ++node )
+    const size_t count = m_timers.size();
+    for ( ;; )
     {
-        wxASSERT_MSG( (*node)->m_timer != s->m_timer,
-                      wxT("adding the same timer twice?") );
+        size_t child = 2*index + 1;
+        if ( child >= count )
+            break;
+
+        if ( child + 1 < count &&
+                ExpiresBefore(m_timers[child + 1], m_timers[child]) )
+            child++;
 
-        if ( (*node)->m_expiration > s->m_expiration )
+        if ( !ExpiresBefore(m_timers[child], s) )
             break;
+
+        SetAt(index, m_timers[child]);
+        index = child;
     }
 
-    m_timers.insert(node, s);
+    SetAt(index, s);
+}
+
+void wxTimerScheduler::AddTimer(wxUnixTimerImpl *timer, wxUsecClock_t expiration)
+{
+    wxASSERT_MSG( !timer->m_schedule, wxT("adding the same timer twice?") );
+
+    wxTimerSchedule * const s = new wxTimerSchedule(timer, expiration);
+    timer->m_schedule = s;
+
+    DoAddTimer(s);
+
+    UpdateTimerFD();
+}
+
+void wxTimerScheduler::DoAddTimer(wxTimerSchedule *s)
+{
+    // the timers with the same expiration time expire in the order in which
+    // they were added
+    s->m_seq = m_nextSeq++;
+
+    m_timers.push_back(s);
+    SiftUp(m_timers.size() - 1, s);
 
     wxLogTrace(wxTrace_Timer, wxT("Inserted timer %d expiring at %s"),
                s->m_timer->GetId(),
                wxUsecClockAsString(s->m_expiration).c_str());
 }
 
+void wxTimerScheduler::DoRemoveTimer(size_t index)
+{
+    // replace the removed element with the last one and move it either up or
+    // down, as needed, to restore the heap property
+    wxTimerSchedule * const last = m_timers.back();
+    m_timers.pop_back();
+
+    if ( index == m_timers.size() )
+        return;
+
+    if ( index > 0 && ExpiresBefore(last, m_timers[(index - 1) / 2]) )
+        SiftUp(index, last);
+    else
+        SiftDown(index, last);
+}
+
 void wxTimerScheduler::RemoveTimer(wxUnixTimerImpl *timer)
 {
     wxLogTrace(wxTrace_Timer, wxT("Removing timer %d"), timer->GetId());
 
-    for ( wxTimerList::iterator node = m_timers.begin();
-          node != m_timers.end();
-          ++node )
+    wxTimerSchedule * const s = timer->m_schedule;
+    wxCHECK_RET( s, wxT("removing inexistent timer?") );
+
+    DoRemoveTimer(s->m_index);
+
+    timer->m_schedule = NULL;
+    delete s;
+
+    UpdateTimerFD();
+}
+
+void wxTimerScheduler::UpdateTimerFD()
+{
+#ifdef wxHAS_TIMERFD
+    if ( !m_triedTimerFD )
     {
-        if ( (*node)->m_timer == timer )
-        {
-            delete *node;
-            m_timers.erase(node);
+        // don't create the timer fd until it's really needed
+        if ( m_timers.empty() )
             return;
-        }
+
+        // and don't try to create it again if it fails, we'll just fall back
+        // to letting the event loop poll for the timers expiration then
+        m_triedTimerFD = true;
+        m_timerFD = wxTimerFDHandler::Create();
     }
 
-    wxFAIL_MSG( wxT("removing inexistent timer?") );
+    if ( m_timerFD )
+        m_timerFD->SetExpiration(m_timers.empty() ? wxUsecClock_t(0)
+                                                  : m_timers[0]->m_expiration);
+#endif // wxHAS_TIMERFD
 }
 
 bool wxTimerScheduler::GetNext(wxUsecClock_t *remaining) const
@@ -126,7 +346,7 @@ bool wxTimerScheduler::GetNext(wxUsecClock_t *remaining) const
 
     wxCHECK_MSG( remaining, false, wxT("NULL pointer") );
 
-    *remaining = (*m_timers.begin())->m_expiration - wxGetUTCTimeUSec();
+    *remaining = m_timers[0]->m_expiration - wxGetUTCTimeUSec();
     if ( *remaining < 0 )
     {
         // timer already expired, don't wait at all before notifying it
@@ -138,6 +358,17 @@ bool wxTimerScheduler::GetNext(wxUsecClock_t *remaining) const
 
 bool wxTimerScheduler::NotifyExpired()
 {
+#ifdef wxHAS_TIMERFD
+    if ( m_timerFD )
+    {
+        // no timers can have expired if the timer fd didn't
+        if ( !m_timerFDExpired )
+            return false;
+
+        m_timerFDExpired = false;
+    }
+#endif // wxHAS_TIMERFD
+
     if ( m_timers.empty() )
       return false;
 
@@ -145,30 +376,30 @@ bool wxTimerScheduler::NotifyExpired()
 
     typedef wxVector<wxUnixTimerImpl *> TimerImpls;
     TimerImpls toNotify;
-    for ( wxTimerList::iterator next,
-            cur = m_timers.begin(); cur != m_timers.end(); cur = next )
+
+    typedef wxVector<wxTimerSchedule *> TimerSchedules;
+    TimerSchedules toReschedule;
+
+    while ( !m_timers.empty() )
     {
-        wxTimerSchedule * const s = *cur;
+        wxTimerSchedule * const s = m_timers[0];
         if ( s->m_expiration > now )
         {
-            // as the list is sorted by expiration time, we can skip the rest
+            // as the heap top expires first, all the other timers are later
             break;
         }
 
-        // remember next as we will delete the node pointed to by cur
-        next = cur;
-        ++next;
-
-        m_timers.erase(cur);
+        DoRemoveTimer(0);
 
         // check whether we need to keep this timer
         wxUnixTimerImpl * const timer = s->m_timer;
         if ( timer->IsOneShot() )
         {
             // the timer needs to be stopped but don't call its Stop() from
-            // here as it would attempt to remove the timer from our list and
+            // here as it would attempt to remove the timer from our heap and
             // we had already done it, so we just need to reset its state
             timer->MarkStopped();
+            timer->m_schedule = NULL;
 
             // don't need it any more
             delete s;
@@ -180,16 +411,29 @@ bool wxTimerScheduler::NotifyExpired()
             // expiration time because it could happen that we're late and the
             // current expiration time is (far) in the past
             s->m_expiration = now + timer->GetInterval()*1000;
-            DoAddTimer(s);
+
+            // but don't add it back to the heap before we're done with it as
+            // it could expire again immediately if its interval is 0
+            toReschedule.push_back(s);
         }
 
         // we can't notify the timer from this loop as the timer event handler
         // could modify m_timers (for example, but not only, by stopping this
-        // timer) which would render our iterators invalid, so do it after the
+        // timer) which would break our iteration over it, so do it after the
         // loop end
         toNotify.push_back(timer);
     }
 
+    for ( TimerSchedules::const_iterator i = toReschedule.begin(),
+                                         end = toReschedule.end();
+          i != end;
+          ++i )
+    {
+        DoAddTimer(*i);
+    }
+
+    UpdateTimerFD();
+
     if ( toNotify.empty() )
         return false;
 
@@ -212,6 +456,7 @@ wxUnixTimerImpl::wxUnixTimerImpl(wxTimer* timer)
                : wxTimerImpl(timer)
 {
     m_isRunning = false;
+    m_schedule = NULL;
 }
 
 bool wxUnixTimerImpl::Start(int milliseconds, bool oneShot)
@@ -252,7 +497,15 @@ wxUnixTimerImpl::~wxUnixTimerImpl()
 class wxTimerUnixModule : public wxModule
 {
 public:
-    wxTimerUnixModule() {}
+    wxTimerUnixModule()
+    {
+#ifdef wxHAS_TIMERFD
+        // the timer fd is registered with the global IO dispatcher, so it must
+        // still exist when we're cleaned up
+        AddDependency("wxFDIODispatcherModule");
+#endif // wxHAS_TIMERFD
+    }
+
     virtual bool OnInit() { return true; }
     virtual void OnExit() { wxTimerScheduler::Shutdown(); }
 
@@ -174,6 +174,7 @@ private:
         CPPUNIT_TEST( Clear );
         CPPUNIT_TEST( Swap );
         CPPUNIT_TEST( IndexFromEnd );
+        CPPUNIT_TEST( MoveStrings );
     CPPUNIT_TEST_SUITE_END();
 
     void wxStringArrayTest();
@@ -190,6 +191,7 @@ private:
     void Clear();
     void Swap();
     void IndexFromEnd();
+    void MoveStrings();
 
     DECLARE_NO_COPY_CLASS(ArraysTestCase)
 };
@@ -730,3 +732,78 @@ void ArraysTestCase::IndexFromEnd()
     CPPUNIT_ASSERT_EQUAL( 1, a.Index(1, /*bFromEnd=*/true) );
     CPPUNIT_ASSERT_EQUAL( 2, a.Index(42, /*bFromEnd=*/true) );
 }
+
+void ArraysTestCase::MoveStrings()
+{
+    wxArrayString a;
+    for ( int n = 0; n < 100; n++ )
+        a.Add(wxString::Format("%d", n));
+
+    // inserting an element of the array itself must work even though the
+    // existing elements are moved to make place for it
+    a.Insert(a[1], 0);
+    CPPUNIT_ASSERT_EQUAL( 101, a.size() );
+    CPPUNIT_ASSERT_EQUAL( "1", a[0] );
+    CPPUNIT_ASSERT_EQUAL( "0", a[1] );
+    CPPUNIT_ASSERT_EQUAL( "99", a[100] );
+
+    a.RemoveAt(0, 2);
+    CPPUNIT_ASSERT_EQUAL( 99, a.size() );
+    CPPUNIT_ASSERT_EQUAL( "1", a[0] );
+    CPPUNIT_ASSERT_EQUAL( "99", a[98] );
+
+#ifdef wxHAS_RVALUE_REF
+    wxString s("moved");
+    a.Add(std::move(s));
+    CPPUNIT_ASSERT_EQUAL( "moved", a.Last() );
+    CPPUNIT_ASSERT( s.empty() );
+
+    s = "inserted";
+    a.Insert(std::move(s), 1);
+    CPPUNIT_ASSERT_EQUAL( "1", a[0] );
+    CPPUNIT_ASSERT_EQUAL( "inserted", a[1] );
+    CPPUNIT_ASSERT_EQUAL( "2", a[2] );
+
+    wxSortedArrayString sorted;
+    sorted.Add(wxString("foo"));
+    sorted.Add(wxString("bar"));
+    s = "baz";
+    sorted.Add(std::move(s));
+    CPPUNIT_ASSERT_EQUAL( "bar", sorted[0] );
+    CPPUNIT_ASSERT_EQUAL( "baz", sorted[1] );
+    CPPUNIT_ASSERT_EQUAL( "foo", sorted[2] );
+
+    wxArrayString a2(std::move(a));
+    CPPUNIT_ASSERT_EQUAL( 101, a2.size() );
+    CPPUNIT_ASSERT_EQUAL( "moved", a2.Last() );
+
+    a = std::move(sorted);
+    CPPUNIT_ASSERT_EQUAL( 3, a.size() );
+    CPPUNIT_ASSERT_EQUAL( "baz", a[1] );
+
+    // the sort flag is taken from the source array, as when copying, while
+    // the moved-from arrays must be empty and keep their own flags
+    a.Add("aaa");
+    CPPUNIT_ASSERT_EQUAL( "aaa", a[0] );
+
+    CPPUNIT_ASSERT( sorted.empty() );
+    sorted.Add("z");
+    sorted.Add("a");
+    CPPUNIT_ASSERT_EQUAL( "a", sorted[0] );
+
+    wxSortedArrayString sorted2(std::move(sorted));
+    CPPUNIT_ASSERT_EQUAL( 2, sorted2.size() );
+    sorted2.Add("b");
+    CPPUNIT_ASSERT_EQUAL( "b", sorted2[1] );
+
+    a2 = std::move(a);
+    CPPUNIT_ASSERT_EQUAL( 4, a2.size() );
+    a2.Add("abc");
+    CPPUNIT_ASSERT_EQUAL( "abc", a2[1] );
+
+    CPPUNIT_ASSERT( a.empty() );
+    a.Add("b");
+    a.Add("a");
+    CPPUNIT_ASSERT_EQUAL( "a", a[0] );
+#endif // wxHAS_RVALUE_REF
+}
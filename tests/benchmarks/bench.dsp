@@ -243,6 +243,14 @@ SOURCE=.\datetime.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=.\events.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=.\fdio.cpp
+# End Source File
+# Begin Source File
+
 SOURCE=.\htmlparser\htmlpars.cpp
 # End Source File
 # Begin Source File
@@ -267,6 +275,10 @@ SOURCE=.\strings.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=.\timers.cpp
+# End Source File
+# Begin Source File
+
 SOURCE=.\tls.cpp
 # End Source File
 # End Group
@@ -0,0 +1,116 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        tests/benchmarks/events.cpp
+// Purpose:     Event processing benchmarks
+// Author:      agent
+// Created:     2026-10-16
+// RCS-ID:      $Id$
+// Copyright:   (c) 2026 agent <agent@local>
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#include "wx/app.h"
+#include "wx/event.h"
+
+#include "bench.h"
+
+// number of Bind() calls done for the handler, can be changed using the
+// numeric parameter, i.e. "-p 1000" command line option
+static long GetNumBinds()
+{
+    const long n = Bench::GetNumericParameter();
+    return n > 1 ? n : 100;
+}
+
+namespace
+{
+
+class BenchHandler : public wxEvtHandler
+{
+public:
+    void OnEvent(wxEvent& WXUNUSED(event)) { }
+};
+
+// the event type and the handler used by the benchmarks below, created once
+// by InitBindHandler() and destroyed by DoneBindHandler()
+wxEventType gs_benchEventType = wxEVT_NULL;
+BenchHandler *gs_handler = NULL;
+
+bool InitBindHandler()
+{
+    if ( gs_benchEventType == wxEVT_NULL )
+        gs_benchEventType = wxNewEventType();
+
+    gs_handler = new BenchHandler;
+
+    // simulate a window with many handlers for different ids and a few other
+    // event types, which is typical for generated UIs
+    const long numBinds = GetNumBinds();
+    for ( long n = 0; n < numBinds; n++ )
+    {
+        const wxEventType type = n % 10 ? gs_benchEventType
+                                        : wxEventType(wxEVT_IDLE);
+        gs_handler->Connect(n, type, wxEventHandler(BenchHandler::OnEvent));
+    }
+
+    return true;
+}
+
+void DoneBindHandler()
+{
+    delete gs_handler;
+    gs_handler = NULL;
+}
+
+} // anonymous namespace
+
+// dispatch an event with an id for which there is a handler
+BENCHMARK_FUNC_WITH_INIT(ProcessBoundEvent, InitBindHandler, DoneBindHandler)
+{
+    wxThreadEvent event(gs_benchEventType, GetNumBinds() / 2 + 1);
+    return gs_handler->ProcessEvent(event);
+}
+
+// dispatch an event of a type without any handlers at all, this is the most
+// common case for e.g. mouse move events
+BENCHMARK_FUNC_WITH_INIT(ProcessUnboundEvent, InitBindHandler, DoneBindHandler)
+{
+    wxThreadEvent event(wxEVT_NULL, 1);
+    return !gs_handler->ProcessEvent(event);
+}
+
+BENCHMARK_FUNC(BindUnbind)
+{
+    BenchHandler handler;
+
+    const long numBinds = GetNumBinds();
+    for ( long n = 0; n < numBinds; n++ )
+    {
+        handler.Connect(n, wxEVT_IDLE,
+                        wxEventHandler(BenchHandler::OnEvent));
+    }
+
+    bool ok = true;
+    for ( long n = 0; n < numBinds; n++ )
+    {
+        if ( !handler.Disconnect(n, wxEVT_IDLE,
+                                 wxEventHandler(BenchHandler::OnEvent)) )
+            ok = false;
+    }
+
+    return ok;
+}
+
+// queue many events and then process all of them, this mostly measures the
+// overhead of allocating and freeing the events and the queue nodes
+BENCHMARK_FUNC(QueueEvents)
+{
+    BenchHandler handler;
+    handler.Connect(wxEVT_THREAD, wxEventHandler(BenchHandler::OnEvent));
+
+    for ( int n = 0; n < 1000; n++ )
+        handler.QueueEvent(new wxThreadEvent);
+
+    wxTheApp->ProcessPendingEvents();
+
+    return !wxTheApp->HasPendingEvents();
+}
@@ -0,0 +1,162 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        tests/benchmarks/fdio.cpp
+// Purpose:     wxFDIODispatcher benchmarks
+// Author:      agent
+// Created:     2026-10-16
+// RCS-ID:      $Id$
+// Copyright:   (c) 2026 agent <agent@local>
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#include "wx/defs.h"
+
+#ifdef __UNIX__
+
+#include "wx/vector.h"
+#include "wx/private/fdiodispatcher.h"
+
+#include "bench.h"
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+// number of socket pairs used by the benchmarks, can be changed using the
+// numeric parameter, i.e. "-p 100" command line option
+static long GetNumSocketPairs()
+{
+    const long n = Bench::GetNumericParameter();
+    return n > 0 ? n : 1000;
+}
+
+namespace
+{
+
+// handler reading everything available from the socket it's associated with
+class SocketReader : public wxFDIOHandler
+{
+public:
+    SocketReader(int fd) : m_fd(fd) { }
+
+    virtual void OnReadWaiting()
+    {
+        char buf[64];
+        for ( ;; )
+        {
+            const ssize_t rc = read(m_fd, buf, sizeof(buf));
+            if ( rc <= 0 )
+                break;
+
+            ms_numBytesRead += rc;
+        }
+    }
+
+    virtual void OnWriteWaiting() { }
+    virtual void OnExceptionWaiting() { }
+
+    int GetFD() const { return m_fd; }
+
+    static long ms_numBytesRead;
+
+private:
+    const int m_fd;
+};
+
+long SocketReader::ms_numBytesRead = 0;
+
+wxVector<SocketReader *> gs_readers;
+wxVector<int> gs_writeFDs;
+
+bool DoInitSocketPairs(int flags)
+{
+    wxFDIODispatcher * const dispatcher = wxFDIODispatcher::Get();
+    if ( !dispatcher )
+        return false;
+
+    const long numPairs = GetNumSocketPairs();
+    for ( long n = 0; n < numPairs; n++ )
+    {
+        int fds[2];
+        if ( socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0 )
+            return false;
+
+        fcntl(fds[0], F_SETFL, fcntl(fds[0], F_GETFL) | O_NONBLOCK);
+
+        SocketReader * const reader = new SocketReader(fds[0]);
+        gs_readers.push_back(reader);
+        gs_writeFDs.push_back(fds[1]);
+
+        if ( !dispatcher->RegisterFD(fds[0], reader, flags) )
+            return false;
+    }
+
+    return true;
+}
+
+bool InitSocketPairs()
+{
+    return DoInitSocketPairs(wxFDIO_INPUT);
+}
+
+bool InitSocketPairsEdgeTriggered()
+{
+    return DoInitSocketPairs(wxFDIO_INPUT | wxFDIO_EDGE_TRIGGERED);
+}
+
+void DoneSocketPairs()
+{
+    wxFDIODispatcher * const dispatcher = wxFDIODispatcher::Get();
+
+    for ( size_t n = 0; n < gs_readers.size(); n++ )
+    {
+        SocketReader * const reader = gs_readers[n];
+        dispatcher->UnregisterFD(reader->GetFD());
+        close(reader->GetFD());
+        delete reader;
+    }
+
+    for ( size_t n = 0; n < gs_writeFDs.size(); n++ )
+        close(gs_writeFDs[n]);
+
+    gs_readers.clear();
+    gs_writeFDs.clear();
+}
+
+// write a byte into every socket pair and dispatch the IO events until all of
+// them are read, as would happen in a busy server with many connections
+bool DispatchAllSocketPairs()
+{
+    SocketReader::ms_numBytesRead = 0;
+
+    const long numPairs = gs_writeFDs.size();
+    for ( long n = 0; n < numPairs; n++ )
+    {
+        if ( write(gs_writeFDs[n], "x", 1) != 1 )
+            return false;
+    }
+
+    wxFDIODispatcher * const dispatcher = wxFDIODispatcher::Get();
+    while ( SocketReader::ms_numBytesRead < numPairs )
+    {
+        if ( dispatcher->Dispatch(1000) <= 0 )
+            return false;
+    }
+
+    return SocketReader::ms_numBytesRead == numPairs;
+}
+
+} // anonymous namespace
+
+BENCHMARK_FUNC_WITH_INIT(DispatchSocketPairs, InitSocketPairs, DoneSocketPairs)
+{
+    return DispatchAllSocketPairs();
+}
+
+BENCHMARK_FUNC_WITH_INIT(DispatchSocketPairsEdgeTriggered,
+                         InitSocketPairsEdgeTriggered, DoneSocketPairs)
+{
+    return DispatchAllSocketPairs();
+}
+
+#endif // __UNIX__
@@ -195,6 +195,23 @@ __LIB_PNG_IF_MONO_p =
 !ifeq MONOLITHIC 1
 __LIB_PNG_IF_MONO_p = $(__LIB_PNG_p)
 !endif
+__bench_gui___depname =
+!ifeq USE_GUI 1
+__bench_gui___depname = $(OBJS)\bench_gui.exe
+!endif
+__WXLIB_CORE_p =
+!ifeq MONOLITHIC 0
+__WXLIB_CORE_p = &
+	wx$(PORTNAME)$(WXUNIVNAME)$(WX_RELEASE_NODOT)$(WXUNICODEFLAG)$(WXDEBUGFLAG)$(WX_LIB_FLAVOUR)_core.lib
+!endif
+__LIB_TIFF_p =
+!ifeq USE_GUI 1
+__LIB_TIFF_p = wxtiff$(WXDEBUGFLAG).lib
+!endif
+__LIB_JPEG_p =
+!ifeq USE_GUI 1
+__LIB_JPEG_p = wxjpeg$(WXDEBUGFLAG).lib
+!endif
 __LIB_PNG_p =
 !ifeq USE_GUI 1
 __LIB_PNG_p = wxpng$(WXDEBUGFLAG).lib
@@ -227,13 +244,26 @@ BENCH_CXXFLAGS = $(__DEBUGINFO_0) $(__OPTIMIZEFLAG_2) $(__THREADSFLAG_5) &
 BENCH_OBJECTS =  &
 	$(OBJS)\bench_bench.obj &
 	$(OBJS)\bench_datetime.obj &
+	$(OBJS)\bench_events.obj &
 	$(OBJS)\bench_htmlpars.obj &
 	$(OBJS)\bench_htmltag.obj &
 	$(OBJS)\bench_ipcclient.obj &
 	$(OBJS)\bench_mbconv.obj &
 	$(OBJS)\bench_strings.obj &
 	$(OBJS)\bench_tls.obj &
+	$(OBJS)\bench_timers.obj &
+	$(OBJS)\bench_fdio.obj &
 	$(OBJS)\bench_printfbench.obj
+BENCH_GUI_CXXFLAGS = $(__DEBUGINFO_0) $(__OPTIMIZEFLAG_2) $(__THREADSFLAG_5) &
+	$(__RUNTIME_LIBS_6) -d__WXMSW__ $(__WXUNIV_DEFINE_p) $(__DEBUG_DEFINE_p) &
+	$(__NDEBUG_DEFINE_p) $(__EXCEPTIONS_DEFINE_p) $(__RTTI_DEFINE_p) &
+	$(__THREAD_DEFINE_p) $(__UNICODE_DEFINE_p) -i=$(SETUPHDIR) &
+	-i=.\..\..\include $(____CAIRO_INCLUDEDIR_FILENAMES_p) -wx -wcd=549 -wcd=656 &
+	-wcd=657 -wcd=667 -i=. $(__DLLFLAG_p) -i=.\..\..\samples -dNOPCH &
+	$(__RTTIFLAG_7) $(__EXCEPTIONSFLAG_8) $(CPPFLAGS) $(CXXFLAGS)
+BENCH_GUI_OBJECTS =  &
+	$(OBJS)\bench_gui_bench.obj &
+	$(OBJS)\bench_gui_quantize.obj
 
 
 all : $(OBJS)
@@ -242,7 +272,7 @@ $(OBJS) :
 
 ### Targets: ###
 
-all : .SYMBOLIC $(OBJS)\bench.exe data
+all : .SYMBOLIC $(OBJS)\bench.exe $(__bench_gui___depname) data
 
 clean : .SYMBOLIC 
 	-if exist $(OBJS)\*.obj del $(OBJS)\*.obj
@@ -251,6 +281,7 @@ clean : .SYMBOLIC
 	-if exist $(OBJS)\*.ilk del $(OBJS)\*.ilk
 	-if exist $(OBJS)\*.pch del $(OBJS)\*.pch
 	-if exist $(OBJS)\bench.exe del $(OBJS)\bench.exe
+	-if exist $(OBJS)\bench_gui.exe del $(OBJS)\bench_gui.exe
 
 $(OBJS)\bench.exe :  $(BENCH_OBJECTS)
 	@%create $(OBJS)\bench.lbc
@@ -264,6 +295,20 @@ $(OBJS)\bench.exe :  $(BENCH_OBJECTS)
 	@for %i in () do @%append $(OBJS)\bench.lbc option stack=%i
 	wlink @$(OBJS)\bench.lbc
 
+!ifeq USE_GUI 1
+$(OBJS)\bench_gui.exe :  $(BENCH_GUI_OBJECTS) $(OBJS)\bench_gui_sample.res
+	@%create $(OBJS)\bench_gui.lbc
+	@%append $(OBJS)\bench_gui.lbc option quiet
+	@%append $(OBJS)\bench_gui.lbc name $^@
+	@%append $(OBJS)\bench_gui.lbc option caseexact
+	@%append $(OBJS)\bench_gui.lbc  $(__DEBUGINFO_1)  libpath $(LIBDIRNAME) system nt ref 'main_' $(____CAIRO_LIBDIR_FILENAMES_p) $(LDFLAGS)
+	@for %i in ($(BENCH_GUI_OBJECTS)) do @%append $(OBJS)\bench_gui.lbc file %i
+	@for %i in ( $(__WXLIB_CORE_p)  $(__WXLIB_BASE_p)  $(__WXLIB_MONO_p) $(__LIB_TIFF_p) $(__LIB_JPEG_p) $(__LIB_PNG_p)  wxzlib$(WXDEBUGFLAG).lib wxregex$(WXUNICODEFLAG)$(WXDEBUGFLAG).lib wxexpat$(WXDEBUGFLAG).lib $(EXTRALIBS_FOR_BASE)  $(__CAIRO_LIB_p) kernel32.lib user32.lib gdi32.lib comdlg32.lib winspool.lib winmm.lib shell32.lib comctl32.lib ole32.lib oleaut32.lib uuid.lib rpcrt4.lib advapi32.lib wsock32.lib wininet.lib) do @%append $(OBJS)\bench_gui.lbc library %i
+	@%append $(OBJS)\bench_gui.lbc option resource=$(OBJS)\bench_gui_sample.res
+	@for %i in () do @%append $(OBJS)\bench_gui.lbc option stack=%i
+	wlink @$(OBJS)\bench_gui.lbc
+!endif
+
 data : .SYMBOLIC 
 	if not exist $(OBJS) mkdir $(OBJS)
 	for %f in (htmltest.html) do if not exist $(OBJS)\%f copy .\%f $(OBJS)
@@ -274,6 +319,9 @@ $(OBJS)\bench_bench.obj :  .AUTODEPEND .\bench.cpp
 $(OBJS)\bench_datetime.obj :  .AUTODEPEND .\datetime.cpp
 	$(CXX) -bt=nt -zq -fo=$^@ $(BENCH_CXXFLAGS) $<
 
+$(OBJS)\bench_events.obj :  .AUTODEPEND .\events.cpp
+	$(CXX) -bt=nt -zq -fo=$^@ $(BENCH_CXXFLAGS) $<
+
 $(OBJS)\bench_htmlpars.obj :  .AUTODEPEND .\htmlparser\htmlpars.cpp
 	$(CXX) -bt=nt -zq -fo=$^@ $(BENCH_CXXFLAGS) $<
 
@@ -292,6 +340,21 @@ $(OBJS)\bench_strings.obj :  .AUTODEPEND .\strings.cpp
 $(OBJS)\bench_tls.obj :  .AUTODEPEND .\tls.cpp
 	$(CXX) -bt=nt -zq -fo=$^@ $(BENCH_CXXFLAGS) $<
 
+$(OBJS)\bench_timers.obj :  .AUTODEPEND .\timers.cpp
+	$(CXX) -bt=nt -zq -fo=$^@ $(BENCH_CXXFLAGS) $<
+
+$(OBJS)\bench_fdio.obj :  .AUTODEPEND .\fdio.cpp
+	$(CXX) -bt=nt -zq -fo=$^@ $(BENCH_CXXFLAGS) $<
+
 $(OBJS)\bench_printfbench.obj :  .AUTODEPEND .\printfbench.cpp
 	$(CXX) -bt=nt -zq -fo=$^@ $(BENCH_CXXFLAGS) $<
 
+$(OBJS)\bench_gui_sample.res :  .AUTODEPEND .\..\..\samples\sample.rc
+	wrc -q -ad -bt=nt -r -fo=$^@    -d__WXMSW__ $(__WXUNIV_DEFINE_p) $(__DEBUG_DEFINE_p) $(__NDEBUG_DEFINE_p) $(__EXCEPTIONS_DEFINE_p) $(__RTTI_DEFINE_p) $(__THREAD_DEFINE_p) $(__UNICODE_DEFINE_p)  -i=$(SETUPHDIR) -i=.\..\..\include $(____CAIRO_INCLUDEDIR_FILENAMES_p) -i=. $(__DLLFLAG_p) -i=.\..\..\samples -dNOPCH $<
+
+$(OBJS)\bench_gui_bench.obj :  .AUTODEPEND .\bench.cpp
+	$(CXX) -bt=nt -zq -fo=$^@ $(BENCH_GUI_CXXFLAGS) $<
+
+$(OBJS)\bench_gui_quantize.obj :  .AUTODEPEND .\quantize.cpp
+	$(CXX) -bt=nt -zq -fo=$^@ $(BENCH_GUI_CXXFLAGS) $<
+
@@ -77,3 +77,22 @@ BENCHMARK_FUNC(UTF16Sys)
     return ConvertToMB(wxCSConv("UTF-16LE"));
 }
 
+
+BENCHMARK_FUNC(UTF8LenWX)
+{
+    return ComputeMBLength(wxMBConvStrictUTF8());
+}
+
+BENCHMARK_FUNC(UTF8WX)
+{
+    return ConvertToMB(wxMBConvStrictUTF8());
+}
+
+BENCHMARK_FUNC(UTF8ToWCharWX)
+{
+    static const wxCharBuffer utf8 = wxConvUTF8.cWC2MB(TEST_STRING);
+
+    const size_t len = wcslen(TEST_STRING) + 1;
+    wxWCharBuffer buf(len - 1);
+    return wxConvUTF8.ToWChar(buf.data(), len, utf8) == len;
+}
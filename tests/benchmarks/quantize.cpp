@@ -0,0 +1,125 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        tests/benchmarks/quantize.cpp
+// Purpose:     wxQuantize benchmarks
+// Author:      agent
+// Created:     2026-10-16
+// RCS-ID:      $Id$
+// Copyright:   (c) 2026 agent <agent@local>
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#include "wx/defs.h"
+
+#if wxUSE_GUI
+
+#include "wx/image.h"
+#include "wx/quantize.h"
+
+#include "bench.h"
+
+#include <math.h>
+
+namespace
+{
+
+wxImage gs_image,
+        gs_quantized;
+
+// the number of colours to quantize to, can be changed using the numeric
+// parameter, i.e. "-p 16" command line option
+int GetNumColours()
+{
+    const long n = Bench::GetNumericParameter();
+    return n >= 2 && n <= 256 ? n : 236;
+}
+
+// create an image with smooth gradients and some noise, which is a reasonably
+// realistic (and difficult) input for the quantizers, unless an image file is
+// given using the string parameter, i.e. "-s image.png" option
+bool InitImage()
+{
+    const wxString file = Bench::GetStringParameter();
+    if ( !file.empty() )
+    {
+        wxInitAllImageHandlers();
+
+        if ( !gs_image.LoadFile(file) )
+        {
+            wxPrintf("Failed to load \"%s\".\n", file);
+            return false;
+        }
+
+        return true;
+    }
+
+    const int width = 1920,
+              height = 1080;
+
+    gs_image.Create(width, height, false);
+
+    unsigned char *p = gs_image.GetData();
+    for ( int y = 0; y < height; y++ )
+    {
+        for ( int x = 0; x < width; x++ )
+        {
+            const int noise = rand() % 16;
+            *p++ = (unsigned char)((255*x)/width);
+            *p++ = (unsigned char)((255*y)/height);
+            *p++ = (unsigned char)(128 + 64*sin(x/50.) + 48*cos(y/30.) + noise);
+        }
+    }
+
+    return true;
+}
+
+// compute the PSNR of the quantized image compared to the original one
+double ComputePSNR(const wxImage& orig, const wxImage& image)
+{
+    const unsigned char *p1 = orig.GetData(),
+                        *p2 = image.GetData();
+    const long size = 3L*orig.GetWidth()*orig.GetHeight();
+
+    double sum = 0;
+    for ( long n = 0; n < size; n++ )
+    {
+        const int d = p1[n] - p2[n];
+        sum += d*d;
+    }
+
+    if ( sum == 0 )
+        return HUGE_VAL;
+
+    return 10*log10(255.*255.*size/sum);
+}
+
+// show the quality of the last result as the speed is not everything
+void DoneImage()
+{
+    if ( gs_quantized.IsOk() )
+        wxPrintf("(PSNR = %.2fdB) ", ComputePSNR(gs_image, gs_quantized));
+
+    gs_quantized = wxImage();
+    gs_image = wxImage();
+}
+
+bool DoQuantize(int flags)
+{
+    gs_quantized = wxImage();
+
+    return wxQuantize::Quantize(gs_image, gs_quantized, NULL, GetNumColours(),
+                                NULL, flags | wxQUANTIZE_FILL_DESTINATION_IMAGE);
+}
+
+} // anonymous namespace
+
+BENCHMARK_FUNC_WITH_INIT(QuantizeDefault, InitImage, DoneImage)
+{
+    return DoQuantize(0);
+}
+
+BENCHMARK_FUNC_WITH_INIT(QuantizeFast, InitImage, DoneImage)
+{
+    return DoQuantize(wxQUANTIZE_FAST);
+}
+
+#endif // wxUSE_GUI
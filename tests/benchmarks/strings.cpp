@@ -59,6 +59,22 @@ const wxString& GetTestAsciiString()
     return testString;
 }
 
+const wxString& GetTestUTF8String()
+{
+    static wxString testString;
+    if ( testString.empty() )
+    {
+        long num = Bench::GetNumericParameter();
+        if ( !num )
+            num = 1;
+
+        for ( long n = 0; n < num; n++ )
+            testString += wxString::FromUTF8(utf8str);
+    }
+
+    return testString;
+}
+
 } // anonymous namespace
 
 // this is just a baseline
@@ -219,6 +235,47 @@ BENCHMARK_FUNC(ForStringIndex)
     return true;
 }
 
+BENCHMARK_FUNC(ForStringIndexUTF8)
+{
+    const wxString& s = GetTestUTF8String();
+    const size_t len = s.length();
+    for ( size_t n = 0; n < len; n++ )
+    {
+        if ( s[n] == '~' )
+            return false;
+    }
+
+    return true;
+}
+
+// in UTF-8 build the position cache doesn't help with this one, but the
+// position index does
+BENCHMARK_FUNC(ForStringIndexBackwardsUTF8)
+{
+    const wxString& s = GetTestUTF8String();
+    for ( size_t n = s.length(); n > 0; n-- )
+    {
+        if ( s[n - 1] == '~' )
+            return false;
+    }
+
+    return true;
+}
+
+BENCHMARK_FUNC(FindAndMidUTF8)
+{
+    const wxString& s = GetTestUTF8String();
+    const wxString digit("9");
+    for ( size_t pos = s.find(digit); pos != wxString::npos;
+          pos = s.find(digit, pos + 1) )
+    {
+        if ( s.Mid(pos, 2).empty() )
+            return false;
+    }
+
+    return true;
+}
+
 BENCHMARK_FUNC(ForStringIter)
 {
     const wxString& s = GetTestAsciiString();
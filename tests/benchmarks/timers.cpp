@@ -0,0 +1,98 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        tests/benchmarks/timers.cpp
+// Purpose:     wxTimer benchmarks
+// Author:      agent
+// Created:     2026-10-16
+// RCS-ID:      $Id$
+// Copyright:   (c) 2026 agent <agent@local>
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#include "wx/event.h"
+#include "wx/timer.h"
+#include "wx/vector.h"
+
+#include "bench.h"
+
+// number of timers used by the benchmarks, can be changed using the numeric
+// parameter, i.e. "-p 1000" command line option
+static long GetNumTimers()
+{
+    const long n = Bench::GetNumericParameter();
+    return n > 0 ? n : 100000;
+}
+
+namespace
+{
+
+// the intervals of the timers are chosen so that they never expire during the
+// benchmark and are not added in order
+int GetTimerInterval(long n)
+{
+    return 1000000 + (n*7919) % 100000;
+}
+
+wxEvtHandler *gs_owner = NULL;
+wxVector<wxTimer *> gs_timers;
+
+bool InitTimers()
+{
+    gs_owner = new wxEvtHandler;
+
+    const long numTimers = GetNumTimers();
+    gs_timers.reserve(numTimers);
+    for ( long n = 0; n < numTimers; n++ )
+        gs_timers.push_back(new wxTimer(gs_owner, n));
+
+    return true;
+}
+
+void DoneTimers()
+{
+    for ( size_t n = 0; n < gs_timers.size(); n++ )
+        delete gs_timers[n];
+
+    gs_timers.clear();
+
+    delete gs_owner;
+    gs_owner = NULL;
+}
+
+bool InitRunningTimers()
+{
+    InitTimers();
+
+    for ( size_t n = 0; n < gs_timers.size(); n++ )
+        gs_timers[n]->Start(GetTimerInterval(n), true);
+
+    return true;
+}
+
+} // anonymous namespace
+
+// start all timers and then stop them in a different order
+BENCHMARK_FUNC_WITH_INIT(StartStopTimers, InitTimers, DoneTimers)
+{
+    const size_t numTimers = gs_timers.size();
+    for ( size_t n = 0; n < numTimers; n++ )
+        gs_timers[n]->Start(GetTimerInterval(n), true);
+
+    for ( size_t n = 0; n < numTimers; n++ )
+        gs_timers[(n*7) % numTimers]->Stop();
+
+    return true;
+}
+
+// restart some of many running timers, as done with the timeouts of the
+// network connections whenever there is some activity on them
+BENCHMARK_FUNC_WITH_INIT(RestartTimers, InitRunningTimers, DoneTimers)
+{
+    const size_t numTimers = gs_timers.size();
+    for ( size_t n = 0; n < 1000; n++ )
+    {
+        const size_t i = (n*7919) % numTimers;
+        gs_timers[i]->Start(GetTimerInterval(n), true);
+    }
+
+    return true;
+}
@@ -17,7 +17,10 @@
     #pragma hdrstop
 #endif
 
+#include "wx/app.h"
 #include "wx/event.h"
+#include "wx/thread.h"
+#include "wx/tls.h"
 
 // ----------------------------------------------------------------------------
 // test events and their handlers
@@ -144,6 +147,173 @@ BEGIN_EVENT_TABLE(MyClassWithEventTable, wxEvtHandler)
     //EVT_IDLE(MyClassWithEventTable::OnAnotherEvent)
 END_EVENT_TABLE()
 
+// handler counting the thread events it gets and checking that the events
+// with the same id are received in the order of their GetInt() values, either
+// without any gaps (inOrder) or possibly with them (increasing)
+class ThreadEventCounter : public wxEvtHandler
+{
+public:
+    enum { MAX_ID = 4 };
+
+    ThreadEventCounter()
+    {
+        count = 0;
+        inOrder =
+        increasing = true;
+        for ( int n = 0; n < MAX_ID; n++ )
+            last[n] = -1;
+    }
+
+    void OnThreadEvent(wxThreadEvent& event)
+    {
+        const int id = event.GetId();
+        if ( event.GetInt() != last[id] + 1 )
+            inOrder = false;
+        if ( event.GetInt() <= last[id] )
+            increasing = false;
+        last[id] = event.GetInt();
+        count++;
+    }
+
+    int count;
+    bool inOrder,
+         increasing;
+    int last[MAX_ID];
+
+private:
+    DECLARE_EVENT_TABLE()
+};
+
+BEGIN_EVENT_TABLE(ThreadEventCounter, wxEvtHandler)
+    EVT_THREAD(wxID_ANY, ThreadEventCounter::OnThreadEvent)
+END_EVENT_TABLE()
+
+// handler appending its name to the given string for each event it processes
+// and deleting itself after the given number of them if it's positive
+class RecordingHandler : public wxEvtHandler
+{
+public:
+    RecordingHandler(wxString& record, char name, int deleteAfter = 0)
+        : m_record(record), m_name(name), m_deleteAfter(deleteAfter)
+    {
+        Connect(wxEVT_THREAD, wxThreadEventHandler(RecordingHandler::OnThread));
+    }
+
+private:
+    void OnThread(wxThreadEvent&)
+    {
+        m_record += m_name;
+        if ( m_deleteAfter && !--m_deleteAfter )
+            delete this;
+    }
+
+    wxString& m_record;
+    const char m_name;
+    int m_deleteAfter;
+};
+
+#ifdef wxHAS_EVENT_BIND
+
+// functor appending its name to the given string and skipping the event
+struct RecordingFunctor
+{
+    RecordingFunctor(wxString& record, char name)
+        : m_record(&record), m_name(name)
+    {
+    }
+
+    void operator()(MyEvent& event)
+    {
+        *m_record += m_name;
+        event.Skip();
+    }
+
+    wxString *m_record;
+    char m_name;
+};
+
+#endif // wxHAS_EVENT_BIND
+
+void QueueThreadEvent(wxEvtHandler& handler, int id, int n)
+{
+    wxThreadEvent * const event = new wxThreadEvent(wxEVT_THREAD, id);
+    event->SetInt(n);
+    handler.QueueEvent(event);
+}
+
+#if wxUSE_THREADS
+
+class QueueingThread : public wxThread
+{
+public:
+    QueueingThread(wxEvtHandler& handler, int id, int count)
+        : wxThread(wxTHREAD_JOINABLE),
+          m_handler(handler),
+          m_id(id),
+          m_count(count)
+    {
+    }
+
+    virtual void *Entry()
+    {
+        for ( int n = 0; n < m_count; n++ )
+            QueueThreadEvent(m_handler, m_id, n);
+
+        return NULL;
+    }
+
+private:
+    wxEvtHandler& m_handler;
+    const int m_id;
+    const int m_count;
+};
+
+// thread queuing a single event when its semaphore is posted
+class SingleQueueingThread : public wxThread
+{
+public:
+    SingleQueueingThread(wxEvtHandler& handler)
+        : wxThread(wxTHREAD_JOINABLE),
+          m_handler(handler)
+    {
+    }
+
+    virtual void *Entry()
+    {
+        m_go.Wait();
+
+        QueueThreadEvent(m_handler, 0, 0);
+
+        m_queued.Post();
+
+        return NULL;
+    }
+
+    wxSemaphore m_go,
+                m_queued;
+
+private:
+    wxEvtHandler& m_handler;
+};
+
+// event making the thread queue its event when it's deleted
+class QueueOnDeleteEvent : public MyEvent
+{
+public:
+    QueueOnDeleteEvent(SingleQueueingThread& thread) : m_thread(thread) { }
+
+    virtual ~QueueOnDeleteEvent()
+    {
+        m_thread.m_go.Post();
+        m_thread.m_queued.Wait();
+    }
+
+private:
+    SingleQueueingThread& m_thread;
+};
+
+#endif // wxUSE_THREADS
+
 } // anonymous namespace
 
 
@@ -160,6 +330,17 @@ private:
     CPPUNIT_TEST_SUITE( EvtHandlerTestCase );
         CPPUNIT_TEST( BuiltinConnect );
         CPPUNIT_TEST( LegacyConnect );
+        CPPUNIT_TEST( QueueEvent );
+        CPPUNIT_TEST( ProcessPendingEventsBatch );
+        CPPUNIT_TEST( CoalesceEvents );
+#if defined(wxHAS_COMPILER_TLS) && !wxUSE_MEMORY_TRACING
+        CPPUNIT_TEST( EventAllocator );
+#endif
+#if wxUSE_THREADS
+        CPPUNIT_TEST( QueueEventFromThreads );
+        CPPUNIT_TEST( CoalesceEventsFromThreads );
+        CPPUNIT_TEST( DeletePendingEventsFromThreads );
+#endif // wxUSE_THREADS
 #ifdef wxHAS_EVENT_BIND
         CPPUNIT_TEST( BindFunction );
         CPPUNIT_TEST( BindStaticMethod );
@@ -169,11 +350,24 @@ private:
         CPPUNIT_TEST( BindFunctionUsingBaseEvent );
         CPPUNIT_TEST( BindNonHandler );
         CPPUNIT_TEST( InvalidBind );
+        CPPUNIT_TEST( BindOrder );
+        CPPUNIT_TEST( UnbindMatching );
+        CPPUNIT_TEST( UnbindFromHandler );
+        CPPUNIT_TEST( DeleteFromHandler );
 #endif // wxHAS_EVENT_BIND
     CPPUNIT_TEST_SUITE_END();
 
     void BuiltinConnect();
     void LegacyConnect();
+    void QueueEvent();
+    void ProcessPendingEventsBatch();
+    void CoalesceEvents();
+    void EventAllocator();
+#if wxUSE_THREADS
+    void QueueEventFromThreads();
+    void CoalesceEventsFromThreads();
+    void DeletePendingEventsFromThreads();
+#endif // wxUSE_THREADS
 #ifdef wxHAS_EVENT_BIND
     void BindFunction();
     void BindStaticMethod();
@@ -183,6 +377,10 @@ private:
     void BindFunctionUsingBaseEvent();
     void BindNonHandler();
     void InvalidBind();
+    void BindOrder();
+    void UnbindMatching();
+    void UnbindFromHandler();
+    void DeleteFromHandler();
 #endif // wxHAS_EVENT_BIND
 
 
@@ -249,6 +447,276 @@ void EvtHandlerTestCase::LegacyConnect()
     handler.Disconnect( 0, 0, LegacyEventType, (wxObjectEventFunction)&MyHandler::OnEvent, NULL, &handler );
 }
 
+void EvtHandlerTestCase::QueueEvent()
+{
+    ThreadEventCounter counter;
+    for ( int n = 0; n < 10; n++ )
+        QueueThreadEvent(counter, 0, n);
+
+    CPPUNIT_ASSERT( wxTheApp->HasPendingEvents() );
+
+    wxTheApp->ProcessPendingEvents();
+    CPPUNIT_ASSERT_EQUAL( 10, counter.count );
+    CPPUNIT_ASSERT( counter.inOrder );
+    CPPUNIT_ASSERT( !wxTheApp->HasPendingEvents() );
+
+    // the deleted events must not be processed but the handler must still get
+    // the events queued after it
+    QueueThreadEvent(counter, 1, 0);
+    counter.DeletePendingEvents();
+    wxTheApp->ProcessPendingEvents();
+    CPPUNIT_ASSERT_EQUAL( 10, counter.count );
+
+    QueueThreadEvent(counter, 1, 0);
+    wxTheApp->ProcessPendingEvents();
+    CPPUNIT_ASSERT_EQUAL( 11, counter.count );
+
+    // destroying a handler with pending events must unregister it
+    {
+        ThreadEventCounter other;
+        QueueThreadEvent(other, 0, 0);
+    }
+
+    CPPUNIT_ASSERT( !wxTheApp->HasPendingEvents() );
+}
+
+void EvtHandlerTestCase::ProcessPendingEventsBatch()
+{
+    wxString record;
+    RecordingHandler h1(record, '1'),
+                     h2(record, '2');
+    for ( int n = 0; n < 3; n++ )
+    {
+        QueueThreadEvent(h1, 0, n);
+        QueueThreadEvent(h2, 0, n);
+    }
+
+    // the events are processed in the same order whether they are processed
+    // in batches or not
+    wxTheApp->ProcessPendingEvents();
+    CPPUNIT_ASSERT_EQUAL( "111222", record );
+
+    record.clear();
+    for ( int n = 0; n < 3; n++ )
+    {
+        QueueThreadEvent(h1, 0, n);
+        QueueThreadEvent(h2, 0, n);
+    }
+
+    wxTheApp->SetPendingEventsBatch(2);
+    wxTheApp->ProcessPendingEvents();
+    CPPUNIT_ASSERT_EQUAL( "111222", record );
+
+    // the handler deleting itself in the middle of the batch must be ok
+    record.clear();
+    RecordingHandler * const h3 = new RecordingHandler(record, '3', 2);
+    for ( int n = 0; n < 4; n++ )
+        QueueThreadEvent(*h3, 0, n);
+    QueueThreadEvent(h1, 0, 0);
+
+    wxTheApp->SetPendingEventsBatch(0);
+    wxTheApp->ProcessPendingEvents();
+    CPPUNIT_ASSERT_EQUAL( "331", record );
+    CPPUNIT_ASSERT( !wxTheApp->HasPendingEvents() );
+
+    wxTheApp->SetPendingEventsBatch(1);
+}
+
+void EvtHandlerTestCase::CoalesceEvents()
+{
+    ThreadEventCounter counter;
+    counter.EnableEventCoalescing(wxEVT_THREAD);
+
+    // only the last event with the given id must be processed
+    for ( int n = 0; n < 10; n++ )
+    {
+        QueueThreadEvent(counter, 0, n);
+        QueueThreadEvent(counter, 1, n);
+    }
+
+    wxTheApp->ProcessPendingEvents();
+    CPPUNIT_ASSERT_EQUAL( 2, counter.count );
+    CPPUNIT_ASSERT_EQUAL( 9, counter.last[0] );
+    CPPUNIT_ASSERT_EQUAL( 9, counter.last[1] );
+    CPPUNIT_ASSERT( !wxTheApp->HasPendingEvents() );
+
+    // but the events queued after the pending one was processed are not lost
+    QueueThreadEvent(counter, 0, 10);
+    wxTheApp->ProcessPendingEvents();
+    CPPUNIT_ASSERT_EQUAL( 3, counter.count );
+    CPPUNIT_ASSERT_EQUAL( 10, counter.last[0] );
+
+    QueueThreadEvent(counter, 0, 11);
+    counter.DeletePendingEvents();
+    QueueThreadEvent(counter, 0, 12);
+    wxTheApp->ProcessPendingEvents();
+    CPPUNIT_ASSERT_EQUAL( 4, counter.count );
+    CPPUNIT_ASSERT_EQUAL( 12, counter.last[0] );
+
+    // disabling coalescing must make all events processed again
+    counter.EnableEventCoalescing(wxEVT_THREAD, false);
+    for ( int n = 0; n < 5; n++ )
+        QueueThreadEvent(counter, 2, n);
+
+    wxTheApp->ProcessPendingEvents();
+    CPPUNIT_ASSERT_EQUAL( 9, counter.count );
+    CPPUNIT_ASSERT_EQUAL( 4, counter.last[2] );
+    CPPUNIT_ASSERT( counter.increasing );
+}
+
+void EvtHandlerTestCase::EventAllocator()
+{
+    static const unsigned long NUM_EVENTS = 100;
+
+    wxThreadEvent *events[NUM_EVENTS];
+    unsigned long n;
+
+    const wxEventAllocatorStats stats0 = wxEventAllocator::GetStats();
+    for ( n = 0; n < NUM_EVENTS; n++ )
+        events[n] = new wxThreadEvent(wxEVT_THREAD, n);
+    for ( n = 0; n < NUM_EVENTS; n++ )
+        delete events[n];
+
+    const wxEventAllocatorStats stats1 = wxEventAllocator::GetStats();
+    CPPUNIT_ASSERT( stats1.numAllocs - stats0.numAllocs == NUM_EVENTS );
+    CPPUNIT_ASSERT( stats1.numFrees - stats0.numFrees == NUM_EVENTS );
+
+    // the memory of the events deleted above must be reused
+    for ( n = 0; n < NUM_EVENTS; n++ )
+        events[n] = new wxThreadEvent(wxEVT_THREAD, n);
+
+    const wxEventAllocatorStats stats2 = wxEventAllocator::GetStats();
+    CPPUNIT_ASSERT( stats2.numAllocs - stats1.numAllocs == NUM_EVENTS );
+    CPPUNIT_ASSERT_EQUAL( stats1.numHeapAllocs, stats2.numHeapAllocs );
+
+    for ( n = 0; n < NUM_EVENTS; n++ )
+    {
+        CPPUNIT_ASSERT_EQUAL( n, (unsigned long)events[n]->GetId() );
+        delete events[n];
+    }
+
+    // the other forms of operator new must still be usable too
+    wxThreadEvent * const event = new(std::nothrow) wxThreadEvent(wxEVT_THREAD, 17);
+    CPPUNIT_ASSERT( event );
+    CPPUNIT_ASSERT_EQUAL( 17, event->GetId() );
+    delete event;
+
+    const wxEventAllocatorStats stats3 = wxEventAllocator::GetStats();
+    CPPUNIT_ASSERT( stats3.numAllocs - stats2.numAllocs == 1 );
+    CPPUNIT_ASSERT( stats3.numFrees - stats2.numFrees == NUM_EVENTS + 1 );
+
+    void * const buf = ::operator new(sizeof(wxThreadEvent));
+    wxThreadEvent * const eventInPlace = new(buf) wxThreadEvent(wxEVT_THREAD, 42);
+    CPPUNIT_ASSERT_EQUAL( 42, eventInPlace->GetId() );
+    eventInPlace->~wxThreadEvent();
+    ::operator delete(buf);
+}
+
+#if wxUSE_THREADS
+
+void EvtHandlerTestCase::QueueEventFromThreads()
+{
+    static const int EVENTS_PER_THREAD = 10000;
+
+    ThreadEventCounter counter;
+
+    wxThread *threads[ThreadEventCounter::MAX_ID];
+    int n;
+    for ( n = 0; n < ThreadEventCounter::MAX_ID; n++ )
+    {
+        threads[n] = new QueueingThread(counter, n, EVENTS_PER_THREAD);
+        CPPUNIT_ASSERT_EQUAL( wxTHREAD_NO_ERROR, threads[n]->Create() );
+    }
+
+    for ( n = 0; n < ThreadEventCounter::MAX_ID; n++ )
+        threads[n]->Run();
+
+    // process the events while they're being queued
+    const int total = ThreadEventCounter::MAX_ID*EVENTS_PER_THREAD;
+    while ( counter.count < total )
+        wxTheApp->ProcessPendingEvents();
+
+    for ( n = 0; n < ThreadEventCounter::MAX_ID; n++ )
+    {
+        threads[n]->Wait();
+        delete threads[n];
+    }
+
+    CPPUNIT_ASSERT_EQUAL( total, counter.count );
+    CPPUNIT_ASSERT( counter.inOrder );
+    CPPUNIT_ASSERT( !wxTheApp->HasPendingEvents() );
+}
+
+void EvtHandlerTestCase::CoalesceEventsFromThreads()
+{
+    static const int EVENTS_PER_THREAD = 10000;
+
+    ThreadEventCounter counter;
+    counter.EnableEventCoalescing(wxEVT_THREAD);
+
+    wxThread *threads[ThreadEventCounter::MAX_ID];
+    int n;
+    for ( n = 0; n < ThreadEventCounter::MAX_ID; n++ )
+    {
+        threads[n] = new QueueingThread(counter, n, EVENTS_PER_THREAD);
+        CPPUNIT_ASSERT_EQUAL( wxTHREAD_NO_ERROR, threads[n]->Create() );
+    }
+
+    for ( n = 0; n < ThreadEventCounter::MAX_ID; n++ )
+        threads[n]->Run();
+
+    // process the events while they're being queued until we get the last
+    // event from every thread
+    for ( ;; )
+    {
+        wxTheApp->ProcessPendingEvents();
+
+        for ( n = 0; n < ThreadEventCounter::MAX_ID; n++ )
+        {
+            if ( counter.last[n] != EVENTS_PER_THREAD - 1 )
+                break;
+        }
+
+        if ( n == ThreadEventCounter::MAX_ID )
+            break;
+    }
+
+    for ( n = 0; n < ThreadEventCounter::MAX_ID; n++ )
+    {
+        threads[n]->Wait();
+        delete threads[n];
+    }
+
+    CPPUNIT_ASSERT( counter.count <= ThreadEventCounter::MAX_ID*EVENTS_PER_THREAD );
+    CPPUNIT_ASSERT( counter.increasing );
+    CPPUNIT_ASSERT( !wxTheApp->HasPendingEvents() );
+}
+
+void EvtHandlerTestCase::DeletePendingEventsFromThreads()
+{
+    ThreadEventCounter counter;
+
+    SingleQueueingThread thread(counter);
+    CPPUNIT_ASSERT_EQUAL( wxTHREAD_NO_ERROR, thread.Create() );
+    thread.Run();
+
+    // the thread queues its event while wxApp::DeletePendingEvents() runs,
+    // after the pending events of the handler were taken from it but before
+    // it is marked as not scheduled any more: the new event must not be lost
+    counter.QueueEvent(new QueueOnDeleteEvent(thread));
+    wxTheApp->DeletePendingEvents();
+
+    thread.Wait();
+
+    CPPUNIT_ASSERT( wxTheApp->HasPendingEvents() );
+
+    wxTheApp->ProcessPendingEvents();
+    CPPUNIT_ASSERT_EQUAL( 1, counter.count );
+    CPPUNIT_ASSERT( !wxTheApp->HasPendingEvents() );
+}
+
+#endif // wxUSE_THREADS
+
 #ifdef wxHAS_EVENT_BIND
 
 void EvtHandlerTestCase::BindFunction()
@@ -445,4 +913,171 @@ void EvtHandlerTestCase::InvalidBind()
 #endif
 }
 
+void EvtHandlerTestCase::BindOrder()
+{
+    wxString record;
+    RecordingFunctor a(record, 'a'),
+                     b(record, 'b'),
+                     c(record, 'c'),
+                     d(record, 'd'),
+                     e2(record, 'e'),
+                     f(record, 'f');
+
+    // the handlers for specific ids, ranges of them and any id must all be
+    // called in the reverse order of their binding
+    handler.Bind(MyEventType, a);
+    handler.Bind(MyEventType, b, 17);
+    handler.Bind(MyEventType, c, 10, 20);
+    handler.Bind(MyEventType, d, 18);
+    handler.Bind(MyEventType, e2, 17);
+    handler.Bind(MyEventType, f);
+
+    e.SetId(17);
+    handler.ProcessEvent(e);
+    CPPUNIT_ASSERT_EQUAL( "fecba", record );
+
+    record.clear();
+    e.SetId(18);
+    handler.ProcessEvent(e);
+    CPPUNIT_ASSERT_EQUAL( "fdca", record );
+
+    record.clear();
+    e.SetId(42);
+    handler.ProcessEvent(e);
+    CPPUNIT_ASSERT_EQUAL( "fa", record );
+
+    // rebinding a handler makes it the most recent one
+    CPPUNIT_ASSERT( handler.Unbind(MyEventType, b, 17) );
+    handler.Bind(MyEventType, b, 17);
+
+    record.clear();
+    e.SetId(17);
+    handler.ProcessEvent(e);
+    CPPUNIT_ASSERT_EQUAL( "bfeca", record );
+
+    CPPUNIT_ASSERT( handler.Unbind(MyEventType, a) );
+    CPPUNIT_ASSERT( handler.Unbind(MyEventType, b, 17) );
+    CPPUNIT_ASSERT( handler.Unbind(MyEventType, c, 10, 20) );
+    CPPUNIT_ASSERT( handler.Unbind(MyEventType, d, 18) );
+    CPPUNIT_ASSERT( handler.Unbind(MyEventType, e2, 17) );
+    CPPUNIT_ASSERT( handler.Unbind(MyEventType, f) );
+
+    record.clear();
+    handler.ProcessEvent(e);
+    CPPUNIT_ASSERT( record.empty() );
+
+    e.SetId(0);
+}
+
+void EvtHandlerTestCase::UnbindMatching()
+{
+    wxString record;
+    RecordingFunctor a(record, 'a'),
+                     b(record, 'b');
+
+    handler.Bind(MyEventType, a, 17);
+    handler.Bind(MyEventType, b, 10, 20);
+    handler.Bind(MyEventType, a, 17, 17);
+
+    // not specifying the last id matches the ranges starting at this id too
+    // and the most recently bound matching handler is removed first
+    CPPUNIT_ASSERT( handler.Unbind(MyEventType, a, 17) );
+    CPPUNIT_ASSERT( handler.Unbind(MyEventType, b, 10) );
+    CPPUNIT_ASSERT( !handler.Unbind(MyEventType, b, 10) );
+    CPPUNIT_ASSERT( !handler.Unbind(MyEventType, a, 17, 18) );
+
+    e.SetId(17);
+    handler.ProcessEvent(e);
+    CPPUNIT_ASSERT_EQUAL( "a", record );
+
+    // the handler for the single id is the one which remains
+    CPPUNIT_ASSERT( !handler.Unbind(MyEventType, a, 17, 17) );
+    CPPUNIT_ASSERT( handler.Unbind(MyEventType, a, 17) );
+
+    // disconnecting without specifying the event type works for any type
+    handler.Connect(17, LegacyEventType,
+                    (wxObjectEventFunction)&MyHandler::OnEvent);
+    CPPUNIT_ASSERT( !handler.Disconnect(18) );
+    CPPUNIT_ASSERT( handler.Disconnect(17) );
+    CPPUNIT_ASSERT( !handler.Disconnect(17) );
+
+    e.SetId(0);
+}
+
+namespace
+{
+
+// functor unbinding the other functor when it's called
+struct UnbindingFunctor
+{
+    UnbindingFunctor(wxEvtHandler& handler, RecordingFunctor& other)
+        : m_handler(&handler), m_other(&other)
+    {
+    }
+
+    void operator()(MyEvent& event)
+    {
+        *m_other->m_record += '-';
+        m_handler->Unbind(MyEventType, *m_other);
+        event.Skip();
+    }
+
+    wxEvtHandler *m_handler;
+    RecordingFunctor *m_other;
+};
+
+// functor deleting the event handler which is its event object
+struct DeletingFunctor
+{
+    DeletingFunctor(wxString& record) : m_record(&record) { }
+
+    void operator()(MyEvent& event)
+    {
+        *m_record += 'x';
+        delete static_cast<wxEvtHandler *>(event.GetEventObject());
+    }
+
+    wxString *m_record;
+};
+
+} // anonymous namespace
+
+void EvtHandlerTestCase::UnbindFromHandler()
+{
+    wxString record;
+    RecordingFunctor a(record, 'a');
+    UnbindingFunctor unbinder(handler, a);
+
+    handler.Bind(MyEventType, a);
+    handler.Bind(MyEventType, unbinder);
+
+    // the unbound handler must not be called any more, even during the
+    // dispatching of the event which resulted in unbinding it
+    handler.ProcessEvent(e);
+    CPPUNIT_ASSERT_EQUAL( "-", record );
+
+    CPPUNIT_ASSERT( handler.Unbind(MyEventType, unbinder) );
+
+    record.clear();
+    handler.ProcessEvent(e);
+    CPPUNIT_ASSERT( record.empty() );
+}
+
+void EvtHandlerTestCase::DeleteFromHandler()
+{
+    wxString record;
+    RecordingFunctor a(record, 'a');
+    DeletingFunctor deleter(record);
+
+    // destroying the handler from inside its own event handler must work
+    wxEvtHandler * const h = new wxEvtHandler;
+    h->Bind(MyEventType, a);
+    h->Bind(MyEventType, deleter);
+
+    e.SetEventObject(h);
+    h->ProcessEvent(e);
+    e.SetEventObject(NULL);
+    CPPUNIT_ASSERT_EQUAL( "x", record );
+}
+
 #endif // wxHAS_EVENT_BIND
@@ -0,0 +1,247 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        tests/events/fdiodispatcher.cpp
+// Purpose:     Test the wxFDIODispatcher implementations
+// Author:      agent
+// Created:     2026-10-17
+// RCS-ID:      $Id$
+// Copyright:   (c) 2026 agent <agent@local>
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+// ----------------------------------------------------------------------------
+// headers
+// ----------------------------------------------------------------------------
+
+#include "testprec.h"
+
+#ifdef __BORLANDC__
+    #pragma hdrstop
+#endif
+
+#ifdef __UNIX__
+
+#include "wx/scopedptr.h"
+#include "wx/stopwatch.h"
+
+#include "wx/private/fdiodispatcher.h"
+#include "wx/private/selectdispatcher.h"
+#include "wx/unix/private/epolldispatcher.h"
+#include "wx/unix/private/iouringdispatcher.h"
+
+#include <signal.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+namespace
+{
+
+// ----------------------------------------------------------------------------
+// helpers
+// ----------------------------------------------------------------------------
+
+// handler counting the notifications for the read end of a pipe
+class CountingHandler : public wxFDIOHandler
+{
+public:
+    CountingHandler() { m_numRead = 0; }
+
+    virtual void OnReadWaiting() { m_numRead++; }
+    virtual void OnWriteWaiting() { }
+    virtual void OnExceptionWaiting() { }
+
+    int m_numRead;
+};
+
+// a pipe closed on scope exit
+class Pipe
+{
+public:
+    Pipe()
+    {
+        CPPUNIT_ASSERT_EQUAL( 0, pipe(m_fds) );
+    }
+
+    ~Pipe()
+    {
+        close(m_fds[0]);
+        close(m_fds[1]);
+    }
+
+    int GetReadFD() const { return m_fds[0]; }
+
+    void Write()
+    {
+        CPPUNIT_ASSERT_EQUAL( 1, write(m_fds[1], "x", 1) );
+    }
+
+    void Read()
+    {
+        char ch;
+        CPPUNIT_ASSERT_EQUAL( 1, read(m_fds[0], &ch, 1) );
+    }
+
+private:
+    int m_fds[2];
+
+    wxDECLARE_NO_COPY_CLASS(Pipe);
+};
+
+extern "C" void DummySignalHandler(int WXUNUSED(sig))
+{
+}
+
+// check the basic functionality common to all dispatchers
+void TestDispatcher(wxFDIODispatcher& dispatcher)
+{
+    Pipe p;
+    CountingHandler handler;
+    CPPUNIT_ASSERT( dispatcher.RegisterFD(p.GetReadFD(), &handler,
+                                          wxFDIO_INPUT) );
+
+    // nothing to read yet
+    CPPUNIT_ASSERT_EQUAL( 0, dispatcher.Dispatch(0) );
+    CPPUNIT_ASSERT_EQUAL( 0, handler.m_numRead );
+
+    // the notifications are level-triggered by default, so we must get them
+    // as long as there is data to read
+    p.Write();
+    CPPUNIT_ASSERT_EQUAL( 1, dispatcher.Dispatch(1000) );
+    CPPUNIT_ASSERT_EQUAL( 1, handler.m_numRead );
+    CPPUNIT_ASSERT_EQUAL( 1, dispatcher.Dispatch(1000) );
+    CPPUNIT_ASSERT_EQUAL( 2, handler.m_numRead );
+
+    p.Read();
+    CPPUNIT_ASSERT_EQUAL( 0, dispatcher.Dispatch(10) );
+    CPPUNIT_ASSERT_EQUAL( 2, handler.m_numRead );
+
+    // no notifications must be given for the unregistered descriptors
+    CPPUNIT_ASSERT( dispatcher.UnregisterFD(p.GetReadFD()) );
+    p.Write();
+    CPPUNIT_ASSERT_EQUAL( 0, dispatcher.Dispatch(10) );
+    CPPUNIT_ASSERT_EQUAL( 2, handler.m_numRead );
+
+    // but registering it again must work
+    CPPUNIT_ASSERT( dispatcher.RegisterFD(p.GetReadFD(), &handler,
+                                          wxFDIO_INPUT) );
+    CPPUNIT_ASSERT_EQUAL( 1, dispatcher.Dispatch(1000) );
+    CPPUNIT_ASSERT_EQUAL( 3, handler.m_numRead );
+
+    CPPUNIT_ASSERT( dispatcher.UnregisterFD(p.GetReadFD()) );
+}
+
+// check the edge-triggered notifications and that the timeout is respected
+// even if the wait is interrupted by a signal, which is only supported by
+// epoll and io_uring dispatchers
+void TestDispatcherExtra(wxFDIODispatcher& dispatcher)
+{
+    Pipe p;
+    CountingHandler handler;
+    CPPUNIT_ASSERT( dispatcher.RegisterFD(p.GetReadFD(), &handler,
+                                          wxFDIO_INPUT | wxFDIO_EDGE_TRIGGERED) );
+
+    p.Write();
+    CPPUNIT_ASSERT_EQUAL( 1, dispatcher.Dispatch(1000) );
+    CPPUNIT_ASSERT_EQUAL( 1, handler.m_numRead );
+
+    // there is still data to read but we already were notified about it
+    CPPUNIT_ASSERT_EQUAL( 0, dispatcher.Dispatch(10) );
+    CPPUNIT_ASSERT_EQUAL( 1, handler.m_numRead );
+
+    // but we must be notified again when more data arrives
+    p.Write();
+    CPPUNIT_ASSERT_EQUAL( 1, dispatcher.Dispatch(1000) );
+    CPPUNIT_ASSERT_EQUAL( 2, handler.m_numRead );
+
+    CPPUNIT_ASSERT( dispatcher.UnregisterFD(p.GetReadFD()) );
+
+    // interrupt the wait with a signal handled without SA_RESTART after 50ms
+    struct sigaction sa, saOld;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = DummySignalHandler;
+    sigemptyset(&sa.sa_mask);
+    CPPUNIT_ASSERT_EQUAL( 0, sigaction(SIGALRM, &sa, &saOld) );
+
+    struct itimerval it;
+    memset(&it, 0, sizeof(it));
+    it.it_value.tv_usec = 50000;
+    CPPUNIT_ASSERT_EQUAL( 0, setitimer(ITIMER_REAL, &it, NULL) );
+
+    const wxMilliClock_t start = wxGetLocalTimeMillis();
+    CPPUNIT_ASSERT_EQUAL( 0, dispatcher.Dispatch(300) );
+    const long elapsed = wxMilliClockToLong(wxGetLocalTimeMillis() - start);
+
+    sigaction(SIGALRM, &saOld, NULL);
+
+    // the dispatcher must have waited for the remaining time after the signal
+    WX_ASSERT_MESSAGE
+    (
+        ("Dispatch() returned after %ldms only", elapsed),
+        elapsed >= 250
+    );
+}
+
+} // anonymous namespace
+
+// ----------------------------------------------------------------------------
+// test class
+// ----------------------------------------------------------------------------
+
+class FDIODispatcherTestCase : public CppUnit::TestCase
+{
+public:
+    FDIODispatcherTestCase() { }
+
+private:
+    CPPUNIT_TEST_SUITE( FDIODispatcherTestCase );
+        CPPUNIT_TEST( Select );
+        CPPUNIT_TEST( Epoll );
+        CPPUNIT_TEST( IoUring );
+    CPPUNIT_TEST_SUITE_END();
+
+    void Select();
+    void Epoll();
+    void IoUring();
+
+    DECLARE_NO_COPY_CLASS(FDIODispatcherTestCase)
+};
+
+// register in the unnamed registry so that these tests are run by default
+CPPUNIT_TEST_SUITE_REGISTRATION( FDIODispatcherTestCase );
+
+// also include in its own registry so that these tests can be run alone
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( FDIODispatcherTestCase, "FDIODispatcherTestCase" );
+
+void FDIODispatcherTestCase::Select()
+{
+#if wxUSE_SELECT_DISPATCHER
+    wxSelectDispatcher dispatcher;
+    TestDispatcher(dispatcher);
+#endif // wxUSE_SELECT_DISPATCHER
+}
+
+void FDIODispatcherTestCase::Epoll()
+{
+#if wxUSE_EPOLL_DISPATCHER
+    wxScopedPtr<wxEpollDispatcher> dispatcher(wxEpollDispatcher::Create());
+    CPPUNIT_ASSERT( dispatcher );
+
+    TestDispatcher(*dispatcher);
+    TestDispatcherExtra(*dispatcher);
+#endif // wxUSE_EPOLL_DISPATCHER
+}
+
+void FDIODispatcherTestCase::IoUring()
+{
+#ifdef wxHAS_IOURING_DISPATCHER
+    // io_uring may be unsupported by the running kernel or disabled, there is
+    // nothing to test then
+    wxScopedPtr<wxIoUringDispatcher> dispatcher(wxIoUringDispatcher::Create());
+    if ( !dispatcher )
+        return;
+
+    TestDispatcher(*dispatcher);
+    TestDispatcherExtra(*dispatcher);
+#endif // wxHAS_IOURING_DISPATCHER
+}
+
+#endif // __UNIX__
@@ -25,6 +25,10 @@
 #include "wx/evtloop.h"
 #include "wx/timer.h"
 
+#if defined(__UNIX__) && wxUSE_TIMER
+    #include "wx/unix/private/timer.h"
+#endif
+
 // --------------------------------------------------------------------------
 // helper class counting the number of timer events
 // --------------------------------------------------------------------------
@@ -69,10 +73,18 @@ private:
     CPPUNIT_TEST_SUITE( TimerEventTestCase );
         CPPUNIT_TEST( OneShot );
         CPPUNIT_TEST( Multiple );
+        CPPUNIT_TEST( Order );
+#ifdef wxHAS_TIMERFD
+        CPPUNIT_TEST( TimerFD );
+#endif // wxHAS_TIMERFD
     CPPUNIT_TEST_SUITE_END();
 
     void OneShot();
     void Multiple();
+    void Order();
+#ifdef wxHAS_TIMERFD
+    void TimerFD();
+#endif // wxHAS_TIMERFD
 
     DECLARE_NO_COPY_CLASS(TimerEventTestCase)
 };
@@ -146,3 +158,109 @@ void TimerEventTestCase::Multiple()
     CPPUNIT_ASSERT( numTicks > 1 );
 #endif // !(wxGTK Unicode)
 }
+
+void TimerEventTestCase::Order()
+{
+    // handler recording the ids of the timers in the order in which they
+    // expire and exiting the loop after the given number of them
+    class RecordingHandler : public wxEvtHandler
+    {
+    public:
+        RecordingHandler(wxEventLoopBase& loop, size_t count)
+            : m_loop(loop),
+              m_count(count)
+        {
+            Connect(wxEVT_TIMER, wxTimerEventHandler(RecordingHandler::OnTimer));
+        }
+
+        wxString m_ids;
+
+    private:
+        void OnTimer(wxTimerEvent& event)
+        {
+            m_ids += wxString::Format("%d", event.GetId());
+            if ( m_ids.length() == m_count )
+                m_loop.Exit();
+        }
+
+        wxEventLoopBase& m_loop;
+        const size_t m_count;
+    };
+
+    wxEventLoop loop;
+
+    RecordingHandler handler(loop, 4);
+
+    // the timers expire in the order of their intervals and not of their
+    // creation and stopping or restarting them must be taken into account
+    wxTimer t1(&handler, 1),
+            t2(&handler, 2),
+            t3(&handler, 3),
+            t4(&handler, 4),
+            t5(&handler, 5);
+    t1.Start(250, true);
+    t2.Start(50, true);
+    t3.Start(200, true);
+    t4.Start(100, true);
+    t5.Start(150, true);
+
+    t3.Stop();
+    t4.Start(300, true);
+
+    loop.Run();
+
+    CPPUNIT_ASSERT_EQUAL( "2514", handler.m_ids );
+    CPPUNIT_ASSERT( !t1.IsRunning() );
+    CPPUNIT_ASSERT( !t4.IsRunning() );
+}
+
+#ifdef wxHAS_TIMERFD
+
+void TimerEventTestCase::TimerFD()
+{
+    // handler restarting the timer from its event handler, i.e. after the
+    // timer fd expiration, a few times before exiting the loop
+    class RestartingHandler : public TimerCounterHandler
+    {
+    public:
+        RestartingHandler(wxEventLoopBase& loop)
+            : TimerCounterHandler(),
+              m_loop(loop)
+        {
+            m_timer = NULL;
+        }
+
+        wxTimer *m_timer;
+
+    private:
+        virtual void Tick()
+        {
+            if ( GetNumEvents() == 3 )
+                m_loop.Exit();
+            else
+                m_timer->Start(50, true);
+        }
+
+        wxEventLoopBase& m_loop;
+    };
+
+    wxEventLoop loop;
+
+    RestartingHandler handler(loop);
+    wxTimer timer(&handler);
+    handler.m_timer = &timer;
+    timer.Start(50, true);
+
+    // the timer fd is used if it could be created, which should be always
+    // the case under any recent Linux version
+    CPPUNIT_ASSERT( wxTimerScheduler::Get().IsMonitoredByDispatcher() );
+
+    // the event loop doesn't wake up for the timers on its own then, so this
+    // would block forever if the timer fd didn't work
+    loop.Run();
+
+    CPPUNIT_ASSERT_EQUAL( 3, handler.GetNumEvents() );
+    CPPUNIT_ASSERT( !timer.IsRunning() );
+}
+
+#endif // wxHAS_TIMERFD
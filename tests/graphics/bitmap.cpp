@@ -19,6 +19,7 @@
 
 #include "wx/bitmap.h"
 #include "wx/dcmemory.h"
+#include "wx/graphics.h"
 
 // ----------------------------------------------------------------------------
 // test class
@@ -35,9 +36,13 @@ public:
 private:
     CPPUNIT_TEST_SUITE( BitmapTestCase );
         CPPUNIT_TEST( Mask );
+        CPPUNIT_TEST( ImageRoundTrip );
+        CPPUNIT_TEST( PremultipliedAlpha );
     CPPUNIT_TEST_SUITE_END();
 
     void Mask();
+    void ImageRoundTrip();
+    void PremultipliedAlpha();
 
     wxBitmap m_bmp;
 
@@ -81,3 +86,91 @@ void BitmapTestCase::Mask()
     m_bmp.SetMask(mask2);
 }
 
+
+void BitmapTestCase::ImageRoundTrip()
+{
+#if wxUSE_IMAGE
+    // use different widths to check that the conversion of the rows works
+    // whether it can be done in blocks of several pixels or not
+    for ( int w = 1; w < 20; w++ )
+    {
+        wxImage image(w, 3);
+        image.SetAlpha();
+
+        unsigned char *data = image.GetData();
+        for ( int n = 0; n < 3*w*3; n++ )
+            data[n] = (unsigned char)(n*7);
+
+        unsigned char *alpha = image.GetAlpha();
+        for ( int n = 0; n < w*3; n++ )
+            alpha[n] = (unsigned char)(n*13);
+
+        wxImage result = wxBitmap(image).ConvertToImage();
+        CPPUNIT_ASSERT( result.HasAlpha() );
+        CPPUNIT_ASSERT( memcmp(result.GetData(), data, 3*w*3) == 0 );
+        CPPUNIT_ASSERT( memcmp(result.GetAlpha(), alpha, w*3) == 0 );
+
+        // a 32bpp bitmap created from an image without alpha is opaque
+        image.ClearAlpha();
+        result = wxBitmap(image, 32).ConvertToImage();
+        CPPUNIT_ASSERT( memcmp(result.GetData(), data, 3*w*3) == 0 );
+        if ( result.HasAlpha() )
+        {
+            for ( int n = 0; n < w*3; n++ )
+                CPPUNIT_ASSERT_EQUAL( wxIMAGE_ALPHA_OPAQUE, result.GetAlpha()[n] );
+        }
+    }
+#endif // wxUSE_IMAGE
+}
+
+void BitmapTestCase::PremultipliedAlpha()
+{
+#if wxUSE_IMAGE && wxUSE_GRAPHICS_CONTEXT && wxUSE_CAIRO
+    // cairo uses pre-multiplied alpha, so converting an image to its surface
+    // and back loses precision, but the result must always be the one of the
+    // exact integer computation
+    wxImage image(256, 256);
+    image.SetAlpha();
+    for ( int y = 0; y < 256; y++ )
+    {
+        for ( int x = 0; x < 256; x++ )
+        {
+            image.SetRGB(x, y, x, 255 - x, x / 3);
+            image.SetAlpha(x, y, y);
+        }
+    }
+
+    wxGraphicsRenderer * const renderer = wxGraphicsRenderer::GetCairoRenderer();
+    const wxImage
+        result = renderer->CreateBitmapFromImage(image).ConvertToImage();
+    CPPUNIT_ASSERT( result.HasAlpha() );
+
+    for ( int y = 0; y < 256; y++ )
+    {
+        const unsigned a = y;
+        for ( int x = 0; x < 256; x++ )
+        {
+            CPPUNIT_ASSERT_EQUAL( a, (unsigned)result.GetAlpha(x, y) );
+
+            const unsigned value = x;
+            const unsigned rgb[] = { value, 255 - value, value / 3 };
+            const unsigned rgbResult[] =
+            {
+                result.GetRed(x, y), result.GetGreen(x, y), result.GetBlue(x, y)
+            };
+
+            for ( int n = 0; n < 3; n++ )
+            {
+                // the fully transparent pixels have no colour at all
+                const unsigned expected = a ? rgb[n]*a/255*255/a : 0;
+
+                WX_ASSERT_EQUAL_MESSAGE
+                (
+                    ("component %d, value %u, alpha %u", n, rgb[n], a),
+                    expected, (unsigned)rgbResult[n]
+                );
+            }
+        }
+    }
+#endif // wxUSE_IMAGE && wxUSE_GRAPHICS_CONTEXT && wxUSE_CAIRO
+}
@@ -24,12 +24,18 @@
 #endif // WX_PRECOMP
 
 #include "wx/anidecod.h" // wxImageArray
+#include "wx/imagecache.h"
 #include "wx/palette.h"
+#include "wx/quantize.h"
 #include "wx/url.h"
 #include "wx/log.h"
 #include "wx/mstream.h"
+#include "wx/scopedptr.h"
 #include "wx/zstream.h"
 #include "wx/wfstream.h"
+#include "wx/vector.h"
+
+#include "wx/private/pixelops.h"
 
 #include "testimage.h"
 
@@ -79,6 +85,17 @@ private:
         CPPUNIT_TEST( GIFComment );
         CPPUNIT_TEST( DibPadding );
         CPPUNIT_TEST( BMPFlippingAndRLECompression );
+        CPPUNIT_TEST( ScaleQuality );
+        CPPUNIT_TEST( MultiThreaded );
+        CPPUNIT_TEST( LoadJPEGScaled );
+        CPPUNIT_TEST( LoadRows );
+        CPPUNIT_TEST( LoadReduced );
+        CPPUNIT_TEST( LoadFiles );
+        CPPUNIT_TEST( LoadIncrementally );
+        CPPUNIT_TEST( Quantize );
+        CPPUNIT_TEST( Cache );
+        CPPUNIT_TEST( PasteCompose );
+        CPPUNIT_TEST( PixelOps );
     CPPUNIT_TEST_SUITE_END();
 
     void LoadFromSocketStream();
@@ -94,6 +111,17 @@ private:
     void GIFComment();
     void DibPadding();
     void BMPFlippingAndRLECompression();
+    void ScaleQuality();
+    void MultiThreaded();
+    void LoadJPEGScaled();
+    void LoadRows();
+    void LoadReduced();
+    void LoadFiles();
+    void LoadIncrementally();
+    void Quantize();
+    void Cache();
+    void PasteCompose();
+    void PixelOps();
 
     DECLARE_NO_COPY_CLASS(ImageTestCase)
 };
@@ -1343,6 +1371,982 @@ void ImageTestCase::BMPFlippingAndRLECompression()
 
     CompareBMPImage("image/horse_rle4.bmp", "image/horse_rle4_flipped.bmp");
 }
+
+void ImageTestCase::ScaleQuality()
+{
+    // scaling an image of uniform colour must not change it, whatever the
+    // algorithm and the scale factors
+    wxImage image(40, 30);
+    image.SetRGB(wxRect(0, 0, 40, 30), 10, 200, 77);
+    image.SetAlpha();
+    memset(image.GetAlpha(), 128, 40*30);
+
+    static const wxImageResizeQuality qualities[] =
+    {
+        wxIMAGE_QUALITY_NEAREST,
+        wxIMAGE_QUALITY_BILINEAR,
+        wxIMAGE_QUALITY_BICUBIC,
+        wxIMAGE_QUALITY_BOX_AVERAGE,
+        wxIMAGE_QUALITY_HIGH,
+        wxIMAGE_QUALITY_LANCZOS3,
+    };
+
+    static const wxSize sizes[] =
+    {
+        wxSize(40, 7),
+        wxSize(11, 30),
+        wxSize(17, 61),
+        wxSize(100, 9),
+        wxSize(1, 1),
+    };
+
+    for ( unsigned q = 0; q < WXSIZEOF(qualities); q++ )
+    {
+        for ( unsigned n = 0; n < WXSIZEOF(sizes); n++ )
+        {
+            const int width = sizes[n].x,
+                      height = sizes[n].y;
+            const wxImage scaled = image.Scale(width, height, qualities[q]);
+
+            WX_ASSERT_MESSAGE
+            (
+                ("Wrong size for quality %d", qualities[q]),
+                scaled.GetSize() == sizes[n]
+            );
+
+            CPPUNIT_ASSERT( scaled.HasAlpha() );
+
+            const unsigned char *data = scaled.GetData();
+            const unsigned char *alpha = scaled.GetAlpha();
+            for ( int i = 0; i < width*height; i++, data += 3 )
+            {
+                WX_ASSERT_MESSAGE
+                (
+                    ("Wrong pixel %d for quality %d", i, qualities[q]),
+                    data[0] == 10 && data[1] == 200 && data[2] == 77 &&
+                        alpha[i] == 128
+                );
+            }
+        }
+    }
+
+    // check that the filters don't shift the image: a centred white square on
+    // black background must remain symmetric when reduced
+    wxImage square(60, 60);
+    square.SetRGB(wxRect(10, 10, 40, 40), 255, 255, 255);
+
+    const wxImage reduced = square.Scale(15, 15, wxIMAGE_QUALITY_LANCZOS3);
+    for ( int y = 0; y < 15; y++ )
+    {
+        for ( int x = 0; x < 15; x++ )
+        {
+            CPPUNIT_ASSERT_EQUAL( reduced.GetRed(x, y),
+                                  reduced.GetRed(14 - x, 14 - y) );
+        }
+    }
+
+    CPPUNIT_ASSERT( reduced.GetRed(7, 7) == 255 );
+    CPPUNIT_ASSERT( reduced.GetRed(0, 0) == 0 );
+}
+
+namespace
+{
+
+bool AreImagesIdentical(const wxImage& image1, const wxImage& image2)
+{
+    if ( image1.GetSize() != image2.GetSize() )
+        return false;
+
+    const int size = image1.GetWidth()*image1.GetHeight();
+    if ( memcmp(image1.GetData(), image2.GetData(), size*3) != 0 )
+        return false;
+
+    if ( image1.HasAlpha() != image2.HasAlpha() )
+        return false;
+
+    return !image1.HasAlpha() ||
+                memcmp(image1.GetAlpha(), image2.GetAlpha(), size) == 0;
+}
+
+} // anonymous namespace
+
+void ImageTestCase::MultiThreaded()
+{
+    // create an image big enough to be processed by several threads
+    const int width = 600,
+              height = 500;
+    wxImage image(width, height, false);
+    image.SetAlpha();
+
+    unsigned char *data = image.GetData();
+    unsigned char *alpha = image.GetAlpha();
+    for ( int y = 0; y < height; y++ )
+    {
+        for ( int x = 0; x < width; x++ )
+        {
+            *data++ = x*y;
+            *data++ = x + y;
+            *data++ = (x/7)*(y/5);
+            *alpha++ = x ^ y;
+        }
+    }
+
+    static const wxSize sizes[] =
+    {
+        wxSize(150, 120),
+        wxSize(800, 700),
+        wxSize(600, 900),
+        wxSize(500, 500),
+    };
+
+    static const wxImageResizeQuality qualities[] =
+    {
+        wxIMAGE_QUALITY_NEAREST,
+        wxIMAGE_QUALITY_BILINEAR,
+        wxIMAGE_QUALITY_BICUBIC,
+        wxIMAGE_QUALITY_BOX_AVERAGE,
+        wxIMAGE_QUALITY_LANCZOS3,
+    };
+
+    // compute the results using a single thread first
+    wxVector<wxImage> expected;
+    for ( unsigned q = 0; q < WXSIZEOF(qualities); q++ )
+    {
+        for ( unsigned n = 0; n < WXSIZEOF(sizes); n++ )
+            expected.push_back(image.Scale(sizes[n].x, sizes[n].y, qualities[q]));
+    }
+
+    expected.push_back(image.Blur(3));
+    expected.push_back(image.Rotate90(true));
+    expected.push_back(image.Rotate90(false));
+    expected.push_back(image.ConvertToGreyscale());
+
+    // and then check that using several threads gives exactly the same ones
+    CPPUNIT_ASSERT_EQUAL( 1u, wxImage::GetMaxThreads() );
+    wxImage::SetMaxThreads(4);
+
+    unsigned i = 0;
+    for ( unsigned q = 0; q < WXSIZEOF(qualities); q++ )
+    {
+        for ( unsigned n = 0; n < WXSIZEOF(sizes); n++ )
+        {
+            WX_ASSERT_MESSAGE
+            (
+                ("Different result for quality %d and size %dx%d",
+                 qualities[q], sizes[n].x, sizes[n].y),
+                AreImagesIdentical
+                (
+                    image.Scale(sizes[n].x, sizes[n].y, qualities[q]),
+                    expected[i++]
+                )
+            );
+        }
+    }
+
+    CPPUNIT_ASSERT( AreImagesIdentical(image.Blur(3), expected[i++]) );
+    CPPUNIT_ASSERT( AreImagesIdentical(image.Rotate90(true), expected[i++]) );
+    CPPUNIT_ASSERT( AreImagesIdentical(image.Rotate90(false), expected[i++]) );
+    CPPUNIT_ASSERT( AreImagesIdentical(image.ConvertToGreyscale(), expected[i++]) );
+
+    wxImage::SetMaxThreads(1);
+}
+
+void ImageTestCase::LoadJPEGScaled()
+{
+#if wxUSE_LIBJPEG
+    // use odd size to check that the rounding of the size of the image scaled
+    // by libjpeg is taken into account
+    wxImage image(101, 75);
+    image.SetRGB(wxRect(0, 0, 101, 75), 0, 128, 255);
+
+    wxMemoryOutputStream mos;
+    CPPUNIT_ASSERT( image.SaveFile(mos, wxBITMAP_TYPE_JPEG) );
+
+    static const struct
+    {
+        int maxWidth,
+            maxHeight;
+        wxSize size;
+    } testData[] =
+    {
+        { 200,   0, wxSize(101, 75) },
+        {  51,   0, wxSize( 51, 38) },
+        {  50,   0, wxSize( 26, 19) },
+        {   0,  19, wxSize( 26, 19) },
+        {  50,  10, wxSize( 13, 10) },
+        {   6,   0, wxSize(  6,  5) },
+    };
+
+    for ( unsigned n = 0; n < WXSIZEOF(testData); n++ )
+    {
+        for ( int fast = 0; fast < 2; fast++ )
+        {
+            wxMemoryInputStream mis(mos);
+
+            wxImage loaded;
+            loaded.SetOption(wxIMAGE_OPTION_MAX_WIDTH, testData[n].maxWidth);
+            loaded.SetOption(wxIMAGE_OPTION_MAX_HEIGHT, testData[n].maxHeight);
+            loaded.SetOption(wxIMAGE_OPTION_JPEG_FAST_DECODE, fast);
+            CPPUNIT_ASSERT( loaded.LoadFile(mis, wxBITMAP_TYPE_JPEG) );
+
+            WX_ASSERT_MESSAGE
+            (
+                ("Wrong size for max size %dx%d: %dx%d",
+                 testData[n].maxWidth, testData[n].maxHeight,
+                 loaded.GetWidth(), loaded.GetHeight()),
+                loaded.GetSize() == testData[n].size
+            );
+
+            if ( loaded.GetWidth() != 101 )
+            {
+                CPPUNIT_ASSERT_EQUAL
+                (
+                    101,
+                    loaded.GetOptionInt(wxIMAGE_OPTION_ORIGINAL_WIDTH)
+                );
+                CPPUNIT_ASSERT_EQUAL
+                (
+                    75,
+                    loaded.GetOptionInt(wxIMAGE_OPTION_ORIGINAL_HEIGHT)
+                );
+            }
+
+            // JPEG is lossy, so check that the colour is approximately right
+            CPPUNIT_ASSERT( loaded.GetRed(0, 0) < 8 );
+            CPPUNIT_ASSERT( abs(loaded.GetGreen(3, 3) - 128) < 8 );
+            CPPUNIT_ASSERT( loaded.GetBlue(1, 2) > 247 );
+        }
+    }
+#endif // wxUSE_LIBJPEG
+}
+
+namespace
+{
+
+// sink storing the rows passed to it in an image
+class ImageRowSink : public wxImageRowSink
+{
+public:
+    ImageRowSink() : m_numRows(0) { }
+
+    virtual bool Start(int width, int height, bool hasAlpha)
+    {
+        m_image.Create(width, height, false);
+        if ( hasAlpha )
+            m_image.SetAlpha();
+
+        return true;
+    }
+
+    virtual bool ProcessRow(int y,
+                            const unsigned char *data,
+                            const unsigned char *alpha)
+    {
+        const int width = m_image.GetWidth();
+        memcpy(m_image.GetData() + 3*y*width, data, 3*width);
+        if ( m_image.HasAlpha() )
+            memcpy(m_image.GetAlpha() + y*width, alpha, width);
+
+        m_numRows++;
+
+        return true;
+    }
+
+    const wxImage& GetImage() const { return m_image; }
+    int GetNumRows() const { return m_numRows; }
+
+private:
+    wxImage m_image;
+    int m_numRows;
+};
+
+void CheckLoadRows(wxImageHandler& handler,
+                   wxInputStream& stream,
+                   const wxImage& expected)
+{
+    const wxFileOffset pos = stream.TellI();
+
+    wxImage options;
+    ImageRowSink sink;
+    CPPUNIT_ASSERT( handler.LoadRows(&options, sink, stream) );
+
+    const wxImage& image = sink.GetImage();
+    CPPUNIT_ASSERT_EQUAL( expected.GetHeight(), sink.GetNumRows() );
+    CPPUNIT_ASSERT( image.GetSize() == expected.GetSize() );
+
+    const int numPixels = image.GetWidth()*image.GetHeight();
+    CPPUNIT_ASSERT( memcmp(image.GetData(), expected.GetData(),
+                           3*numPixels) == 0 );
+
+    if ( expected.HasAlpha() )
+    {
+        CPPUNIT_ASSERT( image.HasAlpha() );
+        CPPUNIT_ASSERT( memcmp(image.GetAlpha(), expected.GetAlpha(),
+                               numPixels) == 0 );
+    }
+
+    // the options set by the handler must be the same too
+    CPPUNIT_ASSERT_EQUAL
+    (
+        expected.GetOption(wxIMAGE_OPTION_RESOLUTIONX),
+        options.GetOption(wxIMAGE_OPTION_RESOLUTIONX)
+    );
+
+    stream.SeekI(pos);
+}
+
+} // anonymous namespace
+
+void ImageTestCase::LoadRows()
+{
+    static const struct
+    {
+        const char *file;
+        wxBitmapType type;
+    } testFiles[] =
+    {
+        { "image/horse_grey.bmp",           wxBITMAP_TYPE_BMP  },
+        { "image/horse_grey_flipped.bmp",   wxBITMAP_TYPE_BMP  },
+        { "image/horse_rle8.bmp",           wxBITMAP_TYPE_BMP  },
+        { "horse.ico",                      wxBITMAP_TYPE_ICO  },
+        { "horse.png",                      wxBITMAP_TYPE_PNG  },
+        { "horse.jpg",                      wxBITMAP_TYPE_JPEG },
+        { "horse.tif",                      wxBITMAP_TYPE_TIFF },
+        { "horse.gif",                      wxBITMAP_TYPE_GIF  },
+    };
+
+    for ( unsigned n = 0; n < WXSIZEOF(testFiles); n++ )
+    {
+        wxImageHandler * const
+            handler = wxImage::FindHandler(testFiles[n].type);
+        CPPUNIT_ASSERT( handler );
+
+        wxImage expected(testFiles[n].file, testFiles[n].type);
+        CPPUNIT_ASSERT( expected.IsOk() );
+
+        wxFileInputStream stream(testFiles[n].file);
+        CPPUNIT_ASSERT( stream.IsOk() );
+
+        CheckLoadRows(*handler, stream, expected);
+    }
+
+    // horse.png is interlaced, so also test with a normal PNG with alpha
+    wxImage image("horse.png");
+    CPPUNIT_ASSERT( image.IsOk() );
+    image.SetAlpha();
+    for ( int y = 0; y < image.GetHeight(); y++ )
+    {
+        for ( int x = 0; x < image.GetWidth(); x++ )
+            image.SetAlpha(x, y, (x + y) % 256);
+    }
+
+    wxMemoryOutputStream mos;
+    CPPUNIT_ASSERT( image.SaveFile(mos, wxBITMAP_TYPE_PNG) );
+
+    wxMemoryInputStream mis(mos);
+    wxImage expected;
+    CPPUNIT_ASSERT( expected.LoadFile(mis, wxBITMAP_TYPE_PNG) );
+    CPPUNIT_ASSERT( expected.HasAlpha() );
+
+    mis.SeekI(0);
+    CheckLoadRows(*wxImage::FindHandler(wxBITMAP_TYPE_PNG), mis, expected);
+}
+
+namespace
+{
+
+// create a PNG image of the given size with 2 pixels wide or high stripes of
+// black and (200, 100, 50) colour along its longer side and check that it's
+// reduced to the given size of uniform average colour
+void CheckReducedNarrow(const wxSize& size,
+                        const wxString& option,
+                        int maxSize,
+                        const wxSize& sizeReduced)
+{
+    wxImage image(size);
+    if ( size.x < size.y )
+        image.SetRGB(wxRect(1, 0, 1, size.y), 200, 100, 50);
+    else
+        image.SetRGB(wxRect(0, 1, size.x, 1), 200, 100, 50);
+
+    wxMemoryOutputStream mos;
+    CPPUNIT_ASSERT( image.SaveFile(mos, wxBITMAP_TYPE_PNG) );
+
+    wxMemoryInputStream mis(mos);
+    wxImage reduced;
+    reduced.SetOption(option, maxSize);
+    CPPUNIT_ASSERT( reduced.LoadFile(mis, wxBITMAP_TYPE_PNG) );
+    CPPUNIT_ASSERT( reduced.GetSize() == sizeReduced );
+
+    for ( int y = 0; y < sizeReduced.y; y++ )
+    {
+        for ( int x = 0; x < sizeReduced.x; x++ )
+        {
+            CPPUNIT_ASSERT_EQUAL( 100, (int)reduced.GetRed(x, y) );
+            CPPUNIT_ASSERT_EQUAL( 50, (int)reduced.GetGreen(x, y) );
+            CPPUNIT_ASSERT_EQUAL( 25, (int)reduced.GetBlue(x, y) );
+        }
+    }
+}
+
+} // anonymous namespace
+
+void ImageTestCase::LoadReduced()
+{
+    static const struct
+    {
+        const char *file;
+        wxBitmapType type;
+    } testFiles[] =
+    {
+        { "image/horse_grey.bmp",           wxBITMAP_TYPE_BMP  },
+        { "horse.png",                      wxBITMAP_TYPE_PNG  },
+        { "horse.tif",                      wxBITMAP_TYPE_TIFF },
+        { "horse.gif",                      wxBITMAP_TYPE_GIF  },
+    };
+
+    for ( unsigned n = 0; n < WXSIZEOF(testFiles); n++ )
+    {
+        wxImage image;
+        image.SetOption(wxIMAGE_OPTION_MAX_WIDTH, 60);
+        CPPUNIT_ASSERT( image.LoadFile(testFiles[n].file, testFiles[n].type) );
+
+        // the images are 200*200 and are reduced by a power of 2 whether
+        // they're loaded row by row or entirely
+        WX_ASSERT_MESSAGE
+        (
+            ("Wrong size of \"%s\": %dx%d",
+             testFiles[n].file, image.GetWidth(), image.GetHeight()),
+            image.GetSize() == wxSize(50, 50)
+        );
+
+        CPPUNIT_ASSERT_EQUAL( 200, image.GetOptionInt(wxIMAGE_OPTION_ORIGINAL_WIDTH) );
+        CPPUNIT_ASSERT_EQUAL( 200, image.GetOptionInt(wxIMAGE_OPTION_ORIGINAL_HEIGHT) );
+        CPPUNIT_ASSERT( image.GetType() == testFiles[n].type );
+    }
+
+    // check that the pixels are averaged correctly
+    wxImage image(4, 2);
+    image.SetRGB(wxRect(0, 0, 2, 2), 0, 100, 255);
+    image.SetRGB(wxRect(2, 0, 2, 2), 255, 100, 0);
+    image.SetRGB(3, 1, 255, 104, 4);
+
+    wxMemoryOutputStream mos;
+    CPPUNIT_ASSERT( image.SaveFile(mos, wxBITMAP_TYPE_PNG) );
+
+    wxMemoryInputStream mis(mos);
+    wxImage reduced;
+    reduced.SetOption(wxIMAGE_OPTION_MAX_WIDTH, 2);
+    CPPUNIT_ASSERT( reduced.LoadFile(mis, wxBITMAP_TYPE_PNG) );
+    CPPUNIT_ASSERT( reduced.GetSize() == wxSize(2, 1) );
+    CPPUNIT_ASSERT_EQUAL( 0, (int)reduced.GetRed(0, 0) );
+    CPPUNIT_ASSERT_EQUAL( 100, (int)reduced.GetGreen(0, 0) );
+    CPPUNIT_ASSERT_EQUAL( 255, (int)reduced.GetBlue(0, 0) );
+    CPPUNIT_ASSERT_EQUAL( 255, (int)reduced.GetRed(1, 0) );
+    CPPUNIT_ASSERT_EQUAL( 101, (int)reduced.GetGreen(1, 0) );
+    CPPUNIT_ASSERT_EQUAL( 1, (int)reduced.GetBlue(1, 0) );
+
+    // check that very narrow images, which are reduced to a single pixel
+    // in one direction, are averaged correctly too
+    CheckReducedNarrow(wxSize(2, 5000), wxIMAGE_OPTION_MAX_HEIGHT, 100,
+                       wxSize(1, 78));
+    CheckReducedNarrow(wxSize(5000, 2), wxIMAGE_OPTION_MAX_WIDTH, 100,
+                       wxSize(78, 1));
+}
+
+namespace
+{
+
+// callback storing the loaded images and stopping after the given number
+class TestLoadCallback : public wxImageLoadCallback
+{
+public:
+    TestLoadCallback(size_t maxImages = (size_t)-1)
+        : m_maxImages(maxImages)
+    {
+    }
+
+    virtual bool OnImageLoaded(size_t n,
+                               const wxString& WXUNUSED(filename),
+                               wxImage& image)
+    {
+        // the images must be passed to us in order
+        CPPUNIT_ASSERT_EQUAL( m_images.size(), n );
+
+        m_images.push_back(image);
+
+        return m_images.size() < m_maxImages;
+    }
+
+    wxVector<wxImage> m_images;
+
+private:
+    const size_t m_maxImages;
+};
+
+} // anonymous namespace
+
+void ImageTestCase::LoadFiles()
+{
+    // load each file several times to have more files than threads
+    wxArrayString names;
+    for ( unsigned i = 0; i < 4; i++ )
+    {
+        for ( unsigned n = 0; n < WXSIZEOF(g_testfiles); n++ )
+            names.push_back(g_testfiles[n].file);
+    }
+
+    TestLoadCallback callback;
+    CPPUNIT_ASSERT_EQUAL( names.size(), wxImage::LoadFiles(names, callback) );
+    CPPUNIT_ASSERT_EQUAL( names.size(), callback.m_images.size() );
+
+    for ( size_t n = 0; n < names.size(); n++ )
+    {
+        wxImage expected;
+        CPPUNIT_ASSERT( expected.LoadFile(names[n]) );
+        CPPUNIT_ASSERT_EQUAL( expected, callback.m_images[n] );
+    }
+
+    // the options should be applied to all images
+    wxArrayString namesPNG;
+    namesPNG.Add("horse.png", 8);
+
+    wxImage options;
+    options.SetOption(wxIMAGE_OPTION_MAX_WIDTH, 60);
+
+    TestLoadCallback callbackReduced;
+    CPPUNIT_ASSERT_EQUAL
+    (
+        namesPNG.size(),
+        wxImage::LoadFiles(namesPNG, callbackReduced, wxBITMAP_TYPE_PNG, &options)
+    );
+
+    for ( size_t n = 0; n < callbackReduced.m_images.size(); n++ )
+        CPPUNIT_ASSERT( callbackReduced.m_images[n].GetSize() == wxSize(50, 50) );
+
+    // loading must stop when the callback returns false
+    TestLoadCallback callbackStop(3);
+    CPPUNIT_ASSERT_EQUAL( (size_t)3, wxImage::LoadFiles(names, callbackStop) );
+    CPPUNIT_ASSERT_EQUAL( (size_t)3, callbackStop.m_images.size() );
+}
+
+namespace
+{
+
+// callback storing the decoded frames
+class TestDecodeCallback : public wxImageDecodeCallback
+{
+public:
+    TestDecodeCallback() : m_numRows(0) { }
+
+    virtual bool OnRowsDecoded(unsigned frame,
+                               const wxImage& image,
+                               int yStart,
+                               int yEnd)
+    {
+        CPPUNIT_ASSERT_EQUAL( m_frames.size(), (size_t)frame );
+        CPPUNIT_ASSERT( image.IsOk() );
+        CPPUNIT_ASSERT( 0 <= yStart );
+        CPPUNIT_ASSERT( yStart < yEnd );
+        CPPUNIT_ASSERT( yEnd <= image.GetHeight() );
+
+        m_numRows += yEnd - yStart;
+
+        return true;
+    }
+
+    virtual bool OnFrameDecoded(unsigned frame, const wxImage& image)
+    {
+        CPPUNIT_ASSERT_EQUAL( m_frames.size(), (size_t)frame );
+
+        m_frames.push_back(image);
+
+        return true;
+    }
+
+    wxVector<wxImage> m_frames;
+    int m_numRows;
+};
+
+// feed the contents of the stream to the decoder in chunks of the given size
+// and check that the result is the expected image
+void CheckIncrementalDecoder(wxImageHandler& handler,
+                             const wxMemoryOutputStream& data,
+                             size_t chunkSize,
+                             const wxImage& expected)
+{
+    TestDecodeCallback callback;
+    wxScopedPtr<wxImageIncrementalDecoder>
+        decoder(handler.CreateIncrementalDecoder(callback));
+    CPPUNIT_ASSERT( decoder );
+
+    const size_t len = data.GetLength();
+    wxCharBuffer buf(len);
+    data.CopyTo(buf.data(), len);
+    const char * const start = buf.data();
+
+    for ( size_t pos = 0; pos < len; pos += chunkSize )
+    {
+        CPPUNIT_ASSERT( !decoder->IsDone() );
+        CPPUNIT_ASSERT( decoder->Feed(start + pos,
+                                      wxMin(chunkSize, len - pos)) );
+    }
+
+    CPPUNIT_ASSERT( decoder->IsDone() );
+    CPPUNIT_ASSERT_EQUAL( (size_t)1, callback.m_frames.size() );
+    CPPUNIT_ASSERT( callback.m_numRows >= expected.GetHeight() );
+
+    const wxImage& image = callback.m_frames[0];
+    CPPUNIT_ASSERT_EQUAL( expected, image );
+
+    if ( expected.HasAlpha() )
+    {
+        CPPUNIT_ASSERT( image.HasAlpha() );
+        CPPUNIT_ASSERT( memcmp(image.GetAlpha(), expected.GetAlpha(),
+                               image.GetWidth()*image.GetHeight()) == 0 );
+    }
+}
+
+} // anonymous namespace
+
+void ImageTestCase::LoadIncrementally()
+{
+    static const struct
+    {
+        const char *file;
+        wxBitmapType type;
+    } testFiles[] =
+    {
+        { "horse.png",                      wxBITMAP_TYPE_PNG  },
+        { "horse.gif",                      wxBITMAP_TYPE_GIF  },
+    };
+
+    for ( unsigned n = 0; n < WXSIZEOF(testFiles); n++ )
+    {
+        wxImageHandler * const
+            handler = wxImage::FindHandler(testFiles[n].type);
+        CPPUNIT_ASSERT( handler );
+
+        wxImage expected(testFiles[n].file, testFiles[n].type);
+        CPPUNIT_ASSERT( expected.IsOk() );
+
+        wxFileInputStream stream(testFiles[n].file);
+        CPPUNIT_ASSERT( stream.IsOk() );
+
+        wxMemoryOutputStream data;
+        data.Write(stream);
+
+        // horse.png is interlaced, so its rows are updated several times
+        CheckIncrementalDecoder(*handler, data, 1, expected);
+        CheckIncrementalDecoder(*handler, data, 100, expected);
+        CheckIncrementalDecoder(*handler, data, data.GetLength(), expected);
+    }
+
+    // also test a non-interlaced PNG with alpha
+    wxImage image("horse.png");
+    CPPUNIT_ASSERT( image.IsOk() );
+    image.SetAlpha();
+    for ( int y = 0; y < image.GetHeight(); y++ )
+    {
+        for ( int x = 0; x < image.GetWidth(); x++ )
+            image.SetAlpha(x, y, (x + y) % 256);
+    }
+
+    wxMemoryOutputStream mos;
+    CPPUNIT_ASSERT( image.SaveFile(mos, wxBITMAP_TYPE_PNG) );
+
+    wxImageHandler * const handler = wxImage::FindHandler(wxBITMAP_TYPE_PNG);
+    CheckIncrementalDecoder(*handler, mos, 7, image);
+
+    // invalid data must be detected
+    TestDecodeCallback callback;
+    wxScopedPtr<wxImageIncrementalDecoder>
+        decoder(handler->CreateIncrementalDecoder(callback, false));
+    CPPUNIT_ASSERT( decoder );
+
+    static const char garbage[] = "This is not a PNG file at all";
+    {
+        wxLogNull noLog;
+        CPPUNIT_ASSERT( !decoder->Feed(garbage, sizeof(garbage)) );
+    }
+    CPPUNIT_ASSERT( callback.m_frames.empty() );
+}
+
+void ImageTestCase::Quantize()
+{
+    wxImage image("horse.png");
+    CPPUNIT_ASSERT( image.IsOk() );
+
+    static const int flags[] = { 0, wxQUANTIZE_FAST };
+    for ( unsigned n = 0; n < WXSIZEOF(flags); n++ )
+    {
+        wxImage quantized;
+        unsigned char *data8bit = NULL;
+        CPPUNIT_ASSERT( wxQuantize::Quantize(image, quantized, NULL, 16,
+                                             &data8bit,
+                                             flags[n] |
+                                             wxQUANTIZE_FILL_DESTINATION_IMAGE |
+                                             wxQUANTIZE_RETURN_8BIT_DATA) );
+        CPPUNIT_ASSERT( quantized.GetSize() == image.GetSize() );
+        CPPUNIT_ASSERT( quantized.CountColours(16) <= 16 );
+
+        const int numPixels = image.GetWidth()*image.GetHeight();
+        for ( int i = 0; i < numPixels; i++ )
+            CPPUNIT_ASSERT( data8bit[i] < 16 );
+
+        delete [] data8bit;
+    }
+
+    // the fast quantizer must preserve an image with few distinct colours
+    wxImage few(40, 30);
+    unsigned char *p = few.GetData();
+    for ( int i = 0; i < 40*30; i++ )
+    {
+        const int c = (i / 7) % 10;
+        *p++ = (unsigned char)(c*25);
+        *p++ = (unsigned char)(255 - c*20);
+        *p++ = (unsigned char)((c*77) & 0xff);
+    }
+
+    wxImage quantized;
+    CPPUNIT_ASSERT( wxQuantize::Quantize(few, quantized, NULL, 236, NULL,
+                                         wxQUANTIZE_FAST |
+                                         wxQUANTIZE_FILL_DESTINATION_IMAGE) );
+    CPPUNIT_ASSERT_EQUAL( few, quantized );
+}
+
+void ImageTestCase::Cache()
+{
+    // each of these images uses 48 bytes
+    const wxImage image(4, 4);
+    wxImage image2(4, 4);
+    image2.SetRGB(0, 0, 1, 2, 3);
+
+    wxImageCache cache(100);
+    CPPUNIT_ASSERT( cache.Store("1", image) );
+    CPPUNIT_ASSERT( cache.Store("2", image2) );
+    CPPUNIT_ASSERT_EQUAL( 96, (int)cache.GetMemoryUsed() );
+
+    // make "1" the most recently used image, so that "2" is evicted
+    wxImage found;
+    CPPUNIT_ASSERT( cache.Lookup("1", &found) );
+    CPPUNIT_ASSERT( cache.Store("3", image2) );
+    CPPUNIT_ASSERT_EQUAL( 2, (int)cache.GetCount() );
+    CPPUNIT_ASSERT( !cache.Lookup("2", &found) );
+    CPPUNIT_ASSERT( cache.Lookup("3", &found) );
+    CPPUNIT_ASSERT_EQUAL( image2, found );
+    CPPUNIT_ASSERT_EQUAL( 2, (int)cache.GetHits() );
+    CPPUNIT_ASSERT_EQUAL( 1, (int)cache.GetMisses() );
+
+    // modifying the returned image doesn't affect the cached one
+    found.SetRGB(0, 0, 4, 5, 6);
+    CPPUNIT_ASSERT( cache.Lookup("3", &found) );
+    CPPUNIT_ASSERT_EQUAL( image2, found );
+
+    // images bigger than the budget are not stored
+    CPPUNIT_ASSERT( !cache.Store("4", wxImage(10, 10)) );
+
+    cache.SetMaxMemory(50);
+    CPPUNIT_ASSERT_EQUAL( 1, (int)cache.GetCount() );
+
+    cache.ResetStatistics();
+    CPPUNIT_ASSERT_EQUAL( 0, (int)cache.GetHits() );
+
+    // check that the global cache is used by LoadFile()
+    wxImageCache& global = wxImageCache::Get();
+    CPPUNIT_ASSERT( !global.IsEnabled() );
+    global.SetMaxMemory(16*1024*1024);
+    global.ResetStatistics();
+
+    wxImage loaded;
+    CPPUNIT_ASSERT( loaded.LoadFile("horse.png") );
+    CPPUNIT_ASSERT_EQUAL( 1, (int)global.GetMisses() );
+    CPPUNIT_ASSERT_EQUAL( 1, (int)global.GetCount() );
+
+    wxImage cached;
+    CPPUNIT_ASSERT( cached.LoadFile("horse.png") );
+    CPPUNIT_ASSERT_EQUAL( 1, (int)global.GetHits() );
+    CPPUNIT_ASSERT_EQUAL( loaded, cached );
+    CPPUNIT_ASSERT_EQUAL( wxBITMAP_TYPE_PNG, cached.GetType() );
+
+    // different options must result in a different cache entry
+    wxImage reduced;
+    reduced.SetOption(wxIMAGE_OPTION_MAX_WIDTH, loaded.GetWidth()/2);
+    CPPUNIT_ASSERT( reduced.LoadFile("horse.png") );
+    CPPUNIT_ASSERT_EQUAL( 2, (int)global.GetMisses() );
+    CPPUNIT_ASSERT( reduced.GetWidth() < loaded.GetWidth() );
+
+    global.SetMaxMemory(0);
+    CPPUNIT_ASSERT_EQUAL( 0, (int)global.GetCount() );
+}
+
+void ImageTestCase::PasteCompose()
+{
+    wxImage image(2, 1);
+    image.SetRGB(0, 0, 200, 100, 0);
+    image.SetRGB(1, 0, 200, 100, 0);
+
+    wxImage pasted(2, 1);
+    pasted.SetRGB(0, 0, 0, 0, 255);
+    pasted.SetRGB(1, 0, 0, 0, 255);
+    pasted.SetAlpha();
+    pasted.SetAlpha(0, 0, wxIMAGE_ALPHA_OPAQUE);
+    pasted.SetAlpha(1, 0, 51);
+
+    // by default the pasted pixels simply replace the existing ones
+    wxImage replaced = image.Copy();
+    replaced.Paste(pasted, 0, 0);
+    CPPUNIT_ASSERT_EQUAL( 0, (int)replaced.GetRed(1, 0) );
+    CPPUNIT_ASSERT_EQUAL( 51, (int)replaced.GetAlpha(1, 0) );
+
+    // but they're drawn over them when composing
+    wxImage composed = image.Copy();
+    composed.Paste(pasted, 0, 0, wxIMAGE_ALPHA_BLEND_COMPOSE);
+    CPPUNIT_ASSERT_EQUAL( 0, (int)composed.GetRed(0, 0) );
+    CPPUNIT_ASSERT_EQUAL( 255, (int)composed.GetBlue(0, 0) );
+    CPPUNIT_ASSERT_EQUAL( 160, (int)composed.GetRed(1, 0) );
+    CPPUNIT_ASSERT_EQUAL( 80, (int)composed.GetGreen(1, 0) );
+    CPPUNIT_ASSERT_EQUAL( 51, (int)composed.GetBlue(1, 0) );
+    CPPUNIT_ASSERT_EQUAL( 255, (int)composed.GetAlpha(1, 0) );
+
+    // composing over a transparent pixel results in the pasted one
+    composed = image.Copy();
+    composed.InitAlpha();
+    composed.SetAlpha(1, 0, wxIMAGE_ALPHA_TRANSPARENT);
+    composed.Paste(pasted, 0, 0, wxIMAGE_ALPHA_BLEND_COMPOSE);
+    CPPUNIT_ASSERT_EQUAL( 0, (int)composed.GetRed(1, 0) );
+    CPPUNIT_ASSERT_EQUAL( 255, (int)composed.GetBlue(1, 0) );
+    CPPUNIT_ASSERT_EQUAL( 51, (int)composed.GetAlpha(1, 0) );
+}
+
+namespace
+{
+
+// return alpha which is fully transparent or opaque more often than not, as
+// these values are handled specially by the kernels
+unsigned char GetRandomAlpha()
+{
+    switch ( rand() % 4 )
+    {
+        case 0:
+            return wxIMAGE_ALPHA_TRANSPARENT;
+
+        case 1:
+            return wxIMAGE_ALPHA_OPAQUE;
+    }
+
+    return rand();
+}
+
+template <typename T>
+bool AreEqual(const wxVector<T>& v1, const wxVector<T>& v2)
+{
+    return v1.size() == v2.size() &&
+            memcmp(&v1[0], &v2[0], v1.size()*sizeof(T)) == 0;
+}
+
+} // anonymous namespace
+
+void ImageTestCase::PixelOps()
+{
+    // check that the vectorized kernels, if available, produce exactly the
+    // same results as the scalar ones for all lengths around the vector size
+    for ( int count = 0; count < 70; count++ )
+    {
+        for ( int iteration = 0; iteration < 10; iteration++ )
+        {
+            // all alpha values are the same in some iterations to check the
+            // special cases for whole vectors of them
+            const int alphaKind = iteration % 3;
+
+            wxVector<unsigned char> rgb(3*count + 1),
+                                    alpha(count + 1),
+                                    pixels(4*count + 1);
+            for ( int i = 0; i < 3*count; i++ )
+                rgb[i] = rand();
+            for ( int i = 0; i < count; i++ )
+            {
+                alpha[i] = alphaKind == 0 ? wxIMAGE_ALPHA_OPAQUE
+                                          : alphaKind == 1 ? GetRandomAlpha()
+                                                           : rand();
+            }
+            for ( int i = 0; i < 4*count; i++ )
+                pixels[i] = i % 4 == 3 ? alpha[i/4] : rand();
+
+            wxVector<wxUint32> argb1(count + 1),
+                               argb2(count + 1);
+
+            wxPixelOps::RGBToARGBScalar(&argb1[0], &rgb[0], &alpha[0], count);
+            wxPixelOps::RGBToARGB(&argb2[0], &rgb[0], &alpha[0], count);
+            CPPUNIT_ASSERT( AreEqual(argb1, argb2) );
+
+            wxPixelOps::RGBToARGBScalar(&argb1[0], &rgb[0], NULL, count);
+            wxPixelOps::RGBToARGB(&argb2[0], &rgb[0], NULL, count);
+            CPPUNIT_ASSERT( AreEqual(argb1, argb2) );
+
+            wxPixelOps::PixelsToARGBScalar<0, 1, 2, 3>(&argb1[0], &pixels[0], count);
+            wxPixelOps::PixelsToARGB<0, 1, 2, 3>(&argb2[0], &pixels[0], count);
+            CPPUNIT_ASSERT( AreEqual(argb1, argb2) );
+
+            wxPixelOps::PixelsToARGBScalar<2, 1, 0, 3>(&argb1[0], &pixels[0], count);
+            wxPixelOps::PixelsToARGB<2, 1, 0, 3>(&argb2[0], &pixels[0], count);
+            CPPUNIT_ASSERT( AreEqual(argb1, argb2) );
+
+            // use valid pre-multiplied data for the reverse conversion
+            wxPixelOps::RGBToARGBScalar(&argb1[0], &rgb[0], &alpha[0], count);
+
+            wxVector<unsigned char> rgb1(3*count + 1), rgb2(3*count + 1),
+                                    alpha1(count + 1), alpha2(count + 1);
+            wxPixelOps::ARGBToRGBScalar(&rgb1[0], &alpha1[0], &argb1[0], count);
+            wxPixelOps::ARGBToRGB(&rgb2[0], &alpha2[0], &argb1[0], count);
+            CPPUNIT_ASSERT( AreEqual(rgb1, rgb2) );
+            CPPUNIT_ASSERT( AreEqual(alpha1, alpha2) );
+
+            wxPixelOps::ARGBToRGBScalar(&rgb1[0], NULL, &argb1[0], count);
+            wxPixelOps::ARGBToRGB(&rgb2[0], NULL, &argb1[0], count);
+            CPPUNIT_ASSERT( AreEqual(rgb1, rgb2) );
+
+            // compose over both opaque and partially transparent pixels
+            for ( int i = 0; i < 3*count; i++ )
+                rgb1[i] = rand();
+            for ( int i = 0; i < count; i++ )
+            {
+                alpha1[i] = iteration % 2 ? wxIMAGE_ALPHA_OPAQUE
+                                          : GetRandomAlpha();
+            }
+            rgb2 = rgb1;
+            alpha2 = alpha1;
+
+            wxPixelOps::BlendOverScalar(&rgb1[0], &alpha1[0],
+                                        &rgb[0], &alpha[0], count);
+            wxPixelOps::BlendOver(&rgb2[0], &alpha2[0],
+                                  &rgb[0], &alpha[0], count);
+            CPPUNIT_ASSERT( AreEqual(rgb1, rgb2) );
+            CPPUNIT_ASSERT( AreEqual(alpha1, alpha2) );
+
+            wxPixelOps::BlendOverScalar(&rgb1[0], NULL,
+                                        &rgb[0], &alpha[0], count);
+            wxPixelOps::BlendOver(&rgb2[0], NULL,
+                                  &rgb[0], &alpha[0], count);
+            CPPUNIT_ASSERT( AreEqual(rgb1, rgb2) );
+
+            // mask generation in both directions
+            const unsigned char threshold = rand();
+            rgb1 = rgb;
+            rgb2 = rgb;
+            wxPixelOps::AlphaToMaskScalar(&rgb1[0], &alpha[0], count,
+                                          threshold, 1, 2, 3);
+            wxPixelOps::AlphaToMask(&rgb2[0], &alpha[0], count,
+                                    threshold, 1, 2, 3);
+            CPPUNIT_ASSERT( AreEqual(rgb1, rgb2) );
+
+            wxPixelOps::MaskToAlphaScalar(&alpha1[0], &rgb1[0], count, 1, 2, 3);
+            wxPixelOps::MaskToAlpha(&alpha2[0], &rgb1[0], count, 1, 2, 3);
+            CPPUNIT_ASSERT( AreEqual(alpha1, alpha2) );
+        }
+    }
+}
+
 #endif //wxUSE_IMAGE
 
 
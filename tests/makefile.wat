@@ -296,6 +296,7 @@ TEST_OBJECTS =  &
 	$(OBJS)\test_datetimetest.obj &
 	$(OBJS)\test_evthandler.obj &
 	$(OBJS)\test_evtsource.obj &
+	$(OBJS)\test_fdiodispatcher.obj &
 	$(OBJS)\test_stopwatch.obj &
 	$(OBJS)\test_timertest.obj &
 	$(OBJS)\test_exec.obj &
@@ -357,6 +358,7 @@ TEST_OBJECTS =  &
 	$(OBJS)\test_atomic.obj &
 	$(OBJS)\test_misc.obj &
 	$(OBJS)\test_queue.obj &
+	$(OBJS)\test_threadpool.obj &
 	$(OBJS)\test_tls.obj &
 	$(OBJS)\test_ftp.obj &
 	$(OBJS)\test_uris.obj &
@@ -556,6 +558,9 @@ $(OBJS)\test_evthandler.obj :  .AUTODEPEND .\events\evthandler.cpp
 $(OBJS)\test_evtsource.obj :  .AUTODEPEND .\events\evtsource.cpp
 	$(CXX) -bt=nt -zq -fo=$^@ $(TEST_CXXFLAGS) $<
 
+$(OBJS)\test_fdiodispatcher.obj :  .AUTODEPEND .\events\fdiodispatcher.cpp
+	$(CXX) -bt=nt -zq -fo=$^@ $(TEST_CXXFLAGS) $<
+
 $(OBJS)\test_stopwatch.obj :  .AUTODEPEND .\events\stopwatch.cpp
 	$(CXX) -bt=nt -zq -fo=$^@ $(TEST_CXXFLAGS) $<
 
@@ -739,6 +744,9 @@ $(OBJS)\test_misc.obj :  .AUTODEPEND .\thread\misc.cpp
 $(OBJS)\test_queue.obj :  .AUTODEPEND .\thread\queue.cpp
 	$(CXX) -bt=nt -zq -fo=$^@ $(TEST_CXXFLAGS) $<
 
+$(OBJS)\test_threadpool.obj :  .AUTODEPEND .\thread\threadpool.cpp
+	$(CXX) -bt=nt -zq -fo=$^@ $(TEST_CXXFLAGS) $<
+
 $(OBJS)\test_tls.obj :  .AUTODEPEND .\thread\tls.cpp
 	$(CXX) -bt=nt -zq -fo=$^@ $(TEST_CXXFLAGS) $<
 
@@ -26,6 +26,8 @@
 #include "wx/txtstrm.h"
 #include "wx/mstream.h"
 
+#include "wx/private/utf8ops.h"
+
 #if defined wxHAVE_TCHAR_SUPPORT && !defined HAVE_WCHAR_H
     #define HAVE_WCHAR_H
 #endif
@@ -82,6 +84,11 @@ private:
         CPPUNIT_TEST( FontmapTests );
         CPPUNIT_TEST( BufSize );
         CPPUNIT_TEST( FromWCharTests );
+        CPPUNIT_TEST( UTF8LongTests );
+        CPPUNIT_TEST( UTF8MultiByteTests );
+        CPPUNIT_TEST( UTF8Validation );
+        CPPUNIT_TEST( BufferConversion );
+        CPPUNIT_TEST( SingleByteTables );
 #ifdef HAVE_WCHAR_H
         CPPUNIT_TEST( UTF8_41 );
         CPPUNIT_TEST( UTF8_7f );
@@ -117,6 +124,11 @@ private:
     void FontmapTests();
     void BufSize();
     void FromWCharTests();
+    void UTF8LongTests();
+    void UTF8MultiByteTests();
+    void UTF8Validation();
+    void BufferConversion();
+    void SingleByteTables();
     void IconvTests();
     void Latin1Tests();
 
@@ -929,6 +941,437 @@ void MBConvTestCase::FromWCharTests()
     CPPUNIT_ASSERT_EQUAL( '!', mbuf[6]);
 }
 
+// check that the strings long enough to be converted in blocks, and not one
+// character at a time, are handled correctly, whatever the position of the
+// non-ASCII characters in them is
+void MBConvTestCase::UTF8LongTests()
+{
+    for ( size_t len = 1; len < 70; len++ )
+    {
+        for ( size_t pos = 0; pos <= len; pos++ )
+        {
+            // the string is ASCII except for U+00E9 at the given position,
+            // unless it is at the end of it
+            wxWCharBuffer wbuf(len);
+            wxCharBuffer expected(len + 1);
+            size_t lenUTF8 = 0;
+            for ( size_t n = 0; n < len; n++ )
+            {
+                if ( n == pos )
+                {
+                    wbuf.data()[n] = 0xe9;
+                    expected.data()[lenUTF8++] = '\xc3';
+                    expected.data()[lenUTF8++] = '\xa9';
+                }
+                else
+                {
+                    wbuf.data()[n] = 'a' + n % 26;
+                    expected.data()[lenUTF8++] = 'a' + n % 26;
+                }
+            }
+            expected.data()[lenUTF8] = '\0';
+
+            WX_ASSERT_EQUAL_MESSAGE
+            (
+                ("length %u, position %u", (unsigned)len, (unsigned)pos),
+                lenUTF8 + 1,
+                wxConvUTF8.FromWChar(NULL, 0, wbuf)
+            );
+
+            char buf[80];
+            memset(buf, '!', sizeof(buf));
+            CPPUNIT_ASSERT_EQUAL
+            (
+                wxCONV_FAILED,
+                wxConvUTF8.FromWChar(buf, lenUTF8, wbuf)
+            );
+            CPPUNIT_ASSERT_EQUAL( '!', buf[lenUTF8] );
+
+            CPPUNIT_ASSERT_EQUAL
+            (
+                lenUTF8 + 1,
+                wxConvUTF8.FromWChar(buf, lenUTF8 + 1, wbuf)
+            );
+            CPPUNIT_ASSERT( memcmp(buf, expected.data(), lenUTF8 + 1) == 0 );
+            CPPUNIT_ASSERT_EQUAL( '!', buf[lenUTF8 + 1] );
+
+            CPPUNIT_ASSERT_EQUAL( len + 1, wxConvUTF8.ToWChar(NULL, 0, buf) );
+
+            wchar_t wout[80];
+            wout[len + 1] = L'!';
+            CPPUNIT_ASSERT_EQUAL
+            (
+                wxCONV_FAILED,
+                wxConvUTF8.ToWChar(wout, len, buf)
+            );
+            CPPUNIT_ASSERT_EQUAL( L'!', wout[len + 1] );
+
+            CPPUNIT_ASSERT_EQUAL
+            (
+                len + 1,
+                wxConvUTF8.ToWChar(wout, len + 1, buf)
+            );
+            CPPUNIT_ASSERT( memcmp(wout, wbuf.data(), (len + 1)*sizeof(wchar_t)) == 0 );
+            CPPUNIT_ASSERT_EQUAL( L'!', wout[len + 1] );
+
+            // also check that an invalid byte is detected wherever it is
+            buf[pos < lenUTF8 ? pos : lenUTF8 - 1] = '\xff';
+            CPPUNIT_ASSERT_EQUAL
+            (
+                wxCONV_FAILED,
+                wxConvUTF8.ToWChar(NULL, 0, buf, lenUTF8)
+            );
+        }
+    }
+}
+
+// simple linear congruential generator giving the same results everywhere
+static unsigned NextRandom(unsigned long& seed)
+{
+    seed = (seed*1103515245 + 12345) & 0xffffffff;
+    return (unsigned)(seed >> 16) & 0x7fff;
+}
+
+// return a random code point from one of the ranges whose bits are set in
+// the given mask
+static wxUint32 RandomCodePoint(unsigned long& seed, unsigned ranges)
+{
+    static const wxUint32 limits[][2] =
+    {
+        { 0x20,     0x7e },
+        { 0x80,     0x7ff },
+        { 0x800,    0xd7ff },
+        { 0xe000,   0xfffd },
+        { 0x10000,  0x10ffff },
+    };
+
+    size_t n;
+    do
+    {
+        n = NextRandom(seed) % WXSIZEOF(limits);
+    }
+    while ( !(ranges & (1 << n)) );
+
+    const wxUint32 r = NextRandom(seed)*0x8000 + NextRandom(seed);
+    return limits[n][0] + r % (limits[n][1] - limits[n][0] + 1);
+}
+
+// append the code point to UTF-8 and wchar_t strings
+static void AppendCodePoint(wxUint32 code,
+                            char *utf8, size_t& lenUTF8,
+                            wchar_t *wide, size_t& lenWide)
+{
+    if ( code < 0x80 )
+    {
+        utf8[lenUTF8++] = (char)code;
+    }
+    else if ( code < 0x800 )
+    {
+        utf8[lenUTF8++] = (char)(0xc0 | (code >> 6));
+        utf8[lenUTF8++] = (char)(0x80 | (code & 0x3f));
+    }
+    else if ( code < 0x10000 )
+    {
+        utf8[lenUTF8++] = (char)(0xe0 | (code >> 12));
+        utf8[lenUTF8++] = (char)(0x80 | ((code >> 6) & 0x3f));
+        utf8[lenUTF8++] = (char)(0x80 | (code & 0x3f));
+    }
+    else
+    {
+        utf8[lenUTF8++] = (char)(0xf0 | (code >> 18));
+        utf8[lenUTF8++] = (char)(0x80 | ((code >> 12) & 0x3f));
+        utf8[lenUTF8++] = (char)(0x80 | ((code >> 6) & 0x3f));
+        utf8[lenUTF8++] = (char)(0x80 | (code & 0x3f));
+    }
+
+#if SIZEOF_WCHAR_T == 2
+    if ( code >= 0x10000 )
+    {
+        wide[lenWide++] = (wchar_t)(0xd800 | ((code - 0x10000) >> 10));
+        wide[lenWide++] = (wchar_t)(0xdc00 | (code & 0x3ff));
+        return;
+    }
+#endif // SIZEOF_WCHAR_T == 2
+
+    wide[lenWide++] = (wchar_t)code;
+}
+
+// check that the strings containing multibyte characters, which may be
+// converted in blocks too, are handled correctly
+void MBConvTestCase::UTF8MultiByteTests()
+{
+    unsigned long seed = 1;
+    for ( size_t iteration = 0; iteration < 1000; iteration++ )
+    {
+        const size_t len = NextRandom(seed) % 100;
+        const unsigned ranges = 1 + NextRandom(seed) % 31;
+
+        // the string may contain an overlong encoding of '/' which is not
+        // valid UTF-8 but is still accepted by wxConvUTF8 and must be
+        // handled in the same way whatever its position is
+        const size_t posOverlong = NextRandom(seed) % 200;
+
+        wxCharBuffer utf8(4*len + 3);
+        wxWCharBuffer wide(2*len + 1);
+        size_t lenUTF8 = 0,
+               lenWide = 0;
+        for ( size_t n = 0; n < len; n++ )
+        {
+            if ( n == posOverlong )
+            {
+                memcpy(utf8.data() + lenUTF8, "\xe0\x80\xaf", 3);
+                lenUTF8 += 3;
+                wide.data()[lenWide++] = L'/';
+            }
+
+            AppendCodePoint(RandomCodePoint(seed, ranges),
+                            utf8.data(), lenUTF8,
+                            wide.data(), lenWide);
+        }
+
+        utf8.data()[lenUTF8] = '\0';
+        wide.data()[lenWide] = L'\0';
+
+        CPPUNIT_ASSERT_EQUAL( lenWide + 1, wxConvUTF8.ToWChar(NULL, 0, utf8) );
+        CPPUNIT_ASSERT_EQUAL( lenWide,
+                              wxConvUTF8.ToWChar(NULL, 0, utf8, lenUTF8) );
+
+        wxWCharBuffer wout(lenWide);
+        CPPUNIT_ASSERT_EQUAL
+        (
+            lenWide + 1,
+            wxConvUTF8.ToWChar(wout.data(), lenWide + 1, utf8)
+        );
+        WX_ASSERT_MESSAGE
+        (
+            ("iteration %u", (unsigned)iteration),
+            memcmp(wout, wide, (lenWide + 1)*sizeof(wchar_t)) == 0
+        );
+
+        if ( lenWide > 1 )
+        {
+            CPPUNIT_ASSERT_EQUAL
+            (
+                wxCONV_FAILED,
+                wxConvUTF8.ToWChar(wout.data(), lenWide / 2, utf8, lenUTF8)
+            );
+        }
+
+        if ( posOverlong >= len )
+        {
+            CPPUNIT_ASSERT_EQUAL
+            (
+                lenUTF8 + 1,
+                wxConvUTF8.FromWChar(NULL, 0, wide)
+            );
+
+            wxCharBuffer out(lenUTF8 + 1);
+            out.data()[lenUTF8] = '!';
+            if ( lenUTF8 )
+            {
+                CPPUNIT_ASSERT_EQUAL
+                (
+                    wxCONV_FAILED,
+                    wxConvUTF8.FromWChar(out.data(), lenUTF8, wide)
+                );
+                CPPUNIT_ASSERT_EQUAL( '!', out.data()[lenUTF8] );
+            }
+
+            CPPUNIT_ASSERT_EQUAL
+            (
+                lenUTF8 + 1,
+                wxConvUTF8.FromWChar(out.data(), lenUTF8 + 1, wide)
+            );
+            WX_ASSERT_MESSAGE
+            (
+                ("iteration %u", (unsigned)iteration),
+                memcmp(out, utf8, lenUTF8 + 1) == 0
+            );
+        }
+
+        // an invalid byte must be detected wherever it is
+        if ( lenUTF8 )
+        {
+            utf8.data()[NextRandom(seed) % lenUTF8] = '\xff';
+            CPPUNIT_ASSERT_EQUAL
+            (
+                wxCONV_FAILED,
+                wxConvUTF8.ToWChar(NULL, 0, utf8, lenUTF8)
+            );
+        }
+    }
+}
+
+// check that the vectorized UTF-8 validation, if any, gives the same results
+// as the scalar one
+void MBConvTestCase::UTF8Validation()
+{
+    static const char *sequences[] =
+    {
+        "\x41",
+        "\xc2\x80",
+        "\xdf\xbf",
+        "\xe0\xa0\x80",
+        "\xed\x9f\xbf",
+        "\xef\xbf\xbd",
+        "\xf0\x90\x80\x80",
+        "\xf4\x8f\xbf\xbd",
+
+        // the sequences below are invalid
+        "\x80",
+        "\xc0\x80",
+        "\xc1\xbf",
+        "\xc2\x41",
+        "\xe0\x9f\xbf",
+        "\xed\xa0\x80",
+        "\xef\xbf",
+        "\xf0\x8f\xbf\xbf",
+        "\xf4\x90\x80\x80",
+        "\xf5\x80\x80\x80",
+        "\xff",
+    };
+
+    for ( size_t n = 0; n < WXSIZEOF(sequences); n++ )
+    {
+        const bool valid = n < 8;
+        const size_t lenSeq = strlen(sequences[n]);
+
+        // put the sequence at all positions in the string long enough to be
+        // processed in several blocks
+        for ( size_t pos = 0; pos < 40; pos++ )
+        {
+            char buf[64];
+            memset(buf, 'x', sizeof(buf));
+            memcpy(buf + pos, sequences[n], lenSeq);
+
+            for ( size_t len = pos; len <= pos + lenSeq; len++ )
+            {
+                const bool expected = valid ? len == pos || len == pos + lenSeq
+                                            : len == pos;
+
+                WX_ASSERT_EQUAL_MESSAGE
+                (
+                    ("sequence %u, position %u, length %u",
+                     (unsigned)n, (unsigned)pos, (unsigned)len),
+                    expected,
+                    wxUtf8Ops::IsValidScalar(buf, len)
+                );
+
+                CPPUNIT_ASSERT_EQUAL( expected, wxUtf8Ops::IsValid(buf, len) );
+            }
+        }
+    }
+}
+
+// check that {To,From}WCharBuffer() give the same results as the functions
+// converting the input twice, whether they can convert it in one pass or not
+void MBConvTestCase::BufferConversion()
+{
+    wxMBConvUTF16LE convUTF16LE;
+    wxMBConvUTF32BE convUTF32BE;
+    wxMBConvUTF7 convUTF7;
+    wxCSConv convLatin1("ISO-8859-1");
+    const wxMBConv * const convs[] =
+    {
+        &wxConvUTF8, &convUTF16LE, &convUTF32BE, &convUTF7, &convLatin1
+    };
+
+    static const wchar_t *strings[] =
+    {
+        L"",
+        L"x",
+        L"Just some ASCII text",
+        L"Caf\u00e9 cr\u00e8me",
+    };
+
+    for ( size_t n = 0; n < WXSIZEOF(convs); n++ )
+    {
+        const wxMBConv& conv = *convs[n];
+        const size_t nulLen = conv.GetMBNulLen();
+
+        for ( size_t m = 0; m < WXSIZEOF(strings); m++ )
+        {
+            const wchar_t * const wstr = strings[m];
+
+            size_t lenMB;
+            const wxCharBuffer expectedMB = conv.cWC2MB(wstr, wxNO_LEN, &lenMB);
+
+            wxCharBuffer mb;
+            CPPUNIT_ASSERT_EQUAL( lenMB + nulLen, conv.FromWCharBuffer(mb, wstr) );
+            CPPUNIT_ASSERT_EQUAL( lenMB + nulLen, mb.length() );
+            CPPUNIT_ASSERT( memcmp(mb.data(), expectedMB.data(), lenMB + nulLen) == 0 );
+
+            const size_t lenWC = wxWcslen(wstr);
+            wxWCharBuffer wc;
+            CPPUNIT_ASSERT_EQUAL( lenWC + 1, conv.ToWCharBuffer(wc, expectedMB) );
+            CPPUNIT_ASSERT_EQUAL( lenWC + 1, wc.length() );
+            CPPUNIT_ASSERT( wxStrcmp(wc.data(), wstr) == 0 );
+
+            if ( !lenWC )
+                continue;
+
+            // check that the buffer is NUL-terminated even if the input isn't
+            CPPUNIT_ASSERT_EQUAL( lenMB, conv.FromWCharBuffer(mb, wstr, lenWC) );
+            for ( size_t i = 0; i < nulLen; i++ )
+                CPPUNIT_ASSERT_EQUAL( '\0', mb[lenMB + i] );
+
+            CPPUNIT_ASSERT_EQUAL( lenWC, conv.ToWCharBuffer(wc, expectedMB, lenMB) );
+            CPPUNIT_ASSERT_EQUAL( L'\0', wc[lenWC] );
+            CPPUNIT_ASSERT( wxStrcmp(wc.data(), wstr) == 0 );
+        }
+    }
+
+    // this converter can't convert in one pass as an invalid byte is mapped to
+    // 4 characters in this mode, check that the fallback works too
+    wxMBConvUTF8 convOctal(wxMBConvUTF8::MAP_INVALID_UTF8_TO_OCTAL);
+    wxWCharBuffer wc;
+    CPPUNIT_ASSERT_EQUAL( 7, convOctal.ToWCharBuffer(wc, "a\xff" "b") );
+    CPPUNIT_ASSERT( wxStrcmp(wc.data(), L"a\\377b") == 0 );
+
+    // failing conversion doesn't modify the output buffer
+    CPPUNIT_ASSERT_EQUAL( wxCONV_FAILED, wxConvUTF8.ToWCharBuffer(wc, "\xff") );
+    CPPUNIT_ASSERT( wxStrcmp(wc.data(), L"a\\377b") == 0 );
+}
+
+// check the table-driven conversions used by wxCSConv for the single byte
+// encodings
+void MBConvTestCase::SingleByteTables()
+{
+    wxCSConv conv(wxFONTENCODING_ISO8859_2);
+    CPPUNIT_ASSERT( conv.IsOk() );
+
+    // all characters are defined in this encoding, so all of them must survive
+    // the round trip
+    char all[256];
+    for ( size_t n = 0; n < WXSIZEOF(all) - 1; n++ )
+        all[n] = (char)(n + 1);
+    all[WXSIZEOF(all) - 1] = '\0';
+
+    wchar_t wc[WXSIZEOF(all)];
+    CPPUNIT_ASSERT_EQUAL( WXSIZEOF(all), conv.ToWChar(wc, WXSIZEOF(wc), all) );
+    CPPUNIT_ASSERT_EQUAL( L'A', wc['A' - 1] );
+    CPPUNIT_ASSERT_EQUAL( (wchar_t)0x0104, wc[0xa1 - 1] );
+    CPPUNIT_ASSERT_EQUAL( (wchar_t)0x02d9, wc[0xff - 1] );
+
+    char mb[WXSIZEOF(all)];
+    CPPUNIT_ASSERT_EQUAL( WXSIZEOF(all), conv.FromWChar(mb, WXSIZEOF(mb), wc) );
+    CPPUNIT_ASSERT( memcmp(mb, all, WXSIZEOF(all)) == 0 );
+
+    // too small buffers and characters not representable in this encoding
+    // must be detected
+    CPPUNIT_ASSERT_EQUAL( wxCONV_FAILED, conv.ToWChar(wc, 2, "abc") );
+    CPPUNIT_ASSERT_EQUAL( wxCONV_FAILED, conv.FromWChar(mb, 2, L"abc") );
+    CPPUNIT_ASSERT_EQUAL( wxCONV_FAILED, conv.FromWChar(NULL, 0, L"x\u00e0y") );
+    CPPUNIT_ASSERT_EQUAL( wxCONV_FAILED, conv.FromWChar(NULL, 0, L"\u20ac") );
+
+    // unlike in ISO-8859-x, some of the characters in 0x80..0x9f range are not
+    // defined in CP1252 while the others are
+    wxCSConv conv1252(wxFONTENCODING_CP1252);
+    CPPUNIT_ASSERT_EQUAL( wxCONV_FAILED, conv1252.ToWChar(NULL, 0, "\x81") );
+    CPPUNIT_ASSERT_EQUAL( 2, conv1252.FromWChar(mb, WXSIZEOF(mb), L"\u20ac") );
+    CPPUNIT_ASSERT_EQUAL( '\x80', mb[0] );
+}
+
 WXDLLIMPEXP_BASE wxMBConv* new_wxMBConv_iconv( const char* name );
 
 void MBConvTestCase::IconvTests()
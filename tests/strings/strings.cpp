@@ -61,6 +61,7 @@ private:
         CPPUNIT_TEST( CStrDataImplicitConversion );
         CPPUNIT_TEST( ExplicitConversion );
         CPPUNIT_TEST( IndexedAccess );
+        CPPUNIT_TEST( IndexedAccessLong );
         CPPUNIT_TEST( BeforeAndAfter );
         CPPUNIT_TEST( ScopedBuffers );
     CPPUNIT_TEST_SUITE_END();
@@ -95,6 +96,7 @@ private:
     void CStrDataImplicitConversion();
     void ExplicitConversion();
     void IndexedAccess();
+    void IndexedAccessLong();
     void BeforeAndAfter();
     void ScopedBuffers();
 
@@ -971,6 +973,62 @@ void StringTestCase::IndexedAccess()
     CPPUNIT_ASSERT_EQUAL( 'r', (char)s[2] );
 }
 
+// return the character at the given position in the string used by the test
+// below: it contains the characters taking 1, 2 and 3 bytes in UTF-8
+static wxUniChar GetLongStringChar(size_t n)
+{
+    if ( n % 7 == 0 )
+        return wxUniChar('a' + n % 26);
+
+    return wxUniChar(n % 7 < 4 ? 0x430 : 0x4e00);
+}
+
+// in UTF-8 build, long strings use an index to find the characters, check
+// that it works correctly, including after modifying the string
+void StringTestCase::IndexedAccessLong()
+{
+    const size_t len = 10000;
+    wxString s;
+    for ( size_t n = 0; n < len; n++ )
+        s += GetLongStringChar(n);
+
+    CPPUNIT_ASSERT_EQUAL( len, s.length() );
+
+    // access the characters in the order not allowing to use the cache
+    for ( size_t n = len; n > 0; n-- )
+        CPPUNIT_ASSERT( s[n - 1] == GetLongStringChar(n - 1) );
+
+    for ( size_t n = 0; n < len; n += 997 )
+        CPPUNIT_ASSERT( s[n] == GetLongStringChar(n) );
+
+    CPPUNIT_ASSERT_EQUAL( 7000, s.find(GetLongStringChar(7000), 6990) );
+    CPPUNIT_ASSERT_EQUAL( 1, s.find(GetLongStringChar(1), 1) );
+    CPPUNIT_ASSERT( s.Mid(6999, 2) ==
+                        wxString(GetLongStringChar(6999)) + GetLongStringChar(7000) );
+    CPPUNIT_ASSERT_EQUAL( 1000, s.Mid(5000, 1000).length() );
+    CPPUNIT_ASSERT_EQUAL( 5, s.Mid(len - 5, 1000).length() );
+
+    // modify the string before the last accessed position and check that the
+    // characters are still found correctly
+    s.erase(0, 1);
+    CPPUNIT_ASSERT( s[6999] == GetLongStringChar(7000) );
+
+    s.insert(0, wxString(L"\x4e00\x4e00"));
+    CPPUNIT_ASSERT( s[7001] == GetLongStringChar(7000) );
+
+    s[0] = '#';
+    CPPUNIT_ASSERT( s[7001] == GetLongStringChar(7000) );
+
+    s += wxString(L"\x430z");
+    CPPUNIT_ASSERT_EQUAL( len + 3, s.length() );
+    CPPUNIT_ASSERT( s[len + 2] == 'z' );
+
+    wxString s2(s);
+    s2.Replace("#", "##");
+    CPPUNIT_ASSERT( s2[7002] == GetLongStringChar(7000) );
+    CPPUNIT_ASSERT( s[7001] == GetLongStringChar(7000) );
+}
+
 void StringTestCase::BeforeAndAfter()
 {
     // Construct a string with 2 equal signs in it by concatenating its three
@@ -313,6 +313,10 @@ SOURCE=.\exec\exec.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=.\events\fdiodispatcher.cpp
+# End Source File
+# Begin Source File
+
 SOURCE=.\streams\ffilestream.cpp
 # End Source File
 # Begin Source File
@@ -505,6 +509,10 @@ SOURCE=.\streams\textstreamtest.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=.\thread\threadpool.cpp
+# End Source File
+# Begin Source File
+
 SOURCE=.\events\timertest.cpp
 # End Source File
 # Begin Source File
@@ -73,6 +73,7 @@ private:
     CPPUNIT_TEST_SUITE( AtomicTestCase );
         CPPUNIT_TEST( TestNoThread );
         CPPUNIT_TEST( TestDecReturn );
+        CPPUNIT_TEST( TestCompareAndSwap );
         CPPUNIT_TEST( TestTwoThreadsMix );
         CPPUNIT_TEST( TestTenThreadsMix );
         CPPUNIT_TEST( TestTwoThreadsSeparate );
@@ -81,6 +82,7 @@ private:
 
     void TestNoThread();
     void TestDecReturn();
+    void TestCompareAndSwap();
     void TestTenThreadsMix() { TestWithThreads(10, IncAndDecMixed); }
     void TestTwoThreadsMix() { TestWithThreads(2, IncAndDecMixed); }
     void TestTenThreadsSeparate() { TestWithThreads(10, IncOnly); }
@@ -122,6 +124,28 @@ void AtomicTestCase::TestDecReturn()
     CPPUNIT_ASSERT( wxAtomicDec(i) == 0 );
 }
 
+void AtomicTestCase::TestCompareAndSwap()
+{
+    wxUint32 value = 1;
+    CPPUNIT_ASSERT( !wxAtomicCompareAndSwap(value, 0, 2) );
+    CPPUNIT_ASSERT( value == 1 );
+
+    CPPUNIT_ASSERT( wxAtomicCompareAndSwap(value, 1, 2) );
+    CPPUNIT_ASSERT( value == 2 );
+
+    int n1 = 1,
+        n2 = 2;
+    int * volatile ptr = &n1;
+    CPPUNIT_ASSERT( !wxAtomicCompareAndSwapPtr(ptr, &n2, &n2) );
+    CPPUNIT_ASSERT( ptr == &n1 );
+
+    CPPUNIT_ASSERT( wxAtomicCompareAndSwapPtr(ptr, &n1, &n2) );
+    CPPUNIT_ASSERT( ptr == &n2 );
+
+    CPPUNIT_ASSERT( wxAtomicExchangePtr(ptr, (int *)NULL) == &n2 );
+    CPPUNIT_ASSERT( ptr == NULL );
+}
+
 void AtomicTestCase::TestWithThreads(int count, ETestType testType)
 {
     wxAtomicInt    int1=0;
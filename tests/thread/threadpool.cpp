@@ -0,0 +1,331 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        tests/thread/threadpool.cpp
+// Purpose:     Unit test for wxThreadPool
+// Author:      agent
+// Created:     2026-10-16
+// RCS-ID:      $Id$
+// Copyright:   (c) 2026 agent <agent@local>
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+// ----------------------------------------------------------------------------
+// headers
+// ----------------------------------------------------------------------------
+
+#include "testprec.h"
+
+#ifdef __BORLANDC__
+    #pragma hdrstop
+#endif
+
+#ifndef WX_PRECOMP
+    #include "wx/thread.h"
+#endif // WX_PRECOMP
+
+#include "wx/threadpool.h"
+
+namespace
+{
+
+// ----------------------------------------------------------------------------
+// test tasks
+// ----------------------------------------------------------------------------
+
+// task incrementing the given counter
+class CountingTask : public wxThreadPoolTask
+{
+public:
+    CountingTask(wxAtomicInt& counter, int id = wxID_ANY)
+        : wxThreadPoolTask(id),
+          m_counter(counter)
+    {
+    }
+
+protected:
+    virtual void Run() { wxAtomicInc(m_counter); }
+
+private:
+    wxAtomicInt& m_counter;
+};
+
+// task computing the sum of the numbers in the given range by recursively
+// splitting it in two subtasks and waiting for them
+class SumTask : public wxThreadPoolTask
+{
+public:
+    SumTask(wxThreadPool& pool, int from, int to)
+        : m_pool(pool),
+          m_from(from),
+          m_to(to),
+          m_sum(0)
+    {
+    }
+
+    wxInt64 GetSum() const { return m_sum; }
+
+protected:
+    virtual void Run()
+    {
+        if ( m_to - m_from < 100 )
+        {
+            for ( int n = m_from; n < m_to; n++ )
+                m_sum += n;
+            return;
+        }
+
+        const int middle = (m_from + m_to) / 2;
+        SumTask * const left = new SumTask(m_pool, m_from, middle);
+        SumTask * const right = new SumTask(m_pool, middle, m_to);
+        m_pool.Submit(left);
+        m_pool.Submit(right);
+
+        left->Wait();
+        right->Wait();
+
+        m_sum = left->GetSum() + right->GetSum();
+
+        left->DecRef();
+        right->DecRef();
+    }
+
+private:
+    wxThreadPool& m_pool;
+    const int m_from,
+              m_to;
+    wxInt64 m_sum;
+};
+
+// task blocking the thread running it until it is allowed to continue
+class BlockingTask : public wxThreadPoolTask
+{
+public:
+    BlockingTask() : m_started(0, 1), m_continue(0, 1) { }
+
+    void WaitUntilStarted() { m_started.Wait(); }
+    void Continue() { m_continue.Post(); }
+
+protected:
+    virtual void Run()
+    {
+        m_started.Post();
+        m_continue.Wait();
+    }
+
+private:
+    wxSemaphore m_started,
+                m_continue;
+};
+
+// handler counting the completion events it receives
+class CompletionHandler : public wxEvtHandler
+{
+public:
+    CompletionHandler()
+    {
+        m_numDone =
+        m_numCancelled = 0;
+        m_sumIds = 0;
+
+        Connect(wxEVT_THREAD_POOL_TASK,
+                wxThreadEventHandler(CompletionHandler::OnTask));
+    }
+
+    int m_numDone,
+        m_numCancelled,
+        m_sumIds;
+
+private:
+    void OnTask(wxThreadEvent& event)
+    {
+        switch ( event.GetInt() )
+        {
+            case wxTHREAD_POOL_TASK_DONE:
+                m_numDone++;
+                break;
+
+            case wxTHREAD_POOL_TASK_CANCELLED:
+                m_numCancelled++;
+                break;
+        }
+
+        m_sumIds += event.GetId();
+    }
+};
+
+} // anonymous namespace
+
+// ----------------------------------------------------------------------------
+// test class
+// ----------------------------------------------------------------------------
+
+class ThreadPoolTestCase : public CppUnit::TestCase
+{
+public:
+    ThreadPoolTestCase() { }
+
+private:
+    CPPUNIT_TEST_SUITE( ThreadPoolTestCase );
+        CPPUNIT_TEST( ManyTasks );
+        CPPUNIT_TEST( Subtasks );
+        CPPUNIT_TEST( Cancel );
+        CPPUNIT_TEST( CancelAll );
+        CPPUNIT_TEST( CompletionEvents );
+    CPPUNIT_TEST_SUITE_END();
+
+    void ManyTasks();
+    void Subtasks();
+    void Cancel();
+    void CancelAll();
+    void CompletionEvents();
+
+    DECLARE_NO_COPY_CLASS(ThreadPoolTestCase)
+};
+
+// register in the unnamed registry so that these tests are run by default
+CPPUNIT_TEST_SUITE_REGISTRATION( ThreadPoolTestCase );
+
+// also include in its own registry so that these tests can be run alone
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( ThreadPoolTestCase, "ThreadPoolTestCase" );
+
+void ThreadPoolTestCase::ManyTasks()
+{
+    wxThreadPool pool(4);
+    CPPUNIT_ASSERT( pool.IsOk() );
+    CPPUNIT_ASSERT_EQUAL( 4u, pool.GetThreadCount() );
+
+    const int numTasks = 10000;
+
+    wxAtomicInt counter = 0;
+    for ( int n = 0; n < numTasks; n++ )
+    {
+        CountingTask * const task = new CountingTask(counter);
+        CPPUNIT_ASSERT( pool.Submit(task) );
+        task->DecRef();
+    }
+
+    pool.WaitAll();
+
+    CPPUNIT_ASSERT_EQUAL( numTasks, counter );
+}
+
+void ThreadPoolTestCase::Subtasks()
+{
+    // use a small number of threads to make sure that waiting for the
+    // subtasks from inside the pool doesn't block it
+    wxThreadPool pool(2);
+
+    SumTask * const task = new SumTask(pool, 0, 100000);
+    CPPUNIT_ASSERT( pool.Submit(task) );
+
+    task->Wait();
+    CPPUNIT_ASSERT_EQUAL( wxTHREAD_POOL_TASK_DONE, task->GetState() );
+    CPPUNIT_ASSERT_EQUAL( wxInt64(100000)*99999/2, task->GetSum() );
+
+    task->DecRef();
+}
+
+void ThreadPoolTestCase::Cancel()
+{
+    wxThreadPool pool(1);
+
+    // block the only thread of the pool
+    BlockingTask * const blocking = new BlockingTask;
+    CPPUNIT_ASSERT( pool.Submit(blocking) );
+    blocking->WaitUntilStarted();
+
+    wxAtomicInt counter = 0;
+    CountingTask * const task = new CountingTask(counter);
+    CPPUNIT_ASSERT( pool.Submit(task) );
+
+    // the running task can't be cancelled but can see the request to do it
+    CPPUNIT_ASSERT( !blocking->Cancel() );
+    CPPUNIT_ASSERT( blocking->IsCancelRequested() );
+    CPPUNIT_ASSERT( !blocking->IsFinished() );
+
+    // but the pending one can
+    CPPUNIT_ASSERT( task->Cancel() );
+    CPPUNIT_ASSERT( task->IsFinished() );
+    CPPUNIT_ASSERT( task->WaitTimeout(0) );
+
+    CPPUNIT_ASSERT( !blocking->WaitTimeout(10) );
+
+    blocking->Continue();
+    blocking->Wait();
+    CPPUNIT_ASSERT_EQUAL( wxTHREAD_POOL_TASK_CANCELLED, blocking->GetState() );
+
+    pool.WaitAll();
+    CPPUNIT_ASSERT_EQUAL( wxTHREAD_POOL_TASK_CANCELLED, task->GetState() );
+    CPPUNIT_ASSERT_EQUAL( 0, counter );
+
+    // cancelled task can't be submitted again
+    CPPUNIT_ASSERT( !pool.Submit(task) );
+
+    task->DecRef();
+    blocking->DecRef();
+}
+
+void ThreadPoolTestCase::CancelAll()
+{
+    wxThreadPool pool(1);
+
+    BlockingTask * const blocking = new BlockingTask;
+    CPPUNIT_ASSERT( pool.Submit(blocking) );
+    blocking->WaitUntilStarted();
+
+    wxAtomicInt counter = 0;
+    for ( int n = 0; n < 100; n++ )
+    {
+        CountingTask * const task = new CountingTask(counter);
+        CPPUNIT_ASSERT( pool.Submit(task) );
+        task->DecRef();
+    }
+
+    pool.CancelAll();
+    CPPUNIT_ASSERT( blocking->IsCancelRequested() );
+
+    blocking->Continue();
+    pool.WaitAll();
+
+    CPPUNIT_ASSERT_EQUAL( 0, counter );
+
+    // the tasks submitted after CancelAll() are not affected by it
+    CountingTask * const task = new CountingTask(counter);
+    CPPUNIT_ASSERT( pool.Submit(task) );
+    task->Wait();
+    CPPUNIT_ASSERT_EQUAL( wxTHREAD_POOL_TASK_DONE, task->GetState() );
+    CPPUNIT_ASSERT_EQUAL( 1, counter );
+
+    task->DecRef();
+    blocking->DecRef();
+}
+
+void ThreadPoolTestCase::CompletionEvents()
+{
+    CompletionHandler handler;
+
+    {
+        wxThreadPool pool(2);
+
+        wxAtomicInt counter = 0;
+        for ( int n = 1; n <= 10; n++ )
+        {
+            CountingTask * const task = new CountingTask(counter, n);
+            task->SetCompletionHandler(&handler);
+            CPPUNIT_ASSERT( pool.Submit(task) );
+            task->DecRef();
+        }
+
+        pool.WaitAll();
+    }
+
+    // the events are only processed in this thread
+    CPPUNIT_ASSERT_EQUAL( 0, handler.m_numDone );
+
+    // each call processes a single event
+    for ( int n = 0; n < 10; n++ )
+        handler.ProcessPendingEvents();
+
+    CPPUNIT_ASSERT_EQUAL( 10, handler.m_numDone );
+    CPPUNIT_ASSERT_EQUAL( 0, handler.m_numCancelled );
+    CPPUNIT_ASSERT_EQUAL( 55, handler.m_sumIds );
+}
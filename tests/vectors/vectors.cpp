@@ -85,6 +85,7 @@ private:
         CPPUNIT_TEST( Resize );
         CPPUNIT_TEST( Swap );
         CPPUNIT_TEST( Sort );
+        CPPUNIT_TEST( Move );
     CPPUNIT_TEST_SUITE_END();
 
     void PushPopTest();
@@ -96,6 +97,7 @@ private:
     void Resize();
     void Swap();
     void Sort();
+    void Move();
 
     DECLARE_NO_COPY_CLASS(VectorsTestCase)
 };
@@ -315,3 +317,34 @@ void VectorsTestCase::Sort()
         CPPUNIT_ASSERT( v[idx-1] <= v[idx] );
     }
 }
+
+void VectorsTestCase::Move()
+{
+    // check that the strings survive being moved around when the vector
+    // grows and when elements are inserted into and erased from it
+    wxVector<wxString> v;
+    for ( int n = 0; n < 100; n++ )
+        v.push_back(wxString::Format("%d", n));
+
+    v.insert(v.begin(), "first");
+    v.erase(v.begin() + 1);
+    CPPUNIT_ASSERT_EQUAL( 100, v.size() );
+    CPPUNIT_ASSERT_EQUAL( "first", v[0] );
+    CPPUNIT_ASSERT_EQUAL( "1", v[1] );
+    CPPUNIT_ASSERT_EQUAL( "99", v[99] );
+
+#ifdef wxHAS_RVALUE_REF
+    wxString s("moved");
+    v.push_back(std::move(s));
+    CPPUNIT_ASSERT_EQUAL( "moved", v.back() );
+    CPPUNIT_ASSERT( s.empty() );
+
+    wxVector<wxString> v2(std::move(v));
+    CPPUNIT_ASSERT( v.empty() );
+    CPPUNIT_ASSERT_EQUAL( 101, v2.size() );
+
+    v = std::move(v2);
+    CPPUNIT_ASSERT_EQUAL( 101, v.size() );
+    CPPUNIT_ASSERT_EQUAL( "first", v[0] );
+#endif // wxHAS_RVALUE_REF
+}